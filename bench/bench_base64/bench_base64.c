@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_input.h"
+#include "foil_output.h"
+#include "foil_random.h"
+#include "foil_util.h"
+
+/* Typical key and message sizes, and a large blob */
+static const gsize bench_base64_sizes[] = { 1024, 64*1024, 1024*1024 };
+
+typedef struct bench_base64 {
+    FoilBytes data;
+    FoilBytes encoded;
+} BenchBase64;
+
+static
+void
+bench_base64_encode(
+    gpointer user_data)
+{
+    BenchBase64* bench = user_data;
+    FoilOutput* out = foil_output_base64_new(NULL);
+
+    foil_output_write(out, bench->data.val, bench->data.len);
+    g_bytes_unref(foil_output_free_to_bytes(out));
+}
+
+static
+void
+bench_base64_decode(
+    gpointer user_data)
+{
+    BenchBase64* bench = user_data;
+    FoilInput* mem = foil_input_mem_new_bytes(&bench->encoded);
+    FoilInput* in = foil_input_base64_new(mem);
+
+    g_bytes_unref(foil_input_read_all(in));
+    foil_input_unref(in);
+    foil_input_unref(mem);
+}
+
+static
+void
+bench_base64_parse(
+    gpointer user_data)
+{
+    BenchBase64* bench = user_data;
+    GUtilRange pos;
+
+    pos.ptr = bench->encoded.val;
+    pos.end = pos.ptr + bench->encoded.len;
+    g_bytes_unref(foil_parse_base64(&pos, 0));
+}
+
+int main(int argc, char* argv[])
+{
+    const gsize max = bench_base64_sizes[G_N_ELEMENTS(bench_base64_sizes)-1];
+    BenchBase64 bench;
+    guint8* buf;
+    guint i;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    buf = g_malloc(max);
+    foil_random(buf, max);
+    bench.data.val = buf;
+    for (i = 0; i < G_N_ELEMENTS(bench_base64_sizes); i++) {
+        const gsize size = bench_base64_sizes[i];
+        char* size_name = bench_size_name(size);
+        FoilOutput* out = foil_output_base64_new(NULL);
+        GBytes* encoded;
+        char* name;
+
+        /* Rates are in terms of the binary data */
+        bench.data.len = size;
+        foil_output_write(out, buf, size);
+        encoded = foil_output_free_to_bytes(out);
+        foil_bytes_from_data(&bench.encoded, encoded);
+
+        name = g_strconcat("encode/", size_name, NULL);
+        bench_run_bytes(name, bench_base64_encode, &bench, size);
+        g_free(name);
+
+        name = g_strconcat("decode/", size_name, NULL);
+        bench_run_bytes(name, bench_base64_decode, &bench, size);
+        g_free(name);
+
+        name = g_strconcat("parse/", size_name, NULL);
+        bench_run_bytes(name, bench_base64_parse, &bench, size);
+        g_free(name);
+
+        g_bytes_unref(encoded);
+        g_free(size_name);
+    }
+    g_free(buf);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_cipher.h"
+#include "foil_key_p.h"
+
+typedef struct bench_cipher_new {
+    const char* name;
+    GType (*cipher)(void);
+    GType (*key)(void);
+} BenchCipherNew;
+
+typedef struct bench_cipher_data {
+    GType type;
+    FoilKey* key;
+    FoilCipher* cipher;
+    guint8 iv[16];
+} BenchCipherData;
+
+static
+void
+bench_cipher_new(
+    gpointer user_data)
+{
+    BenchCipherData* data = user_data;
+
+    foil_cipher_unref(foil_cipher_new(data->type, data->key));
+}
+
+static
+void
+bench_cipher_clone(
+    gpointer user_data)
+{
+    BenchCipherData* data = user_data;
+
+    foil_cipher_unref(foil_cipher_clone(data->cipher));
+}
+
+static
+void
+bench_cipher_set_iv(
+    gpointer user_data)
+{
+    BenchCipherData* data = user_data;
+    FoilKey* key;
+
+    data->iv[0]++;
+    key = foil_key_set_iv(data->key, data->iv, sizeof(data->iv));
+    foil_cipher_unref(foil_cipher_new(data->type, key));
+    foil_key_unref(key);
+}
+
+static const BenchCipherNew bench_cipher_new_all[] = {
+#define BENCH_(mode,dir,bits) { "aes" #bits "_" #mode "_" #dir, \
+    foil_impl_cipher_aes_##mode##_##dir##_get_type, \
+    foil_key_aes##bits##_get_type }
+    BENCH_(cbc, encrypt, 128),
+    BENCH_(cbc, decrypt, 128),
+    BENCH_(ctr, encrypt, 128),
+    BENCH_(cbc, encrypt, 256),
+    BENCH_(cbc, decrypt, 256),
+    BENCH_(ctr, encrypt, 256)
+#undef BENCH_
+};
+
+int main(int argc, char* argv[])
+{
+    guint i;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(bench_cipher_new_all); i++) {
+        const BenchCipherNew* bench = bench_cipher_new_all + i;
+        BenchCipherData data;
+        char* name;
+
+        memset(&data, 0, sizeof(data));
+        data.type = bench->cipher();
+        data.key = foil_key_generate_new(bench->key(), FOIL_KEY_BITS_DEFAULT);
+        data.cipher = foil_cipher_new(data.type, data.key);
+
+        name = g_strconcat(bench->name, "/new", NULL);
+        bench_run(name, bench_cipher_new, &data);
+        g_free(name);
+
+        name = g_strconcat(bench->name, "/clone", NULL);
+        bench_run(name, bench_cipher_clone, &data);
+        g_free(name);
+
+        name = g_strconcat(bench->name, "/set_iv", NULL);
+        bench_run(name, bench_cipher_set_iv, &data);
+        g_free(name);
+
+        foil_cipher_unref(data.cipher);
+        foil_key_unref(data.key);
+    }
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
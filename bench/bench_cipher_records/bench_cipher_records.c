@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_cipher.h"
+#include "foil_key.h"
+
+#define BENCH_MAX_RECORD_SIZE (4096)
+
+typedef struct bench_records {
+    GType type;
+    FoilKey* key;
+    FoilCipher* cipher;
+    gsize size;
+    guint8 in[BENCH_MAX_RECORD_SIZE];
+    guint8 out[BENCH_MAX_RECORD_SIZE];
+} BenchRecords;
+
+static
+void
+bench_records_encrypt(
+    BenchRecords* bench,
+    FoilCipher* cipher)
+{
+    const int bs = foil_cipher_input_block_size(cipher);
+    const guint8* in = bench->in;
+    guint8* out = bench->out;
+    gsize left = bench->size;
+
+    while (left > (gsize)bs) {
+        foil_cipher_step(cipher, in, out);
+        in += bs;
+        out += bs;
+        left -= bs;
+    }
+    foil_cipher_finish(cipher, in, left, out);
+}
+
+static
+void
+bench_records_new(
+    gpointer data)
+{
+    BenchRecords* bench = data;
+    FoilCipher* cipher = foil_cipher_new(bench->type, bench->key);
+
+    bench_records_encrypt(bench, cipher);
+    foil_cipher_unref(cipher);
+}
+
+static
+void
+bench_records_pool(
+    gpointer data)
+{
+    BenchRecords* bench = data;
+    FoilCipher* cipher = foil_cipher_pool_get(bench->type, bench->key);
+
+    bench_records_encrypt(bench, cipher);
+    foil_cipher_pool_put(cipher);
+}
+
+static
+void
+bench_records_reset(
+    gpointer data)
+{
+    BenchRecords* bench = data;
+
+    foil_cipher_reset(bench->cipher);
+    bench_records_encrypt(bench, bench->cipher);
+}
+
+int main(int argc, char* argv[])
+{
+    static const gsize sizes[] = { 64, 256, 1024, 4096 };
+    BenchRecords* bench;
+    guint i;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    bench = g_new0(BenchRecords, 1);
+    bench->type = FOIL_CIPHER_AES_CBC_ENCRYPT;
+    bench->key = foil_key_generate_new(FOIL_KEY_AES128, FOIL_KEY_BITS_DEFAULT);
+    bench->cipher = foil_cipher_new(bench->type, bench->key);
+    for (i = 0; i < sizeof(bench->in); i++) {
+        bench->in[i] = (guint8)i;
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(sizes); i++) {
+        char* name;
+
+        bench->size = sizes[i];
+        name = g_strdup_printf("aes128_cbc_encrypt/%u/new", (guint)sizes[i]);
+        bench_run(name, bench_records_new, bench);
+        g_free(name);
+
+        name = g_strdup_printf("aes128_cbc_encrypt/%u/pool", (guint)sizes[i]);
+        bench_run(name, bench_records_pool, bench);
+        g_free(name);
+
+        name = g_strdup_printf("aes128_cbc_encrypt/%u/reset", (guint)sizes[i]);
+        bench_run(name, bench_records_reset, bench);
+        g_free(name);
+    }
+
+    foil_cipher_pool_clear();
+    foil_cipher_unref(bench->cipher);
+    foil_key_unref(bench->key);
+    g_free(bench);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
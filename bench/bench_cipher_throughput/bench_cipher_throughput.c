@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_cipher.h"
+#include "foil_key.h"
+#include "foil_private_key.h"
+
+/*
+ * Bulk encryption throughput. OpenSSL uses AES-NI and PCLMULQDQ
+ * when the CPU has them, to see how a host without them would fare
+ * run the benchmark with those disabled:
+ *
+ *   OPENSSL_ia32cap="~0x200000200000000" bench_cipher_throughput
+ *
+ * ChaCha20-Poly1305 doesn't depend on either.
+ */
+static const gsize bench_throughput_sizes[] = {
+    1024, 16*1024, 64*1024, 1024*1024
+};
+
+#define BENCH_THROUGHPUT_SIZE (64*1024)
+#define BENCH_THROUGHPUT_MAX_TAG_SIZE (16)
+
+/*
+ * RSA is slow, a small key keeps the runs reasonably short. The bulk
+ * variant spreads the blocks across the CPUs.
+ */
+#define BENCH_THROUGHPUT_RSA_BITS (1024)
+
+typedef struct bench_throughput {
+    const char* name;
+    GType (*encrypt)(void);
+    GType (*decrypt)(void);
+    GType (*key)(void);
+} BenchThroughput;
+
+typedef struct bench_throughput_data {
+    FoilCipher* cipher;
+    const guint8* in;
+    gsize size;
+    guint8* out;
+    guint8 tag[BENCH_THROUGHPUT_MAX_TAG_SIZE];
+    guint tag_size;
+} BenchThroughputData;
+
+typedef struct bench_throughput_pool {
+    GType type;
+    FoilKey* key;
+    const guint8* in;
+    gsize size;
+} BenchThroughputPool;
+
+typedef struct bench_throughput_rsa {
+    FoilKey* key;
+    GBytes* enc;
+} BenchThroughputRsa;
+
+static
+gsize
+bench_throughput_steps(
+    FoilCipher* cipher,
+    const guint8* in,
+    gsize size,
+    guint8* out)
+{
+    const int bs = foil_cipher_input_block_size(cipher);
+    guint8* start = out;
+    int n;
+
+    while (size > (gsize)bs) {
+        out += foil_cipher_step(cipher, in, out);
+        in += bs;
+        size -= bs;
+    }
+    n = foil_cipher_finish(cipher, in, size, out);
+    return (out - start) + MAX(n, 0);
+}
+
+static
+void
+bench_throughput_run(
+    gpointer user_data)
+{
+    BenchThroughputData* data = user_data;
+    FoilCipher* cipher = data->cipher;
+
+    /* The decrypting AEAD cipher needs the tag before it starts */
+    foil_cipher_reset(cipher);
+    if (data->tag_size) {
+        foil_cipher_set_tag(cipher, data->tag, data->tag_size);
+    }
+    bench_throughput_steps(cipher, data->in, data->size, data->out);
+}
+
+/* Each thread picks its own cipher from the pool */
+static
+void
+bench_throughput_pool_run(
+    gpointer user_data)
+{
+    BenchThroughputPool* pool = user_data;
+    FoilCipher* cipher = foil_cipher_pool_get(pool->type, pool->key);
+    guint8* out = g_malloc(2 * pool->size);
+
+    bench_throughput_steps(cipher, pool->in, pool->size, out);
+    foil_cipher_pool_put(cipher);
+    g_free(out);
+}
+
+static
+void
+bench_throughput_cipher(
+    const BenchThroughput* bench,
+    const guint8* in,
+    guint8* enc,
+    guint8* dec)
+{
+    FoilKey* key = foil_key_generate_new(bench->key(), FOIL_KEY_BITS_DEFAULT);
+    FoilCipher* encrypt = foil_cipher_new(bench->encrypt(), key);
+    FoilCipher* decrypt = foil_cipher_new(bench->decrypt(), key);
+    BenchThroughputData data;
+    BenchThroughputPool pool;
+    guint i;
+
+    memset(&data, 0, sizeof(data));
+    for (i = 0; i < G_N_ELEMENTS(bench_throughput_sizes); i++) {
+        const gsize size = bench_throughput_sizes[i];
+        char* size_name = bench_size_name(size);
+        char* name = g_strconcat(bench->name, "/encrypt/", size_name, NULL);
+
+        data.cipher = encrypt;
+        data.in = in;
+        data.size = size;
+        data.out = enc;
+        data.tag_size = 0;
+        bench_run_bytes(name, bench_throughput_run, &data, size);
+        g_free(name);
+
+        /* Decrypt what has been encrypted, with the matching tag */
+        foil_cipher_reset(encrypt);
+        data.cipher = decrypt;
+        data.in = enc;
+        data.size = bench_throughput_steps(encrypt, in, size, enc);
+        data.out = dec;
+        data.tag_size = MIN(foil_cipher_tag_size(encrypt), sizeof(data.tag));
+        if (data.tag_size) {
+            foil_cipher_get_tag(encrypt, data.tag, data.tag_size);
+        }
+        name = g_strconcat(bench->name, "/decrypt/", size_name, NULL);
+        bench_run_bytes(name, bench_throughput_run, &data, size);
+        g_free(name);
+        g_free(size_name);
+    }
+
+    /* Independent streams should scale with the number of cores */
+    pool.type = bench->encrypt();
+    pool.key = key;
+    pool.in = in;
+    pool.size = BENCH_THROUGHPUT_SIZE;
+    if (!strcmp(bench->name, "aes128_gcm")) {
+        bench_run_scaling("aes128_gcm/encrypt/64k",
+            bench_throughput_pool_run, &pool, pool.size);
+    }
+
+    foil_cipher_unref(encrypt);
+    foil_cipher_unref(decrypt);
+    foil_key_unref(key);
+}
+
+/* One block at a time */
+static
+void
+bench_throughput_rsa_serial(
+    gpointer user_data)
+{
+    BenchThroughputRsa* rsa = user_data;
+    FoilCipher* cipher = foil_cipher_new(FOIL_CIPHER_RSA_DECRYPT, rsa->key);
+    const int bs = foil_cipher_input_block_size(cipher);
+    guint8* out = g_malloc(foil_cipher_output_block_size(cipher));
+    gsize left = 0;
+    const guint8* in = g_bytes_get_data(rsa->enc, &left);
+
+    while (left > (gsize)bs) {
+        foil_cipher_step(cipher, in, out);
+        in += bs;
+        left -= bs;
+    }
+    foil_cipher_finish(cipher, in, left, out);
+    foil_cipher_unref(cipher);
+    g_free(out);
+}
+
+/* All blocks at once */
+static
+void
+bench_throughput_rsa_bulk(
+    gpointer user_data)
+{
+    BenchThroughputRsa* rsa = user_data;
+
+    g_bytes_unref(foil_cipher_bytes(FOIL_CIPHER_RSA_DECRYPT, rsa->key,
+        rsa->enc));
+}
+
+static
+void
+bench_throughput_rsa(
+    const guint8* in)
+{
+    BenchThroughputRsa rsa;
+    FoilKey* pub;
+    GBytes* bytes = g_bytes_new_static(in, BENCH_THROUGHPUT_SIZE);
+
+    rsa.key = foil_key_generate_new(FOIL_KEY_RSA_PRIVATE,
+        BENCH_THROUGHPUT_RSA_BITS);
+    pub = foil_public_key_new_from_private(FOIL_PRIVATE_KEY(rsa.key));
+    rsa.enc = foil_cipher_bytes(FOIL_CIPHER_RSA_ENCRYPT, pub, bytes);
+    bench_run_bytes("rsa1024_decrypt/64k/serial",
+        bench_throughput_rsa_serial, &rsa, BENCH_THROUGHPUT_SIZE);
+    bench_run_bytes("rsa1024_decrypt/64k/bulk",
+        bench_throughput_rsa_bulk, &rsa, BENCH_THROUGHPUT_SIZE);
+    g_bytes_unref(rsa.enc);
+    g_bytes_unref(bytes);
+    foil_key_unref(pub);
+    foil_key_unref(rsa.key);
+}
+
+static const BenchThroughput bench_throughput_all[] = {
+#define BENCH_(name,cipher,key) { name, \
+    foil_impl_cipher_##cipher##_encrypt_get_type, \
+    foil_impl_cipher_##cipher##_decrypt_get_type, \
+    key##_get_type }
+    BENCH_("aes128_cbc", aes_cbc, foil_key_aes128),
+    BENCH_("aes192_cbc", aes_cbc, foil_key_aes192),
+    BENCH_("aes256_cbc", aes_cbc, foil_key_aes256),
+    BENCH_("aes128_cfb", aes_cfb, foil_key_aes128),
+    BENCH_("aes256_cfb", aes_cfb, foil_key_aes256),
+    BENCH_("aes128_ctr", aes_ctr, foil_key_aes128),
+    BENCH_("aes256_ctr", aes_ctr, foil_key_aes256),
+    BENCH_("aes128_ecb", aes_ecb, foil_key_aes128),
+    BENCH_("aes256_ecb", aes_ecb, foil_key_aes256),
+    BENCH_("aes128_gcm", aes_gcm, foil_key_aes128),
+    BENCH_("aes256_gcm", aes_gcm, foil_key_aes256),
+    BENCH_("des_cbc", des_cbc, foil_impl_key_des),
+    BENCH_("chacha20_poly1305", chacha20_poly1305, foil_key_aes256)
+#undef BENCH_
+};
+
+int main(int argc, char* argv[])
+{
+    const gsize max =
+        bench_throughput_sizes[G_N_ELEMENTS(bench_throughput_sizes) - 1];
+    guint8* in;
+    guint8* enc;
+    guint8* dec;
+    guint i;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    /* Leave room for the padding */
+    in = g_malloc(max);
+    enc = g_malloc(2 * max);
+    dec = g_malloc(2 * max);
+    for (i = 0; i < max; i++) {
+        in[i] = (guint8)i;
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(bench_throughput_all); i++) {
+        bench_throughput_cipher(bench_throughput_all + i, in, enc, dec);
+    }
+    bench_throughput_rsa(in);
+
+    g_free(in);
+    g_free(enc);
+    g_free(dec);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
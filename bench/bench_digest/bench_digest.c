@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_digest.h"
+#include "foil_random.h"
+
+/* Message sizes, from per-call overhead dominated to bulk hashing */
+static const gsize bench_digest_sizes[] = { 64, 1024, 16*1024, 1024*1024 };
+
+#define BENCH_DIGEST_SCALING_SIZE (16*1024)
+
+/* Large enough for SHA-512 */
+#define BENCH_DIGEST_MAX_SIZE (64)
+
+typedef struct bench_digest {
+    GType type;
+    const GType* types;
+    const guint8* data;
+    gsize size;
+} BenchDigest;
+
+static
+void
+bench_digest_run(
+    gpointer user_data)
+{
+    BenchDigest* bench = user_data;
+    guint8 md[BENCH_DIGEST_MAX_SIZE];
+
+    foil_digest_data_buf(bench->type, bench->data, bench->size, md);
+}
+
+/* MD5, SHA-1 and SHA-256 of the same data */
+#define BENCH_DIGEST_MULTI_COUNT (3)
+
+static
+void
+bench_digest_separate_run(
+    gpointer user_data)
+{
+    BenchDigest* bench = user_data;
+    guint8 md[BENCH_DIGEST_MAX_SIZE];
+    guint i;
+
+    for (i = 0; i < BENCH_DIGEST_MULTI_COUNT; i++) {
+        foil_digest_data_buf(bench->types[i], bench->data,
+            bench->size, md);
+    }
+}
+
+static
+void
+bench_digest_multi_run(
+    gpointer user_data)
+{
+    BenchDigest* bench = user_data;
+    GBytes* md[BENCH_DIGEST_MULTI_COUNT];
+    guint i;
+
+    foil_digest_multi_data(bench->types, BENCH_DIGEST_MULTI_COUNT,
+        bench->data, bench->size, md);
+    for (i = 0; i < BENCH_DIGEST_MULTI_COUNT; i++) {
+        g_bytes_unref(md[i]);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    static const struct bench_digest_type {
+        const char* name;
+        GType (*type)(void);
+    } types[] = {
+        { "md5", foil_impl_digest_md5_get_type },
+        { "sha1", foil_impl_digest_sha1_get_type },
+        { "sha256", foil_impl_digest_sha256_get_type },
+        { "sha512", foil_impl_digest_sha512_get_type },
+        { "blake2b", foil_impl_digest_blake2b_get_type },
+        { "blake3", foil_impl_digest_blake3_get_type }
+    };
+    const gsize max = bench_digest_sizes[G_N_ELEMENTS(bench_digest_sizes)-1];
+    GType multi[BENCH_DIGEST_MULTI_COUNT];
+    BenchDigest bench;
+    guint8* buf;
+    guint i, k;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    buf = g_malloc(max);
+    foil_random(buf, max);
+    bench.data = buf;
+    bench.types = NULL;
+    for (i = 0; i < G_N_ELEMENTS(types); i++) {
+        bench.type = types[i].type();
+        for (k = 0; k < G_N_ELEMENTS(bench_digest_sizes); k++) {
+            char* size = bench_size_name(bench_digest_sizes[k]);
+            char* name = g_strconcat(types[i].name, "/", size, NULL);
+
+            bench.size = bench_digest_sizes[k];
+            bench_run_bytes(name, bench_digest_run, &bench, bench.size);
+            g_free(name);
+            g_free(size);
+        }
+    }
+
+    /* Digests don't share any state, this should scale linearly */
+    bench.type = FOIL_DIGEST_SHA256;
+    bench.size = BENCH_DIGEST_SCALING_SIZE;
+    bench_run_scaling("sha256/16k", bench_digest_run, &bench, bench.size);
+
+    /* Three passes over the data vs one */
+    multi[0] = FOIL_DIGEST_MD5;
+    multi[1] = FOIL_DIGEST_SHA1;
+    multi[2] = FOIL_DIGEST_SHA256;
+    bench.types = multi;
+    for (k = 0; k < G_N_ELEMENTS(bench_digest_sizes); k++) {
+        char* size = bench_size_name(bench_digest_sizes[k]);
+        char* name = g_strconcat("md5+sha1+sha256/separate/", size, NULL);
+
+        bench.size = bench_digest_sizes[k];
+        bench_run_bytes(name, bench_digest_separate_run, &bench, bench.size);
+        g_free(name);
+        name = g_strconcat("md5+sha1+sha256/multi/", size, NULL);
+        bench_run_bytes(name, bench_digest_multi_run, &bench, bench.size);
+        g_free(name);
+        g_free(size);
+    }
+
+    g_free(buf);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
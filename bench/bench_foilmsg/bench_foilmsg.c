@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_arena.h"
+#include "foil_key.h"
+#include "foil_private_key.h"
+#include "foil_random.h"
+#include "foil_util.h"
+
+#include "foilmsg.h"
+
+/*
+ * Small messages and small keys, so that the time isn't all spent
+ * in AES and RSA and the per-message overhead (mostly memory
+ * allocation) shows up.
+ */
+#define BENCH_FOILMSG_SIZE (1024)
+#define BENCH_FOILMSG_KEY_BITS (512)
+
+/* Large enough for the bulk encryption to dominate */
+#define BENCH_FOILMSG_LARGE_SIZE (1024*1024)
+
+/* Size sweep goes from 1K up to bench_max_size() in steps of 16x */
+#define BENCH_FOILMSG_SWEEP_MIN (1024)
+#define BENCH_FOILMSG_SWEEP_STEP (16)
+
+/* Roughly what encrypting and decrypting one message allocates */
+#define BENCH_FOILMSG_TEMPORARIES (32)
+#define BENCH_FOILMSG_TEMPORARY_SIZE (48)
+
+typedef struct bench_foilmsg {
+    FoilPrivateKey* sender;
+    FoilPrivateKey* recipient;
+    FoilKey* pub;
+    FoilMsgEncryptOptions opt;
+    FoilMsgHeaders headers;
+    FoilBytes data;
+    FoilBytes msg;
+} BenchFoilMsg;
+
+static
+void
+bench_foilmsg_encrypt(
+    gpointer data)
+{
+    BenchFoilMsg* bench = data;
+
+    g_bytes_unref(foilmsg_encrypt_to_bytes(&bench->data, "text/plain",
+        &bench->headers, bench->sender, bench->pub, &bench->opt));
+}
+
+static
+void
+bench_foilmsg_decrypt(
+    gpointer data)
+{
+    BenchFoilMsg* bench = data;
+
+    foilmsg_free(foilmsg_decrypt(bench->recipient, &bench->msg, NULL));
+}
+
+static
+void
+bench_foilmsg_temporaries_malloc(
+    gpointer data)
+{
+    gpointer ptr[BENCH_FOILMSG_TEMPORARIES];
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(ptr); i++) {
+        ptr[i] = g_malloc(BENCH_FOILMSG_TEMPORARY_SIZE);
+        memset(ptr[i], i, BENCH_FOILMSG_TEMPORARY_SIZE);
+    }
+    for (i = 0; i < G_N_ELEMENTS(ptr); i++) {
+        g_free(ptr[i]);
+    }
+}
+
+static
+void
+bench_foilmsg_temporaries_arena(
+    gpointer data)
+{
+    FoilArena* arena = foil_arena_new(0);
+    guint i;
+
+    for (i = 0; i < BENCH_FOILMSG_TEMPORARIES; i++) {
+        memset(foil_arena_alloc(arena, BENCH_FOILMSG_TEMPORARY_SIZE), i,
+            BENCH_FOILMSG_TEMPORARY_SIZE);
+    }
+    foil_arena_free(arena);
+}
+
+static
+void
+bench_foilmsg_large(
+    BenchFoilMsg* bench,
+    FOILMSG_CIPHER cipher,
+    const char* encrypt_name,
+    const char* decrypt_name)
+{
+    const FoilBytes data = bench->data;
+    const FoilBytes msg = bench->msg;
+    guint8* buf = g_malloc(BENCH_FOILMSG_LARGE_SIZE);
+    GBytes* enc;
+
+    foil_random(buf, BENCH_FOILMSG_LARGE_SIZE);
+    bench->data.val = buf;
+    bench->data.len = BENCH_FOILMSG_LARGE_SIZE;
+    bench->opt.cipher = cipher;
+    enc = foilmsg_encrypt_to_bytes(&bench->data, "text/plain",
+        &bench->headers, bench->sender, bench->pub, &bench->opt);
+    foil_bytes_from_data(&bench->msg, enc);
+
+    bench_run_bytes(encrypt_name, bench_foilmsg_encrypt, bench,
+        BENCH_FOILMSG_LARGE_SIZE);
+    bench_run_bytes(decrypt_name, bench_foilmsg_decrypt, bench,
+        BENCH_FOILMSG_LARGE_SIZE);
+
+    g_bytes_unref(enc);
+    g_free(buf);
+    bench->data = data;
+    bench->msg = msg;
+    bench->opt.cipher = FOILMSG_CIPHER_DEFAULT;
+}
+
+static
+void
+bench_foilmsg_sweep(
+    BenchFoilMsg* bench)
+{
+    const FoilBytes data = bench->data;
+    const FoilBytes msg = bench->msg;
+    const gsize max = bench_max_size();
+    gsize size;
+
+    for (size = BENCH_FOILMSG_SWEEP_MIN; size <= max;
+         size *= BENCH_FOILMSG_SWEEP_STEP) {
+        guint8* buf = g_malloc(size);
+        char* size_name = bench_size_name(size);
+        char* name;
+        GBytes* enc;
+
+        foil_random(buf, size);
+        bench->data.val = buf;
+        bench->data.len = size;
+        enc = foilmsg_encrypt_to_bytes(&bench->data, "text/plain",
+            &bench->headers, bench->sender, bench->pub, &bench->opt);
+        foil_bytes_from_data(&bench->msg, enc);
+
+        name = g_strconcat("encrypt/sweep/", size_name, NULL);
+        bench_run_bytes(name, bench_foilmsg_encrypt, bench, size);
+        g_free(name);
+
+        name = g_strconcat("decrypt/sweep/", size_name, NULL);
+        bench_run_bytes(name, bench_foilmsg_decrypt, bench, size);
+        g_free(name);
+
+        g_bytes_unref(enc);
+        g_free(size_name);
+        g_free(buf);
+        if (size > max / BENCH_FOILMSG_SWEEP_STEP) {
+            break;
+        }
+    }
+    bench->data = data;
+    bench->msg = msg;
+}
+
+int main(int argc, char* argv[])
+{
+    static const FoilMsgHeader headers[] = {
+        { "Name", "bench" },
+        { "Date", "2026-01-01" },
+        { "Comment", "Small message" }
+    };
+    BenchFoilMsg bench;
+    GBytes* enc;
+    guint8* buf;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    memset(&bench, 0, sizeof(bench));
+    bench.sender = FOIL_PRIVATE_KEY(foil_key_generate_new
+        (FOIL_KEY_RSA_PRIVATE, BENCH_FOILMSG_KEY_BITS));
+    bench.recipient = FOIL_PRIVATE_KEY(foil_key_generate_new
+        (FOIL_KEY_RSA_PRIVATE, BENCH_FOILMSG_KEY_BITS));
+    bench.pub = foil_public_key_new_from_private(bench.recipient);
+    bench.headers.header = headers;
+    bench.headers.count = G_N_ELEMENTS(headers);
+    foilmsg_encrypt_defaults(&bench.opt);
+    buf = g_malloc(BENCH_FOILMSG_SIZE);
+    foil_random(buf, BENCH_FOILMSG_SIZE);
+    bench.data.val = buf;
+    bench.data.len = BENCH_FOILMSG_SIZE;
+    enc = foilmsg_encrypt_to_bytes(&bench.data, "text/plain", &bench.headers,
+        bench.sender, bench.pub, &bench.opt);
+    foil_bytes_from_data(&bench.msg, enc);
+
+    bench_run("encrypt/1k", bench_foilmsg_encrypt, &bench);
+    bench_run("decrypt/1k", bench_foilmsg_decrypt, &bench);
+    bench_run("temporaries/malloc", bench_foilmsg_temporaries_malloc, NULL);
+    bench_run("temporaries/arena", bench_foilmsg_temporaries_arena, NULL);
+
+    /* AES-CBC plus the digest of the data vs single pass AEAD */
+    bench_foilmsg_large(&bench, FOILMSG_CIPHER_AES_CBC, "encrypt/1m/cbc",
+        "decrypt/1m/cbc");
+    bench_foilmsg_large(&bench, FOILMSG_CIPHER_AES_GCM, "encrypt/1m/gcm",
+        "decrypt/1m/gcm");
+    bench_foilmsg_large(&bench, FOILMSG_CIPHER_CHACHA20_POLY1305,
+        "encrypt/1m/chacha20", "decrypt/1m/chacha20");
+
+    /* Default cipher, up to --max-size (e.g. 1G) */
+    bench_foilmsg_sweep(&bench);
+
+    /* Messages are independent, see how that scales */
+    bench_run_scaling("encrypt/1k", bench_foilmsg_encrypt, &bench, 0);
+    bench_run_scaling("decrypt/1k", bench_foilmsg_decrypt, &bench, 0);
+
+    g_bytes_unref(enc);
+    g_free(buf);
+    foil_key_unref(bench.pub);
+    foil_private_key_unref(bench.sender);
+    foil_private_key_unref(bench.recipient);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
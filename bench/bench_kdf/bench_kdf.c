@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_bcrypt.h"
+#include "foil_digest.h"
+#include "foil_kdf.h"
+
+/* Iteration counts are per call, the rates are per iteration */
+#define BENCH_KDF_PBKDF2_ITER (1000)
+#define BENCH_KDF_BCRYPT_ROUNDS (16)
+#define BENCH_KDF_KEY_SIZE (32)
+
+typedef struct bench_kdf {
+    GType digest;
+    FoilBytes salt;
+} BenchKdf;
+
+static const char bench_kdf_password[] = "password";
+static const guint8 bench_kdf_salt[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static
+void
+bench_kdf_pbkdf2(
+    gpointer data)
+{
+    BenchKdf* bench = data;
+
+    g_bytes_unref(foil_kdf_pbkdf2(bench->digest, bench_kdf_password, -1,
+        &bench->salt, BENCH_KDF_PBKDF2_ITER, BENCH_KDF_KEY_SIZE));
+}
+
+static
+void
+bench_kdf_bcrypt(
+    gpointer data)
+{
+    BenchKdf* bench = data;
+
+    g_bytes_unref(foil_bcrypt_pbkdf(bench_kdf_password, &bench->salt,
+        BENCH_KDF_KEY_SIZE, BENCH_KDF_BCRYPT_ROUNDS));
+}
+
+static
+void
+bench_kdf_hkdf(
+    gpointer data)
+{
+    BenchKdf* bench = data;
+    FoilBytes ikm;
+
+    ikm.val = (const guint8*)bench_kdf_password;
+    ikm.len = sizeof(bench_kdf_password) - 1;
+    g_bytes_unref(foil_kdf_hkdf(bench->digest, &ikm, &bench->salt, NULL,
+        BENCH_KDF_KEY_SIZE));
+}
+
+int main(int argc, char* argv[])
+{
+    BenchKdf bench;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    bench.salt.val = bench_kdf_salt;
+    bench.salt.len = sizeof(bench_kdf_salt);
+
+    bench.digest = FOIL_DIGEST_SHA1;
+    bench_run_units("pbkdf2/sha1", bench_kdf_pbkdf2, &bench,
+        BENCH_KDF_PBKDF2_ITER, "iter");
+    bench.digest = FOIL_DIGEST_SHA256;
+    bench_run_units("pbkdf2/sha256", bench_kdf_pbkdf2, &bench,
+        BENCH_KDF_PBKDF2_ITER, "iter");
+    bench.digest = FOIL_DIGEST_SHA512;
+    bench_run_units("pbkdf2/sha512", bench_kdf_pbkdf2, &bench,
+        BENCH_KDF_PBKDF2_ITER, "iter");
+
+    /* OpenSSH private key encryption */
+    bench_run_units("bcrypt_pbkdf", bench_kdf_bcrypt, &bench,
+        BENCH_KDF_BCRYPT_ROUNDS, "rounds");
+
+    bench.digest = FOIL_DIGEST_SHA256;
+    bench_run("hkdf/sha256", bench_kdf_hkdf, &bench);
+
+    /* Independent derivations on several threads */
+    bench_run_scaling("pbkdf2/sha256", bench_kdf_pbkdf2, &bench, 0);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
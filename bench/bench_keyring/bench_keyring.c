@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#include "bench_common.h"
+
+#include "foil_key.h"
+#include "foil_keyring.h"
+#include "foil_private_key.h"
+#include "foil_util.h"
+
+#include "foilmsg.h"
+
+/*
+ * Small keys keep the setup time reasonable, the key size doesn't
+ * affect the lookup anyway.
+ */
+#define BENCH_KEYRING_SIZE (10000)
+#define BENCH_KEYRING_KEY_BITS (512)
+
+typedef struct bench_keyring {
+    FoilKeyring* keyring;
+    FoilPrivateKey** keys;
+    FoilBytes* fingerprints;
+    guint count;
+    guint next;
+    FoilBytes msg;
+} BenchKeyring;
+
+static
+void
+bench_keyring_find(
+    gpointer data)
+{
+    BenchKeyring* bench = data;
+    const FoilBytes* fp = bench->fingerprints + bench->next;
+
+    foil_private_key_unref(foil_keyring_find(bench->keyring, fp));
+    bench->next = (bench->next + 1) % bench->count;
+}
+
+static
+void
+bench_keyring_scan(
+    gpointer data)
+{
+    BenchKeyring* bench = data;
+    const FoilBytes* fp = bench->fingerprints + bench->next;
+    guint i;
+
+    for (i = 0; i < bench->count; i++) {
+        if (foil_bytes_equal(bench->fingerprints + i, fp)) {
+            break;
+        }
+    }
+    bench->next = (bench->next + 1) % bench->count;
+}
+
+static
+void
+bench_keyring_decrypt(
+    gpointer data)
+{
+    BenchKeyring* bench = data;
+
+    foilmsg_free(foilmsg_decrypt_with_keyring(bench->keyring,
+        &bench->msg, NULL));
+}
+
+/* What one had to do without the keyring - try the keys one by one */
+static
+void
+bench_keyring_decrypt_trial(
+    gpointer data)
+{
+    BenchKeyring* bench = data;
+    FoilMsg* msg = NULL;
+    guint i;
+
+    for (i = 0; i < bench->count && !msg; i++) {
+        msg = foilmsg_decrypt(bench->keys[i], &bench->msg, NULL);
+    }
+    foilmsg_free(msg);
+}
+
+int main(int argc, char* argv[])
+{
+    BenchKeyring bench;
+    FoilMsgEncryptOptions opt;
+    FoilPrivateKey* recipient;
+    FoilKey* pub;
+    FoilBytes text;
+    GBytes* enc;
+    guint i;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    memset(&bench, 0, sizeof(bench));
+    bench.count = BENCH_KEYRING_SIZE;
+    bench.keyring = foil_keyring_new();
+    bench.keys = g_new(FoilPrivateKey*, bench.count);
+    bench.fingerprints = g_new(FoilBytes, bench.count);
+    GDEBUG("Generating %u keys", bench.count);
+    for (i = 0; i < bench.count; i++) {
+        FoilKey* key = foil_key_generate_new(FOIL_KEY_RSA_PRIVATE,
+            BENCH_KEYRING_KEY_BITS);
+
+        bench.keys[i] = FOIL_PRIVATE_KEY(key);
+        foil_bytes_from_data(bench.fingerprints + i,
+            foil_private_key_fingerprint(bench.keys[i]));
+        foil_keyring_add(bench.keyring, bench.keys[i]);
+    }
+
+    /* The recipient is in the middle, that's the average for the scan */
+    recipient = bench.keys[bench.count/2];
+    pub = foil_public_key_new_from_private(recipient);
+    foilmsg_encrypt_defaults(&opt);
+    enc = foilmsg_encrypt_to_bytes(foil_bytes_from_string(&text,
+        "Hello, keyring!"), NULL, NULL, bench.keys[0], pub, &opt);
+    foil_bytes_from_data(&bench.msg, enc);
+
+    bench_run("find/10000/keyring", bench_keyring_find, &bench);
+    bench_run("find/10000/scan", bench_keyring_scan, &bench);
+    bench_run("decrypt/10000/keyring", bench_keyring_decrypt, &bench);
+    bench_run("decrypt/10000/trial", bench_keyring_decrypt_trial, &bench);
+
+    g_bytes_unref(enc);
+    foil_key_unref(pub);
+    foil_keyring_unref(bench.keyring);
+    for (i = 0; i < bench.count; i++) {
+        foil_private_key_unref(bench.keys[i]);
+    }
+    g_free(bench.fingerprints);
+    g_free(bench.keys);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_random.h"
+
+#define BENCH_BULK_SIZE (0x10000)
+#define BENCH_SMALL_SIZE (16)
+#define BENCH_THREADS (4)
+#define BENCH_THREAD_COUNT (200000)
+
+typedef struct bench_random {
+    GType type;
+    guint8* buf;
+} BenchRandom;
+
+static
+void
+bench_random_bulk(
+    gpointer data)
+{
+    BenchRandom* bench = data;
+
+    foil_random_generate(bench->type, bench->buf, BENCH_BULK_SIZE);
+}
+
+static
+void
+bench_random_small(
+    gpointer data)
+{
+    BenchRandom* bench = data;
+
+    foil_random_generate(bench->type, bench->buf, BENCH_SMALL_SIZE);
+}
+
+static
+gpointer
+bench_random_thread(
+    gpointer data)
+{
+    BenchRandom* bench = data;
+    guint8 buf[BENCH_SMALL_SIZE];
+    guint i;
+
+    for (i = 0; i < BENCH_THREAD_COUNT; i++) {
+        foil_random_generate(bench->type, buf, sizeof(buf));
+    }
+    return NULL;
+}
+
+static
+void
+bench_random_threads(
+    const char* name,
+    BenchRandom* bench)
+{
+    GThread* threads[BENCH_THREADS];
+    gint64 start = g_get_monotonic_time();
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(threads); i++) {
+        threads[i] = g_thread_new(name, bench_random_thread, bench);
+    }
+    for (i = 0; i < G_N_ELEMENTS(threads); i++) {
+        g_thread_join(threads[i]);
+    }
+    bench_report(name, BENCH_THREADS * BENCH_THREAD_COUNT,
+        g_get_monotonic_time() - start);
+}
+
+int main(int argc, char* argv[])
+{
+    static const struct bench_random_type {
+        const char* name;
+        GType (*type)(void);
+    } types[] = {
+        { "default", foil_impl_random_get_type },
+        { "buffered", foil_impl_random_buffered_get_type }
+    };
+    BenchRandom bench;
+    guint i;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    bench.buf = g_malloc(BENCH_BULK_SIZE);
+    for (i = 0; i < G_N_ELEMENTS(types); i++) {
+        char* name;
+
+        bench.type = types[i].type();
+        name = g_strconcat(types[i].name, "/bulk", NULL);
+        bench_run_bytes(name, bench_random_bulk, &bench, BENCH_BULK_SIZE);
+        g_free(name);
+
+        name = g_strconcat(types[i].name, "/small", NULL);
+        bench_run(name, bench_random_small, &bench);
+        g_free(name);
+
+        name = g_strconcat(types[i].name, "/small_threads", NULL);
+        bench_random_threads(name, &bench);
+        g_free(name);
+    }
+    g_free(bench.buf);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_cipher.h"
+#include "foil_digest.h"
+#include "foil_key.h"
+#include "foil_private_key.h"
+#include "foil_sign.h"
+#include "foil_util.h"
+
+/* Roughly a wrapped session key, fits into one block of any key size */
+#define BENCH_RSA_DATA_SIZE (32)
+
+static const guint bench_rsa_bits[] = { 1024, 2048, 3072, 4096 };
+
+typedef struct bench_rsa {
+    FoilPrivateKey* priv;
+    FoilKey* pub;
+    FoilBytes data;
+    FoilBytes sig;
+    GBytes* enc;
+} BenchRsa;
+
+static
+void
+bench_rsa_sign(
+    gpointer data)
+{
+    BenchRsa* bench = data;
+
+    g_bytes_unref(foil_rsa_sign(&bench->data, FOIL_DIGEST_SHA256,
+        bench->priv));
+}
+
+static
+void
+bench_rsa_verify(
+    gpointer data)
+{
+    BenchRsa* bench = data;
+
+    foil_rsa_verify(&bench->data, &bench->sig, FOIL_DIGEST_SHA256,
+        bench->pub);
+}
+
+static
+void
+bench_rsa_encrypt(
+    gpointer data)
+{
+    BenchRsa* bench = data;
+
+    g_bytes_unref(foil_cipher_data(FOIL_CIPHER_RSA_ENCRYPT, bench->pub,
+        bench->data.val, bench->data.len));
+}
+
+static
+void
+bench_rsa_decrypt(
+    gpointer data)
+{
+    BenchRsa* bench = data;
+
+    g_bytes_unref(foil_cipher_bytes(FOIL_CIPHER_RSA_DECRYPT,
+        FOIL_KEY(bench->priv), bench->enc));
+}
+
+static
+void
+bench_rsa_run(
+    guint bits,
+    const guint8* buf)
+{
+    BenchRsa bench;
+    GBytes* sig;
+    char* name;
+
+    GDEBUG("Generating %u-bit key", bits);
+    bench.priv = FOIL_PRIVATE_KEY(foil_key_generate_new(FOIL_KEY_RSA_PRIVATE,
+        bits));
+    if (!bench.priv) {
+        fprintf(stderr, "Failed to generate %u-bit key\n", bits);
+        return;
+    }
+
+    bench.pub = foil_public_key_new_from_private(bench.priv);
+    bench.data.val = buf;
+    bench.data.len = BENCH_RSA_DATA_SIZE;
+    sig = foil_rsa_sign(&bench.data, FOIL_DIGEST_SHA256, bench.priv);
+    foil_bytes_from_data(&bench.sig, sig);
+    bench.enc = foil_cipher_data(FOIL_CIPHER_RSA_ENCRYPT, bench.pub,
+        bench.data.val, bench.data.len);
+
+    name = g_strdup_printf("sign/%u", bits);
+    bench_run(name, bench_rsa_sign, &bench);
+    g_free(name);
+
+    name = g_strdup_printf("verify/%u", bits);
+    bench_run(name, bench_rsa_verify, &bench);
+    g_free(name);
+
+    name = g_strdup_printf("encrypt/%u", bits);
+    bench_run(name, bench_rsa_encrypt, &bench);
+    g_free(name);
+
+    name = g_strdup_printf("decrypt/%u", bits);
+    bench_run(name, bench_rsa_decrypt, &bench);
+    g_free(name);
+
+    /* Private key operations on several threads at once */
+    if (bits == 2048) {
+        bench_run_scaling("sign/2048", bench_rsa_sign, &bench, 0);
+    }
+
+    g_bytes_unref(bench.enc);
+    g_bytes_unref(sig);
+    foil_key_unref(bench.pub);
+    foil_private_key_unref(bench.priv);
+}
+
+int main(int argc, char* argv[])
+{
+    guint8 buf[BENCH_RSA_DATA_SIZE];
+    guint i;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (guint8)i;
+    }
+    for (i = 0; i < G_N_ELEMENTS(bench_rsa_bits); i++) {
+        bench_rsa_run(bench_rsa_bits[i], buf);
+    }
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
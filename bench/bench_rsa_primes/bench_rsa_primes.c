@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include "foil_cipher.h"
+#include "foil_digest.h"
+#include "foil_key.h"
+#include "foil_private_key.h"
+#include "foil_random.h"
+#include "foil_sign.h"
+#include "foil_util.h"
+
+#include "foilmsg.h"
+
+/*
+ * Private key operations dominate at this size, that's where the
+ * extra prime pays off. Key generation takes a while though.
+ */
+#define BENCH_RSA_PRIMES_KEY_BITS (3072)
+#define BENCH_RSA_PRIMES_MSG_SIZE (1024)
+
+typedef struct bench_rsa_primes {
+    FoilPrivateKey* priv;
+    FoilKey* pub;
+    FoilMsgEncryptOptions opt;
+    FoilBytes data;
+    FoilBytes msg;
+} BenchRsaPrimes;
+
+/* Sender signs the message, that's one private key operation */
+static
+void
+bench_rsa_primes_encrypt(
+    gpointer data)
+{
+    BenchRsaPrimes* bench = data;
+
+    g_bytes_unref(foilmsg_encrypt_to_bytes(&bench->data, NULL, NULL,
+        bench->priv, bench->pub, &bench->opt));
+}
+
+/* Recipient decrypts the message key, another private key operation */
+static
+void
+bench_rsa_primes_decrypt(
+    gpointer data)
+{
+    BenchRsaPrimes* bench = data;
+
+    foilmsg_free(foilmsg_decrypt(bench->priv, &bench->msg, NULL));
+}
+
+static
+void
+bench_rsa_primes_sign(
+    gpointer data)
+{
+    BenchRsaPrimes* bench = data;
+
+    g_bytes_unref(foil_rsa_sign(&bench->data, FOIL_DIGEST_SHA256,
+        bench->priv));
+}
+
+static
+void
+bench_rsa_primes_run(
+    guint primes,
+    const guint8* buf)
+{
+    GHashTable* params = g_hash_table_new_full(g_str_hash, g_str_equal,
+        NULL, (GDestroyNotify) g_variant_unref);
+    BenchRsaPrimes bench;
+    FoilKey* key;
+    GBytes* enc;
+    char* name;
+
+    memset(&bench, 0, sizeof(bench));
+    g_hash_table_insert(params, FOIL_KEY_PARAM_PRIMES,
+        g_variant_ref_sink(g_variant_new_uint32(primes)));
+    GDEBUG("Generating %u-bit key with %u primes", BENCH_RSA_PRIMES_KEY_BITS,
+        primes);
+    key = foil_key_generate_new_full(FOIL_KEY_RSA_PRIVATE,
+        BENCH_RSA_PRIMES_KEY_BITS, params);
+    g_hash_table_destroy(params);
+    if (!key) {
+        fprintf(stderr, "Failed to generate %u-prime key\n", primes);
+        return;
+    }
+
+    /* Same key on both ends, it's the private part that matters */
+    bench.priv = FOIL_PRIVATE_KEY(key);
+    bench.pub = foil_public_key_new_from_private(bench.priv);
+    foilmsg_encrypt_defaults(&bench.opt);
+    bench.data.val = buf;
+    bench.data.len = BENCH_RSA_PRIMES_MSG_SIZE;
+    enc = foilmsg_encrypt_to_bytes(&bench.data, NULL, NULL, bench.priv,
+        bench.pub, &bench.opt);
+    foil_bytes_from_data(&bench.msg, enc);
+
+    name = g_strdup_printf("sign/%u/%u-primes", BENCH_RSA_PRIMES_KEY_BITS,
+        primes);
+    bench_run(name, bench_rsa_primes_sign, &bench);
+    g_free(name);
+
+    name = g_strdup_printf("foilmsg-encrypt/%u/%u-primes",
+        BENCH_RSA_PRIMES_KEY_BITS, primes);
+    bench_run(name, bench_rsa_primes_encrypt, &bench);
+    g_free(name);
+
+    name = g_strdup_printf("foilmsg-decrypt/%u/%u-primes",
+        BENCH_RSA_PRIMES_KEY_BITS, primes);
+    bench_run(name, bench_rsa_primes_decrypt, &bench);
+    g_free(name);
+
+    g_bytes_unref(enc);
+    foil_key_unref(bench.pub);
+    foil_private_key_unref(bench.priv);
+}
+
+int main(int argc, char* argv[])
+{
+    guint8* buf;
+
+    if (!bench_init(&argc, argv)) {
+        return 1;
+    }
+
+    buf = g_malloc(BENCH_RSA_PRIMES_MSG_SIZE);
+    foil_random(buf, BENCH_RSA_PRIMES_MSG_SIZE);
+    bench_rsa_primes_run(2, buf);
+    bench_rsa_primes_run(3, buf);
+    g_free(buf);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
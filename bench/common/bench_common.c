@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_common.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+#define BENCH_DEFAULT_SECONDS (1)
+#define BENCH_DEFAULT_MAX_SIZE (16*1024*1024)
+#define BENCH_BATCH (16)
+
+typedef enum bench_format {
+    BENCH_FORMAT_TEXT,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+} BenchFormat;
+
+typedef struct bench_thread {
+    GThread* thread;
+    BenchFunc fn;
+    gpointer data;
+    guint64 count;
+    gint64 usec;
+} BenchThread;
+
+static gdouble bench_seconds = BENCH_DEFAULT_SECONDS;
+static BenchFormat bench_format = BENCH_FORMAT_TEXT;
+static guint bench_threads = 0;
+static gsize bench_size = BENCH_DEFAULT_MAX_SIZE;
+static gboolean bench_csv_header = FALSE;
+static FILE* bench_out = NULL;
+
+static
+gboolean
+bench_opt_format(
+    const gchar* name,
+    const gchar* value,
+    gpointer data,
+    GError** error)
+{
+    if (!g_ascii_strcasecmp(value, "text")) {
+        bench_format = BENCH_FORMAT_TEXT;
+    } else if (!g_ascii_strcasecmp(value, "csv")) {
+        bench_format = BENCH_FORMAT_CSV;
+    } else if (!g_ascii_strcasecmp(value, "json")) {
+        bench_format = BENCH_FORMAT_JSON;
+    } else {
+        g_set_error(error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+            "Invalid output format '%s'", value);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static
+gboolean
+bench_opt_size(
+    const gchar* name,
+    const gchar* value,
+    gpointer data,
+    GError** error)
+{
+    char* end = NULL;
+    guint64 size = g_ascii_strtoull(value, &end, 10);
+
+    switch (*end) {
+    case 'g': case 'G': size *= 1024;
+        /* fallthrough */
+    case 'm': case 'M': size *= 1024;
+        /* fallthrough */
+    case 'k': case 'K': size *= 1024;
+        end++;
+        break;
+    }
+    if (end == value || *end || !size || size > G_MAXSSIZE) {
+        g_set_error(error, G_OPTION_ERROR, G_OPTION_ERROR_BAD_VALUE,
+            "Invalid size '%s'", value);
+        return FALSE;
+    }
+    bench_size = (gsize)size;
+    return TRUE;
+}
+
+gboolean
+bench_init(
+    int* argc,
+    char* argv[])
+{
+    gboolean ok;
+    gboolean verbose = FALSE;
+    gint threads = 0;
+    char* output = NULL;
+    GError* error = NULL;
+    GOptionContext* options;
+    GOptionEntry entries[] = {
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose output", NULL },
+        { "time", 't', 0, G_OPTION_ARG_DOUBLE, &bench_seconds,
+          "Run each benchmark for SEC seconds [1]", "SEC" },
+        { "format", 'f', 0, G_OPTION_ARG_CALLBACK, bench_opt_format,
+          "Output format (text, csv or json) [text]", "FORMAT" },
+        { "threads", 'j', 0, G_OPTION_ARG_INT, &threads,
+          "Up to N threads for scaling runs [number of CPUs]", "N" },
+        { "max-size", 'm', 0, G_OPTION_ARG_CALLBACK, bench_opt_size,
+          "Largest payload, e.g. 1G [16M]", "SIZE" },
+        { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output,
+          "Append the results to FILE rather than print them", "FILE" },
+        { NULL }
+    };
+
+    options = g_option_context_new(NULL);
+    g_option_context_add_main_entries(options, entries, NULL);
+    ok = g_option_context_parse(options, argc, &argv, &error);
+    if (ok) {
+        if (bench_seconds <= 0) {
+            bench_seconds = BENCH_DEFAULT_SECONDS;
+        }
+        if (threads > 0) {
+            bench_threads = threads;
+        } else {
+            const long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+            bench_threads = (ncpu > 0) ? (guint)ncpu : 1;
+        }
+        if (output) {
+            bench_out = fopen(output, "a");
+            if (bench_out) {
+                /* Don't repeat the CSV header when appending */
+                fseek(bench_out, 0, SEEK_END);
+                bench_csv_header = (ftell(bench_out) > 0);
+            } else {
+                fprintf(stderr, "Failed to open %s: %s\n", output,
+                    strerror(errno));
+                ok = FALSE;
+            }
+        }
+        gutil_log_timestamp = FALSE;
+        gutil_log_default.level = verbose ?
+            GLOG_LEVEL_VERBOSE : GLOG_LEVEL_NONE;
+    } else {
+        fprintf(stderr, "%s\n", GERRMSG(error));
+        g_error_free(error);
+    }
+    g_option_context_free(options);
+    g_free(output);
+    return ok;
+}
+
+guint
+bench_max_threads(
+    void)
+{
+    return bench_threads ? bench_threads : 1;
+}
+
+gsize
+bench_max_size(
+    void)
+{
+    return bench_size;
+}
+
+char*
+bench_size_name(
+    gsize size)
+{
+    static const char suffix[] = { 'k', 'm', 'g' };
+    int i = -1;
+
+    while (i < (int)G_N_ELEMENTS(suffix) - 1 && size >= 1024 &&
+        !(size % 1024)) {
+        size /= 1024;
+        i++;
+    }
+    return (i < 0) ? g_strdup_printf("%" G_GSIZE_FORMAT, size) :
+        g_strdup_printf("%" G_GSIZE_FORMAT "%c", size, suffix[i]);
+}
+
+/* Benchmark names are ours, but let's not produce broken JSON anyway */
+static
+void
+bench_print_json_string(
+    FILE* out,
+    const char* str)
+{
+    putc('"', out);
+    for (; *str; str++) {
+        const char c = *str;
+
+        if (c == '"' || c == '\\') {
+            fprintf(out, "\\%c", c);
+        } else if ((guchar)c < 0x20) {
+            fprintf(out, "\\u%04x", (guchar)c);
+        } else {
+            putc(c, out);
+        }
+    }
+    putc('"', out);
+}
+
+static
+void
+bench_print(
+    const char* name,
+    gdouble rate,
+    const char* unit,
+    guint64 count,
+    gint64 usec)
+{
+    const char* prog = g_get_prgname();
+    FILE* out = bench_out ? bench_out : stdout;
+
+    switch (bench_format) {
+    case BENCH_FORMAT_CSV:
+        if (!bench_csv_header) {
+            bench_csv_header = TRUE;
+            fprintf(out, "bench,name,rate,unit,count,usec\n");
+        }
+        fprintf(out, "%s,%s,%.3f,%s,%" G_GUINT64_FORMAT ",%"
+            G_GINT64_FORMAT "\n", prog ? prog : "", name, rate, unit,
+            count, usec);
+        break;
+    case BENCH_FORMAT_JSON:
+        fprintf(out, "{\"bench\":");
+        bench_print_json_string(out, prog ? prog : "");
+        fprintf(out, ",\"name\":");
+        bench_print_json_string(out, name);
+        fprintf(out, ",\"rate\":%.3f,\"unit\":\"%s\",\"count\":%"
+            G_GUINT64_FORMAT ",\"usec\":%" G_GINT64_FORMAT "}\n", rate,
+            unit, count, usec);
+        break;
+    case BENCH_FORMAT_TEXT:
+        if (!strcmp(unit, "ops/s")) {
+            if (count) {
+                fprintf(out, "%s: %.0f ops/s (%.1f ns/op)\n", name, rate,
+                    usec * 1000.0 / count);
+            } else {
+                fprintf(out, "%s: 0 ops/s\n", name);
+            }
+        } else {
+            fprintf(out, "%s: %.1f %s\n", name, rate, unit);
+        }
+        break;
+    }
+    fflush(out);
+}
+
+static
+guint64
+bench_loop(
+    BenchFunc fn,
+    gpointer data,
+    gint64* usec)
+{
+    const gint64 start = g_get_monotonic_time();
+    const gint64 end = start + (gint64)(bench_seconds * G_USEC_PER_SEC);
+    guint64 count = 0;
+    int batch = 1;
+    gint64 now;
+
+    /*
+     * Check the clock once per batch to keep its cost out of the loop.
+     * The batch starts small so that slow operations (large payloads)
+     * don't overshoot the time limit too much.
+     */
+    do {
+        int i;
+
+        for (i = 0; i < batch; i++) {
+            fn(data);
+        }
+        count += batch;
+        if (batch < BENCH_BATCH) {
+            batch *= 2;
+        }
+        now = g_get_monotonic_time();
+    } while (now < end);
+    *usec = now - start;
+    return count;
+}
+
+static
+gdouble
+bench_rate(
+    guint64 count,
+    gint64 usec,
+    gdouble scale)
+{
+    return usec ? (count * scale / usec) : 0;
+}
+
+gdouble
+bench_run(
+    const char* name,
+    BenchFunc fn,
+    gpointer data)
+{
+    gint64 usec;
+    const guint64 count = bench_loop(fn, data, &usec);
+
+    return bench_report(name, count, usec);
+}
+
+gdouble
+bench_run_bytes(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    gsize bytes)
+{
+    gint64 usec;
+    const guint64 count = bench_loop(fn, data, &usec);
+    /* Bytes per microsecond are megabytes per second */
+    const gdouble rate = bench_rate(count, usec, bytes);
+
+    bench_print(name, rate, "MB/s", count, usec);
+    return rate;
+}
+
+gdouble
+bench_run_units(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    guint64 units,
+    const char* unit)
+{
+    gint64 usec;
+    const guint64 count = bench_loop(fn, data, &usec);
+    const gdouble rate = bench_rate(count, usec,
+        (gdouble)units * G_USEC_PER_SEC);
+    char* rate_unit = g_strconcat(unit, "/s", NULL);
+
+    bench_print(name, rate, rate_unit, count, usec);
+    g_free(rate_unit);
+    return rate;
+}
+
+static
+gpointer
+bench_thread_proc(
+    gpointer user_data)
+{
+    BenchThread* thread = user_data;
+
+    thread->count = bench_loop(thread->fn, thread->data, &thread->usec);
+    return NULL;
+}
+
+gdouble
+bench_run_threads(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    gsize bytes,
+    guint nthreads)
+{
+    BenchThread* threads = g_new0(BenchThread, MAX(nthreads, 1));
+    guint64 count = 0;
+    gint64 usec = 0;
+    gdouble rate;
+    guint i;
+
+    /* The calling thread is one of the workers */
+    for (i = 0; i < nthreads; i++) {
+        BenchThread* thread = threads + i;
+
+        thread->fn = fn;
+        thread->data = data;
+        if (i > 0) {
+            thread->thread = g_thread_new(name, bench_thread_proc, thread);
+        }
+    }
+    bench_thread_proc(threads);
+    for (i = 0; i < nthreads; i++) {
+        BenchThread* thread = threads + i;
+
+        if (thread->thread) {
+            g_thread_join(thread->thread);
+        }
+        count += thread->count;
+        usec = MAX(usec, thread->usec);
+    }
+    g_free(threads);
+
+    if (bytes) {
+        rate = bench_rate(count, usec, bytes);
+        bench_print(name, rate, "MB/s", count, usec);
+    } else {
+        rate = bench_rate(count, usec, G_USEC_PER_SEC);
+        bench_print(name, rate, "ops/s", count, usec);
+    }
+    return rate;
+}
+
+void
+bench_run_scaling(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    gsize bytes)
+{
+    const guint max = bench_max_threads();
+    guint n = 1;
+
+    while (TRUE) {
+        char* thread_name = g_strdup_printf("%s/%ut", name, n);
+
+        bench_run_threads(thread_name, fn, data, bytes, n);
+        g_free(thread_name);
+        if (n == max) {
+            break;
+        }
+        n = MIN(2 * n, max);
+    }
+}
+
+gdouble
+bench_report(
+    const char* name,
+    guint64 count,
+    gint64 usec)
+{
+    const gdouble rate = bench_rate(count, usec, G_USEC_PER_SEC);
+
+    bench_print(name, rate, "ops/s", count, usec);
+    return rate;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
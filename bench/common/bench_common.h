@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include "foil_types.h"
+
+#include <gutil_log.h>
+#include <gutil_macros.h>
+
+#include <glib-object.h>
+
+/* Runs one operation, the argument is passed through by bench_run() */
+typedef
+void
+(*BenchFunc)(
+    gpointer data);
+
+/*
+ * Parses command line, returns FALSE (after printing usage) on error.
+ * Besides the run time, the command line selects the output format
+ * (human readable text, CSV or JSON, one object per line), the number
+ * of threads for the scaling runs and the largest payload size.
+ */
+gboolean
+bench_init(
+    int* argc,
+    char* argv[]);
+
+/* Maximum number of threads for bench_run_scaling() */
+guint
+bench_max_threads(
+    void);
+
+/* Largest payload that size sweeps should go up to */
+gsize
+bench_max_size(
+    void);
+
+/* Formats the size as 64, 1k, 16m, 1g etc. for benchmark names */
+char*
+bench_size_name(
+    gsize size);
+
+/* Calls fn repeatedly for the configured time, returns ops/s */
+gdouble
+bench_run(
+    const char* name,
+    BenchFunc fn,
+    gpointer data);
+
+/* Same as bench_run() but reports throughput in MB/s */
+gdouble
+bench_run_bytes(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    gsize bytes);
+
+/* Same as bench_run() but reports units (e.g. iterations) per second */
+gdouble
+bench_run_units(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    guint64 units,
+    const char* unit);
+
+/*
+ * Calls fn on nthreads threads at once, reports the combined ops/s
+ * (or MB/s if bytes is non-zero). The function must be thread-safe.
+ */
+gdouble
+bench_run_threads(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    gsize bytes,
+    guint nthreads);
+
+/* Runs bench_run_threads() with 1, 2, 4... bench_max_threads() threads */
+void
+bench_run_scaling(
+    const char* name,
+    BenchFunc fn,
+    gpointer data,
+    gsize bytes);
+
+/* Prints the rate of count operations done in usec microseconds */
+gdouble
+bench_report(
+    const char* name,
+    guint64 count,
+    gint64 usec);
+
+#endif /* BENCH_COMMON_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
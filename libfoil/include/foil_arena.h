@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_ARENA_H
+#define FOIL_ARENA_H
+
+#include "foil_types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Bump pointer allocator for short-lived objects which all go away
+ * at the same time. Memory is carved out of large chunks and is only
+ * released by foil_arena_reset or foil_arena_free, individual blocks
+ * can't be freed. The first chunk is allocated together with the arena
+ * itself, so a small workload costs a single malloc.
+ *
+ * The arena is not thread-safe.
+ *
+ * Since 1.0.31
+ */
+
+#define FOIL_ARENA_CHUNK_SIZE_DEFAULT (4000)
+
+/* Zero chunk_size selects FOIL_ARENA_CHUNK_SIZE_DEFAULT */
+FoilArena*
+foil_arena_new(
+    gsize chunk_size);
+
+void
+foil_arena_free(
+    FoilArena* arena);
+
+/* Invokes the destroy callbacks and frees all but the first chunk */
+void
+foil_arena_reset(
+    FoilArena* arena);
+
+gpointer
+foil_arena_alloc(
+    FoilArena* arena,
+    gsize size);
+
+gpointer
+foil_arena_alloc0(
+    FoilArena* arena,
+    gsize size);
+
+/*
+ * If ptr is the most recent allocation and there's enough room left in
+ * its chunk, the block is resized in place. Otherwise a new block is
+ * allocated and the contents gets copied there.
+ */
+gpointer
+foil_arena_realloc(
+    FoilArena* arena,
+    gpointer ptr,
+    gsize old_size,
+    gsize new_size);
+
+gpointer
+foil_arena_memdup(
+    FoilArena* arena,
+    gconstpointer data,
+    gsize size);
+
+char*
+foil_arena_strdup(
+    FoilArena* arena,
+    const char* str);
+
+/* Copies len bytes and appends NUL terminator */
+char*
+foil_arena_strndup(
+    FoilArena* arena,
+    const char* str,
+    gsize len);
+
+/* Copies the data into the arena, returns dest */
+const FoilBytes*
+foil_arena_copy_bytes(
+    FoilArena* arena,
+    FoilBytes* dest,
+    const FoilBytes* src);
+
+/* The destroy callback is invoked when the arena gets reset or freed */
+void
+foil_arena_add(
+    FoilArena* arena,
+    gpointer pointer,
+    GDestroyNotify destroy);
+
+#define foil_arena_new0(arena,type) \
+    ((type*)foil_arena_alloc0(arena, sizeof(type)))
+#define foil_arena_new_array(arena,type,n) \
+    ((type*)foil_arena_alloc(arena, sizeof(type) * (n)))
+
+G_END_DECLS
+
+#endif /* FOIL_ARENA_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
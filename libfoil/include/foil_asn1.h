@@ -127,6 +127,17 @@ foil_asn1_block_length(
 #define foil_asn1_bit_string_block_length(bitcount) \
     foil_asn1_block_length(1 + ((bitcount) + 7)/8)
 
+/*
+ * Size of the encoded INTEGER. Together with foil_asn1_block_length
+ * it allows to calculate the exact size of a structure up front and
+ * then write it in one go, without intermediate buffers.
+ *
+ * Since 1.0.31
+ */
+gsize
+foil_asn1_integer_length(
+    gint32 value);
+
 gboolean
 foil_asn1_parse_len(
     GUtilRange* pos,
@@ -245,6 +256,29 @@ foil_asn1_parse_tag(
     guint8* tag_id, /* Full tag or just leading octet for multi-byte tags */
     guint32* tag_num);
 
+/*
+ * GUtilRange serves as a cursor. None of the foil_asn1_parse_* functions
+ * allocate memory, FoilBytes they return point into the parsed buffer.
+ */
+
+/* Since 1.0.31 */
+gboolean
+foil_asn1_peek_tag(
+    const GUtilRange* pos,
+    guint8* tag_id, /* Full tag or just leading octet for multi-byte tags */
+    guint32* tag_num);
+
+/* Since 1.0.31 (moves pos past SEQUENCE, seq receives its contents) */
+gboolean
+foil_asn1_parse_sequence(
+    GUtilRange* pos,
+    GUtilRange* seq);
+
+/* Since 1.0.31 (skips one block of any kind) */
+gboolean
+foil_asn1_parse_skip(
+    GUtilRange* pos);
+
 G_END_DECLS
 
 #endif /* FOIL_ASN1_H */
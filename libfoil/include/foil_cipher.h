@@ -87,6 +87,46 @@ FoilCipher*
 foil_cipher_clone(
     FoilCipher* cipher); /* Since 1.0.14 */
 
+/*
+ * foil_cipher_rekey brings the cipher into the same state as a cipher
+ * freshly created by foil_cipher_new with the new key, including the
+ * IV and the padding function. foil_cipher_reset does the same with
+ * the current key. Both fail if the key isn't supported by the cipher
+ * or if there are asynchronous operations pending.
+ */
+
+gboolean
+foil_cipher_rekey(
+    FoilCipher* cipher,
+    FoilKey* key); /* Since 1.0.31 */
+
+gboolean
+foil_cipher_reset(
+    FoilCipher* cipher); /* Since 1.0.31 */
+
+/*
+ * Per-thread pool of cipher instances. foil_cipher_pool_get takes
+ * a cipher of the requested type from the calling thread's pool and
+ * rekeys it, or creates a new one if there's none. foil_cipher_pool_put
+ * drops the caller's reference, and if that was the last reference,
+ * stores the cipher (without the key) in the pool for reuse.
+ * foil_cipher_pool_clear empties the calling thread's pool, which
+ * otherwise gets emptied when the thread exits.
+ */
+
+FoilCipher*
+foil_cipher_pool_get(
+    GType type,
+    FoilKey* key); /* Since 1.0.31 */
+
+void
+foil_cipher_pool_put(
+    FoilCipher* cipher); /* Since 1.0.31 */
+
+void
+foil_cipher_pool_clear(
+    void); /* Since 1.0.31 */
+
 FoilCipher*
 foil_cipher_ref(
     FoilCipher* cipher);
@@ -132,6 +172,44 @@ foil_cipher_set_padding_func(
     FoilCipher* cipher,
     FoilCipherPaddingFunc fn);
 
+/*
+ * Authenticated encryption (AEAD) ciphers, e.g. AES-GCM, compute the
+ * authentication tag as they go. foil_cipher_tag_size returns zero for
+ * ciphers which don't. Additional authenticated data must be supplied
+ * before the first block. The encrypting cipher makes the tag available
+ * after foil_cipher_finish. The decrypting cipher needs it before that,
+ * and then foil_cipher_finish fails if the tag doesn't match.
+ *
+ * AES-GCM and ChaCha20-Poly1305 take the nonce from the IV of the AES
+ * key (its first 12 bytes). Such a key must be used for encrypting only
+ * one message. Encrypting two different messages with the same key and
+ * IV reuses the nonce, which reveals the XOR of the two plaintexts and
+ * allows forging the tags. Generate a new key for every message, or at
+ * least a new IV.
+ */
+
+guint
+foil_cipher_tag_size(
+    FoilCipher* cipher); /* Since 1.0.31 */
+
+gboolean
+foil_cipher_add_aad(
+    FoilCipher* cipher,
+    const void* aad,
+    gsize size); /* Since 1.0.31 */
+
+gboolean
+foil_cipher_get_tag(
+    FoilCipher* cipher,
+    void* tag,
+    gsize size); /* Since 1.0.31 */
+
+gboolean
+foil_cipher_set_tag(
+    FoilCipher* cipher,
+    const void* tag,
+    gsize size); /* Since 1.0.31 */
+
 /*
  * Primitive operations, synchronous or asynchronous variants.
  *
@@ -229,10 +307,15 @@ GType foil_impl_cipher_aes_cfb_encrypt_get_type(void); /* Since 1.0.18 */
 GType foil_impl_cipher_aes_cfb_decrypt_get_type(void); /* Since 1.0.18 */
 GType foil_impl_cipher_aes_ctr_encrypt_get_type(void); /* Since 1.0.28 */
 GType foil_impl_cipher_aes_ctr_decrypt_get_type(void); /* Since 1.0.28 */
+GType foil_impl_cipher_aes_gcm_encrypt_get_type(void); /* Since 1.0.31 */
+GType foil_impl_cipher_aes_gcm_decrypt_get_type(void); /* Since 1.0.31 */
 GType foil_impl_cipher_aes_ecb_encrypt_get_type(void); /* Since 1.0.17 */
 GType foil_impl_cipher_aes_ecb_decrypt_get_type(void); /* Since 1.0.17 */
 GType foil_impl_cipher_des_cbc_encrypt_get_type(void); /* Since 1.0.16 */
 GType foil_impl_cipher_des_cbc_decrypt_get_type(void); /* Since 1.0.16 */
+/* Since 1.0.31 */
+GType foil_impl_cipher_chacha20_poly1305_encrypt_get_type(void);
+GType foil_impl_cipher_chacha20_poly1305_decrypt_get_type(void);
 
 #define FOIL_CIPHER_RSA_ENCRYPT foil_impl_cipher_rsa_encrypt_get_type()
 #define FOIL_CIPHER_RSA_DECRYPT foil_impl_cipher_rsa_decrypt_get_type()
@@ -242,10 +325,16 @@ GType foil_impl_cipher_des_cbc_decrypt_get_type(void); /* Since 1.0.16 */
 #define FOIL_CIPHER_AES_CFB_DECRYPT foil_impl_cipher_aes_cfb_decrypt_get_type()
 #define FOIL_CIPHER_AES_CTR_ENCRYPT foil_impl_cipher_aes_ctr_encrypt_get_type()
 #define FOIL_CIPHER_AES_CTR_DECRYPT foil_impl_cipher_aes_ctr_decrypt_get_type()
+#define FOIL_CIPHER_AES_GCM_ENCRYPT foil_impl_cipher_aes_gcm_encrypt_get_type()
+#define FOIL_CIPHER_AES_GCM_DECRYPT foil_impl_cipher_aes_gcm_decrypt_get_type()
 #define FOIL_CIPHER_AES_ECB_ENCRYPT foil_impl_cipher_aes_ecb_encrypt_get_type()
 #define FOIL_CIPHER_AES_ECB_DECRYPT foil_impl_cipher_aes_ecb_decrypt_get_type()
 #define FOIL_CIPHER_DES_CBC_ENCRYPT foil_impl_cipher_des_cbc_encrypt_get_type()
 #define FOIL_CIPHER_DES_CBC_DECRYPT foil_impl_cipher_des_cbc_decrypt_get_type()
+#define FOIL_CIPHER_CHACHA20_POLY1305_ENCRYPT \
+    foil_impl_cipher_chacha20_poly1305_encrypt_get_type()
+#define FOIL_CIPHER_CHACHA20_POLY1305_DECRYPT \
+    foil_impl_cipher_chacha20_poly1305_decrypt_get_type()
 
 G_END_DECLS
 
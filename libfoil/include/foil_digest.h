@@ -122,20 +122,75 @@ GBytes*
 foil_digest_free_to_bytes(
     FoilDigest* digest);
 
+/*
+ * Several digests of the same data, computed in a single pass. The data
+ * are fed to the digests in small chunks, each chunk to all the digests
+ * while it's still in the cache. Large updates are split between the
+ * threads, one digest per thread. The individual digests are available
+ * via foil_digest_multi_get(), e.g. to finish them.
+ */
+
+FoilDigestMulti*
+foil_digest_multi_new(
+    const GType* types,
+    guint count); /* Since 1.0.31 */
+
+FoilDigestMulti*
+foil_digest_multi_ref(
+    FoilDigestMulti* multi); /* Since 1.0.31 */
+
+void
+foil_digest_multi_unref(
+    FoilDigestMulti* multi); /* Since 1.0.31 */
+
+guint
+foil_digest_multi_count(
+    FoilDigestMulti* multi); /* Since 1.0.31 */
+
+FoilDigest*
+foil_digest_multi_get(
+    FoilDigestMulti* multi,
+    guint index); /* Since 1.0.31 */
+
+gboolean
+foil_digest_multi_update(
+    FoilDigestMulti* multi,
+    const void* data,
+    gsize size); /* Since 1.0.31 */
+
+gboolean
+foil_digest_multi_reset(
+    FoilDigestMulti* multi); /* Since 1.0.31 */
+
+/* Stores count digests, which the caller must unref */
+gboolean
+foil_digest_multi_data(
+    const GType* types,
+    guint count,
+    const void* data,
+    gsize size,
+    GBytes** digests); /* Since 1.0.31 */
+
 /* Implementation types */
 GType foil_impl_digest_md5_get_type(void);
 GType foil_impl_digest_sha1_get_type(void);
 GType foil_impl_digest_sha256_get_type(void);
 GType foil_impl_digest_sha512_get_type(void); /* Since 1.0.22 */
+GType foil_impl_digest_blake2b_get_type(void); /* Since 1.0.31 */
+GType foil_impl_digest_blake3_get_type(void); /* Since 1.0.31 */
 #define FOIL_DIGEST_MD5 (foil_impl_digest_md5_get_type())
 #define FOIL_DIGEST_SHA1 (foil_impl_digest_sha1_get_type())
 #define FOIL_DIGEST_SHA256 (foil_impl_digest_sha256_get_type())
 #define FOIL_DIGEST_SHA512 (foil_impl_digest_sha512_get_type())
+#define FOIL_DIGEST_BLAKE2B (foil_impl_digest_blake2b_get_type())
+#define FOIL_DIGEST_BLAKE3 (foil_impl_digest_blake3_get_type())
 
 #define foil_digest_new_md5() foil_digest_new(FOIL_DIGEST_MD5)
 #define foil_digest_new_sha1() foil_digest_new(FOIL_DIGEST_SHA1)
 #define foil_digest_new_sha256() foil_digest_new(FOIL_DIGEST_SHA256)
 #define foil_digest_new_sha512() foil_digest_new(FOIL_DIGEST_SHA512)
+#define foil_digest_new_blake2b() foil_digest_new(FOIL_DIGEST_BLAKE2B)
+#define foil_digest_new_blake3() foil_digest_new(FOIL_DIGEST_BLAKE3)
 
 G_END_DECLS
 
@@ -116,6 +116,15 @@ foil_input_digest_new(
     FoilInput* in,
     FoilDigest* digest);
 
+/*
+ * Feeds the data read from the underlying input to the verifier. Call
+ * foil_verifier_finish() after the last byte has been read.
+ */
+FoilInput*
+foil_input_verify_new(
+    FoilInput* in,
+    FoilVerifier* verifier); /* Since 1.0.31 */
+
 FoilInput*
 foil_input_base64_new(
     FoilInput* in);
@@ -142,17 +151,66 @@ foil_input_cipher_new(
     FoilCipher* cipher,
     FoilInput* in);
 
+/*
+ * Reads the source stream on a separate thread, up to depth chunks
+ * ahead. The source stream must not be used by anyone else after that.
+ * Zero chunk size and depth mean the defaults (64K and 4). If the
+ * thread can't be started, returns a new reference to the source.
+ */
+FoilInput*
+foil_input_readahead_new(
+    FoilInput* in,
+    gsize chunk,
+    guint depth); /* Since 1.0.31 */
+
 FoilInput*
 foil_input_file_new(
     FILE* file,
     guint flags);
 
 #define FOIL_INPUT_FILE_CLOSE           (0x01)  /* Close the file when done */
+#define FOIL_INPUT_FILE_DIRECT          (0x02)  /* O_DIRECT (Since 1.0.31) */
+
+/*
+ * File descriptor based input does its own buffering and tells the
+ * kernel that the file is going to be read sequentially. The buffer
+ * size of zero means the default (64K). FOIL_INPUT_FILE_DIRECT is
+ * ignored by foil_input_file_new().
+ */
+FoilInput*
+foil_input_file_new_fd(
+    int fd,
+    guint flags,
+    gsize bufsize); /* Since 1.0.31 */
 
 FoilInput*
 foil_input_file_new_open(
     const char* path);
 
+FoilInput*
+foil_input_file_new_open_full(
+    const char* path,
+    guint flags,
+    gsize bufsize); /* Since 1.0.31 */
+
+/*
+ * io_uring based input (Linux only) keeps up to depth reads of bufsize
+ * bytes in flight. Zeros mean the defaults. The descriptor must be
+ * seekable. If io_uring is unavailable, these fall back to the plain
+ * file descriptor based input. Only FOIL_INPUT_FILE_CLOSE flag is
+ * honored by the io_uring implementation.
+ */
+FoilInput*
+foil_input_uring_new(
+    int fd,
+    guint flags,
+    gsize bufsize,
+    guint depth); /* Since 1.0.31 */
+
+FoilInput*
+foil_input_uring_new_open(
+    const char* path); /* Since 1.0.31 */
+
 G_END_DECLS
 
 #endif /* FOIL_INPUT_H */
@@ -56,6 +56,19 @@ foil_kdf_pbkdf2(
     guint iter,     /* Number of iterations */
     guint dklen);   /* Derived key length, zero for auto (digest length) */
 
+/*
+ * HKDF (RFC 5869). Salt and info are optional. Fails if dklen exceeds
+ * 255 digest lengths.
+ */
+
+GBytes*
+foil_kdf_hkdf(
+    GType digest,   /* HMAC digest algorithm, e.g. FOIL_DIGEST_SHA256 */
+    const FoilBytes* ikm,
+    const FoilBytes* salt,
+    const FoilBytes* info,
+    guint dklen);   /* Since 1.0.31 */
+
 G_END_DECLS
 
 #endif /* FOIL_KDF_H */
@@ -57,6 +57,15 @@ G_BEGIN_DECLS
  */
 #define FOIL_KEY_PARAM_COMMENT "Comment"        /* G_VARIANT_TYPE_STRING */
 
+/*
+ * "Primes" is the number of prime factors of the RSA modulus for
+ * foil_key_generate_new_full(). Two by default, more primes make
+ * private key operations faster. OpenSSL limits it depending on the
+ * key size (up to 3 for keys shorter than 4096 bits, up to 4 for
+ * keys shorter than 8192 bits). Since 1.0.31
+ */
+#define FOIL_KEY_PARAM_PRIMES "Primes"          /* G_VARIANT_TYPE_UINT32 */
+
 /* Key export format (for exporting to text) */
 typedef enum foil_key_export_format {
     FOIL_KEY_EXPORT_FORMAT_DEFAULT,
@@ -160,6 +169,12 @@ foil_key_generate_new(
     GType type,
     guint bits);
 
+FoilKey*
+foil_key_generate_new_full(
+    GType type,
+    guint bits,
+    GHashTable* param); /* Since 1.0.31 */
+
 #define FOIL_KEY_BITS_DEFAULT (0)
 
 FoilKey*
@@ -223,12 +238,20 @@ GType foil_key_des_get_type(void); /* Since 1.0.16 */
 GType foil_key_aes_get_type(void);
 GType foil_key_rsa_public_get_type(void);
 GType foil_key_rsa_private_get_type(void);
+GType foil_key_ed25519_public_get_type(void); /* Since 1.0.31 */
+GType foil_key_ed25519_private_get_type(void); /* Since 1.0.31 */
+GType foil_key_x25519_public_get_type(void); /* Since 1.0.31 */
+GType foil_key_x25519_private_get_type(void); /* Since 1.0.31 */
 
 #define FOIL_TYPE_KEY (foil_key_get_type())
 #define FOIL_TYPE_KEY_DES (foil_key_des_get_type()) /* Since 1.0.16 */
 #define FOIL_TYPE_KEY_AES (foil_key_aes_get_type())
 #define FOIL_TYPE_KEY_RSA_PUBLIC (foil_key_rsa_public_get_type())
 #define FOIL_TYPE_KEY_RSA_PRIVATE (foil_key_rsa_private_get_type())
+#define FOIL_TYPE_KEY_ED25519_PUBLIC (foil_key_ed25519_public_get_type())
+#define FOIL_TYPE_KEY_ED25519_PRIVATE (foil_key_ed25519_private_get_type())
+#define FOIL_TYPE_KEY_X25519_PUBLIC (foil_key_x25519_public_get_type())
+#define FOIL_TYPE_KEY_X25519_PRIVATE (foil_key_x25519_private_get_type())
 
 #define FOIL_IS_KEY_DES(obj) \
     G_TYPE_CHECK_INSTANCE_TYPE(obj, FOIL_TYPE_KEY_DES)
@@ -238,6 +261,14 @@ GType foil_key_rsa_private_get_type(void);
     G_TYPE_CHECK_INSTANCE_TYPE(obj, FOIL_TYPE_KEY_RSA_PUBLIC)
 #define FOIL_IS_KEY_RSA_PRIVATE(obj) \
     G_TYPE_CHECK_INSTANCE_TYPE(obj, FOIL_TYPE_KEY_RSA_PRIVATE)
+#define FOIL_IS_KEY_ED25519_PUBLIC(obj) \
+    G_TYPE_CHECK_INSTANCE_TYPE(obj, FOIL_TYPE_KEY_ED25519_PUBLIC)
+#define FOIL_IS_KEY_ED25519_PRIVATE(obj) \
+    G_TYPE_CHECK_INSTANCE_TYPE(obj, FOIL_TYPE_KEY_ED25519_PRIVATE)
+#define FOIL_IS_KEY_X25519_PUBLIC(obj) \
+    G_TYPE_CHECK_INSTANCE_TYPE(obj, FOIL_TYPE_KEY_X25519_PUBLIC)
+#define FOIL_IS_KEY_X25519_PRIVATE(obj) \
+    G_TYPE_CHECK_INSTANCE_TYPE(obj, FOIL_TYPE_KEY_X25519_PRIVATE)
 
 /* Implementation types */
 GType foil_key_aes128_get_type(void);
@@ -246,6 +277,10 @@ GType foil_key_aes256_get_type(void);
 GType foil_impl_key_des_get_type(void); /* Since 1.0.16 */
 GType foil_impl_key_rsa_public_get_type(void);
 GType foil_impl_key_rsa_private_get_type(void);
+GType foil_impl_key_ed25519_public_get_type(void); /* Since 1.0.31 */
+GType foil_impl_key_ed25519_private_get_type(void); /* Since 1.0.31 */
+GType foil_impl_key_x25519_public_get_type(void); /* Since 1.0.31 */
+GType foil_impl_key_x25519_private_get_type(void); /* Since 1.0.31 */
 
 #define FOIL_KEY_DES (foil_impl_key_des_get_type()) /* Since 1.0.16 */
 #define FOIL_KEY_AES128 (foil_key_aes128_get_type())
@@ -253,6 +288,10 @@ GType foil_impl_key_rsa_private_get_type(void);
 #define FOIL_KEY_AES256 (foil_key_aes256_get_type())
 #define FOIL_KEY_RSA_PUBLIC (foil_impl_key_rsa_public_get_type())
 #define FOIL_KEY_RSA_PRIVATE (foil_impl_key_rsa_private_get_type())
+#define FOIL_KEY_ED25519_PUBLIC (foil_impl_key_ed25519_public_get_type())
+#define FOIL_KEY_ED25519_PRIVATE (foil_impl_key_ed25519_private_get_type())
+#define FOIL_KEY_X25519_PUBLIC (foil_impl_key_x25519_public_get_type())
+#define FOIL_KEY_X25519_PRIVATE (foil_impl_key_x25519_private_get_type())
 
 G_END_DECLS
 
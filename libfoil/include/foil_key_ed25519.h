@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_KEY_ED25519_H
+#define FOIL_KEY_ED25519_H
+
+#include "foil_key.h"
+#include "foil_private_key.h"
+
+/* Ed25519 specific stuff */
+
+/* Since 1.0.31 */
+
+G_BEGIN_DECLS
+
+#define FOIL_ED25519_KEY_BITS       (256)
+#define FOIL_ED25519_KEY_SIZE       (32) /* Public key or private seed */
+#define FOIL_ED25519_SIGNATURE_SIZE (64)
+
+/*
+ * Ed25519 signatures aren't produced by encrypting the digest, so they
+ * don't fit foil_sign() and foil_verify(). The data is signed as is
+ * (it's hashed internally with SHA-512). Large amounts of data should
+ * be hashed first, and the digest signed.
+ */
+
+GBytes*
+foil_ed25519_sign(
+    const void* data,
+    gsize len,
+    FoilPrivateKey* priv); /* Since 1.0.31 */
+
+gboolean
+foil_ed25519_verify(
+    const void* data,
+    gsize len,
+    const FoilBytes* signature,
+    FoilKey* pub); /* Since 1.0.31 */
+
+G_END_DECLS
+
+#endif /* FOIL_KEY_ED25519_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_KEY_X25519_H
+#define FOIL_KEY_X25519_H
+
+#include "foil_key.h"
+#include "foil_private_key.h"
+
+/* X25519 specific stuff */
+
+/* Since 1.0.31 */
+
+G_BEGIN_DECLS
+
+#define FOIL_X25519_KEY_BITS        (256)
+#define FOIL_X25519_KEY_SIZE        (32) /* Public or private key */
+
+/*
+ * X25519 keys can't encrypt or sign anything, all they can do is
+ * Diffie-Hellman key agreement (RFC 7748). foil_x25519_derive returns
+ * the 32-byte shared secret, which should be run through a KDF before
+ * being used as a key. It fails if the peer's key is one of the low
+ * order points (i.e. the shared secret comes out all zeros).
+ *
+ * foil_x25519_public_bytes returns the raw 32-byte public key for
+ * either public or private X25519 key.
+ */
+
+GBytes*
+foil_x25519_derive(
+    FoilPrivateKey* priv,
+    FoilKey* peer); /* Since 1.0.31 */
+
+GBytes*
+foil_x25519_public_bytes(
+    FoilKey* key); /* Since 1.0.31 */
+
+G_END_DECLS
+
+#endif /* FOIL_KEY_X25519_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_KEYGEN_H
+#define FOIL_KEYGEN_H
+
+#include "foil_types.h"
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Generating an RSA key takes anywhere from a fraction of a second to
+ * several seconds, depending on the size and luck. These functions get
+ * it off the caller's thread. They work with any key type supported
+ * by foil_key_generate_new.
+ *
+ * Since 1.0.31
+ */
+
+/* The key is NULL if generation failed. Take a reference to keep it. */
+typedef
+void
+(*FoilKeyGenerateFunc)(
+    FoilKey* key,
+    void* arg);
+
+/*
+ * Generates the key on a worker thread and invokes the callback on
+ * the thread-default main context of the calling thread. Returns the
+ * source id, the operation can be cancelled with g_source_remove
+ * (the key still gets generated but the callback is not invoked).
+ */
+guint
+foil_key_generate_async(
+    GType type,
+    guint bits,
+    FoilKeyGenerateFunc fn,
+    void* arg);
+
+/*
+ * Generates count keys in parallel, using up to max_threads threads
+ * (zero means one per CPU). Returns NULL if any of them fails, the
+ * returned array owns the keys.
+ */
+GPtrArray*
+foil_key_generate_many(
+    GType type,
+    guint bits,
+    guint count,
+    guint max_threads);
+
+/*
+ * FoilKeyPool keeps up to size keys generated in advance by threads
+ * background threads (zero means one), so that foil_key_pool_take
+ * normally just removes the first one from the queue. If the pool
+ * is empty, the key is generated synchronously. The pool threads
+ * run at the lowest priority the system allows. All functions are
+ * thread-safe.
+ */
+FoilKeyPool*
+foil_key_pool_new(
+    GType type,
+    guint bits,
+    guint size,
+    guint threads);
+
+void
+foil_key_pool_free(
+    FoilKeyPool* pool);
+
+/* Number of keys ready to be taken */
+guint
+foil_key_pool_count(
+    FoilKeyPool* pool);
+
+/* Caller must release the returned reference with foil_key_unref */
+FoilKey*
+foil_key_pool_take(
+    FoilKeyPool* pool);
+
+G_END_DECLS
+
+#endif /* FOIL_KEYGEN_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#ifndef FOIL_KEYRING_H
+#define FOIL_KEYRING_H
+
+#include "foil_types.h"
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Collection of private keys indexed by their fingerprints. Lookups
+ * take constant time regardless of the number of keys. All functions
+ * are thread-safe, foil_keyring_find returns a new reference to make
+ * sure that the key doesn't go away if it gets removed from the keyring
+ * by another thread.
+ *
+ * Since 1.0.31
+ */
+
+FoilKeyring*
+foil_keyring_new(
+    void);
+
+FoilKeyring*
+foil_keyring_ref(
+    FoilKeyring* keyring);
+
+void
+foil_keyring_unref(
+    FoilKeyring* keyring);
+
+guint
+foil_keyring_count(
+    FoilKeyring* keyring);
+
+/* Returns FALSE if a key with the same fingerprint is already there */
+gboolean
+foil_keyring_add(
+    FoilKeyring* keyring,
+    FoilPrivateKey* key);
+
+gboolean
+foil_keyring_remove(
+    FoilKeyring* keyring,
+    const FoilBytes* fingerprint);
+
+/* Caller must release the returned reference with foil_private_key_unref */
+FoilPrivateKey*
+foil_keyring_find(
+    FoilKeyring* keyring,
+    const FoilBytes* fingerprint);
+
+G_END_DECLS
+
+#endif /* FOIL_KEYRING_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
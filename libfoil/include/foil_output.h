@@ -55,6 +55,17 @@ foil_output_write(
     const void* buf,
     gsize size);
 
+gssize
+foil_output_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n); /* Since 1.0.31 */
+
+gboolean
+foil_output_reserve(
+    FoilOutput* out,
+    gsize size); /* Since 1.0.31 */
+
 gssize
 foil_output_write_bytes(
     FoilOutput* out,
@@ -99,6 +110,18 @@ FoilOutput*
 foil_output_mem_new(
     GByteArray* buf);
 
+/*
+ * Writes into the memory allocated from the arena. The result is always
+ * up to date and remains valid until the arena is reset or freed, which
+ * must not happen before the output is released. Growing the buffer
+ * doesn't copy the data as long as nothing else gets allocated from the
+ * same arena in the meantime.
+ */
+FoilOutput*
+foil_output_arena_new(
+    FoilArena* arena,
+    FoilBytes* result); /* Since 1.0.31 */
+
 FoilOutput*
 foil_output_cipher_new(
     FoilOutput* out,
@@ -128,6 +151,21 @@ foil_output_digest_new(
     FoilOutput* out,
     FoilDigest* digest);
 
+/* The output is optional, without one the data just get digested */
+FoilOutput*
+foil_output_multi_digest_new(
+    FoilOutput* out,
+    FoilDigestMulti* digests); /* Since 1.0.31 */
+
+/*
+ * Passes the data through to the underlying output and feeds it to the
+ * signer. Call foil_signer_finish() after the last byte has been written.
+ */
+FoilOutput*
+foil_output_sign_new(
+    FoilOutput* out,
+    FoilSigner* signer); /* Since 1.0.31 */
+
 FoilOutput*
 foil_output_base64_new(
     FoilOutput* out);
@@ -141,20 +179,80 @@ foil_output_base64_new_full(
 #define FOIL_OUTPUT_BASE64_CLOSE    (0x01)  /* Close the target stream */
 #define FOIL_OUTPUT_BASE64_FILESAFE (0x02)  /* Use filename safe encoding */
 
+/*
+ * Writes the data to the target stream on a separate thread, with up
+ * to depth chunks queued. The target stream must not be used by anyone
+ * else after that. Zero chunk size and depth mean the defaults (64K and
+ * 4). If the thread can't be started, returns a new reference to the
+ * target. Write errors are reported by the next write, flush or reserve
+ * call, after which the stream remains unusable until it's reset.
+ */
+FoilOutput*
+foil_output_writebehind_new(
+    FoilOutput* out,
+    gsize chunk,
+    guint depth); /* Since 1.0.31 */
+
 FoilOutput*
 foil_output_file_new(
     FILE* file,
     guint flags); /* Since 1.0.1 */
 
 #define FOIL_OUTPUT_FILE_CLOSE      (0x01)  /* Close the file when done */
+#define FOIL_OUTPUT_FILE_DIRECT     (0x02)  /* O_DIRECT (Since 1.0.31) */
+#define FOIL_OUTPUT_FILE_WRITEBEHIND (0x04) /* Since 1.0.31 */
+
+/*
+ * File descriptor based output does its own buffering. The buffer size
+ * of zero means the default (64K). With FOIL_OUTPUT_FILE_DIRECT the file
+ * is written with O_DIRECT (where supported) bypassing the page cache.
+ * FOIL_OUTPUT_FILE_WRITEBEHIND periodically pushes the written data to
+ * the disk and drops it from the page cache so that dirty pages don't
+ * pile up. Both are ignored by foil_output_file_new().
+ */
+FoilOutput*
+foil_output_file_new_fd(
+    int fd,
+    guint flags,
+    gsize bufsize); /* Since 1.0.31 */
 
 FoilOutput*
 foil_output_file_new_open(
     const char* path);
 
+FoilOutput*
+foil_output_file_new_open_full(
+    const char* path,
+    guint flags,
+    gsize bufsize); /* Since 1.0.31 */
+
 FoilOutput*
 foil_output_file_new_tmp(void);
 
+FoilOutput*
+foil_output_file_new_tmp_full(
+    guint flags,
+    gsize bufsize,
+    gsize size); /* Since 1.0.31 */
+
+/*
+ * io_uring based output (Linux only) keeps up to depth writes of bufsize
+ * bytes in flight. Zeros mean the defaults. The descriptor must be
+ * seekable and not opened with O_APPEND. If io_uring is unavailable,
+ * these fall back to the plain file descriptor based output. Only
+ * FOIL_OUTPUT_FILE_CLOSE flag is honored by the io_uring implementation.
+ */
+FoilOutput*
+foil_output_uring_new(
+    int fd,
+    guint flags,
+    gsize bufsize,
+    guint depth); /* Since 1.0.31 */
+
+FoilOutput*
+foil_output_uring_new_open(
+    const char* path); /* Since 1.0.31 */
+
 G_END_DECLS
 
 #endif /* FOIL_OUTPUT_H */
@@ -56,9 +56,20 @@ GBytes*
 foil_random_bytes(
     guint len); /* Since 1.0.13 */
 
+/*
+ * Selects the generator used by foil_random() and foil_random_bytes(),
+ * zero restores FOIL_RANDOM_DEFAULT. Meant to be called at startup,
+ * before anything needs random numbers.
+ */
+gboolean
+foil_random_set_default(
+    GType type); /* Since 1.0.31 */
+
 /* Implementation */
 GType foil_impl_random_get_type(void);
+GType foil_impl_random_buffered_get_type(void); /* Since 1.0.31 */
 #define FOIL_RANDOM_DEFAULT (foil_impl_random_get_type())
+#define FOIL_RANDOM_BUFFERED (foil_impl_random_buffered_get_type())
 
 G_END_DECLS
 
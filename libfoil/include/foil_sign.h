@@ -51,6 +51,70 @@ foil_verify(
     GType cipher_type,
     FoilKey* pub);
 
+/*
+ * Incremental signing and verification. The data is fed through the
+ * digest as it arrives, so it doesn't have to be in memory all at once.
+ * The result is the same as what foil_sign() and foil_verify() produce
+ * for the concatenation of all the updates. Once finished, the object
+ * can't be updated any more.
+ *
+ * Since 1.0.31
+ */
+
+FoilSigner*
+foil_signer_new(
+    GType digest_type,
+    GType cipher_type,
+    FoilPrivateKey* priv); /* Since 1.0.31 */
+
+FoilSigner*
+foil_signer_ref(
+    FoilSigner* signer); /* Since 1.0.31 */
+
+void
+foil_signer_unref(
+    FoilSigner* signer); /* Since 1.0.31 */
+
+gboolean
+foil_signer_update(
+    FoilSigner* signer,
+    const void* data,
+    gsize size); /* Since 1.0.31 */
+
+GBytes*
+foil_signer_finish(
+    FoilSigner* signer); /* Since 1.0.31 */
+
+FoilVerifier*
+foil_verifier_new(
+    GType digest_type,
+    GType cipher_type,
+    FoilKey* pub); /* Since 1.0.31 */
+
+FoilVerifier*
+foil_verifier_ref(
+    FoilVerifier* verifier); /* Since 1.0.31 */
+
+void
+foil_verifier_unref(
+    FoilVerifier* verifier); /* Since 1.0.31 */
+
+gboolean
+foil_verifier_update(
+    FoilVerifier* verifier,
+    const void* data,
+    gsize size); /* Since 1.0.31 */
+
+gboolean
+foil_verifier_finish(
+    FoilVerifier* verifier,
+    const FoilBytes* signature); /* Since 1.0.31 */
+
+#define foil_rsa_signer_new(digest_type,priv) \
+    foil_signer_new(digest_type,FOIL_CIPHER_RSA_ENCRYPT,priv)
+#define foil_rsa_verifier_new(digest_type,pub) \
+    foil_verifier_new(digest_type,FOIL_CIPHER_RSA_DECRYPT,pub)
+
 #define foil_rsa_sign(bytes,digest_type,priv) \
     foil_sign(bytes,digest_type,FOIL_CIPHER_RSA_ENCRYPT,priv)
 #define foil_rsa_verify(bytes,signature,digest_type,pub) \
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_STATS_H
+#define FOIL_STATS_H
+
+#include "foil_types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Opt-in performance counters and trace hooks.
+ *
+ * Nothing is collected by default. While neither statistics nor
+ * tracing is enabled, the cost of each instrumentation point is one
+ * (well predicted) branch. Once enabled, each thread updates its own
+ * counters without locking, foil_stats_snapshot() adds them up.
+ *
+ * Counters are per (kind, algorithm, operation). Operations nest, e.g.
+ * PBKDF2 time includes the time spent in HMAC which includes the time
+ * spent in the digest, so the totals of different kinds don't add up.
+ *
+ * Since 1.0.31
+ */
+
+typedef enum foil_stats_kind {
+    FOIL_STATS_CIPHER,
+    FOIL_STATS_DIGEST,
+    FOIL_STATS_HMAC,
+    FOIL_STATS_KDF,
+    FOIL_STATS_MSG
+} FoilStatsKind;
+
+typedef struct foil_stats_entry {
+    FoilStatsKind kind;
+    const char* name;   /* Algorithm, e.g. "AES-CBC" or "SHA256" */
+    const char* op;     /* Operation, e.g. "new", "step" or "update" */
+    guint64 ops;        /* Number of operations (or objects created) */
+    guint64 bytes;      /* Input bytes processed */
+    guint64 nsec;       /* Cumulative time, zero for untimed operations */
+} FoilStatsEntry;
+
+typedef struct foil_stats {
+    const FoilStatsEntry* entries;
+    guint count;
+} FoilStats;
+
+/* Completed operation, passed to the trace function */
+typedef struct foil_stats_span {
+    FoilStatsKind kind;
+    const char* name;
+    const char* op;
+    guint64 bytes;
+    gint64 start;       /* CLOCK_MONOTONIC nanoseconds */
+    gint64 nsec;        /* Duration */
+} FoilStatsSpan;
+
+typedef
+void
+(*FoilStatsTraceFunc)(
+    const FoilStatsSpan* span,
+    void* user_data);
+
+void
+foil_stats_enable(
+    gboolean enable); /* Since 1.0.31 */
+
+gboolean
+foil_stats_enabled(
+    void); /* Since 1.0.31 */
+
+/*
+ * Counters of the running threads are read without stopping them,
+ * the snapshot is consistent only when nothing else is going on.
+ * The result must be deallocated with foil_stats_free().
+ */
+FoilStats*
+foil_stats_snapshot(
+    void); /* Since 1.0.31 */
+
+void
+foil_stats_free(
+    FoilStats* stats); /* Since 1.0.31 */
+
+void
+foil_stats_reset(
+    void); /* Since 1.0.31 */
+
+/*
+ * The trace function is invoked on the thread which has performed the
+ * operation. It may be called for a while after it's been replaced or
+ * removed (by other threads, that is), so user_data must stay valid.
+ */
+void
+foil_stats_set_trace_func(
+    FoilStatsTraceFunc fn,
+    void* user_data); /* Since 1.0.31 */
+
+/*
+ * Instrumentation points, used by libfoil itself and by libraries
+ * built on top of it. The id together with the kind and the operation
+ * identifies the counter, the name must stay valid for the lifetime
+ * of the process (normally it's a static string). The operation name
+ * must be a static string too.
+ *
+ *   if (foil_stats_active()) {
+ *       const gint64 start = foil_stats_begin();
+ *
+ *       do_it();
+ *       foil_stats_end(kind, id, name, op, bytes, start);
+ *   } else {
+ *       do_it();
+ *   }
+ */
+
+/* TRUE if either statistics or tracing is enabled */
+gboolean
+foil_stats_active(
+    void); /* Since 1.0.31 */
+
+gint64
+foil_stats_begin(
+    void); /* Since 1.0.31 */
+
+void
+foil_stats_end(
+    FoilStatsKind kind,
+    gconstpointer id,
+    const char* name,
+    const char* op,
+    guint64 bytes,
+    gint64 start); /* Since 1.0.31 */
+
+/* Untimed event, e.g. object creation */
+void
+foil_stats_count(
+    FoilStatsKind kind,
+    gconstpointer id,
+    const char* name,
+    const char* op); /* Since 1.0.31 */
+
+G_END_DECLS
+
+#endif /* FOIL_STATS_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
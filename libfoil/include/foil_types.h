@@ -41,16 +41,22 @@
 
 G_BEGIN_DECLS
 
+typedef struct foil_arena FoilArena; /* Since 1.0.31 */
 typedef struct foil_digest FoilDigest;
+typedef struct foil_digest_multi FoilDigestMulti; /* Since 1.0.31 */
 typedef struct foil_cipher FoilCipher;
 typedef struct foil_cmac FoilCmac;
 typedef struct foil_hmac FoilHmac;
 typedef struct foil_input FoilInput;
 typedef struct foil_kdf FoilKdf; /* Since 1.0.25 */
 typedef struct foil_key FoilKey;
+typedef struct foil_key_pool FoilKeyPool; /* Since 1.0.31 */
+typedef struct foil_keyring FoilKeyring; /* Since 1.0.31 */
 typedef struct foil_output FoilOutput;
 typedef struct foil_private_key FoilPrivateKey;
 typedef struct foil_random FoilRandom;
+typedef struct foil_signer FoilSigner; /* Since 1.0.31 */
+typedef struct foil_verifier FoilVerifier; /* Since 1.0.31 */
 
 typedef struct foil_bytes {
     const guint8* val;
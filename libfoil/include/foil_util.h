@@ -68,6 +68,23 @@ foil_parse_base64(
     GUtilRange* pos,
     guint flags);
 
+/*
+ * Invokes fn for each index from 0 to count-1 on the thread pool shared
+ * by the whole library, with the calling thread pitching in. Returns
+ * after all calls have completed. The order of calls is undefined.
+ */
+typedef
+void
+(*FoilParallelFunc)(
+    guint index,
+    gpointer user_data); /* Since 1.0.31 */
+
+void
+foil_parallel_run(
+    guint count,
+    FoilParallelFunc fn,
+    gpointer user_data); /* Since 1.0.31 */
+
 G_END_DECLS
 
 #endif /* FOIL_UTIL_H */
@@ -61,8 +61,8 @@ G_BEGIN_DECLS
 
 #define FOIL_VERSION_MAJOR   1
 #define FOIL_VERSION_MINOR   0
-#define FOIL_VERSION_RELEASE 30
-#define FOIL_VERSION_STRING  "1.0.30"
+#define FOIL_VERSION_RELEASE 31
+#define FOIL_VERSION_STRING  "1.0.31"
 
 /* Version as a single word */
 #define FOIL_VERSION_WORD(v1,v2,v3) \
@@ -94,6 +94,7 @@ foil_version(
 #define FOIL_VERSION_1_0_28 FOIL_VERSION_WORD(1,0,28)
 #define FOIL_VERSION_1_0_29 FOIL_VERSION_WORD(1,0,29)
 #define FOIL_VERSION_1_0_30 FOIL_VERSION_WORD(1,0,30)
+#define FOIL_VERSION_1_0_31 FOIL_VERSION_WORD(1,0,31)
 
 G_END_DECLS
 
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_arena.h"
+#include "foil_pool.h"
+
+#include "foil_log_p.h"
+
+/*
+ * Allocations are aligned the same way as malloc aligns them on most
+ * platforms, which is good enough for any type.
+ */
+#define FOIL_ARENA_ALIGN (2 * sizeof(gpointer))
+#define FOIL_ARENA_ALIGN_SIZE(size) \
+    (((size) + FOIL_ARENA_ALIGN - 1) & ~(FOIL_ARENA_ALIGN - 1))
+
+/* Blocks larger than this get a chunk of their own */
+#define FOIL_ARENA_LARGE_BLOCK(arena) ((arena)->chunk_size / 4)
+
+typedef struct foil_arena_chunk FoilArenaChunk;
+
+struct foil_arena_chunk {
+    FoilArenaChunk* next;
+};
+
+#define FOIL_ARENA_CHUNK_HEADER FOIL_ARENA_ALIGN_SIZE(sizeof(FoilArenaChunk))
+#define FOIL_ARENA_HEADER FOIL_ARENA_ALIGN_SIZE(sizeof(FoilArena))
+
+struct foil_arena {
+    guint8* ptr;                /* Next free byte in the current chunk */
+    guint8* end;                /* End of the current chunk */
+    guint8* last;               /* The most recent allocation */
+    gsize chunk_size;
+    FoilArenaChunk* chunks;     /* Additional chunks */
+    FoilPool pool;              /* Destroy callbacks */
+};
+
+static
+void
+foil_arena_rewind(
+    FoilArena* self)
+{
+    /* The first chunk immediately follows the arena structure */
+    self->ptr = ((guint8*)self) + FOIL_ARENA_HEADER;
+    self->end = self->ptr + self->chunk_size;
+    self->last = NULL;
+}
+
+static
+void
+foil_arena_free_chunks(
+    FoilArena* self)
+{
+    FoilArenaChunk* chunk = self->chunks;
+
+    self->chunks = NULL;
+    while (chunk) {
+        FoilArenaChunk* next = chunk->next;
+
+        g_free(chunk);
+        chunk = next;
+    }
+}
+
+static
+gpointer
+foil_arena_new_chunk(
+    FoilArena* self,
+    gsize size)
+{
+    FoilArenaChunk* chunk = g_malloc(FOIL_ARENA_CHUNK_HEADER + size);
+
+    chunk->next = self->chunks;
+    self->chunks = chunk;
+    return ((guint8*)chunk) + FOIL_ARENA_CHUNK_HEADER;
+}
+
+static
+gpointer
+foil_arena_alloc_slow(
+    FoilArena* self,
+    gsize size)
+{
+    if (size > FOIL_ARENA_LARGE_BLOCK(self)) {
+        /*
+         * Large blocks don't replace the current chunk, there may be
+         * quite a bit of space left in it.
+         */
+        return foil_arena_new_chunk(self, size);
+    } else {
+        guint8* ptr = foil_arena_new_chunk(self, self->chunk_size);
+
+        self->end = ptr + self->chunk_size;
+        self->ptr = ptr + size;
+        self->last = ptr;
+        return ptr;
+    }
+}
+
+FoilArena*
+foil_arena_new(
+    gsize chunk_size) /* Since 1.0.31 */
+{
+    FoilArena* self;
+
+    chunk_size = FOIL_ARENA_ALIGN_SIZE(chunk_size ? chunk_size :
+        FOIL_ARENA_CHUNK_SIZE_DEFAULT);
+    self = g_malloc(FOIL_ARENA_HEADER + chunk_size);
+    self->chunk_size = chunk_size;
+    self->chunks = NULL;
+    foil_pool_init(&self->pool);
+    foil_arena_rewind(self);
+    return self;
+}
+
+void
+foil_arena_free(
+    FoilArena* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        foil_pool_drain(&self->pool);
+        foil_arena_free_chunks(self);
+        g_free(self);
+    }
+}
+
+void
+foil_arena_reset(
+    FoilArena* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        foil_pool_drain(&self->pool);
+        foil_arena_free_chunks(self);
+        foil_arena_rewind(self);
+    }
+}
+
+gpointer
+foil_arena_alloc(
+    FoilArena* self,
+    gsize size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        const gsize aligned = FOIL_ARENA_ALIGN_SIZE(size);
+
+        GASSERT(aligned >= size);
+        if (aligned <= (gsize)(self->end - self->ptr)) {
+            /* Fast path */
+            self->last = self->ptr;
+            self->ptr += aligned;
+            return self->last;
+        } else {
+            return foil_arena_alloc_slow(self, aligned);
+        }
+    }
+    return NULL;
+}
+
+gpointer
+foil_arena_alloc0(
+    FoilArena* self,
+    gsize size) /* Since 1.0.31 */
+{
+    gpointer ptr = foil_arena_alloc(self, size);
+
+    if (G_LIKELY(ptr) && size) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+gpointer
+foil_arena_realloc(
+    FoilArena* self,
+    gpointer ptr,
+    gsize old_size,
+    gsize new_size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        if (!ptr) {
+            return foil_arena_alloc(self, new_size);
+        } else if (ptr == self->last) {
+            const gsize aligned = FOIL_ARENA_ALIGN_SIZE(new_size);
+
+            if (aligned <= (gsize)(self->end - self->last)) {
+                /* Resize the most recent allocation in place */
+                self->ptr = self->last + aligned;
+                return ptr;
+            }
+        }
+        if (new_size <= old_size) {
+            return ptr;
+        } else {
+            gpointer copy = foil_arena_alloc(self, new_size);
+
+            memcpy(copy, ptr, old_size);
+            return copy;
+        }
+    }
+    return NULL;
+}
+
+gpointer
+foil_arena_memdup(
+    FoilArena* self,
+    gconstpointer data,
+    gsize size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(data)) {
+        gpointer copy = foil_arena_alloc(self, size);
+
+        memcpy(copy, data, size);
+        return copy;
+    }
+    return NULL;
+}
+
+char*
+foil_arena_strdup(
+    FoilArena* self,
+    const char* str) /* Since 1.0.31 */
+{
+    return G_LIKELY(str) ? foil_arena_strndup(self, str, strlen(str)) : NULL;
+}
+
+char*
+foil_arena_strndup(
+    FoilArena* self,
+    const char* str,
+    gsize len) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(str)) {
+        char* copy = foil_arena_alloc(self, len + 1);
+
+        memcpy(copy, str, len);
+        copy[len] = 0;
+        return copy;
+    }
+    return NULL;
+}
+
+const FoilBytes*
+foil_arena_copy_bytes(
+    FoilArena* self,
+    FoilBytes* dest,
+    const FoilBytes* src) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(dest) && G_LIKELY(src)) {
+        dest->val = src->len ? foil_arena_memdup(self, src->val, src->len) :
+            NULL;
+        dest->len = src->len;
+        return dest;
+    }
+    return NULL;
+}
+
+void
+foil_arena_add(
+    FoilArena* self,
+    gpointer pointer,
+    GDestroyNotify destroy) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(destroy)) {
+        foil_pool_add(&self->pool, pointer, destroy);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -530,16 +530,17 @@ foil_asn1_block_length(
     return total_length;
 }
 
+/* Identifier octet, length octet and up to sizeof(gsize) length octets */
+#define ASN1_BLOCK_HEADER_MAX_SIZE (2 + sizeof(gsize))
+
 static
-gsize
-foil_asn1_encode_block_header(
-    FoilOutput* out,
+guint
+foil_asn1_format_block_header(
+    guint8* header,
     guint8 id,
     gsize data_length)
 {
-    const gsize prev_written = foil_output_bytes_written(out);
     guint i, len_octets = 0;
-    guint8 octet;
 
     /* Check if we need to use the long form */
     if (data_length >= 0x7f) {
@@ -551,32 +552,34 @@ foil_asn1_encode_block_header(
     }
 
     /* Identifier octet */
-    if (foil_output_write(out, &id, 1) < 1) {
-        return 0;
-    }
+    header[0] = id;
 
     /* Length octet(s) */
     if (len_octets) {
         /* Long form */
-        octet = 0x80 | len_octets;
-        if (foil_output_write(out, &octet, 1) < 1) {
-            return 0;
-        }
+        header[1] = 0x80 | len_octets;
         for (i=0; i<len_octets; i++) {
-            octet = (guint8)(data_length >> 8*(len_octets - i - 1));
-            if (foil_output_write(out, &octet, 1) < 1) {
-                return 0;
-            }
+            header[i+2] = (guint8)(data_length >> 8*(len_octets - i - 1));
         }
+        return len_octets + 2;
     } else {
         /* Short form */
-        octet = (guint8)data_length;
-        if (foil_output_write(out, &octet, 1) < 1) {
-            return 0;
-        }
+        header[1] = (guint8)data_length;
+        return 2;
     }
+}
 
-    return foil_output_bytes_written(out) - prev_written;
+static
+gsize
+foil_asn1_encode_block_header(
+    FoilOutput* out,
+    guint8 id,
+    gsize data_length)
+{
+    guint8 header[ASN1_BLOCK_HEADER_MAX_SIZE];
+    const guint len = foil_asn1_format_block_header(header, id, data_length);
+
+    return foil_output_write_all(out, header, len) ? len : 0;
 }
 
 gsize
@@ -604,29 +607,29 @@ foil_asn1_encode_block(
     const FoilBytes* bytes[],
     guint count)
 {
-    const gsize prev_written = foil_output_bytes_written(out);
-    guint i;
+    guint8 header[ASN1_BLOCK_HEADER_MAX_SIZE];
+    FoilBytes stack_parts[8];
+    FoilBytes* parts = (count < G_N_ELEMENTS(stack_parts)) ? stack_parts :
+        g_new(FoilBytes, count + 1);
     gsize total = 0;
+    gssize written;
+    guint i;
 
     /* Sum the lengths */
     for (i=0; i<count; i++) {
+        parts[i+1] = *bytes[i];
         total += bytes[i]->len;
     }
 
-    /* Identifier octet */
-    if (!foil_asn1_encode_block_header(out, id, total)) {
-        return 0;
-    }
-
-    /* Contents octets */
-    for (i=0; i<count; i++) {
-        const gssize len = bytes[i]->len;
-        if (foil_output_write(out, bytes[i]->val, len) < len) {
-            return 0;
-        }
+    /* Identifier and length octets followed by the contents octets */
+    parts[0].val = header;
+    parts[0].len = foil_asn1_format_block_header(header, id, total);
+    total += parts[0].len;
+    written = foil_output_writev(out, parts, count + 1);
+    if (parts != stack_parts) {
+        g_free(parts);
     }
-
-    return foil_output_bytes_written(out) - prev_written;
+    return (written == (gssize)total) ? total : 0;
 }
 
 static
@@ -754,14 +757,15 @@ foil_asn1_encode_integer_bytes(
     return foil_asn1_encode_block1(out, ASN1_TAG_INTEGER, bytes);
 }
 
-gsize
-foil_asn1_encode_integer(
-    FoilOutput* out,
+/* Returns the number of contents octets (1..4) stored in data */
+static
+guint
+foil_asn1_format_integer(
+    guint8* data,
     gint32 value)
 {
-    FoilBytes bytes;
-    guint8 data[4];
-    int len = 0;
+    guint n = 0;
+    int len;
     if (value < 0) {
         len = ((value & 0xffffff80) == 0xffffff80) ? 1 :
               ((value & 0xffff8000) == 0xffff8000) ? 2 :
@@ -771,14 +775,33 @@ foil_asn1_encode_integer(
               !(value & 0xffff8000) ? 2 :
               !(value & 0xff800000) ? 3 : 4;
     }
-    bytes.val = data;
-    bytes.len = 0;
     switch (len) {
-    case 4: data[bytes.len++] = (guint8)(value >> 24); /* fallthrough */
-    case 3: data[bytes.len++] = (guint8)(value >> 16); /* fallthrough */
-    case 2: data[bytes.len++] = (guint8)(value >> 8);  /* fallthrough */
-    case 1: data[bytes.len++] = (guint8)(value);
+    case 4: data[n++] = (guint8)(value >> 24); /* fallthrough */
+    case 3: data[n++] = (guint8)(value >> 16); /* fallthrough */
+    case 2: data[n++] = (guint8)(value >> 8);  /* fallthrough */
+    case 1: data[n++] = (guint8)(value);
     }
+    return n;
+}
+
+gsize
+foil_asn1_integer_length(
+    gint32 value) /* Since 1.0.31 */
+{
+    guint8 data[4];
+    /* Identifier octet, length octet and up to 4 contents octets */
+    return 2 + foil_asn1_format_integer(data, value);
+}
+
+gsize
+foil_asn1_encode_integer(
+    FoilOutput* out,
+    gint32 value)
+{
+    FoilBytes bytes;
+    guint8 data[4];
+    bytes.val = data;
+    bytes.len = foil_asn1_format_integer(data, value);
     return foil_asn1_encode_integer_bytes(out, &bytes);
 }
 
@@ -786,9 +809,11 @@ GBytes*
 foil_asn1_encode_integer_value(
     gint32 value)
 {
-    FoilOutput* out = foil_output_mem_new(NULL);
-    foil_asn1_encode_integer(out, value);
-    return foil_output_free_to_bytes(out);
+    guint8 data[6];
+    const guint len = foil_asn1_format_integer(data + 2, value);
+    data[0] = ASN1_TAG_INTEGER;
+    data[1] = (guint8)len;
+    return g_bytes_new(data, len + 2);
 }
 
 gsize
@@ -855,6 +880,49 @@ foil_asn1_parse_tag(
     return FALSE;
 }
 
+gboolean
+foil_asn1_peek_tag(
+    const GUtilRange* pos,
+    guint8* id,
+    guint32* num) /* Since 1.0.31 */
+{
+    GUtilRange tmp = *pos;
+    return foil_asn1_parse_tag(&tmp, id, num);
+}
+
+gboolean
+foil_asn1_parse_sequence(
+    GUtilRange* pos,
+    GUtilRange* seq) /* Since 1.0.31 */
+{
+    GUtilRange tmp = *pos;
+    guint32 len;
+    if (foil_asn1_parse_start_sequence(&tmp, &len)) {
+        /* foil_asn1_parse_start_sequence has checked the length */
+        tmp.end = tmp.ptr + len;
+        pos->ptr = tmp.end;
+        if (seq) {
+            *seq = tmp;
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+foil_asn1_parse_skip(
+    GUtilRange* pos) /* Since 1.0.31 */
+{
+    guint32 total;
+    if (foil_asn1_is_block_header(pos, &total) &&
+        /* Overflow can occur on 32-bit systems */
+        pos->ptr + total > pos->ptr && pos->ptr + total <= pos->end) {
+        pos->ptr += total;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /*
  * Local Variables:
  * mode: C
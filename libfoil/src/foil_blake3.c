@@ -0,0 +1,723 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_blake3.h"
+#include "foil_thread_pool_p.h"
+
+/*
+ * https://github.com/BLAKE3-team/BLAKE3-specs
+ *
+ * The input is split into 1 KiB chunks which are hashed independently
+ * and then combined into a binary tree. That allows to hash several
+ * chunks at once (one per vector lane) and to hash large subtrees on
+ * separate threads. The incremental part follows the reference
+ * implementation.
+ */
+
+#define FOIL_BLAKE3_CHUNK_START (0x01)
+#define FOIL_BLAKE3_CHUNK_END   (0x02)
+#define FOIL_BLAKE3_PARENT      (0x04)
+#define FOIL_BLAKE3_ROOT        (0x08)
+
+#define FOIL_BLAKE3_BLOCKS_PER_CHUNK \
+    (FOIL_BLAKE3_CHUNK_LEN / FOIL_BLAKE3_BLOCK_LEN)
+
+/* Leaf subtrees are hashed in batches of this many chunks */
+#define FOIL_BLAKE3_BATCH (16)
+
+/*
+ * Subtrees are split between the threads in parts no smaller than
+ * this many chunks, otherwise it's not worth the overhead.
+ */
+#define FOIL_BLAKE3_PARALLEL_PART (256)
+
+static const guint32 foil_blake3_iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+    0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19
+};
+
+static const guint8 foil_blake3_schedule[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 }
+};
+
+typedef guint32 FoilBlake3CV[8];
+
+typedef struct foil_blake3_job {
+    const guint8* in;
+    guint64 nchunks;
+    guint64 counter;
+    guint32* cv;
+} FoilBlake3Job;
+
+static inline
+guint32
+foil_blake3_load32(
+    const guint8* p)
+{
+    return ((guint32)p[0]) | (((guint32)p[1]) << 8) |
+        (((guint32)p[2]) << 16) | (((guint32)p[3]) << 24);
+}
+
+static inline
+void
+foil_blake3_store32(
+    guint8* p,
+    guint32 w)
+{
+    p[0] = (guint8)w;
+    p[1] = (guint8)(w >> 8);
+    p[2] = (guint8)(w >> 16);
+    p[3] = (guint8)(w >> 24);
+}
+
+static inline
+void
+foil_blake3_load_block(
+    guint32* m,
+    const guint8* block)
+{
+    guint i;
+
+    for (i = 0; i < 16; i++) {
+        m[i] = foil_blake3_load32(block + 4 * i);
+    }
+}
+
+/*==========================================================================*
+ * Compression function
+ *==========================================================================*/
+
+#define FOIL_BLAKE3_ROTR(x,n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define FOIL_BLAKE3_G(v,a,b,c,d,x,y) \
+    v[a] = v[a] + v[b] + (x); \
+    v[d] = FOIL_BLAKE3_ROTR(v[d] ^ v[a], 16); \
+    v[c] = v[c] + v[d]; \
+    v[b] = FOIL_BLAKE3_ROTR(v[b] ^ v[c], 12); \
+    v[a] = v[a] + v[b] + (y); \
+    v[d] = FOIL_BLAKE3_ROTR(v[d] ^ v[a], 8); \
+    v[c] = v[c] + v[d]; \
+    v[b] = FOIL_BLAKE3_ROTR(v[b] ^ v[c], 7)
+
+/* Works for both scalars and vectors */
+#define FOIL_BLAKE3_ROUNDS(v,m) do { \
+    guint r; \
+    for (r = 0; r < 7; r++) { \
+        const guint8* s = foil_blake3_schedule[r]; \
+        FOIL_BLAKE3_G(v, 0, 4,  8, 12, m[s[0]],  m[s[1]]); \
+        FOIL_BLAKE3_G(v, 1, 5,  9, 13, m[s[2]],  m[s[3]]); \
+        FOIL_BLAKE3_G(v, 2, 6, 10, 14, m[s[4]],  m[s[5]]); \
+        FOIL_BLAKE3_G(v, 3, 7, 11, 15, m[s[6]],  m[s[7]]); \
+        FOIL_BLAKE3_G(v, 0, 5, 10, 15, m[s[8]],  m[s[9]]); \
+        FOIL_BLAKE3_G(v, 1, 6, 11, 12, m[s[10]], m[s[11]]); \
+        FOIL_BLAKE3_G(v, 2, 7,  8, 13, m[s[12]], m[s[13]]); \
+        FOIL_BLAKE3_G(v, 3, 4,  9, 14, m[s[14]], m[s[15]]); \
+    } \
+} while (0)
+
+static
+void
+foil_blake3_compress(
+    guint32* cv,
+    const guint32* m,
+    guint64 counter,
+    guint block_len,
+    guint flags)
+{
+    guint32 v[16];
+    guint i;
+
+    memcpy(v, cv, 8 * sizeof(guint32));
+    memcpy(v + 8, foil_blake3_iv, 4 * sizeof(guint32));
+    v[12] = (guint32)counter;
+    v[13] = (guint32)(counter >> 32);
+    v[14] = block_len;
+    v[15] = flags;
+    FOIL_BLAKE3_ROUNDS(v, m);
+    for (i = 0; i < 8; i++) {
+        cv[i] = v[i] ^ v[i + 8];
+    }
+}
+
+static
+void
+foil_blake3_parent_cv(
+    guint32* out,
+    const guint32* left,
+    const guint32* right,
+    guint flags)
+{
+    guint32 m[16];
+
+    memcpy(m, left, 8 * sizeof(guint32));
+    memcpy(m + 8, right, 8 * sizeof(guint32));
+    memcpy(out, foil_blake3_iv, 8 * sizeof(guint32));
+    foil_blake3_compress(out, m, 0, FOIL_BLAKE3_BLOCK_LEN,
+        FOIL_BLAKE3_PARENT | flags);
+}
+
+/*==========================================================================*
+ * Full chunks
+ *==========================================================================*/
+
+static
+void
+foil_blake3_chunk_cv(
+    guint32* cv,
+    const guint8* in,
+    guint64 counter)
+{
+    guint32 m[16];
+    guint i;
+
+    memcpy(cv, foil_blake3_iv, 8 * sizeof(guint32));
+    for (i = 0; i < FOIL_BLAKE3_BLOCKS_PER_CHUNK; i++) {
+        foil_blake3_load_block(m, in + i * FOIL_BLAKE3_BLOCK_LEN);
+        foil_blake3_compress(cv, m, counter, FOIL_BLAKE3_BLOCK_LEN,
+            (i ? 0 : FOIL_BLAKE3_CHUNK_START) |
+            ((i == FOIL_BLAKE3_BLOCKS_PER_CHUNK - 1) ?
+                FOIL_BLAKE3_CHUNK_END : 0));
+    }
+}
+
+#if defined(__GNUC__)
+/*
+ * Several chunks are compressed at once, one per vector lane. The
+ * compiler maps that onto whatever SIMD instructions are available
+ * for the target (SSE2 on x86_64, NEON on aarch64) or falls back to
+ * scalar code.
+ */
+#define FOIL_BLAKE3_LANES (4)
+
+typedef guint32 FoilBlake3Vec __attribute__((vector_size(16)));
+#define FOIL_BLAKE3_SPLAT(x) ((FoilBlake3Vec) { (x), (x), (x), (x) })
+
+static
+void
+foil_blake3_chunk_cv4(
+    FoilBlake3CV* cvs,
+    const guint8* in,
+    guint64 counter)
+{
+    FoilBlake3Vec h[8], m[16], v[16];
+    FoilBlake3Vec counter_lo, counter_hi;
+    guint i, j, k;
+
+    for (k = 0; k < FOIL_BLAKE3_LANES; k++) {
+        counter_lo[k] = (guint32)(counter + k);
+        counter_hi[k] = (guint32)((counter + k) >> 32);
+    }
+    for (i = 0; i < 8; i++) {
+        h[i] = FOIL_BLAKE3_SPLAT(foil_blake3_iv[i]);
+    }
+    for (i = 0; i < FOIL_BLAKE3_BLOCKS_PER_CHUNK; i++) {
+        const guint8* block = in + i * FOIL_BLAKE3_BLOCK_LEN;
+        const guint32 flags = (i ? 0 : FOIL_BLAKE3_CHUNK_START) |
+            ((i == FOIL_BLAKE3_BLOCKS_PER_CHUNK - 1) ?
+                FOIL_BLAKE3_CHUNK_END : 0);
+
+        /* Transpose, each lane gets the block from its own chunk */
+        for (j = 0; j < 16; j++) {
+            for (k = 0; k < FOIL_BLAKE3_LANES; k++) {
+                m[j][k] = foil_blake3_load32(block + 4 * j +
+                    k * FOIL_BLAKE3_CHUNK_LEN);
+            }
+        }
+        for (j = 0; j < 8; j++) {
+            v[j] = h[j];
+        }
+        for (j = 0; j < 4; j++) {
+            v[j + 8] = FOIL_BLAKE3_SPLAT(foil_blake3_iv[j]);
+        }
+        v[12] = counter_lo;
+        v[13] = counter_hi;
+        v[14] = FOIL_BLAKE3_SPLAT(FOIL_BLAKE3_BLOCK_LEN);
+        v[15] = FOIL_BLAKE3_SPLAT(flags);
+        FOIL_BLAKE3_ROUNDS(v, m);
+        for (j = 0; j < 8; j++) {
+            h[j] = v[j] ^ v[j + 8];
+        }
+    }
+
+    /* And transpose back */
+    for (k = 0; k < FOIL_BLAKE3_LANES; k++) {
+        for (j = 0; j < 8; j++) {
+            cvs[k][j] = h[j][k];
+        }
+    }
+}
+
+#endif /* __GNUC__ */
+
+static
+void
+foil_blake3_chunk_cvs(
+    FoilBlake3CV* cvs,
+    const guint8* in,
+    guint n,
+    guint64 counter)
+{
+    guint i = 0;
+
+#ifdef FOIL_BLAKE3_LANES
+    for (; i + FOIL_BLAKE3_LANES <= n; i += FOIL_BLAKE3_LANES) {
+        foil_blake3_chunk_cv4(cvs + i, in + i * FOIL_BLAKE3_CHUNK_LEN,
+            counter + i);
+    }
+#endif
+    for (; i < n; i++) {
+        foil_blake3_chunk_cv(cvs[i], in + i * FOIL_BLAKE3_CHUNK_LEN,
+            counter + i);
+    }
+}
+
+/*==========================================================================*
+ * Subtrees
+ *==========================================================================*/
+
+/* Number of chunks must be a power of 2 */
+static
+void
+foil_blake3_subtree_cv(
+    guint32* cv,
+    const guint8* in,
+    guint64 nchunks,
+    guint64 counter)
+{
+    if (nchunks <= FOIL_BLAKE3_BATCH) {
+        FoilBlake3CV cvs[FOIL_BLAKE3_BATCH];
+        guint n = (guint)nchunks;
+        guint i;
+
+        foil_blake3_chunk_cvs(cvs, in, n, counter);
+        while (n > 1) {
+            n /= 2;
+            for (i = 0; i < n; i++) {
+                foil_blake3_parent_cv(cvs[i], cvs[2 * i], cvs[2 * i + 1], 0);
+            }
+        }
+        memcpy(cv, cvs[0], sizeof(cvs[0]));
+    } else {
+        const guint64 half = nchunks / 2;
+        guint32 left[8], right[8];
+
+        foil_blake3_subtree_cv(left, in, half, counter);
+        foil_blake3_subtree_cv(right, in + half * FOIL_BLAKE3_CHUNK_LEN,
+            half, counter + half);
+        foil_blake3_parent_cv(cv, left, right, 0);
+    }
+}
+
+static
+void
+foil_blake3_job_run(
+    gpointer data)
+{
+    FoilBlake3Job* job = data;
+
+    foil_blake3_subtree_cv(job->cv, job->in, job->nchunks, job->counter);
+}
+
+/*
+ * Splits the subtree into equal parts (a power of 2) and hashes them
+ * in parallel. The parts are merged here, until two remain.
+ */
+static
+void
+foil_blake3_subtree_parallel(
+    guint32* left,
+    guint32* right,
+    const guint8* in,
+    guint64 nchunks,
+    guint64 counter,
+    guint nparts)
+{
+    FoilBlake3CV* cvs = g_new(FoilBlake3CV, nparts);
+    FoilBlake3Job* jobs = g_new(FoilBlake3Job, nparts);
+    FoilThreadBatch* batch = foil_thread_batch_new();
+    const guint64 part = nchunks / nparts;
+    guint i, n;
+
+    for (i = 0; i < nparts; i++) {
+        FoilBlake3Job* job = jobs + i;
+
+        job->in = in + i * part * FOIL_BLAKE3_CHUNK_LEN;
+        job->nchunks = part;
+        job->counter = counter + i * part;
+        job->cv = cvs[i];
+        if (i) {
+            foil_thread_batch_push(batch, foil_blake3_job_run, job);
+        }
+    }
+
+    /* The first part is hashed by this thread */
+    foil_blake3_job_run(jobs);
+    foil_thread_batch_finish(batch);
+
+    for (n = nparts; n > 2; n /= 2) {
+        for (i = 0; i < n / 2; i++) {
+            foil_blake3_parent_cv(cvs[i], cvs[2 * i], cvs[2 * i + 1], 0);
+        }
+    }
+    memcpy(left, cvs[0], sizeof(cvs[0]));
+    memcpy(right, cvs[1], sizeof(cvs[1]));
+    g_free(jobs);
+    g_free(cvs);
+}
+
+/*
+ * Children of the subtree, the subtree itself may turn out to be the
+ * root and therefore can't be finalized here.
+ */
+static
+void
+foil_blake3_subtree_children(
+    guint32* left,
+    guint32* right,
+    const guint8* in,
+    guint64 nchunks,
+    guint64 counter)
+{
+    guint nparts = 1;
+    guint ncpu;
+
+    if (nchunks >= 2 * FOIL_BLAKE3_PARALLEL_PART &&
+        (ncpu = foil_ncpu()) > 1) {
+        while (nparts * 2 <= ncpu &&
+            nchunks / (nparts * 2) >= FOIL_BLAKE3_PARALLEL_PART) {
+            nparts *= 2;
+        }
+    }
+    if (nparts > 1) {
+        foil_blake3_subtree_parallel(left, right, in, nchunks, counter,
+            nparts);
+    } else {
+        const guint64 half = nchunks / 2;
+
+        foil_blake3_subtree_cv(left, in, half, counter);
+        foil_blake3_subtree_cv(right, in + half * FOIL_BLAKE3_CHUNK_LEN,
+            half, counter + half);
+    }
+}
+
+/*==========================================================================*
+ * Incremental hashing
+ *==========================================================================*/
+
+static
+void
+foil_blake3_chunk_init(
+    FoilBlake3Chunk* chunk,
+    guint64 counter)
+{
+    memcpy(chunk->cv, foil_blake3_iv, sizeof(chunk->cv));
+    chunk->counter = counter;
+    chunk->buf_len = 0;
+    chunk->blocks = 0;
+}
+
+static inline
+gsize
+foil_blake3_chunk_len(
+    const FoilBlake3Chunk* chunk)
+{
+    return FOIL_BLAKE3_BLOCK_LEN * chunk->blocks + chunk->buf_len;
+}
+
+static inline
+guint
+foil_blake3_chunk_start_flag(
+    const FoilBlake3Chunk* chunk)
+{
+    return chunk->blocks ? 0 : FOIL_BLAKE3_CHUNK_START;
+}
+
+static
+void
+foil_blake3_chunk_update(
+    FoilBlake3Chunk* chunk,
+    const guint8* in,
+    gsize len)
+{
+    guint32 m[16];
+
+    /* The last block is always left in the buffer */
+    while (len > 0) {
+        gsize take;
+
+        if (chunk->buf_len == FOIL_BLAKE3_BLOCK_LEN) {
+            foil_blake3_load_block(m, chunk->buf);
+            foil_blake3_compress(chunk->cv, m, chunk->counter,
+                FOIL_BLAKE3_BLOCK_LEN, foil_blake3_chunk_start_flag(chunk));
+            chunk->blocks++;
+            chunk->buf_len = 0;
+        }
+        take = MIN(FOIL_BLAKE3_BLOCK_LEN - chunk->buf_len, len);
+        memcpy(chunk->buf + chunk->buf_len, in, take);
+        chunk->buf_len += take;
+        in += take;
+        len -= take;
+    }
+}
+
+/* Output node, which is either compressed or finalized as the root */
+typedef struct foil_blake3_output {
+    guint32 cv[8];
+    guint32 m[16];
+    guint64 counter;
+    guint block_len;
+    guint flags;
+} FoilBlake3Output;
+
+static
+void
+foil_blake3_chunk_output(
+    const FoilBlake3Chunk* chunk,
+    FoilBlake3Output* out)
+{
+    guint8 block[FOIL_BLAKE3_BLOCK_LEN];
+
+    memcpy(block, chunk->buf, chunk->buf_len);
+    memset(block + chunk->buf_len, 0, sizeof(block) - chunk->buf_len);
+    memcpy(out->cv, chunk->cv, sizeof(out->cv));
+    foil_blake3_load_block(out->m, block);
+    out->counter = chunk->counter;
+    out->block_len = chunk->buf_len;
+    out->flags = foil_blake3_chunk_start_flag(chunk) | FOIL_BLAKE3_CHUNK_END;
+}
+
+static
+void
+foil_blake3_parent_output(
+    const guint32* left,
+    const guint32* right,
+    FoilBlake3Output* out)
+{
+    memcpy(out->cv, foil_blake3_iv, sizeof(out->cv));
+    memcpy(out->m, left, 8 * sizeof(guint32));
+    memcpy(out->m + 8, right, 8 * sizeof(guint32));
+    out->counter = 0;
+    out->block_len = FOIL_BLAKE3_BLOCK_LEN;
+    out->flags = FOIL_BLAKE3_PARENT;
+}
+
+static
+void
+foil_blake3_output_cv(
+    const FoilBlake3Output* out,
+    guint32* cv)
+{
+    memcpy(cv, out->cv, sizeof(out->cv));
+    foil_blake3_compress(cv, out->m, out->counter, out->block_len,
+        out->flags);
+}
+
+static
+guint
+foil_blake3_popcount(
+    guint64 x)
+{
+    guint n = 0;
+
+    while (x) {
+        x &= x - 1;
+        n++;
+    }
+    return n;
+}
+
+/*
+ * Merges the completed subtrees on the stack. The number of chunks
+ * hashed so far determines how many of them must remain.
+ */
+static
+void
+foil_blake3_merge_cv_stack(
+    FoilBlake3* self,
+    guint64 total_chunks)
+{
+    const guint post_merge_len = foil_blake3_popcount(total_chunks);
+
+    while (self->cv_stack_len > post_merge_len) {
+        guint32* left = self->cv_stack[self->cv_stack_len - 2];
+
+        foil_blake3_parent_cv(left, left, self->cv_stack[self->cv_stack_len
+            - 1], 0);
+        self->cv_stack_len--;
+    }
+}
+
+static
+void
+foil_blake3_push_cv(
+    FoilBlake3* self,
+    const guint32* cv,
+    guint64 counter)
+{
+    foil_blake3_merge_cv_stack(self, counter);
+    memcpy(self->cv_stack[self->cv_stack_len++], cv, 8 * sizeof(guint32));
+}
+
+void
+foil_blake3_init(
+    FoilBlake3* self)
+{
+    foil_blake3_chunk_init(&self->chunk, 0);
+    self->cv_stack_len = 0;
+}
+
+void
+foil_blake3_update(
+    FoilBlake3* self,
+    const void* data,
+    gsize len)
+{
+    const guint8* in = data;
+    FoilBlake3Chunk* chunk = &self->chunk;
+    guint32 cv[8];
+
+    if (!len) {
+        return;
+    }
+
+    /* Finish the chunk which is already in progress */
+    if (foil_blake3_chunk_len(chunk) > 0) {
+        const gsize take = MIN(FOIL_BLAKE3_CHUNK_LEN -
+            foil_blake3_chunk_len(chunk), len);
+
+        foil_blake3_chunk_update(chunk, in, take);
+        in += take;
+        len -= take;
+        if (len > 0) {
+            FoilBlake3Output out;
+
+            foil_blake3_chunk_output(chunk, &out);
+            foil_blake3_output_cv(&out, cv);
+            foil_blake3_push_cv(self, cv, chunk->counter);
+            foil_blake3_chunk_init(chunk, chunk->counter + 1);
+        } else {
+            return;
+        }
+    }
+
+    /*
+     * Hash the largest subtrees which fit into the input and line up
+     * with what's been hashed so far. At least one byte is left for
+     * the chunk state, the last chunk may turn out to be the root.
+     */
+    while (len > FOIL_BLAKE3_CHUNK_LEN) {
+        const guint64 count_so_far = chunk->counter * FOIL_BLAKE3_CHUNK_LEN;
+        guint64 subtree_len = ((guint64)1) << (g_bit_nth_msf(len, -1));
+        guint64 subtree_chunks;
+
+        while (((subtree_len - 1) & count_so_far) != 0) {
+            subtree_len /= 2;
+        }
+        subtree_chunks = subtree_len / FOIL_BLAKE3_CHUNK_LEN;
+        if (subtree_len <= FOIL_BLAKE3_CHUNK_LEN) {
+            FoilBlake3Chunk tmp;
+            FoilBlake3Output out;
+
+            foil_blake3_chunk_init(&tmp, chunk->counter);
+            foil_blake3_chunk_update(&tmp, in, subtree_len);
+            foil_blake3_chunk_output(&tmp, &out);
+            foil_blake3_output_cv(&out, cv);
+            foil_blake3_push_cv(self, cv, tmp.counter);
+        } else {
+            guint32 right[8];
+
+            foil_blake3_subtree_children(cv, right, in, subtree_chunks,
+                chunk->counter);
+            foil_blake3_push_cv(self, cv, chunk->counter);
+            foil_blake3_push_cv(self, right, chunk->counter +
+                subtree_chunks / 2);
+        }
+        chunk->counter += subtree_chunks;
+        in += subtree_len;
+        len -= subtree_len;
+    }
+
+    if (len > 0) {
+        foil_blake3_chunk_update(chunk, in, len);
+        foil_blake3_merge_cv_stack(self, chunk->counter);
+    }
+}
+
+void
+foil_blake3_finish(
+    const FoilBlake3* self,
+    guint8* md)
+{
+    FoilBlake3Output out;
+    guint32 cv[8];
+    guint i, remaining;
+
+    if (!self->cv_stack_len) {
+        /* The only chunk is the root */
+        foil_blake3_chunk_output(&self->chunk, &out);
+    } else {
+        if (foil_blake3_chunk_len(&self->chunk) > 0) {
+            remaining = self->cv_stack_len;
+            foil_blake3_chunk_output(&self->chunk, &out);
+        } else {
+            remaining = self->cv_stack_len - 2;
+            foil_blake3_parent_output(self->cv_stack[remaining],
+                self->cv_stack[remaining + 1], &out);
+        }
+        while (remaining > 0) {
+            remaining--;
+            foil_blake3_output_cv(&out, cv);
+            foil_blake3_parent_output(self->cv_stack[remaining], cv, &out);
+        }
+    }
+
+    /* Only the first 32 bytes of the root output are needed */
+    out.flags |= FOIL_BLAKE3_ROOT;
+    foil_blake3_output_cv(&out, cv);
+    for (i = 0; i < 8; i++) {
+        foil_blake3_store32(md + 4 * i, cv[i]);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_BLAKE3_H
+#define FOIL_BLAKE3_H
+
+#include "foil_types_p.h"
+
+/* BLAKE3 in the default hashing mode (no key, no key derivation) */
+
+#define FOIL_BLAKE3_OUT_LEN (32)
+#define FOIL_BLAKE3_BLOCK_LEN (64)
+#define FOIL_BLAKE3_CHUNK_LEN (1024)
+#define FOIL_BLAKE3_MAX_DEPTH (54)
+
+typedef struct foil_blake3_chunk {
+    guint32 cv[8];
+    guint64 counter;
+    guint8 buf[FOIL_BLAKE3_BLOCK_LEN];
+    guint buf_len;
+    guint blocks;
+} FoilBlake3Chunk;
+
+typedef struct foil_blake3 {
+    FoilBlake3Chunk chunk;
+    guint cv_stack_len;
+    guint32 cv_stack[FOIL_BLAKE3_MAX_DEPTH + 1][8];
+} FoilBlake3;
+
+void
+foil_blake3_init(
+    FoilBlake3* b3)
+    FOIL_INTERNAL;
+
+void
+foil_blake3_update(
+    FoilBlake3* b3,
+    const void* data,
+    gsize size)
+    FOIL_INTERNAL;
+
+void
+foil_blake3_finish(
+    const FoilBlake3* b3,
+    guint8* out /* FOIL_BLAKE3_OUT_LEN bytes */)
+    FOIL_INTERNAL;
+
+#endif /* FOIL_BLAKE3_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
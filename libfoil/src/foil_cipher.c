@@ -35,6 +35,7 @@
 #include "foil_digest.h"
 #include "foil_output.h"
 #include "foil_key.h"
+#include "foil_stats_p.h"
 
 /* Logging */
 #define GLOG_MODULE_NAME foil_log_cipher
@@ -45,6 +46,63 @@ G_DEFINE_ABSTRACT_TYPE(FoilCipher, foil_cipher, G_TYPE_OBJECT);
 #define foil_cipher_class_ref(type) ((FoilCipherClass*)foil_class_ref(type, \
         FOIL_TYPE_CIPHER))
 
+/*==========================================================================*
+ * Statistics
+ *==========================================================================*/
+
+static
+void
+foil_cipher_stats_end(
+    FoilCipher* self,
+    const char* op,
+    gsize bytes,
+    gint64 start)
+{
+    foil_stats_end(FOIL_STATS_CIPHER, GSIZE_TO_POINTER
+        (G_TYPE_FROM_INSTANCE(self)), FOIL_CIPHER_GET_CLASS(self)->name,
+        op, bytes, start);
+}
+
+static
+void
+foil_cipher_stats_new(
+    FoilCipher* self)
+{
+    foil_stats_count(FOIL_STATS_CIPHER, GSIZE_TO_POINTER
+        (G_TYPE_FROM_INSTANCE(self)), FOIL_CIPHER_GET_CLASS(self)->name,
+        "new");
+}
+
+static
+int
+foil_cipher_step_stats(
+    FoilCipher* self,
+    const void* in,
+    void* out)
+{
+    const gint64 start = foil_stats_begin();
+    const int ret = FOIL_CIPHER_GET_CLASS(self)->fn_step(self, in, out);
+
+    foil_cipher_stats_end(self, "step", self->input_block_size, start);
+    return ret;
+}
+
+static
+int
+foil_cipher_finish_stats(
+    FoilCipher* self,
+    const void* in,
+    int len,
+    void* out)
+{
+    const gint64 start = foil_stats_begin();
+    const int ret = FOIL_CIPHER_GET_CLASS(self)->fn_finish(self, in, len,
+        out);
+
+    foil_cipher_stats_end(self, "finish", len, start);
+    return ret;
+}
+
 /*==========================================================================*
  * Public API
  *==========================================================================*/
@@ -92,6 +150,9 @@ foil_cipher_new(
                 GASSERT(cipher->key); /* Set by foil_cipher_init_with_key */
                 GASSERT(cipher->input_block_size);  /* and these two are set */
                 GASSERT(cipher->output_block_size); /* by the implementation */
+                if (FOIL_STATS_ACTIVE()) {
+                    foil_cipher_stats_new(cipher);
+                }
             }
             g_type_class_unref(klass);
         }
@@ -109,12 +170,43 @@ foil_cipher_clone(
             FoilCipher* clone = g_object_new(G_TYPE_FROM_INSTANCE(self), NULL);
             klass->fn_init_with_key(clone, self->key);
             klass->fn_copy(clone, self);
+            if (FOIL_STATS_ACTIVE()) {
+                foil_cipher_stats_new(clone);
+            }
             return clone;
         }
     }
     return NULL;
 }
 
+gboolean
+foil_cipher_rekey(
+    FoilCipher* self,
+    FoilKey* key) /* Since 1.0.31 */
+{
+    /* Can't change the key under pending asynchronous operations */
+    if (G_LIKELY(self) && G_LIKELY(key) &&
+        !foil_cipher_priv_busy(self->priv)) {
+        FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
+
+        if (klass->fn_supports_key(klass, G_TYPE_FROM_INSTANCE(key))) {
+            foil_key_ref(key); /* It may be the current key */
+            foil_cipher_clear_key(self);
+            klass->fn_init_with_key(self, key);
+            foil_key_unref(key);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+gboolean
+foil_cipher_reset(
+    FoilCipher* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) && foil_cipher_rekey(self, self->key);
+}
+
 FoilCipher*
 foil_cipher_ref(
     FoilCipher* self)
@@ -172,6 +264,54 @@ foil_cipher_symmetric(
         (FOIL_CIPHER_GET_CLASS(self)->flags & FOIL_CIPHER_SYMMETRIC);
 }
 
+guint
+foil_cipher_tag_size(
+    FoilCipher* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? FOIL_CIPHER_GET_CLASS(self)->tag_size : 0;
+}
+
+gboolean
+foil_cipher_add_aad(
+    FoilCipher* self,
+    const void* aad,
+    gsize size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(aad || !size)) {
+        FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
+        return klass->fn_add_aad && klass->fn_add_aad(self, aad, size);
+    }
+    return FALSE;
+}
+
+gboolean
+foil_cipher_get_tag(
+    FoilCipher* self,
+    void* tag,
+    gsize size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(tag)) {
+        FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
+        return klass->fn_get_tag && size && size <= klass->tag_size &&
+            klass->fn_get_tag(self, tag, size);
+    }
+    return FALSE;
+}
+
+gboolean
+foil_cipher_set_tag(
+    FoilCipher* self,
+    const void* tag,
+    gsize size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(tag)) {
+        FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
+        return klass->fn_set_tag && size && size <= klass->tag_size &&
+            klass->fn_set_tag(self, tag, size);
+    }
+    return FALSE;
+}
+
 gboolean
 foil_cipher_set_padding_func(
     FoilCipher* self,
@@ -195,8 +335,12 @@ foil_cipher_step(
     void* out)
 {
     if (G_LIKELY(self) && G_LIKELY(in) && G_LIKELY(out)) {
-        FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
-        return klass->fn_step(self, in, out);
+        if (FOIL_STATS_ACTIVE()) {
+            return foil_cipher_step_stats(self, in, out);
+        } else {
+            FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
+            return klass->fn_step(self, in, out);
+        }
     }
     return -1;
 }
@@ -209,8 +353,12 @@ foil_cipher_finish(
     void* out)
 {
     if (G_LIKELY(self) && len >= 0) {
-        FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
-        return klass->fn_finish(self, in, len, out);
+        if (FOIL_STATS_ACTIVE()) {
+            return foil_cipher_finish_stats(self, in, len, out);
+        } else {
+            FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
+            return klass->fn_finish(self, in, len, out);
+        }
     }
     return -1;
 }
@@ -224,8 +372,68 @@ foil_cipher_cancel_all(
     }
 }
 
+/*
+ * Full blocks are handed to fn_steps in batches of this size. That
+ * bounds the size of the temporary output buffer and still gives the
+ * cipher enough work to spread across the threads.
+ *
+ * The results are interpreted the same way as in the fn_step loop,
+ * a block which produces no output ends the sequence of full blocks.
+ * The number of blocks preceding it is returned via the steps pointer
+ * and the caller proceeds from there just like it does after fn_step
+ * returns zero.
+ */
+#define FOIL_CIPHER_STEPS_BATCH (1024)
+
+static
 gboolean
-foil_cipher_write_data(
+foil_cipher_write_steps(
+    FoilCipher* self,
+    const guint8* in,
+    guint n,
+    FoilOutput* out,
+    FoilDigest* digest,
+    guint* steps)
+{
+    FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(self);
+    const int in_size = self->input_block_size;
+    const int out_size = self->output_block_size;
+    const guint batch = MIN(n, FOIL_CIPHER_STEPS_BATCH);
+    guint8* out_buf = g_malloc(batch * out_size);
+    int* nout = g_new(int, batch);
+    gboolean ok = TRUE, done = FALSE;
+
+    *steps = 0;
+    while (n > 0 && ok && !done) {
+        const guint count = MIN(n, batch);
+        guint i;
+
+        ok = klass->fn_steps(self, in, out_buf, nout, count);
+
+        /* Output goes in the original order */
+        for (i = 0; i < count && ok && !done; i++) {
+            foil_digest_update(digest, in, in_size);
+            if (nout[i] > 0) {
+                ok = foil_output_write_all(out, out_buf + i * out_size,
+                    nout[i]);
+                in += in_size;
+                (*steps)++;
+            } else if (nout[i] < 0) {
+                ok = FALSE;
+            } else {
+                done = TRUE;
+            }
+        }
+        n -= count;
+    }
+    g_free(nout);
+    g_free(out_buf);
+    return ok;
+}
+
+static
+gboolean
+foil_cipher_write_data_run(
     FoilCipher* self,
     const void* data,
     gsize size,
@@ -246,7 +454,16 @@ foil_cipher_write_data(
 
         /* Full input blocks */
         ok = TRUE;
-        for (i=1; i<n && ok; i++) {
+        i = 1;
+        if (klass->fn_steps && n > 2) {
+            guint steps;
+
+            ok = foil_cipher_write_steps(self, ptr, n - 1, out, digest,
+                &steps);
+            ptr += in_size * steps;
+            i = n;
+        }
+        for (; i<n && ok; i++) {
             foil_digest_update(digest, ptr, in_size);
             nout = klass->fn_step(self, ptr, out_block);
             if (nout > 0) {
@@ -280,6 +497,25 @@ foil_cipher_write_data(
     return ok;
 }
 
+gboolean
+foil_cipher_write_data(
+    FoilCipher* self,
+    const void* data,
+    gsize size,
+    FoilOutput* out,
+    FoilDigest* digest)
+{
+    if (FOIL_STATS_ACTIVE() && G_LIKELY(self)) {
+        const gint64 start = foil_stats_begin();
+        const gboolean ok = foil_cipher_write_data_run(self, data, size,
+            out, digest);
+
+        foil_cipher_stats_end(self, "data", size, start);
+        return ok;
+    }
+    return foil_cipher_write_data_run(self, data, size, out, digest);
+}
+
 GBytes*
 foil_cipher_data(
     GType type,
@@ -351,6 +587,16 @@ foil_cipher_run_init(
     foil_cipher_run_next(run);
 }
 
+void
+foil_cipher_clear_key(
+    FoilCipher* self)
+{
+    if (self->key) {
+        FOIL_CIPHER_GET_CLASS(self)->fn_clear_key(self);
+        GASSERT(!self->key);
+    }
+}
+
 void
 foil_cipher_run_deinit(
     FoilCipherRun* run)
@@ -478,8 +724,9 @@ foil_cipher_default_padding_func(
     }
 }
 
+static
 gboolean
-foil_cipher_write_data_blocks(
+foil_cipher_write_data_blocks_run(
     FoilCipher* self,
     const FoilBytes* blocks,
     guint nblocks,
@@ -530,6 +777,31 @@ foil_cipher_write_data_blocks(
     return ok;
 }
 
+gboolean
+foil_cipher_write_data_blocks(
+    FoilCipher* self,
+    const FoilBytes* blocks,
+    guint nblocks,
+    FoilOutput* out,
+    FoilDigest* digest)
+{
+    if (FOIL_STATS_ACTIVE() && G_LIKELY(self)) {
+        const gint64 start = foil_stats_begin();
+        const gboolean ok = foil_cipher_write_data_blocks_run(self, blocks,
+            nblocks, out, digest);
+        gsize size = 0;
+        guint i;
+
+        for (i = 0; i < nblocks; i++) {
+            size += blocks[i].len;
+        }
+        foil_cipher_stats_end(self, "data", size, start);
+        return ok;
+    }
+    return foil_cipher_write_data_blocks_run(self, blocks, nblocks, out,
+        digest);
+}
+
 static
 void
 foil_cipher_init_with_key(
@@ -554,6 +826,16 @@ foil_cipher_default_copy(
     self->key = src->key;
 }
 
+static
+void
+foil_cipher_default_clear_key(
+    FoilCipher* self)
+{
+    foil_key_unref(self->key);
+    self->key = NULL;
+    self->fn_pad = FOIL_CIPHER_GET_CLASS(self)->fn_pad;
+}
+
 static
 void
 foil_cipher_finalize(
@@ -583,6 +865,7 @@ foil_cipher_class_init(
     klass->fn_pad = foil_cipher_default_padding_func;
     klass->fn_init_with_key = foil_cipher_init_with_key;
     klass->fn_copy = foil_cipher_default_copy;
+    klass->fn_clear_key = foil_cipher_default_clear_key;
     G_OBJECT_CLASS(klass)->finalize = foil_cipher_finalize;
     foil_cipher_priv_add(klass);
 }
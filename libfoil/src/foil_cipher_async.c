@@ -470,6 +470,13 @@ foil_cipher_priv_finalize(
     gutil_weakref_unref(priv->ref);
 }
 
+gboolean
+foil_cipher_priv_busy(
+    FoilCipherPriv* priv)
+{
+    return priv->async_queue.length || (priv->ids && priv->ids->count);
+}
+
 void
 foil_cipher_priv_cancel_all(
     FoilCipherPriv* priv)
@@ -53,8 +53,17 @@ struct foil_cipher_class {
     gboolean (*fn_supports_key)(FoilCipherClass* klass, GType key_type);
     void (*fn_init_with_key)(FoilCipher* cipher, FoilKey* key);
     void (*fn_copy)(FoilCipher* dest, FoilCipher* src);
+    void (*fn_clear_key)(FoilCipher* cipher);
     int (*fn_step)(FoilCipher* cipher, const void* in, void* out);
     int (*fn_finish)(FoilCipher* cipher, const void* in, int n, void* out);
+    /* Authenticated encryption (Since 1.0.31) */
+    guint tag_size;
+    gboolean (*fn_add_aad)(FoilCipher* cipher, const void* aad, gsize size);
+    gboolean (*fn_get_tag)(FoilCipher* cipher, void* tag, gsize size);
+    gboolean (*fn_set_tag)(FoilCipher* cipher, const void* tag, gsize size);
+    /* Bulk processing of n full input blocks (Since 1.0.31) */
+    gboolean (*fn_steps)(FoilCipher* cipher, const void* in, void* out,
+        int* nout, guint n);
 };
 
 struct foil_cipher {
@@ -128,6 +137,16 @@ foil_cipher_priv_cancel_all(
     FoilCipherPriv* priv)
     FOIL_INTERNAL;
 
+gboolean
+foil_cipher_priv_busy(
+    FoilCipherPriv* priv)
+    FOIL_INTERNAL;
+
+void
+foil_cipher_clear_key(
+    FoilCipher* cipher)
+    FOIL_INTERNAL;
+
 int
 foil_cipher_symmetric_finish(
     FoilCipher* cipher,
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_cipher_p.h"
+
+/*
+ * Each thread has its own pool, so getting a cipher from the pool
+ * and putting it back requires no locking. The pool maps cipher
+ * GType into a stack of ciphers which have no key attached to them.
+ */
+
+#define FOIL_CIPHER_POOL_MAX_PER_TYPE (16)
+
+typedef struct foil_cipher_pool {
+    GHashTable* types;
+} FoilCipherPool;
+
+static
+void
+foil_cipher_pool_free_stack(
+    gpointer data)
+{
+    GPtrArray* stack = data;
+    guint i;
+
+    for (i = 0; i < stack->len; i++) {
+        foil_cipher_unref(stack->pdata[i]);
+    }
+    g_ptr_array_free(stack, TRUE);
+}
+
+static
+void
+foil_cipher_pool_free(
+    gpointer data)
+{
+    FoilCipherPool* pool = data;
+
+    g_hash_table_destroy(pool->types);
+    g_slice_free(FoilCipherPool, pool);
+}
+
+static GPrivate foil_cipher_pool_key = G_PRIVATE_INIT(foil_cipher_pool_free);
+
+static
+FoilCipherPool*
+foil_cipher_pool_current(
+    gboolean create)
+{
+    FoilCipherPool* pool = g_private_get(&foil_cipher_pool_key);
+
+    if (!pool && create) {
+        pool = g_slice_new(FoilCipherPool);
+        pool->types = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+            NULL, foil_cipher_pool_free_stack);
+        g_private_set(&foil_cipher_pool_key, pool);
+    }
+    return pool;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+FoilCipher*
+foil_cipher_pool_get(
+    GType type,
+    FoilKey* key) /* Since 1.0.31 */
+{
+    if (G_LIKELY(key)) {
+        FoilCipherPool* pool = foil_cipher_pool_current(FALSE);
+        GPtrArray* stack = pool ? g_hash_table_lookup(pool->types,
+            GSIZE_TO_POINTER(type)) : NULL;
+
+        if (stack && stack->len) {
+            FoilCipher* cipher = stack->pdata[stack->len - 1];
+            FoilCipherClass* klass = FOIL_CIPHER_GET_CLASS(cipher);
+
+            if (klass->fn_supports_key(klass, G_TYPE_FROM_INSTANCE(key))) {
+                g_ptr_array_remove_index(stack, stack->len - 1);
+                klass->fn_init_with_key(cipher, key);
+                return cipher;
+            }
+            return NULL;
+        }
+        return foil_cipher_new(type, key);
+    }
+    return NULL;
+}
+
+void
+foil_cipher_pool_put(
+    FoilCipher* cipher) /* Since 1.0.31 */
+{
+    if (G_LIKELY(cipher)) {
+        GObject* obj = G_OBJECT(cipher);
+
+        /* Only recycle ciphers that nobody else is using */
+        if (g_atomic_int_get(&obj->ref_count) == 1 &&
+            !foil_cipher_priv_busy(cipher->priv)) {
+            FoilCipherPool* pool = foil_cipher_pool_current(TRUE);
+            gpointer type = GSIZE_TO_POINTER(G_TYPE_FROM_INSTANCE(cipher));
+            GPtrArray* stack = g_hash_table_lookup(pool->types, type);
+
+            if (!stack) {
+                stack = g_ptr_array_new();
+                g_hash_table_insert(pool->types, type, stack);
+            }
+            if (stack->len < FOIL_CIPHER_POOL_MAX_PER_TYPE) {
+                /* Don't keep the key alive while the cipher is idle */
+                foil_cipher_clear_key(cipher);
+                g_ptr_array_add(stack, cipher);
+                return;
+            }
+        }
+        foil_cipher_unref(cipher);
+    }
+}
+
+void
+foil_cipher_pool_clear(
+    void) /* Since 1.0.31 */
+{
+    FoilCipherPool* pool = foil_cipher_pool_current(FALSE);
+
+    if (pool) {
+        g_hash_table_remove_all(pool->types);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
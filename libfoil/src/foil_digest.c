@@ -34,6 +34,7 @@
 
 #include "foil_digest_p.h"
 #include "foil_util_p.h"
+#include "foil_stats_p.h"
 
 /* Logging */
 #define GLOG_MODULE_NAME foil_log_digest
@@ -50,6 +51,40 @@ G_DEFINE_ABSTRACT_TYPE(FoilDigest, foil_digest, G_TYPE_OBJECT);
 #define foil_digest_class_ref(type) ((FoilDigestClass*)foil_class_ref(type, \
         FOIL_TYPE_DIGEST))
 
+/*==========================================================================*
+ * Statistics
+ *==========================================================================*/
+
+static
+void
+foil_digest_stats(
+    FoilDigestClass* klass,
+    const void* data,
+    gsize size,
+    void* digest)
+{
+    const gint64 start = foil_stats_begin();
+
+    klass->fn_digest(data, size, digest);
+    foil_stats_end(FOIL_STATS_DIGEST, GSIZE_TO_POINTER
+        (G_TYPE_FROM_CLASS(klass)), klass->name, "data", size, start);
+}
+
+static
+void
+foil_digest_update_stats(
+    FoilDigest* self,
+    const void* data,
+    gsize size)
+{
+    FoilDigestClass* klass = FOIL_DIGEST_GET_CLASS(self);
+    const gint64 start = foil_stats_begin();
+
+    klass->fn_update(self, data, size);
+    foil_stats_end(FOIL_STATS_DIGEST, GSIZE_TO_POINTER
+        (G_TYPE_FROM_CLASS(klass)), klass->name, "update", size, start);
+}
+
 gsize
 foil_digest_type_size(
     GType type)
@@ -106,7 +141,11 @@ foil_digest_data(
         if (G_LIKELY(klass)) {
             void* digest = klass->fn_digest_alloc();
 
-            klass->fn_digest(data, size, digest);
+            if (FOIL_STATS_ACTIVE()) {
+                foil_digest_stats(klass, data, size, digest);
+            } else {
+                klass->fn_digest(data, size, digest);
+            }
             result = g_bytes_new_with_free_func(digest, klass->size,
                 klass->fn_digest_free, digest);
             g_type_class_unref(klass);
@@ -127,7 +166,11 @@ foil_digest_data_buf(
         FoilDigestClass* klass = foil_digest_class_ref(type);
 
         if (G_LIKELY(klass)) {
-            klass->fn_digest(data, size, digest);
+            if (FOIL_STATS_ACTIVE()) {
+                foil_digest_stats(klass, data, size, digest);
+            } else {
+                klass->fn_digest(data, size, digest);
+            }
             g_type_class_unref(klass);
             return TRUE;
         }
@@ -180,6 +223,10 @@ foil_digest_new(
 
     if (G_LIKELY(klass)) {
         digest = g_object_new(type, NULL);
+        if (FOIL_STATS_ACTIVE()) {
+            foil_stats_count(FOIL_STATS_DIGEST, GSIZE_TO_POINTER(type),
+                klass->name, "new");
+        }
         g_type_class_unref(klass);
     }
     return digest;
@@ -277,7 +324,11 @@ foil_digest_update(
     gsize size) /* Has return value since 1.0.26 */
 {
     if (G_LIKELY(self) && G_LIKELY(!self->result)) {
-        FOIL_DIGEST_GET_CLASS(self)->fn_update(self, data, size);
+        if (FOIL_STATS_ACTIVE()) {
+            foil_digest_update_stats(self, data, size);
+        } else {
+            FOIL_DIGEST_GET_CLASS(self)->fn_update(self, data, size);
+        }
         return TRUE;
     } else {
         return FALSE;
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_digest_p.h"
+
+#define DIGEST_LENGTH (64)
+#define DIGEST_BLOCK_SIZE (128)
+
+G_DEFINE_ABSTRACT_TYPE(FoilDigestBLAKE2B, foil_digest_blake2b,
+    FOIL_TYPE_DIGEST);
+
+/*
+ * https://www.rfc-editor.org/rfc/rfc7693
+ *
+ * id-blake2b512 OBJECT IDENTIFIER ::= {
+ *     iso(1) identified-organization(3) dod(6) internet(1)
+ *     private(4) enterprise(1) kudelski(1722) cryptography(12)
+ *     2 1 16
+ * }
+ */
+static const guint8 foil_digest_blake2b_digest_oid [] = {
+    0x2b,       /* iso(1) identified-organization(3) */
+    0x06,       /* dod(6) */
+    0x01,       /* internet(1) */
+    0x04,       /* private(4) */
+    0x01,       /* enterprise(1) */
+    0x8d, 0x3a, /* kudelski(1722) */
+    0x0c,       /* cryptography(12) */
+    0x02,       /* 2 */
+    0x01,       /* 1 */
+    0x10        /* 16 */
+};
+
+static
+void*
+foil_digest_blake2b_digest_alloc(void)
+{
+    return g_slice_alloc(DIGEST_LENGTH);
+}
+
+static
+void
+foil_digest_blake2b_digest_free(
+    void* md)
+{
+    g_slice_free1(DIGEST_LENGTH, md);
+}
+
+static
+void
+foil_digest_blake2b_init(
+    FoilDigestBLAKE2B* self)
+{
+}
+
+static
+void
+foil_digest_blake2b_class_init(
+    FoilDigestBLAKE2BClass* klass)
+{
+    klass->name = "BLAKE2B";
+    klass->size = DIGEST_LENGTH;
+    klass->block_size = DIGEST_BLOCK_SIZE;
+    FOIL_BYTES_SET(klass->oid, foil_digest_blake2b_digest_oid);
+    klass->fn_digest_alloc = foil_digest_blake2b_digest_alloc;
+    klass->fn_digest_free = foil_digest_blake2b_digest_free;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_digest_p.h"
+#include "foil_blake3.h"
+
+#define DIGEST_LENGTH FOIL_BLAKE3_OUT_LEN
+#define DIGEST_BLOCK_SIZE FOIL_BLAKE3_BLOCK_LEN
+
+/*
+ * BLAKE3 doesn't depend on the crypto backend, it's implemented by
+ * libfoil itself. It has no OID either.
+ */
+typedef FoilDigestClass FoilDigestBLAKE3Class;
+typedef struct foil_digest_blake3 {
+    FoilDigest digest;
+    FoilBlake3 b3;
+} FoilDigestBLAKE3;
+
+#define THIS_TYPE foil_digest_blake3_get_type()
+#define THIS(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, THIS_TYPE, \
+    FoilDigestBLAKE3))
+
+GType THIS_TYPE FOIL_INTERNAL;
+G_DEFINE_TYPE(FoilDigestBLAKE3, foil_digest_blake3, FOIL_TYPE_DIGEST)
+
+GType
+foil_impl_digest_blake3_get_type() /* Since 1.0.31 */
+{
+    return THIS_TYPE;
+}
+
+static
+void*
+foil_digest_blake3_digest_alloc(void)
+{
+    return g_slice_alloc(DIGEST_LENGTH);
+}
+
+static
+void
+foil_digest_blake3_digest_free(
+    void* md)
+{
+    g_slice_free1(DIGEST_LENGTH, md);
+}
+
+static
+void
+foil_digest_blake3_copy(
+    FoilDigest* digest,
+    FoilDigest* source)
+{
+    THIS(digest)->b3 = THIS(source)->b3;
+}
+
+static
+void
+foil_digest_blake3_reset(
+    FoilDigest* digest)
+{
+    foil_blake3_init(&THIS(digest)->b3);
+}
+
+static
+void
+foil_digest_blake3_update(
+    FoilDigest* digest,
+    const void* data,
+    gsize size)
+{
+    foil_blake3_update(&THIS(digest)->b3, data, size);
+}
+
+static
+void
+foil_digest_blake3_finish(
+    FoilDigest* digest,
+    void* md)
+{
+    FoilDigestBLAKE3* self = THIS(digest);
+
+    if (G_LIKELY(md)) {
+        foil_blake3_finish(&self->b3, md);
+    }
+    memset(&self->b3, 0, sizeof(self->b3));
+}
+
+static
+void
+foil_digest_blake3_digest(
+    const void* data,
+    gsize size,
+    void* md)
+{
+    FoilBlake3 b3;
+
+    foil_blake3_init(&b3);
+    foil_blake3_update(&b3, data, size);
+    foil_blake3_finish(&b3, md);
+}
+
+static
+void
+foil_digest_blake3_init(
+    FoilDigestBLAKE3* self)
+{
+    foil_blake3_init(&self->b3);
+}
+
+static
+void
+foil_digest_blake3_class_init(
+    FoilDigestBLAKE3Class* klass)
+{
+    klass->name = "BLAKE3";
+    klass->size = DIGEST_LENGTH;
+    klass->block_size = DIGEST_BLOCK_SIZE;
+    klass->fn_digest_alloc = foil_digest_blake3_digest_alloc;
+    klass->fn_digest_free = foil_digest_blake3_digest_free;
+    klass->fn_copy = foil_digest_blake3_copy;
+    klass->fn_reset = foil_digest_blake3_reset;
+    klass->fn_digest = foil_digest_blake3_digest;
+    klass->fn_update = foil_digest_blake3_update;
+    klass->fn_finish = foil_digest_blake3_finish;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
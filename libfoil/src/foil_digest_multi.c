@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_digest_p.h"
+#include "foil_thread_pool_p.h"
+
+#define GLOG_MODULE_NAME foil_log_digest
+#include "foil_log_p.h"
+
+/*
+ * Chunks are small enough for each of them to stay in L1 (or at least
+ * L2) cache while all the digests are being updated with it. Large
+ * updates are handed over to the shared thread pool, one digest per job.
+ * Those walk the same memory at roughly the same pace, so the data
+ * still get pulled from RAM more or less once.
+ */
+#define FOIL_DIGEST_MULTI_CHUNK (16 * 1024)
+#define FOIL_DIGEST_MULTI_PARALLEL_MIN (1024 * 1024)
+
+struct foil_digest_multi {
+    gint ref_count;
+    guint count;
+    FoilDigest** digests;
+};
+
+typedef struct foil_digest_multi_job {
+    FoilDigest* digest;
+    const void* data;
+    gsize size;
+} FoilDigestMultiJob;
+
+static
+void
+foil_digest_multi_job_run(
+    gpointer data)
+{
+    FoilDigestMultiJob* job = data;
+
+    foil_digest_update(job->digest, job->data, job->size);
+}
+
+static
+void
+foil_digest_multi_update_chunks(
+    FoilDigestMulti* self,
+    const guint8* data,
+    gsize size)
+{
+    while (size > 0) {
+        const gsize chunk = MIN(size, FOIL_DIGEST_MULTI_CHUNK);
+        guint i;
+
+        for (i = 0; i < self->count; i++) {
+            foil_digest_update(self->digests[i], data, chunk);
+        }
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+static
+void
+foil_digest_multi_update_parallel(
+    FoilDigestMulti* self,
+    const void* data,
+    gsize size)
+{
+    FoilDigestMultiJob* jobs = g_new0(FoilDigestMultiJob, self->count);
+    FoilThreadBatch* batch = foil_thread_batch_new();
+    guint i;
+
+    for (i = 0; i < self->count; i++) {
+        FoilDigestMultiJob* job = jobs + i;
+
+        job->digest = self->digests[i];
+        job->data = data;
+        job->size = size;
+    }
+
+    /* The first digest is updated by this thread */
+    for (i = 1; i < self->count; i++) {
+        foil_thread_batch_push(batch, foil_digest_multi_job_run, jobs + i);
+    }
+    foil_digest_multi_job_run(jobs);
+    foil_thread_batch_finish(batch);
+    g_free(jobs);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+FoilDigestMulti*
+foil_digest_multi_new(
+    const GType* types,
+    guint count) /* Since 1.0.31 */
+{
+    if (G_LIKELY(types) && G_LIKELY(count)) {
+        FoilDigestMulti* self = g_slice_new0(FoilDigestMulti);
+        guint i;
+
+        g_atomic_int_set(&self->ref_count, 1);
+        self->digests = g_new0(FoilDigest*, count);
+        for (i = 0; i < count; i++) {
+            FoilDigest* digest = foil_digest_new(types[i]);
+
+            if (G_LIKELY(digest)) {
+                self->digests[self->count++] = digest;
+            } else {
+                GDEBUG("Invalid digest type at %u", i);
+                foil_digest_multi_unref(self);
+                return NULL;
+            }
+        }
+        return self;
+    }
+    return NULL;
+}
+
+FoilDigestMulti*
+foil_digest_multi_ref(
+    FoilDigestMulti* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        g_atomic_int_inc(&self->ref_count);
+    }
+    return self;
+}
+
+void
+foil_digest_multi_unref(
+    FoilDigestMulti* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&self->ref_count)) {
+            guint i;
+
+            for (i = 0; i < self->count; i++) {
+                foil_digest_unref(self->digests[i]);
+            }
+            g_free(self->digests);
+            g_slice_free(FoilDigestMulti, self);
+        }
+    }
+}
+
+guint
+foil_digest_multi_count(
+    FoilDigestMulti* self) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) ? self->count : 0;
+}
+
+FoilDigest*
+foil_digest_multi_get(
+    FoilDigestMulti* self,
+    guint index) /* Since 1.0.31 */
+{
+    return (G_LIKELY(self) && index < self->count) ?
+        self->digests[index] : NULL;
+}
+
+gboolean
+foil_digest_multi_update(
+    FoilDigestMulti* self,
+    const void* data,
+    gsize size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(data || !size)) {
+        guint i;
+
+        /* Don't update any of them unless all can be updated */
+        for (i = 0; i < self->count; i++) {
+            if (self->digests[i]->result) {
+                return FALSE;
+            }
+        }
+        if (size >= FOIL_DIGEST_MULTI_PARALLEL_MIN && self->count > 1 &&
+            foil_ncpu() > 1) {
+            foil_digest_multi_update_parallel(self, data, size);
+        } else if (self->count == 1) {
+            foil_digest_update(self->digests[0], data, size);
+        } else {
+            foil_digest_multi_update_chunks(self, data, size);
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+gboolean
+foil_digest_multi_reset(
+    FoilDigestMulti* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        gboolean ok = TRUE;
+        guint i;
+
+        for (i = 0; i < self->count; i++) {
+            if (!foil_digest_reset(self->digests[i])) {
+                ok = FALSE;
+            }
+        }
+        return ok;
+    }
+    return FALSE;
+}
+
+gboolean
+foil_digest_multi_data(
+    const GType* types,
+    guint count,
+    const void* data,
+    gsize size,
+    GBytes** digests) /* Since 1.0.31 */
+{
+    if (G_LIKELY(digests)) {
+        FoilDigestMulti* self = foil_digest_multi_new(types, count);
+
+        if (self && foil_digest_multi_update(self, data, size)) {
+            guint i;
+
+            for (i = 0; i < count; i++) {
+                digests[i] = g_bytes_ref(foil_digest_finish
+                    (self->digests[i]));
+            }
+            foil_digest_multi_unref(self);
+            return TRUE;
+        }
+        foil_digest_multi_unref(self);
+    }
+    return FALSE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
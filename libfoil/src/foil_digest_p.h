@@ -62,11 +62,13 @@ typedef FoilDigest FoilDigestMD5;
 typedef FoilDigest FoilDigestSHA1;
 typedef FoilDigest FoilDigestSHA256;
 typedef FoilDigest FoilDigestSHA512;
+typedef FoilDigest FoilDigestBLAKE2B;
 
 typedef FoilDigestClass FoilDigestMD5Class;
 typedef FoilDigestClass FoilDigestSHA1Class;
 typedef FoilDigestClass FoilDigestSHA256Class;
 typedef FoilDigestClass FoilDigestSHA512Class;
+typedef FoilDigestClass FoilDigestBLAKE2BClass;
 
 /* Abstract types */
 GType foil_digest_get_type(void) FOIL_INTERNAL;
@@ -74,11 +76,13 @@ GType foil_digest_md5_get_type(void) FOIL_INTERNAL;
 GType foil_digest_sha1_get_type(void) FOIL_INTERNAL;
 GType foil_digest_sha256_get_type(void) FOIL_INTERNAL;
 GType foil_digest_sha512_get_type(void) FOIL_INTERNAL;
+GType foil_digest_blake2b_get_type(void) FOIL_INTERNAL;
 #define FOIL_TYPE_DIGEST (foil_digest_get_type())
 #define FOIL_TYPE_DIGEST_MD5 (foil_digest_md5_get_type())
 #define FOIL_TYPE_DIGEST_SHA1 (foil_digest_sha1_get_type())
 #define FOIL_TYPE_DIGEST_SHA256 (foil_digest_sha256_get_type())
 #define FOIL_TYPE_DIGEST_SHA512 (foil_digest_sha512_get_type())
+#define FOIL_TYPE_DIGEST_BLAKE2B (foil_digest_blake2b_get_type())
 
 #define FOIL_DIGEST_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST((klass), \
         FOIL_TYPE_DIGEST, FoilDigestClass))
@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE   /* O_DIRECT, fallocate, sync_file_range */
+#endif
+
+#include "foil_file_p.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#  include <sys/uio.h>
+#endif
+
+/* Number of struct iovec passed to a single writev() call */
+#define FOIL_FILE_IOV_COUNT (16)
+
+#ifndef O_BINARY
+#  define O_BINARY 0
+#endif
+
+#ifndef O_CLOEXEC
+#  define O_CLOEXEC 0
+#endif
+
+#include "foil_log_p.h"
+
+void
+foil_file_buffer_init(
+    FoilFileBuffer* buf,
+    gsize size,
+    gboolean aligned)
+{
+    buf->len = 0;
+    buf->data = NULL;
+    buf->aligned = FALSE;
+    if (!size) {
+        size = FOIL_FILE_DEFAULT_BUFFER_SIZE;
+    }
+#ifdef O_DIRECT
+    if (aligned) {
+        void* ptr = NULL;
+
+        /* O_DIRECT wants both the address and the size to be aligned */
+        size = (size + FOIL_FILE_DIRECT_ALIGN - 1) &
+            ~((gsize)FOIL_FILE_DIRECT_ALIGN - 1);
+        if (!posix_memalign(&ptr, FOIL_FILE_DIRECT_ALIGN, size)) {
+            buf->data = ptr;
+            buf->aligned = TRUE;
+        }
+    }
+#endif
+    if (!buf->data) {
+        buf->data = g_malloc(size);
+    }
+    buf->size = size;
+}
+
+void
+foil_file_buffer_deinit(
+    FoilFileBuffer* buf)
+{
+    if (buf->aligned) {
+        free(buf->data);
+    } else {
+        g_free(buf->data);
+    }
+    buf->data = NULL;
+    buf->size = buf->len = 0;
+}
+
+int
+foil_file_open(
+    const char* path,
+    int flags,
+    gboolean direct)
+{
+    int fd;
+
+    flags |= O_BINARY | O_CLOEXEC;
+#ifdef O_DIRECT
+    if (direct) {
+        fd = open(path, flags | O_DIRECT, 0600);
+        if (fd >= 0 || errno != EINVAL) {
+            return fd;
+        }
+        /* The filesystem doesn't support O_DIRECT (e.g. tmpfs) */
+        GDEBUG("O_DIRECT is not supported for %s", path);
+    }
+#endif
+    do {
+        fd = open(path, flags, 0600);
+    } while (fd < 0 && errno == EINTR);
+    return fd;
+}
+
+gboolean
+foil_file_set_direct(
+    int fd,
+    gboolean direct)
+{
+#ifdef O_DIRECT
+    const int flags = fcntl(fd, F_GETFL);
+
+    if (flags >= 0) {
+        const int new_flags = direct ? (flags | O_DIRECT) :
+            (flags & ~O_DIRECT);
+
+        return new_flags == flags || !fcntl(fd, F_SETFL, new_flags);
+    }
+#endif
+    return !direct;
+}
+
+gssize
+foil_file_read(
+    int fd,
+    void* buf,
+    gsize size)
+{
+    guint8* ptr = buf;
+    gsize total = 0;
+
+    /* Keep reading until we get everything or hit the end of file */
+    while (total < size) {
+        const gssize n = read(fd, ptr + total, size - total);
+
+        if (n > 0) {
+            total += n;
+        } else if (!n) {
+            break;
+        } else if (errno != EINTR) {
+            return total ? (gssize)total : -1;
+        }
+    }
+    return total;
+}
+
+gssize
+foil_file_write(
+    int fd,
+    const void* buf,
+    gsize size)
+{
+    const guint8* ptr = buf;
+    gsize total = 0;
+
+    while (total < size) {
+        const gssize n = write(fd, ptr + total, size - total);
+
+        if (n > 0) {
+            total += n;
+        } else if (!n) {
+            /* Nothing written and no error, don't spin */
+            break;
+        } else if (errno != EINTR) {
+            GDEBUG("write error %s", strerror(errno));
+            return total ? (gssize)total : -1;
+        }
+    }
+    return total;
+}
+
+gssize
+foil_file_writev(
+    int fd,
+    const FoilBytes* bufs,
+    guint n)
+{
+    gsize total = 0;
+    guint i = 0;
+#ifdef _WIN32
+    for (i = 0; i < n; i++) {
+        const gssize written = foil_file_write(fd, bufs[i].val, bufs[i].len);
+
+        if (written < 0) {
+            return total ? (gssize)total : -1;
+        }
+        total += written;
+        if ((gsize)written < bufs[i].len) {
+            break;
+        }
+    }
+#else
+    gsize skip = 0; /* Part of bufs[i] that's already been written */
+
+    while (i < n) {
+        struct iovec iov[FOIL_FILE_IOV_COUNT];
+        gsize size = 0;
+        guint k;
+        gssize written;
+
+        for (k = 0; k < G_N_ELEMENTS(iov) && (i + k) < n; k++) {
+            const FoilBytes* buf = bufs + i + k;
+            const gsize off = k ? 0 : skip;
+
+            iov[k].iov_base = (void*)(buf->val + off);
+            iov[k].iov_len = buf->len - off;
+            size += iov[k].iov_len;
+        }
+        if (!size) {
+            /* Only empty buffers left */
+            break;
+        }
+        written = writev(fd, iov, k);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            GDEBUG("writev error %s", strerror(errno));
+            return total ? (gssize)total : -1;
+        } else if (!written) {
+            break;
+        }
+        total += written;
+
+        /* Skip what has been written, handling short writes too */
+        skip += written;
+        while (i < n && skip >= bufs[i].len) {
+            skip -= bufs[i].len;
+            i++;
+        }
+    }
+#endif
+    return total;
+}
+
+void
+foil_file_advise_sequential(
+    int fd)
+{
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+gboolean
+foil_file_preallocate(
+    int fd,
+    guint64 offset,
+    guint64 size)
+{
+#if defined(FALLOC_FL_KEEP_SIZE)
+    /*
+     * Reserve the blocks without changing the file size, so that we
+     * don't need to truncate the file if fewer bytes actually get
+     * written. Unlike posix_fallocate() it doesn't fall back to writing
+     * zeros if the filesystem doesn't support preallocation.
+     */
+    if (!fallocate(fd, FALLOC_FL_KEEP_SIZE, offset, size)) {
+        return TRUE;
+    }
+    GDEBUG("fallocate(%" G_GUINT64_FORMAT ") error %s", size,
+        strerror(errno));
+#endif
+    return FALSE;
+}
+
+void
+foil_file_writebehind(
+    int fd,
+    guint64 prev,
+    guint64 start,
+    guint64 end)
+{
+#ifdef SYNC_FILE_RANGE_WRITE
+    /* Start the writeout of the most recent window */
+    if (end > start) {
+        sync_file_range(fd, start, end - start, SYNC_FILE_RANGE_WRITE);
+    }
+
+    /*
+     * Wait for the previous window to hit the disk and drop those
+     * pages from the cache, they won't be needed anymore.
+     */
+    if (start > prev) {
+        sync_file_range(fd, prev, start - prev,
+            SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+            SYNC_FILE_RANGE_WAIT_AFTER);
+#ifdef POSIX_FADV_DONTNEED
+        posix_fadvise(fd, prev, start - prev, POSIX_FADV_DONTNEED);
+#endif
+    }
+#endif
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_FILE_P_H
+#define FOIL_FILE_P_H
+
+#include "foil_types_p.h"
+
+/* Raw file descriptor helpers shared by FoilInputFile and FoilOutputFile */
+
+#define FOIL_FILE_DEFAULT_BUFFER_SIZE   (0x10000)
+#define FOIL_FILE_DIRECT_ALIGN          (0x1000)
+
+/* Flush dirty pages to disk after every so many bytes (write-behind) */
+#define FOIL_FILE_WRITEBEHIND_WINDOW    (0x800000)
+
+typedef struct foil_file_buffer {
+    guint8* data;
+    gsize size;
+    gsize len;
+    gboolean aligned;
+} FoilFileBuffer;
+
+void
+foil_file_buffer_init(
+    FoilFileBuffer* buf,
+    gsize size,
+    gboolean aligned)
+    FOIL_INTERNAL;
+
+void
+foil_file_buffer_deinit(
+    FoilFileBuffer* buf)
+    FOIL_INTERNAL;
+
+int
+foil_file_open(
+    const char* path,
+    int flags,
+    gboolean direct)
+    FOIL_INTERNAL;
+
+gboolean
+foil_file_set_direct(
+    int fd,
+    gboolean direct)
+    FOIL_INTERNAL;
+
+gssize
+foil_file_read(
+    int fd,
+    void* buf,
+    gsize size)
+    FOIL_INTERNAL;
+
+gssize
+foil_file_write(
+    int fd,
+    const void* buf,
+    gsize size)
+    FOIL_INTERNAL;
+
+gssize
+foil_file_writev(
+    int fd,
+    const FoilBytes* bufs,
+    guint n)
+    FOIL_INTERNAL;
+
+void
+foil_file_advise_sequential(
+    int fd)
+    FOIL_INTERNAL;
+
+gboolean
+foil_file_preallocate(
+    int fd,
+    guint64 offset,
+    guint64 size)
+    FOIL_INTERNAL;
+
+void
+foil_file_writebehind(
+    int fd,
+    guint64 prev,
+    guint64 start,
+    guint64 end)
+    FOIL_INTERNAL;
+
+#endif /* FOIL_FILE_P_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
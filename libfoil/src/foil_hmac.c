@@ -34,6 +34,7 @@
 
 #include "foil_hmac.h"
 #include "foil_digest_p.h"
+#include "foil_stats_p.h"
 #include "foil_log_p.h"
 
 /*
@@ -90,6 +91,19 @@ foil_hmac_init(
     g_slice_free1(blocksize, k_ipad);
 }
 
+static
+void
+foil_hmac_stats_end(
+    FoilHmac* self,
+    const char* op,
+    gsize bytes,
+    gint64 start)
+{
+    foil_stats_end(FOIL_STATS_HMAC, GSIZE_TO_POINTER
+        (G_TYPE_FROM_INSTANCE(self->digest)), foil_digest_name(self->digest),
+        op, bytes, start);
+}
+
 static
 void
 foil_hmac_finalize(
@@ -159,6 +173,10 @@ foil_hmac_new(
         }
 
         foil_hmac_init(hmac);
+        if (FOIL_STATS_ACTIVE()) {
+            foil_stats_count(FOIL_STATS_HMAC, GSIZE_TO_POINTER(digest_type),
+                foil_digest_name(digest), "new");
+        }
         return hmac;
     }
     return NULL;
@@ -240,7 +258,14 @@ foil_hmac_update(
     gsize size)
 {
     if (G_LIKELY(self)) {
-        foil_digest_update(self->digest, data, size);
+        if (FOIL_STATS_ACTIVE()) {
+            const gint64 start = foil_stats_begin();
+
+            foil_digest_update(self->digest, data, size);
+            foil_hmac_stats_end(self, "update", size, start);
+        } else {
+            foil_digest_update(self->digest, data, size);
+        }
     }
 }
 
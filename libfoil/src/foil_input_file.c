@@ -28,18 +28,45 @@
  */
 
 #include "foil_input_p.h"
+#include "foil_file_p.h"
 #include "foil_log_p.h"
 
 #include <gutil_macros.h>
 
 #include <errno.h>
+#include <fcntl.h>
 
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+/* stdio based input */
 typedef struct foil_input_file {
     FoilInput parent;
     FILE* file;
     guint flags;
 } FoilInputFile;
 
+/* File descriptor based input */
+typedef struct foil_input_fd {
+    FoilInput parent;
+    int fd;
+    guint flags;
+    gboolean direct;
+    gboolean eof;
+    FoilFileBuffer buf;
+    gsize pos;
+} FoilInputFd;
+
+#define FOIL_INPUT_FILE_FD_FLAGS (FOIL_INPUT_FILE_CLOSE | \
+    FOIL_INPUT_FILE_DIRECT)
+
+/*==========================================================================*
+ * stdio
+ *==========================================================================*/
+
 static
 gssize
 foil_input_file_read(
@@ -74,6 +101,124 @@ foil_input_file_free(
     g_slice_free(FoilInputFile, self);
 }
 
+/*==========================================================================*
+ * File descriptor
+ *==========================================================================*/
+
+static
+gssize
+foil_input_fd_fill(
+    FoilInputFd* self)
+{
+    FoilFileBuffer* buf = &self->buf;
+    gssize n = foil_file_read(self->fd, buf->data, buf->size);
+
+    if (n < 0 && self->direct && errno == EINVAL) {
+        /* Misaligned file offset or whatever, switch to normal I/O */
+        GDEBUG("Switching off O_DIRECT");
+        foil_file_set_direct(self->fd, FALSE);
+        self->direct = FALSE;
+        n = foil_file_read(self->fd, buf->data, buf->size);
+    }
+    self->pos = 0;
+    if (n >= 0) {
+        buf->len = n;
+        if ((gsize)n < buf->size) {
+            self->eof = TRUE;
+        }
+    } else {
+        buf->len = 0;
+    }
+    return n;
+}
+
+static
+gssize
+foil_input_fd_read(
+    FoilInput* in,
+    void* data,
+    gsize size)
+{
+    FoilInputFd* self = G_CAST(in, FoilInputFd, parent);
+    FoilFileBuffer* buf = &self->buf;
+    guint8* ptr = data;
+    gsize total = 0;
+
+    while (total < size) {
+        const gsize available = buf->len - self->pos;
+
+        if (available) {
+            const gsize n = MIN(available, size - total);
+
+            if (ptr) {
+                memcpy(ptr + total, buf->data + self->pos, n);
+            }
+            self->pos += n;
+            total += n;
+        } else if (self->eof) {
+            break;
+        } else if (ptr && !self->direct && (size - total) >= buf->size) {
+            /* Large read, bypass the buffer */
+            const gsize want = size - total;
+            const gssize n = foil_file_read(self->fd, ptr + total, want);
+
+            if (n < 0) {
+                return total ? (gssize)total : -1;
+            }
+            if ((gsize)n < want) {
+                self->eof = TRUE;
+            }
+            total += n;
+        } else {
+            const gssize n = foil_input_fd_fill(self);
+
+            if (n < 0) {
+                return total ? (gssize)total : -1;
+            }
+        }
+    }
+    return total;
+}
+
+static
+void
+foil_input_fd_close(
+    FoilInput* in)
+{
+    FoilInputFd* self = G_CAST(in, FoilInputFd, parent);
+
+    if (self->flags & FOIL_INPUT_FILE_CLOSE) {
+        close(self->fd);
+    } else {
+        if (self->direct) {
+            /* Don't leave O_DIRECT set on somebody else's descriptor */
+            foil_file_set_direct(self->fd, FALSE);
+        }
+        if (self->buf.len > self->pos) {
+            /* Give back what has been read ahead (fails for pipes) */
+            lseek(self->fd, -(off_t)(self->buf.len - self->pos), SEEK_CUR);
+        }
+    }
+    self->fd = -1;
+}
+
+static
+void
+foil_input_fd_free(
+    FoilInput* in)
+{
+    FoilInputFd* self = G_CAST(in, FoilInputFd, parent);
+
+    GASSERT(self->fd < 0);
+    foil_file_buffer_deinit(&self->buf);
+    foil_input_finalize(in);
+    g_slice_free(FoilInputFd, self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
 FoilInput*
 foil_input_file_new(
     FILE* file,
@@ -94,12 +239,58 @@ foil_input_file_new(
     return NULL;
 }
 
+/* Since 1.0.31 */
+FoilInput*
+foil_input_file_new_fd(
+    int fd,
+    guint flags,
+    gsize bufsize)
+{
+    static const FoilInputFunc foil_input_fd_fn = {
+        NULL,                       /* fn_has_available */
+        foil_input_fd_read,         /* fn_read */
+        foil_input_fd_close,        /* fn_close */
+        foil_input_fd_free          /* fn_free */
+    };
+    if (fd >= 0) {
+        FoilInputFd* self = g_slice_new0(FoilInputFd);
+        const gboolean direct = (flags & FOIL_INPUT_FILE_DIRECT) != 0;
+
+        self->fd = fd;
+        self->flags = flags & FOIL_INPUT_FILE_FD_FLAGS;
+        foil_file_buffer_init(&self->buf, bufsize, direct);
+        self->direct = direct && self->buf.aligned &&
+            foil_file_set_direct(fd, TRUE);
+        foil_file_advise_sequential(fd);
+        return foil_input_init(&self->parent, &foil_input_fd_fn);
+    } else {
+        errno = EBADF;
+    }
+    return NULL;
+}
+
 FoilInput*
 foil_input_file_new_open(
     const char* path)
+{
+    return foil_input_file_new_open_full(path, 0, 0);
+}
+
+/* Since 1.0.31 */
+FoilInput*
+foil_input_file_new_open_full(
+    const char* path,
+    guint flags,
+    gsize bufsize)
 {
     if (path) {
-        return foil_input_file_new(fopen(path, "rb"), TRUE);
+        const int fd = foil_file_open(path, O_RDONLY,
+            (flags & FOIL_INPUT_FILE_DIRECT) != 0);
+
+        if (fd >= 0) {
+            return foil_input_file_new_fd(fd, flags | FOIL_INPUT_FILE_CLOSE,
+                bufsize);
+        }
     } else {
         errno = EINVAL;
     }
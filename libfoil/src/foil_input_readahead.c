@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_input_p.h"
+
+#include <gutil_macros.h>
+
+#include <string.h>
+
+#include "foil_log_p.h"
+
+/*
+ * Reads the wrapped stream on a helper thread into a bounded ring of
+ * buffers, so that whatever the wrapped stream is doing (decryption,
+ * base64 decoding, digesting, file I/O) runs in parallel with whatever
+ * the caller is doing with the data. Once wrapped, the source stream
+ * belongs to the helper thread and must not be touched by anyone else.
+ */
+
+#define FOIL_INPUT_READAHEAD_DEFAULT_CHUNK  (0x10000)
+#define FOIL_INPUT_READAHEAD_DEFAULT_DEPTH  (4)
+
+typedef struct foil_input_readahead {
+    FoilInput parent;
+    FoilInput* in;
+    GThread* thread;
+    GMutex mutex;
+    GCond cond;
+    gsize chunk;
+    guint depth;
+    guint8** bufs;
+    gsize* lens;
+    guint head;         /* The oldest filled buffer */
+    guint count;        /* Number of filled buffers */
+    gsize pos;          /* Number of bytes consumed from the head buffer */
+    gboolean eof;
+    gboolean error;
+    gboolean stop;
+} FoilInputReadAhead;
+
+static
+gpointer
+foil_input_readahead_thread(
+    gpointer data)
+{
+    FoilInputReadAhead* self = data;
+
+    g_mutex_lock(&self->mutex);
+    for (;;) {
+        guint index;
+        gssize n;
+
+        while (self->count == self->depth && !self->stop) {
+            g_cond_wait(&self->cond, &self->mutex);
+        }
+        if (self->stop) {
+            break;
+        }
+        index = (self->head + self->count) % self->depth;
+        g_mutex_unlock(&self->mutex);
+
+        /* Nobody else is touching this buffer */
+        n = foil_input_read(self->in, self->bufs[index], self->chunk);
+
+        g_mutex_lock(&self->mutex);
+        if (n > 0) {
+            self->lens[index] = n;
+            self->count++;
+        } else {
+            self->eof = TRUE;
+            self->error = (n < 0);
+        }
+        g_cond_broadcast(&self->cond);
+        if (self->eof) {
+            break;
+        }
+    }
+    g_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+static
+gssize
+foil_input_readahead_read(
+    FoilInput* in,
+    void* buf,
+    gsize size)
+{
+    FoilInputReadAhead* self = G_CAST(in, FoilInputReadAhead, parent);
+    guint8* ptr = buf;
+    gsize total = 0;
+
+    while (total < size) {
+        guint index;
+        gsize n;
+
+        g_mutex_lock(&self->mutex);
+        while (!self->count && !self->eof) {
+            g_cond_wait(&self->cond, &self->mutex);
+        }
+        if (!self->count) {
+            const gboolean error = self->error;
+
+            g_mutex_unlock(&self->mutex);
+            return (error && !total) ? -1 : (gssize)total;
+        }
+        index = self->head;
+        g_mutex_unlock(&self->mutex);
+
+        /* The head buffer stays ours until we release it */
+        n = MIN(self->lens[index] - self->pos, size - total);
+        if (ptr) {
+            memcpy(ptr + total, self->bufs[index] + self->pos, n);
+        }
+        self->pos += n;
+        total += n;
+        if (self->pos == self->lens[index]) {
+            g_mutex_lock(&self->mutex);
+            self->head = (self->head + 1) % self->depth;
+            self->count--;
+            self->pos = 0;
+            g_cond_broadcast(&self->cond);
+            g_mutex_unlock(&self->mutex);
+        }
+    }
+    return total;
+}
+
+static
+void
+foil_input_readahead_close(
+    FoilInput* in)
+{
+    FoilInputReadAhead* self = G_CAST(in, FoilInputReadAhead, parent);
+
+    g_mutex_lock(&self->mutex);
+    self->stop = TRUE;
+    g_cond_broadcast(&self->cond);
+    g_mutex_unlock(&self->mutex);
+    g_thread_join(self->thread);
+    self->thread = NULL;
+    foil_input_unref(self->in);
+    self->in = NULL;
+}
+
+static
+void
+foil_input_readahead_free(
+    FoilInput* in)
+{
+    FoilInputReadAhead* self = G_CAST(in, FoilInputReadAhead, parent);
+    guint i;
+
+    GASSERT(!self->in);
+    GASSERT(!self->thread);
+    for (i = 0; i < self->depth; i++) {
+        g_free(self->bufs[i]);
+    }
+    g_free(self->bufs);
+    g_free(self->lens);
+    g_cond_clear(&self->cond);
+    g_mutex_clear(&self->mutex);
+    foil_input_finalize(in);
+    gutil_slice_free(self);
+}
+
+/* Since 1.0.31 */
+FoilInput*
+foil_input_readahead_new(
+    FoilInput* in,
+    gsize chunk,
+    guint depth)
+{
+    static const FoilInputFunc foil_input_readahead_fn = {
+        NULL,                           /* fn_has_available */
+        foil_input_readahead_read,      /* fn_read */
+        foil_input_readahead_close,     /* fn_close */
+        foil_input_readahead_free       /* fn_free */
+    };
+    if (G_LIKELY(in)) {
+        FoilInputReadAhead* self = g_slice_new0(FoilInputReadAhead);
+        GError* error = NULL;
+        guint i;
+
+        self->in = foil_input_ref(in);
+        self->chunk = chunk ? chunk : FOIL_INPUT_READAHEAD_DEFAULT_CHUNK;
+        self->depth = depth ? depth : FOIL_INPUT_READAHEAD_DEFAULT_DEPTH;
+        self->bufs = g_new(guint8*, self->depth);
+        self->lens = g_new0(gsize, self->depth);
+        for (i = 0; i < self->depth; i++) {
+            self->bufs[i] = g_malloc(self->chunk);
+        }
+        g_mutex_init(&self->mutex);
+        g_cond_init(&self->cond);
+        self->thread = g_thread_try_new("foil-readahead",
+            foil_input_readahead_thread, self, &error);
+        if (self->thread) {
+            return foil_input_init(&self->parent, &foil_input_readahead_fn);
+        }
+
+        /* No thread, no read-ahead */
+        GWARN("Failed to start read-ahead thread: %s", GERRMSG(error));
+        g_error_free(error);
+        foil_input_unref(self->in);
+        self->in = NULL;
+        foil_input_readahead_free(&self->parent);
+        return foil_input_ref(in);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,328 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_input_p.h"
+#include "foil_uring_p.h"
+#include "foil_file_p.h"
+
+#include <gutil_macros.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+#include "foil_log_p.h"
+
+/*
+ * io_uring based input. Up to depth reads are kept in flight, each
+ * one into its own registered buffer. Buffers are consumed in order
+ * of file offsets and resubmitted as soon as they have been drained,
+ * so that the consumer keeps processing one chunk while the kernel is
+ * fetching the next ones.
+ */
+
+typedef struct foil_input_uring_slot {
+    guint64 offset;     /* File offset of the first byte */
+    gsize len;          /* Number of bytes received */
+    gsize pos;          /* Number of bytes consumed */
+    gboolean busy;      /* Read is in flight */
+    gboolean eof;       /* Hit the end of file */
+    int error;
+} FoilInputUringSlot;
+
+typedef struct foil_input_uring {
+    FoilInput parent;
+    int fd;
+    guint flags;
+    FoilUring* ring;
+    gsize bufsize;
+    guint depth;
+    guint current;
+    guint64 start;
+    guint64 consumed;
+    guint64 next_offset;
+    gboolean eof;
+    FoilInputUringSlot* slots;
+} FoilInputUring;
+
+static
+void
+foil_input_uring_submit(
+    FoilInputUring* self,
+    guint index)
+{
+    FoilInputUringSlot* slot = self->slots + index;
+
+    GASSERT(!slot->busy);
+    if (foil_uring_read(self->ring, self->fd, index, slot->len,
+        self->bufsize - slot->len, slot->offset + slot->len)) {
+        slot->busy = TRUE;
+    } else {
+        slot->error = EIO;
+    }
+}
+
+static
+void
+foil_input_uring_start(
+    FoilInputUring* self,
+    guint index)
+{
+    FoilInputUringSlot* slot = self->slots + index;
+
+    slot->len = slot->pos = 0;
+    if (self->eof) {
+        /* Nothing to read beyond the end of file */
+        slot->eof = TRUE;
+    } else {
+        slot->offset = self->next_offset;
+        self->next_offset += self->bufsize;
+        foil_input_uring_submit(self, index);
+    }
+}
+
+static
+gboolean
+foil_input_uring_complete(
+    FoilInputUring* self)
+{
+    guint index;
+    int res;
+
+    if (foil_uring_wait(self->ring, &index, &res) && index < self->depth) {
+        FoilInputUringSlot* slot = self->slots + index;
+
+        slot->busy = FALSE;
+        if (res > 0) {
+            slot->len += res;
+            if (slot->len < self->bufsize) {
+                /* Short read, ask for the rest */
+                foil_input_uring_submit(self, index);
+            }
+        } else if (!res) {
+            slot->eof = TRUE;
+            self->eof = TRUE;
+        } else if (res == -EINTR || res == -EAGAIN) {
+            foil_input_uring_submit(self, index);
+        } else {
+            slot->error = -res;
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+void
+foil_input_uring_drain(
+    FoilInputUring* self)
+{
+    guint i;
+
+    for (i = 0; i < self->depth; i++) {
+        while (self->slots[i].busy) {
+            if (!foil_input_uring_complete(self)) {
+                return;
+            }
+        }
+    }
+}
+
+static
+gssize
+foil_input_uring_read(
+    FoilInput* in,
+    void* data,
+    gsize size)
+{
+    FoilInputUring* self = G_CAST(in, FoilInputUring, parent);
+    guint8* ptr = data;
+    gsize total = 0;
+
+    while (total < size) {
+        FoilInputUringSlot* slot = self->slots + self->current;
+        gsize available;
+
+        while (slot->busy) {
+            if (!foil_input_uring_complete(self)) {
+                return total ? (gssize)total : -1;
+            }
+        }
+        if (slot->error) {
+            errno = slot->error;
+            return total ? (gssize)total : -1;
+        }
+        available = slot->len - slot->pos;
+        if (available) {
+            const gsize n = MIN(available, size - total);
+
+            if (ptr) {
+                memcpy(ptr + total, foil_uring_buffer(self->ring,
+                    self->current) + slot->pos, n);
+            }
+            slot->pos += n;
+            total += n;
+        } else if (slot->eof) {
+            break;
+        } else {
+            /* This one has been drained, refill it and move on */
+            foil_input_uring_start(self, self->current);
+            self->current = (self->current + 1) % self->depth;
+        }
+    }
+    self->consumed += total;
+    return total;
+}
+
+static
+void
+foil_input_uring_close(
+    FoilInput* in)
+{
+    FoilInputUring* self = G_CAST(in, FoilInputUring, parent);
+
+    foil_input_uring_drain(self);
+    if (self->flags & FOIL_INPUT_FILE_CLOSE) {
+        close(self->fd);
+    } else {
+        /* Leave the descriptor positioned right after the consumed data */
+        lseek(self->fd, self->start + self->consumed, SEEK_SET);
+    }
+    self->fd = -1;
+}
+
+static
+void
+foil_input_uring_free(
+    FoilInput* in)
+{
+    FoilInputUring* self = G_CAST(in, FoilInputUring, parent);
+
+    GASSERT(self->fd < 0);
+    foil_uring_free(self->ring);
+    g_free(self->slots);
+    foil_input_finalize(in);
+    gutil_slice_free(self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+/* Since 1.0.31 */
+FoilInput*
+foil_input_uring_new(
+    int fd,
+    guint flags,
+    gsize bufsize,
+    guint depth)
+{
+    if (fd >= 0) {
+        const gint64 start = lseek(fd, 0, SEEK_CUR);
+
+        if (!bufsize) {
+            bufsize = FOIL_FILE_DEFAULT_BUFFER_SIZE;
+        } else if (bufsize > FOIL_URING_MAX_BUFFER_SIZE) {
+            bufsize = FOIL_URING_MAX_BUFFER_SIZE;
+        }
+        if (!depth) {
+            depth = FOIL_URING_DEFAULT_DEPTH;
+        } else if (depth > FOIL_URING_MAX_DEPTH) {
+            depth = FOIL_URING_MAX_DEPTH;
+        }
+
+        /* Reads are submitted at explicit offsets, fd must be seekable */
+        if (start >= 0) {
+            FoilUring* ring = foil_uring_new(depth, bufsize);
+
+            if (ring) {
+                static const FoilInputFunc foil_input_uring_fn = {
+                    NULL,                       /* fn_has_available */
+                    foil_input_uring_read,      /* fn_read */
+                    foil_input_uring_close,     /* fn_close */
+                    foil_input_uring_free       /* fn_free */
+                };
+                FoilInputUring* self = g_slice_new0(FoilInputUring);
+                guint i;
+
+                self->fd = fd;
+                self->flags = flags & FOIL_INPUT_FILE_CLOSE;
+                self->ring = ring;
+                self->bufsize = bufsize;
+                self->depth = depth;
+                self->start = self->next_offset = start;
+                self->slots = g_new0(FoilInputUringSlot, self->depth);
+                for (i = 0; i < self->depth; i++) {
+                    foil_input_uring_start(self, i);
+                }
+                return foil_input_init(&self->parent, &foil_input_uring_fn);
+            }
+        }
+
+        /* Fall back to synchronous reads */
+        return foil_input_file_new_fd(fd, flags, bufsize);
+    } else {
+        errno = EBADF;
+    }
+    return NULL;
+}
+
+/* Since 1.0.31 */
+FoilInput*
+foil_input_uring_new_open(
+    const char* path)
+{
+    if (path) {
+        const int fd = foil_file_open(path, O_RDONLY, FALSE);
+
+        if (fd >= 0) {
+            return foil_input_uring_new(fd, FOIL_INPUT_FILE_CLOSE, 0, 0);
+        }
+    } else {
+        errno = EINVAL;
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
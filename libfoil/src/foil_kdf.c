@@ -35,6 +35,7 @@
 #include "foil_kdf.h"
 #include "foil_hmac.h"
 #include "foil_digest.h"
+#include "foil_stats_p.h"
 
 /*
  * KDF: Key Derivation Functions (RFC 2898)
@@ -64,8 +65,9 @@
  *
  * Output:         DK         derived key, a dkLen-octet string
  */
+static
 GBytes*
-foil_kdf_pbkdf2(
+foil_kdf_pbkdf2_run(
     GType digest,   /* HMAC digest algorithm, e.g. FOIL_DIGEST_SHA1 */
     const char* pw, /* UTF-8 encoded password from which to derive the key */
     gssize pwlen,   /* Negative to strlen() the password */
@@ -178,6 +180,142 @@ foil_kdf_pbkdf2(
     }
 }
 
+/*
+ * RFC 5869
+ *
+ * 2.2. Step 1: Extract
+ *
+ *    PRK = HMAC-Hash(salt, IKM)
+ *
+ *    salt     optional salt value (a non-secret random value);
+ *             if not provided, it is set to a string of HashLen zeros.
+ *
+ * 2.3. Step 2: Expand
+ *
+ *    N = ceil(L/HashLen)
+ *    T = T(1) | T(2) | T(3) | ... | T(N)
+ *    OKM = first L octets of T
+ *
+ *    where:
+ *    T(0) = empty string (zero length)
+ *    T(1) = HMAC-Hash(PRK, T(0) | info | 0x01)
+ *    T(2) = HMAC-Hash(PRK, T(1) | info | 0x02)
+ *    ...
+ *
+ * HMAC pads the key with zeros, so the missing salt is the same
+ * thing as the empty one.
+ */
+static
+GBytes*
+foil_kdf_hkdf_run(
+    GType digest,
+    const FoilBytes* ikm,
+    const FoilBytes* salt,
+    const FoilBytes* info,
+    guint dlen)
+{
+    const gsize hlen = foil_digest_type_size(digest);
+    const gsize dklen = dlen ? dlen : hlen;
+
+    if (ikm && hlen && dklen <= 255 * hlen) {
+        FoilHmac* hmac = foil_hmac_new(digest, salt ? salt->val : NULL,
+            salt ? salt->len : 0);
+        GBytes* prk_bytes;
+        const guint8* prk;
+        guint8* okm = g_malloc(dklen);
+        gsize offset = 0;
+        guint8 i = 1;
+
+        /* Extract */
+        foil_hmac_update(hmac, ikm->val, ikm->len);
+        prk_bytes = foil_hmac_free_to_bytes(hmac);
+        prk = g_bytes_get_data(prk_bytes, NULL);
+
+        /* Expand */
+        hmac = foil_hmac_new(digest, prk, hlen);
+        while (offset < dklen) {
+            FoilHmac* prf = foil_hmac_clone(hmac);
+            const gsize blocklen = MIN(dklen - offset, hlen);
+
+            if (offset) {
+                /* T(i-1) */
+                foil_hmac_update(prf, okm + offset - hlen, hlen);
+            }
+            if (info) {
+                foil_hmac_update(prf, info->val, info->len);
+            }
+            foil_hmac_update(prf, &i, 1);
+            memcpy(okm + offset, g_bytes_get_data(foil_hmac_finish(prf),
+                NULL), blocklen);
+            foil_hmac_unref(prf);
+            offset += blocklen;
+            i++;
+        }
+
+        foil_hmac_unref(hmac);
+        g_bytes_unref(prk_bytes);
+        return g_bytes_new_take(okm, dklen);
+    }
+    return NULL;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+static
+void
+foil_kdf_stats_end(
+    GType digest,
+    const char* op,
+    GBytes* key,
+    gint64 start)
+{
+    /* Failures (e.g. invalid digest type) aren't counted */
+    if (key) {
+        foil_stats_end(FOIL_STATS_KDF, GSIZE_TO_POINTER(digest),
+            foil_digest_type_name(digest), op, g_bytes_get_size(key), start);
+    }
+}
+
+GBytes*
+foil_kdf_pbkdf2(
+    GType digest,
+    const char* pw,
+    gssize pwlen,
+    const FoilBytes* salt,
+    guint iter,
+    guint dlen)
+{
+    if (FOIL_STATS_ACTIVE()) {
+        const gint64 start = foil_stats_begin();
+        GBytes* key = foil_kdf_pbkdf2_run(digest, pw, pwlen, salt, iter,
+            dlen);
+
+        foil_kdf_stats_end(digest, "pbkdf2", key, start);
+        return key;
+    }
+    return foil_kdf_pbkdf2_run(digest, pw, pwlen, salt, iter, dlen);
+}
+
+GBytes*
+foil_kdf_hkdf(
+    GType digest,
+    const FoilBytes* ikm,
+    const FoilBytes* salt,
+    const FoilBytes* info,
+    guint dlen) /* Since 1.0.31 */
+{
+    if (FOIL_STATS_ACTIVE()) {
+        const gint64 start = foil_stats_begin();
+        GBytes* key = foil_kdf_hkdf_run(digest, ikm, salt, info, dlen);
+
+        foil_kdf_stats_end(digest, "hkdf", key, start);
+        return key;
+    }
+    return foil_kdf_hkdf_run(digest, ikm, salt, info, dlen);
+}
+
 /*
  * Local Variables:
  * mode: C
@@ -494,6 +494,26 @@ foil_key_generate_new(
     return key;
 }
 
+FoilKey*
+foil_key_generate_new_full(
+    GType type,
+    guint bits,
+    GHashTable* param) /* Since 1.0.31 */
+{
+    FoilKey* key = NULL;
+    FoilKeyClass* klass = foil_key_class_ref(type);
+    if (G_LIKELY(klass)) {
+        if (klass->fn_generate_full) {
+            key = klass->fn_generate_full(klass, bits, param);
+        } else if (G_LIKELY(klass->fn_generate)) {
+            /* No parameters for this kind of keys */
+            key = klass->fn_generate(klass, bits);
+        }
+        g_type_class_unref(klass);
+    }
+    return key;
+}
+
 static
 GBytes*
 foil_key_default_fingerprint(
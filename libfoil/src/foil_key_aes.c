@@ -35,6 +35,8 @@
 #include "foil_input.h"
 #include "foil_util.h"
 
+#include <gutil_misc.h>
+
 /* Logging */
 #define GLOG_MODULE_NAME foil_log_key
 #include "foil_log_p.h"
@@ -235,6 +237,31 @@ foil_key_aes_to_bytes(
     return NULL;
 }
 
+static
+FoilKey*
+foil_key_aes_new_iv(
+    FoilKeyAes* self,
+    const void* iv)
+{
+    FoilKey* key = foil_key_aes_new(FOIL_KEY_AES_GET_CLASS(self), iv,
+        self->key);
+    FoilKeyAes* aes = FOIL_KEY_AES_(key);
+    guint i;
+
+    /* Same key bytes, same key schedules */
+    for (i = 0; i < G_N_ELEMENTS(self->schedule); i++) {
+        gconstpointer schedule = g_atomic_pointer_get(self->schedule + i);
+
+        if (schedule) {
+            const gsize size = self->schedule_size[i];
+
+            aes->schedule[i] = gutil_memdup(schedule, size);
+            aes->schedule_size[i] = size;
+        }
+    }
+    return key;
+}
+
 static
 FoilKey*
 foil_key_aes_set_iv(
@@ -245,15 +272,13 @@ foil_key_aes_set_iv(
     if (len == FOIL_AES_BLOCK_SIZE) {
         FoilKeyAes* self = FOIL_KEY_AES_(key);
         if (iv) {
-            return foil_key_aes_new(FOIL_KEY_AES_GET_CLASS(self),
-                iv, self->key);
+            return foil_key_aes_new_iv(self, iv);
         } else {
             /* Zero the IV */
             guint i;
             for (i = 0; i < FOIL_AES_BLOCK_SIZE; i++) {
                 if (self->iv[i]) {
-                    return foil_key_aes_new(FOIL_KEY_AES_GET_CLASS(self),
-                        NULL, self->key);
+                    return foil_key_aes_new_iv(self, NULL);
                 }
             }
             /* IV is already zero, there's nothing to do */
@@ -263,6 +288,51 @@ foil_key_aes_set_iv(
     return NULL;
 }
 
+gconstpointer
+foil_key_aes_schedule(
+    FoilKeyAes* self,
+    FOIL_KEY_AES_SCHEDULE_TYPE type,
+    gsize size,
+    FoilKeyAesScheduleFunc expand)
+{
+    gpointer* ptr = self->schedule + type;
+
+    if (!g_atomic_pointer_get(ptr)) {
+        gpointer schedule = g_malloc(size);
+
+        expand(self, schedule);
+        /*
+         * Same thing as with the fingerprint - the first one wins.
+         * The size is the same for all contenders, it's safe to
+         * store it before the pointer.
+         */
+        self->schedule_size[type] = size;
+        if (!g_atomic_pointer_compare_and_exchange(ptr, NULL, schedule)) {
+            memset(schedule, 0, size);
+            g_free(schedule);
+        }
+    }
+    return g_atomic_pointer_get(ptr);
+}
+
+static
+void
+foil_key_aes_finalize(
+    GObject* object)
+{
+    FoilKeyAes* self = FOIL_KEY_AES_(object);
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(self->schedule); i++) {
+        if (self->schedule[i]) {
+            /* Don't leave the expanded key lying around */
+            memset(self->schedule[i], 0, self->schedule_size[i]);
+            g_free(self->schedule[i]);
+        }
+    }
+    G_OBJECT_CLASS(foil_key_aes_parent_class)->finalize(object);
+}
+
 static
 void
 foil_key_aes_init(
@@ -281,6 +351,7 @@ foil_key_aes_class_init(
     key_class->fn_from_data = foil_key_aes_from_data_any;
     key_class->fn_to_bytes = foil_key_aes_to_bytes;
     key_class->fn_set_iv = foil_key_aes_set_iv;
+    G_OBJECT_CLASS(klass)->finalize = foil_key_aes_finalize;
 }
 
 /* AES128 */
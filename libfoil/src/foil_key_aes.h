@@ -40,12 +40,31 @@ typedef struct foil_key_aes_class {
     guint size;  /* 16, 24 or 32 (bytes) */
 } FoilKeyAesClass;
 
+/*
+ * Expanded key schedules are computed on demand by the cipher
+ * implementation and cached by the (otherwise immutable) key object.
+ * Their format is opaque to the key.
+ */
+typedef enum foil_key_aes_schedule_type {
+    FOIL_KEY_AES_SCHEDULE_ENCRYPT,
+    FOIL_KEY_AES_SCHEDULE_DECRYPT,
+    FOIL_KEY_AES_SCHEDULE_COUNT
+} FOIL_KEY_AES_SCHEDULE_TYPE;
+
 typedef struct foil_key_aes {
     FoilKey super;
     guint8 iv[FOIL_AES_BLOCK_SIZE];
     guint8* key;  /* klass->size bytes */
+    gpointer schedule[FOIL_KEY_AES_SCHEDULE_COUNT];
+    gsize schedule_size[FOIL_KEY_AES_SCHEDULE_COUNT];
 } FoilKeyAes;
 
+typedef
+void
+(*FoilKeyAesScheduleFunc)(
+    FoilKeyAes* key,
+    gpointer schedule);
+
 #define FOIL_KEY_AES_(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, \
         FOIL_TYPE_KEY_AES, FoilKeyAes))
 #define FOIL_KEY_AES_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST((klass), \
@@ -55,6 +74,14 @@ typedef struct foil_key_aes {
 #define FOIL_IS_AES_KEY(obj) G_TYPE_CHECK_INSTANCE_TYPE(obj, \
         FOIL_TYPE_KEY_AES)
 
+gconstpointer
+foil_key_aes_schedule(
+    FoilKeyAes* key,
+    FOIL_KEY_AES_SCHEDULE_TYPE type,
+    gsize size,
+    FoilKeyAesScheduleFunc expand)
+    FOIL_INTERNAL;
+
 #endif /* FOIL_KEY_AES_H */
 
 /*
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_KEY_ED25519_P_H
+#define FOIL_KEY_ED25519_P_H
+
+#include "foil_private_key_p.h"
+#include "foil_key_ed25519.h"
+#include "foil_key_rsa.h"
+
+typedef struct foil_key_ed25519_public_class FoilKeyEd25519PublicClass;
+typedef struct foil_key_ed25519_private_class FoilKeyEd25519PrivateClass;
+
+typedef struct foil_key_ed25519_public {
+    FoilKey super;
+    guint8 pub[FOIL_ED25519_KEY_SIZE];
+} FoilKeyEd25519Public;
+
+struct foil_key_ed25519_public_class {
+    FoilKeyClass key;
+    gboolean (*fn_verify)(FoilKeyEd25519Public* key, const void* data,
+        gsize len, const guint8* sig);
+};
+
+typedef struct foil_key_ed25519_private {
+    FoilPrivateKey super;
+    guint8 seed[FOIL_ED25519_KEY_SIZE];
+    guint8 pub[FOIL_ED25519_KEY_SIZE];
+} FoilKeyEd25519Private;
+
+struct foil_key_ed25519_private_class {
+    FoilPrivateKeyClass key;
+    /* Derives the public key from the seed */
+    gboolean (*fn_init)(FoilKeyEd25519Private* key);
+    GBytes* (*fn_sign)(FoilKeyEd25519Private* key, const void* data,
+        gsize len);
+};
+
+#define FOIL_KEY_ED25519_PUBLIC_(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, \
+        FOIL_TYPE_KEY_ED25519_PUBLIC, FoilKeyEd25519Public))
+#define FOIL_KEY_ED25519_PUBLIC_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST((klass),\
+        FOIL_TYPE_KEY_ED25519_PUBLIC, FoilKeyEd25519PublicClass))
+#define FOIL_KEY_ED25519_PUBLIC_GET_CLASS(obj) G_TYPE_INSTANCE_GET_CLASS(obj,\
+        FOIL_TYPE_KEY_ED25519_PUBLIC, FoilKeyEd25519PublicClass)
+#define FOIL_KEY_ED25519_PRIVATE_(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, \
+        FOIL_TYPE_KEY_ED25519_PRIVATE, FoilKeyEd25519Private))
+#define FOIL_KEY_ED25519_PRIVATE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST(\
+        (klass), FOIL_TYPE_KEY_ED25519_PRIVATE, FoilKeyEd25519PrivateClass))
+#define FOIL_KEY_ED25519_PRIVATE_GET_CLASS(obj) G_TYPE_INSTANCE_GET_CLASS(\
+        obj, FOIL_TYPE_KEY_ED25519_PRIVATE, FoilKeyEd25519PrivateClass)
+
+extern const FoilBytes foil_ssh_ed25519_mark FOIL_INTERNAL;
+
+/* string "ssh-ed25519" string key */
+gboolean
+foil_key_ed25519_write_ssh(
+    FoilOutput* out,
+    const guint8* pub)
+    FOIL_INTERNAL;
+
+GBytes*
+foil_key_ed25519_ssh_bytes(
+    const guint8* pub)
+    FOIL_INTERNAL;
+
+gboolean
+foil_key_ed25519_parse_ssh_binary(
+    const FoilBytes* data,
+    guint8* pub)
+    FOIL_INTERNAL;
+
+GBytes*
+foil_key_ed25519_fingerprint(
+    const guint8* pub)
+    FOIL_INTERNAL;
+
+/* openssh-key-v1 container (the public part is always in the clear) */
+gboolean
+foil_key_ed25519_parse_openssh_binary(
+    const FoilBytes* data,
+    guint8* pub,
+    FoilKeyRsaOpensshPrivData* priv)
+    FOIL_INTERNAL;
+
+gboolean
+foil_key_ed25519_parse_openssh_text(
+    const FoilBytes* data,
+    guint8* pub,
+    FoilKeyRsaOpensshPrivData* priv,
+    FoilPool* pool)
+    FOIL_INTERNAL;
+
+void
+foil_key_ed25519_public_set_data(
+    FoilKeyEd25519Public* key,
+    const guint8* pub)
+    FOIL_INTERNAL;
+
+#endif /* FOIL_KEY_ED25519_P_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,680 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_key_ed25519_p.h"
+#include "foil_random.h"
+#include "foil_output.h"
+#include "foil_input.h"
+#include "foil_asn1_p.h"
+#include "foil_pool.h"
+#include "foil_util_p.h"
+#include "foil_oid.h"
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_key
+#include "foil_log_p.h"
+
+G_DEFINE_ABSTRACT_TYPE(FoilKeyEd25519Private, foil_key_ed25519_private,
+        FOIL_TYPE_PRIVATE_KEY);
+
+#define foil_key_ed25519_private_write_data(out,data) \
+    foil_output_write(out, (data)->val, (data)->len)
+#define foil_key_ed25519_private_write_all(out,data) \
+    foil_output_write_all(out, (data)->val, (data)->len)
+
+#define OPENSSH_PLAINTEXT_ALIGN (8)
+#define PKCS8_ED25519_VERSION (0)
+#define PKCS8_ED25519_VERSION_2 (1) /* RFC 5958 OneAsymmetricKey */
+
+/*
+ * PrivateKeyInfo (RFC 8410) is fixed size, all that changes is
+ * the last 32 bytes (the seed):
+ *
+ * SEQUENCE {
+ *   INTEGER 0
+ *   SEQUENCE {
+ *     OBJECT IDENTIFIER 1.3.101.112
+ *   }
+ *   OCTET STRING {
+ *     OCTET STRING (32 bytes)
+ *   }
+ * }
+ */
+static const guint8 ed25519_pkcs8_prefix[] = {
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    3 + ASN1_OID_ED25519_LENGTH + 4 + FOIL_ED25519_KEY_SIZE + 4,
+    ASN1_TAG_INTEGER, 1, PKCS8_ED25519_VERSION,
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    ASN1_OID_ED25519_LENGTH + 2,
+    ASN1_TAG_OBJECT_ID,
+    ASN1_OID_ED25519_LENGTH,
+    ASN1_OID_ED25519_BYTES,
+    ASN1_TAG_OCTET_STRING,
+    FOIL_ED25519_KEY_SIZE + 2,
+    ASN1_TAG_OCTET_STRING,
+    FOIL_ED25519_KEY_SIZE
+};
+
+static const guint8 ed25519_private_pkcs8_prefix_data[] = {
+    '-','-','-','-','-','B','E','G','I','N',' ','P','R','I','V','A',
+    'T','E',' ','K','E','Y','-','-','-','-','-'
+};
+static const guint8 ed25519_private_pkcs8_suffix_data[] = {
+    '-','-','-','-','-','E','N','D',' ','P','R','I','V','A','T','E',
+    ' ','K','E','Y','-','-','-','-','-'
+};
+static const FoilBytes ed25519_private_pkcs8_prefix = {
+    FOIL_ARRAY_AND_SIZE(ed25519_private_pkcs8_prefix_data)
+};
+static const FoilBytes ed25519_private_pkcs8_suffix = {
+    FOIL_ARRAY_AND_SIZE(ed25519_private_pkcs8_suffix_data)
+};
+
+static const guint8 openssh_none_data[] = {'n','o','n','e' };
+static const FoilBytes openssh_none = {
+    FOIL_ARRAY_AND_SIZE(openssh_none_data)
+};
+
+/*
+ * PKCS #8
+ *
+ * https://tools.ietf.org/html/rfc8410 (Section 7)
+ *
+ * OneAsymmetricKey ::= SEQUENCE {
+ *     version                   Version,
+ *     privateKeyAlgorithm       PrivateKeyAlgorithmIdentifier,
+ *     privateKey                PrivateKey,
+ *     attributes            [0] Attributes OPTIONAL,
+ *     ...,
+ *     [[2: publicKey        [1] PublicKey OPTIONAL ]],
+ *     ...
+ * }
+ *
+ * PrivateKey is an OCTET STRING wrapping CurvePrivateKey, which
+ * is an OCTET STRING too. Optional parts are ignored.
+ */
+static
+gboolean
+foil_key_ed25519_private_parse_pkcs8(
+    guint8* seed,
+    const FoilBytes* data)
+{
+    static const guint8 oid_ed25519_bytes[] = { ASN1_OID_ED25519_BYTES };
+    static const FoilBytes oid_ed25519 = {
+        FOIL_ARRAY_AND_SIZE(oid_ed25519_bytes)
+    };
+    GUtilRange pos;
+
+    foil_parse_init_data(&pos, data);
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
+        gint32 version;
+        GUtilRange aid;
+        FoilBytes oid, priv;
+
+        if (foil_asn1_parse_int32(&pos, &version) &&
+            (version == PKCS8_ED25519_VERSION ||
+             version == PKCS8_ED25519_VERSION_2) &&
+            foil_asn1_parse_sequence(&pos, &aid) &&
+            foil_asn1_parse_object_id(&aid, &oid) &&
+            foil_bytes_equal(&oid, &oid_ed25519) && aid.ptr == aid.end &&
+            foil_asn1_parse_octet_string(&pos, &priv)) {
+            GUtilRange key;
+            FoilBytes bytes;
+
+            foil_parse_init_data(&key, &priv);
+            if (foil_asn1_parse_octet_string(&key, &bytes) &&
+                bytes.len == FOIL_ED25519_KEY_SIZE && key.ptr == key.end) {
+                memcpy(seed, bytes.val, bytes.len);
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_ed25519_private_parse_text_pkcs8(
+    guint8* seed,
+    const FoilBytes* data)
+{
+    gboolean ok = FALSE;
+    const guint8* start = foil_memmem(data, &ed25519_private_pkcs8_prefix);
+
+    if (start) {
+        GUtilRange pos;
+
+        pos.ptr = start + ed25519_private_pkcs8_prefix.len;
+        pos.end = data->val + data->len;
+        if (foil_parse_skip_to_next_line(&pos, TRUE)) {
+            GBytes* decoded = foil_parse_base64(&pos,
+                FOIL_INPUT_BASE64_IGNORE_SPACES |
+                FOIL_INPUT_BASE64_STANDARD);
+
+            if (decoded) {
+                if (foil_parse_skip_bytes(&pos,
+                    &ed25519_private_pkcs8_suffix)) {
+                    FoilBytes b;
+
+                    /* And ignore the rest */
+                    ok = foil_key_ed25519_private_parse_pkcs8(seed,
+                        foil_bytes_from_data(&b, decoded));
+                }
+                g_bytes_unref(decoded);
+            }
+        }
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_private_check_openssh_padding(
+    GUtilRange* pos)
+{
+    guint8 counter = 1;
+
+    while (pos->ptr < pos->end) {
+        if (*pos->ptr++ != counter++) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*
+ * uint32    check1
+ * uint32    check2
+ * string    "ssh-ed25519"
+ * string    public key (32 bytes)
+ * string    private key (64 bytes, seed followed by the public key)
+ * string    comment
+ * byte[]    padding 1, 2, 3...
+ */
+static
+gboolean
+foil_key_ed25519_private_decode_openssh_plaintext(
+    guint8* seed,
+    const guint8* pub,
+    const FoilBytes* data)
+{
+    guint32 check1, check2;
+    FoilBytes keytype, pubkey, privkey, comment;
+    GUtilRange pos;
+
+    foil_parse_init_data(&pos, data);
+    if (foil_key_rsa_parse_n(&pos, &check1) &&
+        foil_key_rsa_parse_n(&pos, &check2) &&
+        check1 == check2 &&
+        foil_key_rsa_parse_n_bytes(&pos, &keytype) &&
+        foil_bytes_equal(&keytype, &foil_ssh_ed25519_mark) &&
+        foil_key_rsa_parse_n_bytes(&pos, &pubkey) &&
+        foil_key_rsa_parse_n_bytes(&pos, &privkey) &&
+        foil_key_rsa_parse_n_bytes(&pos, &comment) &&
+        foil_key_ed25519_private_check_openssh_padding(&pos) &&
+        pubkey.len == FOIL_ED25519_KEY_SIZE &&
+        privkey.len == 2 * FOIL_ED25519_KEY_SIZE &&
+        !memcmp(pubkey.val, pub, FOIL_ED25519_KEY_SIZE) &&
+        !memcmp(privkey.val + FOIL_ED25519_KEY_SIZE, pub,
+            FOIL_ED25519_KEY_SIZE)) {
+        memcpy(seed, privkey.val, FOIL_ED25519_KEY_SIZE);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_ed25519_private_decode_openssh(
+    guint8* seed,
+    const guint8* pub,
+    const FoilKeyRsaOpensshPrivData* priv,
+    const char* pass,
+    GError** error)
+{
+    if (foil_bytes_equal(&priv->kdfname, &openssh_none)) {
+        /* Private part is not encrypted */
+        if (foil_bytes_equal(&priv->ciphername, &openssh_none) &&
+            foil_key_ed25519_private_decode_openssh_plaintext(seed, pub,
+            &priv->data)) {
+            return TRUE;
+        } else if (error && !*error) {
+            *error = g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+                "Unrecognized OpenSSH key format");
+        }
+    } else if (!pass || !pass[0]) {
+        /* Private part is encrypted but there's no password */
+        if (error && !*error) {
+            *error = g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_ENCRYPTED,
+                "Key is encrypted");
+        }
+    } else if (error && !*error) {
+        *error = g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_UNKNOWN_ENCRYPTION,
+            "Encrypted Ed25519 keys are not supported");
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_ed25519_private_parse_openssh(
+    guint8* seed,
+    guint8* pub,
+    const FoilBytes* data,
+    const char* pass,
+    FoilPool* pool,
+    GError** error)
+{
+    FoilKeyRsaOpensshPrivData priv;
+
+    return (foil_key_ed25519_parse_openssh_text(data, pub, &priv, pool) ||
+        foil_key_ed25519_parse_openssh_binary(data, pub, &priv)) &&
+        foil_key_ed25519_private_decode_openssh(seed, pub, &priv, pass,
+        error);
+}
+
+static
+FoilKeyEd25519Private*
+foil_key_ed25519_private_new(
+    FoilKeyEd25519PrivateClass* klass,
+    const guint8* seed)
+{
+    FoilKeyEd25519Private* key = g_object_new(G_TYPE_FROM_CLASS(klass), NULL);
+
+    memcpy(key->seed, seed, sizeof(key->seed));
+    if (klass->fn_init(key)) {
+        return key;
+    }
+    g_object_unref(key);
+    return NULL;
+}
+
+static
+FoilKey*
+foil_key_ed25519_private_generate(
+    FoilKeyClass* klass,
+    guint bits)
+{
+    FoilKey* key = NULL;
+
+    if (bits == FOIL_KEY_BITS_DEFAULT || bits == FOIL_ED25519_KEY_BITS) {
+        guint8 seed[FOIL_ED25519_KEY_SIZE];
+
+        if (foil_random(seed, sizeof(seed))) {
+            key = (FoilKey*) foil_key_ed25519_private_new
+                (FOIL_KEY_ED25519_PRIVATE_CLASS(klass), seed);
+        }
+        memset(seed, 0, sizeof(seed));
+    } else {
+        GERR("Invalid number of bits for Ed25519 (%u)", bits);
+    }
+    return key;
+}
+
+static
+FoilKey*
+foil_key_ed25519_private_from_data(
+    FoilKeyClass* klass,
+    const void* bytes,
+    gsize size,
+    GHashTable* param,
+    GError** err)
+{
+    FoilKeyEd25519PrivateClass* ed_class =
+        FOIL_KEY_ED25519_PRIVATE_CLASS(klass);
+    FoilKeyEd25519Private* key = NULL;
+    guint8 seed[FOIL_ED25519_KEY_SIZE];
+    guint8 pub[FOIL_ED25519_KEY_SIZE];
+    gboolean have_pub = FALSE;
+    gboolean ok = FALSE;
+    const char* pw = NULL;
+    FoilBytes data;
+    FoilPool pool;
+
+    if (param) {
+        /* Extract the passphrase */
+        GVariant* var = g_hash_table_lookup(param, FOIL_KEY_PARAM_PASSPHRASE);
+
+        if (var && g_variant_is_of_type(var, G_VARIANT_TYPE_STRING)) {
+            pw = g_variant_get_string(var, NULL);
+        }
+    }
+    foil_pool_init(&pool);
+    data.val = bytes;
+    data.len = size;
+    if (foil_key_ed25519_private_parse_text_pkcs8(seed, &data) ||
+        foil_key_ed25519_private_parse_pkcs8(seed, &data)) {
+        ok = TRUE;
+    } else if (foil_key_ed25519_private_parse_openssh(seed, pub, &data, pw,
+        &pool, err)) {
+        ok = have_pub = TRUE;
+    } else if (size == FOIL_ED25519_KEY_SIZE && (!err || !*err)) {
+        /* Raw 32-byte seed (RFC 8032) */
+        memcpy(seed, bytes, size);
+        ok = TRUE;
+    }
+    foil_pool_drain(&pool);
+
+    if (ok) {
+        key = foil_key_ed25519_private_new(ed_class, seed);
+        /* Make sure that the public key matches the private one */
+        if (key && have_pub && memcmp(key->pub, pub, sizeof(pub))) {
+            GDEBUG("Ed25519 public key mismatch");
+            g_object_unref(key);
+            key = NULL;
+        }
+        if (key) {
+            g_clear_error(err);
+        }
+    }
+    if (!key && err && !*err) {
+        *err = g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+            "Unrecognized Ed25519 private key format");
+    }
+    memset(seed, 0, sizeof(seed));
+    return FOIL_KEY(key);
+}
+
+static
+GBytes*
+foil_key_ed25519_private_to_pkcs8(
+    FoilKeyEd25519Private* self)
+{
+    GByteArray* buf = g_byte_array_sized_new(sizeof(ed25519_pkcs8_prefix) +
+        sizeof(self->seed));
+
+    g_byte_array_append(buf, ed25519_pkcs8_prefix,
+        sizeof(ed25519_pkcs8_prefix));
+    g_byte_array_append(buf, self->seed, sizeof(self->seed));
+    return g_byte_array_free_to_bytes(buf);
+}
+
+static
+GBytes*
+foil_key_ed25519_private_to_openssh_private(
+    FoilKeyEd25519Private* self,
+    const char* comment)
+{
+    FoilOutput* out = foil_output_mem_new(NULL);
+    FoilBytes b;
+    guint32 check;
+    guint8 pad;
+
+    foil_random(&check, sizeof(check));
+
+    /* Memory-backed I/O never fails in a meaningful way */
+    foil_key_rsa_write_n(out, check); /* check1 */
+    foil_key_rsa_write_n(out, check); /* check2 */
+    foil_key_ed25519_write_ssh(out, self->pub); /* keytype + pubkey */
+    foil_key_rsa_write_n(out, sizeof(self->seed) + sizeof(self->pub));
+    foil_output_write(out, self->seed, sizeof(self->seed));
+    foil_output_write(out, self->pub, sizeof(self->pub));
+    b.val = (void*) comment;
+    b.len = comment ? strlen(comment) : 0;
+    foil_key_rsa_write_n_bytes(out, &b);  /* comment */
+    for (pad = 1; foil_output_bytes_written(out) % OPENSSH_PLAINTEXT_ALIGN;
+         pad++) {
+        foil_output_write(out, &pad, 1);
+    }
+    return foil_output_free_to_bytes(out);
+}
+
+static
+GBytes*
+foil_key_ed25519_private_to_openssh(
+    FoilKeyEd25519Private* self,
+    const char* comment)
+{
+    FoilOutput* out = foil_output_mem_new(NULL);
+    GBytes* data;
+    FoilBytes b;
+
+    /* Memory-backed I/O never fails in a meaningful way */
+    foil_key_ed25519_private_write_data(out, &foil_key_openssh_auth_magic);
+    foil_key_rsa_write_n_bytes(out, &openssh_none); /* ciphername */
+    foil_key_rsa_write_n_bytes(out, &openssh_none); /* kdfname */
+    foil_key_rsa_write_n(out, 0); /* kdf */
+    foil_key_rsa_write_n(out, 1); /* nkeys */
+
+    /* pubkey */
+    data = foil_key_ed25519_ssh_bytes(self->pub);
+    foil_key_rsa_write_n_bytes(out, foil_bytes_from_data(&b, data));
+    g_bytes_unref(data);
+
+    /* private part */
+    data = foil_key_ed25519_private_to_openssh_private(self, comment);
+    foil_key_rsa_write_n_bytes(out, foil_bytes_from_data(&b, data));
+    memset((void*)b.val, 0, b.len);
+    g_bytes_unref(data);
+    return foil_output_free_to_bytes(out);
+}
+
+static
+GBytes*
+foil_key_ed25519_private_to_bytes(
+    FoilKey* key,
+    FoilKeyBinaryFormat format)
+{
+    FoilKeyEd25519Private* self = FOIL_KEY_ED25519_PRIVATE_(key);
+
+    switch (format) {
+    case FOIL_KEY_BINARY_FORMAT_DEFAULT:
+        return foil_key_ed25519_private_to_pkcs8(self);
+    case FOIL_KEY_BINARY_FORMAT_OPENSSH:
+        return foil_key_ed25519_private_to_openssh(self, NULL);
+    default:
+        break;
+    }
+    /* Invalid/unsupported format */
+    return NULL;
+}
+
+static
+gboolean
+foil_key_ed25519_private_export_text(
+    FoilOutput* out,
+    GBytes* bytes,
+    const FoilBytes* prefix,
+    const FoilBytes* suffix,
+    guint line_len,
+    GError** error)
+{
+    gboolean ok = FALSE;
+
+    if (foil_key_ed25519_private_write_all(out, prefix) &&
+        foil_output_write_eol(out)) {
+        FoilOutput* base64 = foil_output_base64_new_full(out, 0, line_len);
+
+        ok = foil_output_write_bytes_all(base64, bytes) &&
+            foil_output_flush(base64) &&
+            foil_key_ed25519_private_write_all(out, suffix) &&
+            foil_output_write_eol(out);
+        foil_output_unref(base64);
+    }
+    if (!ok && error && !*error) {
+        *error = g_error_new_literal(FOIL_ERROR, FOIL_ERROR_KEY_WRITE,
+            "Output error");
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_private_export(
+    FoilKey* key,
+    FoilOutput* out,
+    FoilKeyExportFormat format,
+    GHashTable* param,
+    GError** error)
+{
+    FoilKeyEd25519Private* self = FOIL_KEY_ED25519_PRIVATE_(key);
+    const char* comment = NULL;
+    const char* passphrase = NULL;
+    GBytes* bytes = NULL;
+    gboolean ok = FALSE;
+
+    if (param) {
+        GVariant* var = g_hash_table_lookup(param, FOIL_KEY_PARAM_COMMENT);
+
+        if (var && g_variant_is_of_type(var, G_VARIANT_TYPE_STRING)) {
+            comment = g_variant_get_string(var, NULL);
+        }
+        var = g_hash_table_lookup(param, FOIL_KEY_PARAM_PASSPHRASE);
+        if (var && g_variant_is_of_type(var, G_VARIANT_TYPE_STRING)) {
+            passphrase = g_variant_get_string(var, NULL);
+        }
+    }
+    if (passphrase && passphrase[0]) {
+        if (error) {
+            g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_UNSUPPORTED,
+                "Encrypted Ed25519 keys are not supported"));
+        }
+        return FALSE;
+    }
+    switch (format) {
+    case FOIL_KEY_EXPORT_FORMAT_DEFAULT:
+    case FOIL_KEY_EXPORT_FORMAT_PKCS8:
+        bytes = foil_key_ed25519_private_to_pkcs8(self);
+        ok = foil_key_ed25519_private_export_text(out, bytes,
+            &ed25519_private_pkcs8_prefix, &ed25519_private_pkcs8_suffix,
+            64, error);
+        break;
+    case FOIL_KEY_EXPORT_FORMAT_OPENSSH:
+        bytes = foil_key_ed25519_private_to_openssh(self, comment);
+        ok = foil_key_ed25519_private_export_text(out, bytes,
+            &foil_key_openssh_text_prefix, &foil_key_openssh_text_suffix,
+            70, error);
+        break;
+    default:
+        if (error) {
+            g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+                "Unsupported export format"));
+        }
+        break;
+    }
+    if (bytes) {
+        gsize len;
+        const void* data = g_bytes_get_data(bytes, &len);
+
+        /* Don't leave the key lying around */
+        memset((void*)data, 0, len);
+        g_bytes_unref(bytes);
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_private_equal(
+    FoilKey* key1,
+    FoilKey* key2)
+{
+    GASSERT(FOIL_IS_KEY_ED25519_PRIVATE(key1));
+    if (FOIL_IS_KEY_ED25519_PRIVATE(key2)) {
+        FoilKeyEd25519Private* ed1 = FOIL_KEY_ED25519_PRIVATE_(key1);
+        FoilKeyEd25519Private* ed2 = FOIL_KEY_ED25519_PRIVATE_(key2);
+
+        return !memcmp(ed1->seed, ed2->seed, sizeof(ed1->seed));
+    }
+    return FALSE;
+}
+
+static
+GBytes*
+foil_key_ed25519_private_fingerprint(
+    FoilKey* key)
+{
+    return foil_key_ed25519_fingerprint(FOIL_KEY_ED25519_PRIVATE_(key)->pub);
+}
+
+GBytes*
+foil_ed25519_sign(
+    const void* data,
+    gsize len,
+    FoilPrivateKey* key) /* Since 1.0.31 */
+{
+    if (G_LIKELY(data || !len) && FOIL_IS_KEY_ED25519_PRIVATE(key)) {
+        FoilKeyEd25519Private* self = FOIL_KEY_ED25519_PRIVATE_(key);
+
+        return FOIL_KEY_ED25519_PRIVATE_GET_CLASS(self)->
+            fn_sign(self, data, len);
+    }
+    return NULL;
+}
+
+static
+void
+foil_key_ed25519_private_finalize(
+    GObject* object)
+{
+    FoilKeyEd25519Private* self = FOIL_KEY_ED25519_PRIVATE_(object);
+
+    memset(self->seed, 0, sizeof(self->seed));
+    G_OBJECT_CLASS(foil_key_ed25519_private_parent_class)->finalize(object);
+}
+
+static
+void
+foil_key_ed25519_private_init(
+    FoilKeyEd25519Private* key)
+{
+}
+
+static
+void
+foil_key_ed25519_private_class_init(
+    FoilKeyEd25519PrivateClass* klass)
+{
+    FoilKeyClass* key_class = FOIL_KEY_CLASS(klass);
+
+    key_class->fn_generate = foil_key_ed25519_private_generate;
+    key_class->fn_equal = foil_key_ed25519_private_equal;
+    key_class->fn_from_data = foil_key_ed25519_private_from_data;
+    key_class->fn_to_bytes = foil_key_ed25519_private_to_bytes;
+    key_class->fn_export = foil_key_ed25519_private_export;
+    key_class->fn_fingerprint = foil_key_ed25519_private_fingerprint;
+    G_OBJECT_CLASS(klass)->finalize = foil_key_ed25519_private_finalize;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,680 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_key_ed25519_p.h"
+#include "foil_digest.h"
+#include "foil_output.h"
+#include "foil_input.h"
+#include "foil_asn1_p.h"
+#include "foil_pool.h"
+#include "foil_util_p.h"
+#include "foil_oid.h"
+
+#include <ctype.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_key
+#include "foil_log_p.h"
+
+G_DEFINE_ABSTRACT_TYPE(FoilKeyEd25519Public, foil_key_ed25519_public,
+        FOIL_TYPE_KEY);
+
+#define foil_key_ed25519_public_write_all(out, data) \
+    foil_output_write_all(out, (data)->val, (data)->len)
+
+/*
+ * SubjectPublicKeyInfo (RFC 8410) is fixed size, all that changes
+ * is the last 32 bytes:
+ *
+ * SEQUENCE {
+ *   SEQUENCE {
+ *     OBJECT IDENTIFIER 1.3.101.112
+ *   }
+ *   BIT STRING (256 bits)
+ * }
+ */
+static const guint8 ed25519_spki_prefix[] = {
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    ASN1_OID_ED25519_LENGTH + 4 + FOIL_ED25519_KEY_SIZE + 3,
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    ASN1_OID_ED25519_LENGTH + 2,
+    ASN1_TAG_OBJECT_ID,
+    ASN1_OID_ED25519_LENGTH,
+    ASN1_OID_ED25519_BYTES,
+    ASN1_TAG_BIT_STRING,
+    FOIL_ED25519_KEY_SIZE + 1,
+    0x00 /* Unused bits */
+};
+
+/* First 120 bits of binary ssh-ed25519 prefix, BASE-64 encoded */
+static const guint8 ed25519_public_base64_prefix[] = {
+    'A','A','A','A','C','3','N','z','a','C','1','l','Z','D','I','1',
+    'N','T','E','5'
+};
+static const guint8 ssh_ed25519_mark_data[] = {
+    's','s','h','-','e','d','2','5','5','1','9'
+};
+static const guint8 ed25519_public_rfc4716_prefix_data[] = {
+    '-','-','-','-',' ','B','E','G','I','N',' ','S','S','H','2',' ',
+    'P','U','B','L','I','C',' ','K','E','Y',' ','-','-','-','-'
+};
+static const guint8 ed25519_public_rfc4716_suffix_data[] = {
+    '-','-','-','-',' ','E','N','D',' ','S','S','H','2',' ','P','U',
+    'B','L','I','C',' ','K','E','Y',' ','-','-','-','-'
+};
+static const guint8 ed25519_public_pkcs8_prefix_data[] = {
+    '-','-','-','-','-','B','E','G','I','N',' ','P','U','B','L','I',
+    'C',' ','K','E','Y','-','-','-','-','-'
+};
+static const guint8 ed25519_public_pkcs8_suffix_data[] = {
+    '-','-','-','-','-','E','N','D',' ','P','U','B','L','I','C',' ',
+    'K','E','Y','-','-','-','-','-'
+};
+
+const FoilBytes foil_ssh_ed25519_mark = {
+    FOIL_ARRAY_AND_SIZE(ssh_ed25519_mark_data)
+};
+static const FoilBytes ed25519_public_rfc4716_prefix = {
+    FOIL_ARRAY_AND_SIZE(ed25519_public_rfc4716_prefix_data)
+};
+static const FoilBytes ed25519_public_rfc4716_suffix = {
+    FOIL_ARRAY_AND_SIZE(ed25519_public_rfc4716_suffix_data)
+};
+static const FoilBytes ed25519_public_pkcs8_prefix = {
+    FOIL_ARRAY_AND_SIZE(ed25519_public_pkcs8_prefix_data)
+};
+static const FoilBytes ed25519_public_pkcs8_suffix = {
+    FOIL_ARRAY_AND_SIZE(ed25519_public_pkcs8_suffix_data)
+};
+
+void
+foil_key_ed25519_public_set_data(
+    FoilKeyEd25519Public* self,
+    const guint8* pub)
+{
+    memcpy(self->pub, pub, sizeof(self->pub));
+}
+
+gboolean
+foil_key_ed25519_write_ssh(
+    FoilOutput* out,
+    const guint8* pub)
+{
+    FoilBytes key;
+
+    /*
+     * string    "ssh-ed25519"
+     * string    key
+     */
+    key.val = pub;
+    key.len = FOIL_ED25519_KEY_SIZE;
+    return foil_key_rsa_write_n_bytes(out, &foil_ssh_ed25519_mark) &&
+        foil_key_rsa_write_n_bytes(out, &key);
+}
+
+GBytes*
+foil_key_ed25519_ssh_bytes(
+    const guint8* pub)
+{
+    GByteArray* buf = g_byte_array_sized_new(8 + foil_ssh_ed25519_mark.len +
+        FOIL_ED25519_KEY_SIZE);
+    FoilOutput* out = foil_output_mem_new(buf);
+    GBytes* bytes;
+
+    foil_key_ed25519_write_ssh(out, pub);
+    bytes = foil_output_free_to_bytes(out);
+    g_byte_array_unref(buf);
+    return bytes;
+}
+
+gboolean
+foil_key_ed25519_parse_ssh_binary(
+    const FoilBytes* data,
+    guint8* pub)
+{
+    GUtilRange pos;
+    FoilBytes mark, key;
+
+    foil_parse_init_data(&pos, data);
+    if (foil_key_rsa_parse_n_bytes(&pos, &mark) &&
+        foil_bytes_equal(&mark, &foil_ssh_ed25519_mark) &&
+        foil_key_rsa_parse_n_bytes(&pos, &key) &&
+        key.len == FOIL_ED25519_KEY_SIZE &&
+        pos.ptr == pos.end) {
+        memcpy(pub, key.val, key.len);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+GBytes*
+foil_key_ed25519_fingerprint(
+    const guint8* pub)
+{
+    GBytes* bytes = foil_key_ed25519_ssh_bytes(pub);
+    GBytes* fingerprint = foil_digest_bytes(FOIL_DIGEST_MD5, bytes);
+
+    g_bytes_unref(bytes);
+    return fingerprint;
+}
+
+gboolean
+foil_key_ed25519_parse_openssh_binary(
+    const FoilBytes* data,
+    guint8* pub,
+    FoilKeyRsaOpensshPrivData* priv)
+{
+    guint32 nkeys;
+    GUtilRange pos;
+    FoilBytes pubkey;
+
+    foil_parse_init_data(&pos, data);
+    return foil_parse_skip_bytes(&pos, &foil_key_openssh_auth_magic) &&
+        foil_key_rsa_parse_n_bytes(&pos, &priv->ciphername) &&
+        foil_key_rsa_parse_n_bytes(&pos, &priv->kdfname) &&
+        foil_key_rsa_parse_n_bytes(&pos, &priv->kdf) &&
+        foil_key_rsa_parse_n(&pos, &nkeys) && nkeys == 1 &&
+        foil_key_rsa_parse_n_bytes(&pos, &pubkey) &&
+        foil_key_ed25519_parse_ssh_binary(&pubkey, pub) &&
+        foil_key_rsa_parse_n_bytes(&pos, &priv->data) &&
+        pos.ptr == pos.end;
+}
+
+gboolean
+foil_key_ed25519_parse_openssh_text(
+    const FoilBytes* data,
+    guint8* pub,
+    FoilKeyRsaOpensshPrivData* priv,
+    FoilPool* pool)
+{
+    gboolean ok = FALSE;
+    GUtilRange pos;
+
+    foil_parse_init_data(&pos, data);
+    foil_parse_skip_spaces(&pos);
+    if (foil_parse_skip_bytes(&pos, &foil_key_openssh_text_prefix) &&
+        pos.ptr < pos.end && isspace(*pos.ptr)) {
+        GBytes* decoded = foil_parse_base64(&pos,
+            FOIL_INPUT_BASE64_IGNORE_SPACES |
+            FOIL_INPUT_BASE64_STANDARD);
+        if (decoded) {
+            if (foil_parse_skip_bytes(&pos, &foil_key_openssh_text_suffix)) {
+                FoilBytes b;
+                if (foil_key_ed25519_parse_openssh_binary
+                    (foil_bytes_from_data(&b, decoded), pub, priv)) {
+                    /* Preserve GBytes in the pool to keep pointers valid */
+                    foil_pool_add_bytes_ref(pool, decoded);
+                    ok = TRUE;
+                }
+            }
+            g_bytes_unref(decoded);
+        }
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_public_parse_ssh_text(
+    guint8* pub,
+    const FoilBytes* data)
+{
+    GUtilRange pos;
+    gboolean ok = FALSE;
+
+    foil_parse_init_data(&pos, data);
+    foil_parse_skip_spaces(&pos);
+    if (foil_parse_skip_bytes(&pos, &foil_ssh_ed25519_mark) &&
+        pos.ptr < pos.end && isspace(*pos.ptr)) {
+        GBytes* decoded;
+
+        foil_parse_skip_spaces(&pos);
+        decoded = foil_parse_base64(&pos, 0);
+        if (decoded) {
+            if (pos.ptr == pos.end || isspace(*pos.ptr)) {
+                FoilBytes b;
+
+                ok = foil_key_ed25519_parse_ssh_binary
+                    (foil_bytes_from_data(&b, decoded), pub);
+            }
+            g_bytes_unref(decoded);
+        }
+    }
+    return ok;
+}
+
+/*
+ * SubjectPublicKeyInfo  ::=  SEQUENCE  {
+ *      algorithm           AlgorithmIdentifier,
+ *      subjectPublicKey    BIT STRING }
+ *
+ * For Ed25519 the OID is 1.3.101.112 and parameters must be absent.
+ */
+static
+gboolean
+foil_key_ed25519_public_parse_spki(
+    guint8* pub,
+    const FoilBytes* data)
+{
+    static const guint8 oid_ed25519_bytes[] = { ASN1_OID_ED25519_BYTES };
+    static const FoilBytes oid_ed25519 = {
+        FOIL_ARRAY_AND_SIZE(oid_ed25519_bytes)
+    };
+    GUtilRange pos, aid;
+
+    foil_parse_init_data(&pos, data);
+    if (foil_asn1_parse_sequence(&pos, &pos) &&
+        foil_asn1_parse_sequence(&pos, &aid)) {
+        guint8 unused;
+        FoilBytes oid, bits;
+
+        if (foil_asn1_parse_object_id(&aid, &oid) &&
+            foil_bytes_equal(&oid, &oid_ed25519) && aid.ptr == aid.end &&
+            foil_asn1_parse_bit_string(&pos, &bits, &unused) && !unused &&
+            bits.len == FOIL_ED25519_KEY_SIZE && pos.ptr == pos.end) {
+            memcpy(pub, bits.val, bits.len);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_ed25519_public_parse_pkcs8(
+    guint8* pub,
+    const FoilBytes* data)
+{
+    gboolean ok = FALSE;
+    GUtilRange pos;
+
+    foil_parse_init_data(&pos, data);
+    foil_parse_skip_spaces(&pos);
+    if (foil_parse_skip_bytes(&pos, &ed25519_public_pkcs8_prefix) &&
+        foil_parse_skip_to_next_line(&pos, TRUE)) {
+        GBytes* decoded = foil_parse_base64(&pos,
+            FOIL_INPUT_BASE64_IGNORE_SPACES |
+            FOIL_INPUT_BASE64_STANDARD);
+        if (decoded) {
+            if (foil_parse_skip_bytes(&pos, &ed25519_public_pkcs8_suffix)) {
+                foil_parse_skip_spaces(&pos);
+                if (pos.ptr == pos.end) {
+                    FoilBytes b;
+
+                    ok = foil_key_ed25519_public_parse_spki(pub,
+                        foil_bytes_from_data(&b, decoded));
+                }
+            }
+            g_bytes_unref(decoded);
+        }
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_public_parse_rfc4716(
+    guint8* pub,
+    const FoilBytes* data)
+{
+    gboolean ok = FALSE;
+    GUtilRange pos;
+
+    foil_parse_init_data(&pos, data);
+    foil_parse_skip_spaces(&pos);
+    if (foil_parse_skip_bytes(&pos, &ed25519_public_rfc4716_prefix) &&
+        foil_parse_skip_to_next_line(&pos, TRUE)) {
+        /* Skip headers until we find expected BASE64 signature */
+        while (pos.ptr < pos.end &&
+            ((gsize)(pos.end - pos.ptr) < sizeof(ed25519_public_base64_prefix)
+            || memcmp(pos.ptr, ed25519_public_base64_prefix,
+            sizeof(ed25519_public_base64_prefix)))) {
+            foil_parse_skip_to_next_line(&pos, TRUE);
+        }
+        if (pos.ptr < pos.end) {
+            GBytes* decoded = foil_parse_base64(&pos,
+                FOIL_INPUT_BASE64_IGNORE_SPACES |
+                FOIL_INPUT_BASE64_STANDARD);
+            if (decoded) {
+                if (foil_parse_skip_bytes(&pos,
+                    &ed25519_public_rfc4716_suffix)) {
+                    foil_parse_skip_spaces(&pos);
+                    if (pos.ptr == pos.end) {
+                        FoilBytes b;
+
+                        ok = foil_key_ed25519_parse_ssh_binary
+                            (foil_bytes_from_data(&b, decoded), pub);
+                    }
+                }
+                g_bytes_unref(decoded);
+            }
+        }
+    }
+    return ok;
+}
+
+/* OpenSSH private key file contains unencrypted public key */
+
+static
+gboolean
+foil_key_ed25519_public_parse_openssh(
+    guint8* pub,
+    const FoilBytes* data,
+    FoilPool* pool)
+{
+    FoilKeyRsaOpensshPrivData priv;
+
+    return foil_key_ed25519_parse_openssh_text(data, pub, &priv, pool) ||
+        foil_key_ed25519_parse_openssh_binary(data, pub, &priv);
+}
+
+static
+FoilKey*
+foil_key_ed25519_public_from_data(
+    FoilKeyClass* klass,
+    const void* bytes,
+    gsize size,
+    GHashTable* param,
+    GError** error)
+{
+    FoilKey* result = NULL;
+    guint8 pub[FOIL_ED25519_KEY_SIZE];
+    FoilBytes data;
+    FoilPool pool;
+
+    foil_pool_init(&pool);
+    data.val = bytes;
+    data.len = size;
+    if (foil_key_ed25519_public_parse_ssh_text(pub, &data) ||
+        foil_key_ed25519_public_parse_pkcs8(pub, &data) ||
+        foil_key_ed25519_public_parse_rfc4716(pub, &data) ||
+        foil_key_ed25519_parse_ssh_binary(&data, pub) ||
+        foil_key_ed25519_public_parse_spki(pub, &data) ||
+        foil_key_ed25519_public_parse_openssh(pub, &data, &pool)) {
+        FoilKeyEd25519Public* key = g_object_new(G_TYPE_FROM_CLASS(klass),
+            NULL);
+
+        foil_key_ed25519_public_set_data(key, pub);
+        g_clear_error(error);
+        result = FOIL_KEY(key);
+    } else if (size == FOIL_ED25519_KEY_SIZE) {
+        /* Raw 32-byte public key (RFC 8032) */
+        FoilKeyEd25519Public* key = g_object_new(G_TYPE_FROM_CLASS(klass),
+            NULL);
+
+        foil_key_ed25519_public_set_data(key, bytes);
+        g_clear_error(error);
+        result = FOIL_KEY(key);
+    } else {
+        if (error) {
+            g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+                "Unrecognized Ed25519 public key format"));
+        }
+        GDEBUG("Unsupported Ed25519 public key format");
+    }
+    foil_pool_drain(&pool);
+    return result;
+}
+
+static
+GBytes*
+foil_key_ed25519_public_to_bytes(
+    FoilKey* key,
+    FoilKeyBinaryFormat format)
+{
+    FoilKeyEd25519Public* self = FOIL_KEY_ED25519_PUBLIC_(key);
+
+    switch (format) {
+    case FOIL_KEY_BINARY_FORMAT_DEFAULT: /* fallthrough */
+    case FOIL_KEY_BINARY_FORMAT_OPENSSH:
+        return foil_key_ed25519_ssh_bytes(self->pub);
+    default:
+        break;
+    }
+    /* Invalid/unsupported format */
+    return NULL;
+}
+
+static
+gboolean
+foil_key_ed25519_public_export_ssh(
+    FoilKeyEd25519Public* self,
+    FoilOutput* out,
+    const char* comment,
+    GError** error)
+{
+    const char space = ' ';
+    gboolean ok = foil_key_ed25519_public_write_all(out,
+        &foil_ssh_ed25519_mark) &&
+        foil_output_write_all(out, &space, 1);
+
+    if (ok) {
+        GBytes* bytes = foil_key_ed25519_ssh_bytes(self->pub);
+        FoilOutput* base64 = foil_output_base64_new(out);
+
+        ok = foil_output_write_bytes_all(base64, bytes) &&
+            foil_output_flush(base64);
+        foil_output_unref(base64);
+        g_bytes_unref(bytes);
+        if (ok && comment) {
+            ok = foil_output_write_all(out, &space, 1) &&
+                foil_output_write_all(out, comment, strlen(comment)) &&
+                foil_output_write_eol(out);
+        }
+    }
+    if (!ok && error) {
+        g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_WRITE, "Output error"));
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_public_export_rfc4716(
+    FoilKeyEd25519Public* self,
+    FoilOutput* out,
+    const char* comment,
+    GError** error)
+{
+    gboolean ok = foil_key_ed25519_public_write_all(out,
+        &ed25519_public_rfc4716_prefix) &&
+        foil_output_write_eol(out);
+
+    if (ok && comment) {
+        char* header = foil_format_header("Comment", comment);
+
+        if (header) {
+            ok = foil_output_write_all(out, header, strlen(header)) &&
+                foil_output_write_eol(out);
+            g_free(header);
+        }
+    }
+    if (ok) {
+        GBytes* bytes = foil_key_ed25519_ssh_bytes(self->pub);
+        FoilOutput* base64 = foil_output_base64_new_full(out, 0, 70);
+
+        ok = foil_output_write_bytes_all(base64, bytes) &&
+            foil_output_flush(base64) &&
+            foil_key_ed25519_public_write_all(out,
+            &ed25519_public_rfc4716_suffix) &&
+            foil_output_write_eol(out);
+        foil_output_unref(base64);
+        g_bytes_unref(bytes);
+    }
+    if (!ok && error) {
+        g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_WRITE, "Output error"));
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_public_export_pkcs8(
+    FoilKeyEd25519Public* self,
+    FoilOutput* out,
+    GError** error)
+{
+    gboolean ok = foil_key_ed25519_public_write_all(out,
+        &ed25519_public_pkcs8_prefix) &&
+        foil_output_write_eol(out);
+
+    if (ok) {
+        FoilOutput* base64 = foil_output_base64_new_full(out, 0, 64);
+
+        ok = foil_output_write_all(base64, ed25519_spki_prefix,
+            sizeof(ed25519_spki_prefix)) &&
+            foil_output_write_all(base64, self->pub, sizeof(self->pub)) &&
+            foil_output_flush(base64) &&
+            foil_key_ed25519_public_write_all(out,
+            &ed25519_public_pkcs8_suffix) &&
+            foil_output_write_eol(out);
+        foil_output_unref(base64);
+    }
+    if (!ok && error) {
+        g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_WRITE, "Output error"));
+    }
+    return ok;
+}
+
+static
+gboolean
+foil_key_ed25519_public_export(
+    FoilKey* key,
+    FoilOutput* out,
+    FoilKeyExportFormat format,
+    GHashTable* param,
+    GError** error)
+{
+    FoilKeyEd25519Public* self = FOIL_KEY_ED25519_PUBLIC_(key);
+    const char* comment = NULL;
+
+    if (param) {
+        GVariant* var = g_hash_table_lookup(param, FOIL_KEY_PARAM_COMMENT);
+
+        if (var && g_variant_is_of_type(var, G_VARIANT_TYPE_STRING)) {
+            comment = g_variant_get_string(var, NULL);
+        }
+    }
+    switch (format) {
+    case FOIL_KEY_EXPORT_FORMAT_DEFAULT:
+    case FOIL_KEY_EXPORT_FORMAT_OPENSSH:
+        return foil_key_ed25519_public_export_ssh(self, out, comment, error);
+    case FOIL_KEY_EXPORT_FORMAT_RFC4716:
+        return foil_key_ed25519_public_export_rfc4716(self, out, comment,
+            error);
+    case FOIL_KEY_EXPORT_FORMAT_PKCS8:
+        return foil_key_ed25519_public_export_pkcs8(self, out, error);
+    }
+    if (error) {
+        g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+            "Unsupported export format"));
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_ed25519_public_equal(
+    FoilKey* key1,
+    FoilKey* key2)
+{
+    GASSERT(FOIL_IS_KEY_ED25519_PUBLIC(key1));
+    if (FOIL_IS_KEY_ED25519_PUBLIC(key2)) {
+        FoilKeyEd25519Public* ed1 = FOIL_KEY_ED25519_PUBLIC_(key1);
+        FoilKeyEd25519Public* ed2 = FOIL_KEY_ED25519_PUBLIC_(key2);
+
+        return !memcmp(ed1->pub, ed2->pub, sizeof(ed1->pub));
+    }
+    return FALSE;
+}
+
+static
+GBytes*
+foil_key_ed25519_public_fingerprint(
+    FoilKey* key)
+{
+    return foil_key_ed25519_fingerprint(FOIL_KEY_ED25519_PUBLIC_(key)->pub);
+}
+
+gboolean
+foil_ed25519_verify(
+    const void* data,
+    gsize len,
+    const FoilBytes* sig,
+    FoilKey* key) /* Since 1.0.31 */
+{
+    if (G_LIKELY(data || !len) && G_LIKELY(sig) &&
+        FOIL_IS_KEY_ED25519_PUBLIC(key)) {
+        if (sig->len == FOIL_ED25519_SIGNATURE_SIZE) {
+            FoilKeyEd25519Public* self = FOIL_KEY_ED25519_PUBLIC_(key);
+
+            return FOIL_KEY_ED25519_PUBLIC_GET_CLASS(self)->
+                fn_verify(self, data, len, sig->val);
+        }
+        GDEBUG("Invalid Ed25519 signature size %u", (guint)sig->len);
+    }
+    return FALSE;
+}
+
+static
+void
+foil_key_ed25519_public_init(
+    FoilKeyEd25519Public* key)
+{
+}
+
+static
+void
+foil_key_ed25519_public_class_init(
+    FoilKeyEd25519PublicClass* klass)
+{
+    FoilKeyClass* key_class = FOIL_KEY_CLASS(klass);
+
+    key_class->fn_equal = foil_key_ed25519_public_equal;
+    key_class->fn_from_data = foil_key_ed25519_public_from_data;
+    key_class->fn_to_bytes = foil_key_ed25519_public_to_bytes;
+    key_class->fn_export = foil_key_ed25519_public_export;
+    key_class->fn_fingerprint = foil_key_ed25519_public_fingerprint;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
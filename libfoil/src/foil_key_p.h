@@ -55,6 +55,8 @@ struct foil_key_class {
     gboolean (*fn_export)(FoilKey* key, FoilOutput* out,
         FoilKeyExportFormat format, GHashTable* param, GError** error);
     GBytes* (*fn_fingerprint)(FoilKey* key);
+    FoilKey* (*fn_generate_full)(FoilKeyClass* klass, guint bits,
+        GHashTable* param);
 };
 
 #define FOIL_IS_KEY(obj) G_TYPE_CHECK_INSTANCE_TYPE(obj, \
@@ -65,6 +67,7 @@ struct foil_key_class {
         FOIL_TYPE_KEY, FoilKeyClass)
 
 #define PKCS1_RSA_VERSION (0)
+#define PKCS1_RSA_VERSION_MULTI (1) /* With otherPrimeInfos */
 #define PKCS8_RSA_VERSION (0)
 
 FoilKey*
@@ -158,7 +158,8 @@ foil_key_rsa_private_data_copy(
         FOIL_ALIGN(data->n.len) + FOIL_ALIGN(data->e.len) +
         FOIL_ALIGN(data->d.len) + FOIL_ALIGN(data->p.len) +
         FOIL_ALIGN(data->q.len) + FOIL_ALIGN(data->dmp1.len) +
-        FOIL_ALIGN(data->dmq1.len) + FOIL_ALIGN(data->iqmp.len);
+        FOIL_ALIGN(data->dmq1.len) + FOIL_ALIGN(data->iqmp.len) +
+        FOIL_ALIGN(data->other_primes.len);
     FoilKeyRsaPrivateData* copy = g_malloc(total);
     guint8* ptr = ((guint8*)copy) + FOIL_ALIGN(sizeof(*copy));
     ptr = foil_bytes_copy(&copy->n, &data->n, ptr);
@@ -169,6 +170,7 @@ foil_key_rsa_private_data_copy(
     ptr = foil_bytes_copy(&copy->dmp1, &data->dmp1, ptr);
     ptr = foil_bytes_copy(&copy->dmq1, &data->dmq1, ptr);
     ptr = foil_bytes_copy(&copy->iqmp, &data->iqmp, ptr);
+    ptr = foil_bytes_copy(&copy->other_primes, &data->other_primes, ptr);
     GASSERT((gsize)(ptr - ((guint8*)copy)) == total);
     return copy;
 }
@@ -191,7 +193,8 @@ foil_key_rsa_private_data_equal(
             foil_bytes_equal(&data1->q, &data2->q) &&
             foil_bytes_equal(&data1->dmp1, &data2->dmp1) &&
             foil_bytes_equal(&data1->dmq1, &data2->dmq1) &&
-            foil_bytes_equal(&data1->iqmp, &data2->iqmp);
+            foil_bytes_equal(&data1->iqmp, &data2->iqmp) &&
+            foil_bytes_equal(&data1->other_primes, &data2->other_primes);
     }
 }
 
@@ -200,34 +203,45 @@ GBytes*
 foil_key_rsa_private_data_to_bytes(
     const FoilKeyRsaPrivateData* key_data)
 {
-    GBytes* bytes = NULL;
     if (key_data) {
-        GByteArray* seq;
-        GByteArray* buf = g_byte_array_sized_new(19 +
-            key_data->n.len + key_data->e.len + key_data->d.len +
-            key_data->p.len + key_data->q.len + key_data->dmp1.len +
-            key_data->dmq1.len + key_data->iqmp.len);
-        FoilOutput* seq_out;
-        FoilOutput* data_out = foil_output_mem_new(buf);
         /* PKCS #1 format https://www.ietf.org/rfc/rfc3447 */
-        foil_asn1_encode_integer(data_out, PKCS1_RSA_VERSION);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->n);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->e);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->d);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->p);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->q);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->dmp1);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->dmq1);
-        foil_asn1_encode_integer_bytes(data_out, &key_data->iqmp);
-        seq = g_byte_array_sized_new(foil_asn1_block_length(buf->len));
-        seq_out = foil_output_mem_new(seq);
-        foil_asn1_encode_sequence_data(seq_out, buf->data, buf->len);
-        bytes = foil_output_free_to_bytes(seq_out);
-        foil_output_unref(data_out);
-        g_byte_array_unref(seq);
-        g_byte_array_unref(buf);
+        const gsize other_len = key_data->other_primes.len;
+        const gint32 version = other_len ?
+            PKCS1_RSA_VERSION_MULTI :
+            PKCS1_RSA_VERSION;
+        const gsize seq_len =
+            (other_len ? foil_asn1_block_length(other_len) : 0) +
+            foil_asn1_integer_length(version) +
+            foil_asn1_block_length(key_data->n.len) +
+            foil_asn1_block_length(key_data->e.len) +
+            foil_asn1_block_length(key_data->d.len) +
+            foil_asn1_block_length(key_data->p.len) +
+            foil_asn1_block_length(key_data->q.len) +
+            foil_asn1_block_length(key_data->dmp1.len) +
+            foil_asn1_block_length(key_data->dmq1.len) +
+            foil_asn1_block_length(key_data->iqmp.len);
+        GByteArray* buf = g_byte_array_sized_new
+            (foil_asn1_block_length(seq_len));
+        FoilOutput* out = foil_output_mem_new(buf);
+        foil_asn1_encode_sequence_header(out, seq_len);
+        foil_asn1_encode_integer(out, version);
+        foil_asn1_encode_integer_bytes(out, &key_data->n);
+        foil_asn1_encode_integer_bytes(out, &key_data->e);
+        foil_asn1_encode_integer_bytes(out, &key_data->d);
+        foil_asn1_encode_integer_bytes(out, &key_data->p);
+        foil_asn1_encode_integer_bytes(out, &key_data->q);
+        foil_asn1_encode_integer_bytes(out, &key_data->dmp1);
+        foil_asn1_encode_integer_bytes(out, &key_data->dmq1);
+        foil_asn1_encode_integer_bytes(out, &key_data->iqmp);
+        if (other_len) {
+            foil_asn1_encode_sequence_data(out, key_data->other_primes.val,
+                other_len);
+        }
+        foil_output_unref(out);
+        GASSERT(buf->len == foil_asn1_block_length(seq_len));
+        return g_byte_array_free_to_bytes(buf);
     }
-    return bytes;
+    return NULL;
 }
 
 static
@@ -366,7 +380,12 @@ foil_key_rsa_private_to_bytes(
     case FOIL_KEY_BINARY_FORMAT_RSA_PKCS1:
         return foil_key_rsa_private_data_to_bytes(self->data);
     case FOIL_KEY_BINARY_FORMAT_OPENSSH:
-        return foil_key_rsa_private_data_to_openssh_bytes(self->data, NULL);
+        /* OpenSSH format has no room for more than two primes */
+        if (!self->data->other_primes.len) {
+            return foil_key_rsa_private_data_to_openssh_bytes(self->data,
+                NULL);
+        }
+        break;
     case FOIL_KEY_BINARY_FORMAT_RSA_SSH:
         break;
     }
@@ -388,16 +407,13 @@ foil_key_rsa_private_parse_aid(
     FoilBytes* oid,
     FoilBytes* params)
 {
-    guint32 len;
-    GUtilRange parse = *pos;
-    if (foil_asn1_parse_start_sequence(&parse, &len)) {
-        parse.end = parse.ptr + len;
-        if (foil_asn1_parse_object_id(&parse, oid)) {
-            params->val = parse.ptr;
-            params->len = parse.end - parse.ptr;
-            pos->ptr = parse.end;
-            return TRUE;
-        }
+    GUtilRange tmp = *pos, seq;
+    if (foil_asn1_parse_sequence(&tmp, &seq) &&
+        foil_asn1_parse_object_id(&seq, oid)) {
+        params->val = seq.ptr;
+        params->len = seq.end - seq.ptr;
+        pos->ptr = tmp.ptr;
+        return TRUE;
     }
     return FALSE;
 }
@@ -419,21 +435,62 @@ foil_key_rsa_private_parse_aid(
  *     coefficient       INTEGER,  -- (inverse of q) mod p
  *     otherPrimeInfos   OtherPrimeInfos OPTIONAL
  * }
+ *
+ * OtherPrimeInfo ::= SEQUENCE {
+ *     prime             INTEGER,  -- ri
+ *     exponent          INTEGER,  -- di
+ *     coefficient       INTEGER   -- ti
+ * }
  */
+gboolean
+foil_key_rsa_private_parse_other_prime(
+    GUtilRange* pos,
+    FoilBytes* r,
+    FoilBytes* d,
+    FoilBytes* t)
+{
+    GUtilRange tmp = *pos, seq;
+    if (foil_asn1_parse_sequence(&tmp, &seq) &&
+        foil_asn1_parse_integer_bytes(&seq, r) &&
+        foil_asn1_parse_integer_bytes(&seq, d) &&
+        foil_asn1_parse_integer_bytes(&seq, t) &&
+        seq.ptr == seq.end) {
+        pos->ptr = tmp.ptr;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_rsa_private_parse_other_primes(
+    GUtilRange* pos,
+    FoilBytes* other_primes)
+{
+    GUtilRange seq;
+    if (foil_asn1_parse_sequence(pos, &seq) && seq.ptr < seq.end) {
+        FoilBytes r, d, t;
+        other_primes->val = seq.ptr;
+        other_primes->len = seq.end - seq.ptr;
+        while (foil_key_rsa_private_parse_other_prime(&seq, &r, &d, &t));
+        return seq.ptr == seq.end;
+    }
+    return FALSE;
+}
+
 static
 gboolean
 foil_key_rsa_private_parse_pkcs1(
     FoilKeyRsaPrivateData* key,
     const FoilBytes* data)
 {
-    guint32 len;
     GUtilRange pos;
     foil_parse_init_data(&pos, data);
-    if (foil_asn1_parse_start_sequence(&pos, &len)) {
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
         gint32 version;
-        pos.end = pos.ptr + len;
         if (foil_asn1_parse_int32(&pos, &version) &&
-            version == PKCS1_RSA_VERSION &&
+            (version == PKCS1_RSA_VERSION ||
+             version == PKCS1_RSA_VERSION_MULTI) &&
             foil_asn1_parse_integer_bytes(&pos, &key->n) &&
             foil_asn1_parse_integer_bytes(&pos, &key->e) &&
             foil_asn1_parse_integer_bytes(&pos, &key->d) &&
@@ -442,10 +499,15 @@ foil_key_rsa_private_parse_pkcs1(
             foil_asn1_parse_integer_bytes(&pos, &key->dmp1) &&
             foil_asn1_parse_integer_bytes(&pos, &key->dmq1) &&
             foil_asn1_parse_integer_bytes(&pos, &key->iqmp) &&
+            (version == PKCS1_RSA_VERSION ||
+             foil_key_rsa_private_parse_other_primes(&pos,
+                &key->other_primes)) &&
             pos.ptr == pos.end) {
             return TRUE;
         }
     }
+    /* OpenSSH parser doesn't touch this one */
+    memset(&key->other_primes, 0, sizeof(key->other_primes));
     return FALSE;
 }
 
@@ -468,14 +530,12 @@ foil_key_rsa_private_parse_pkcs8(
 {
     static const guint8 oid_rsa_bytes[] = { ASN1_OID_RSA_BYTES };
     static const FoilBytes oid_rsa = { oid_rsa_bytes, sizeof(oid_rsa_bytes) };
-    guint32 len;
     GUtilRange pos;
     foil_parse_init_data(&pos, data);
     /* PrivateKeyInfo */
-    if (foil_asn1_parse_start_sequence(&pos, &len)) {
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
         gint32 version;
         FoilBytes oid, params, priv;
-        pos.end = pos.ptr + len;
         if (foil_asn1_parse_int32(&pos, &version) &&
             /* version */
             version == PKCS8_RSA_VERSION &&
@@ -663,12 +723,10 @@ foil_key_rsa_private_decrypt_pbes2(
     static const FoilBytes oid_aes256_cbc = { aes256cbc, sizeof(aes256cbc) };
 
     GBytes* decrypted = NULL;
-    guint32 len;
     GUtilRange pos;
     foil_parse_init_data(&pos, params);
-    if (foil_asn1_parse_start_sequence(&pos, &len)) {
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
         FoilBytes kdf, kdf_param, alg, alg_param;
-        pos.end = pos.ptr + len;
         if (foil_key_rsa_private_parse_aid(&pos, &kdf, &kdf_param) &&
             foil_key_rsa_private_parse_aid(&pos, &alg, &alg_param)) {
             FoilBytes iv;
@@ -695,20 +753,17 @@ foil_key_rsa_private_decrypt_pbes2(
                 ivsize = FOIL_AES_BLOCK_SIZE;
                 cipher = FOIL_CIPHER_AES_CBC_DECRYPT;
             }
-            pos.ptr = alg_param.val;
-            pos.end = alg_param.val + alg_param.len;
+            foil_parse_init_data(&pos, &alg_param);
             if (bits && foil_asn1_parse_octet_string(&pos, &iv) &&
                 iv.len == ivsize) {
                 FoilKey* key = NULL;
                 /* Key derivation function */
                 if (foil_bytes_equal(&kdf, &oid_pbkdf2)) {
                     /* PBKDF2 */
-                    pos.ptr = kdf_param.val;
-                    pos.end = kdf_param.val + alg_param.len;
-                    if (foil_asn1_parse_start_sequence(&pos, &len)) {
+                    foil_parse_init_data(&pos, &kdf_param);
+                    if (foil_asn1_parse_sequence(&pos, &pos)) {
                         FoilBytes salt;
                         gint32 count;
-                        pos.end = pos.ptr + len;
                         if (foil_asn1_parse_octet_string(&pos, &salt) &&
                             foil_asn1_parse_int32(&pos, &count) && count > 0 &&
                             /* keyLength and prf are optional, we assume
@@ -778,14 +833,12 @@ foil_key_rsa_private_decrypt_pkcs8(
         0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x05, 0x0d
     };
     static const FoilBytes oid_pbes2 = { FOIL_ARRAY_AND_SIZE(OID_PBES2) };
-    guint32 len;
     GUtilRange pos;
     foil_parse_init_bytes(&pos, bytes);
-    if (foil_asn1_parse_start_sequence(&pos, &len)) {
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
         FoilBytes oid;
         FoilBytes params;
         FoilBytes enc;
-        pos.end = pos.ptr + len;
         if (foil_key_rsa_private_parse_aid(&pos, &oid, &params) &&
             foil_asn1_parse_octet_string(&pos, &enc)) {
             if (foil_bytes_equal(&oid, &oid_pbes2)) {
@@ -1268,7 +1321,17 @@ foil_key_rsa_private_export_openssh(
     const char* pass,
     GError** error)
 {
-    GBytes* bytes = (pass && pass[0]) ?
+    GBytes* bytes;
+
+    if (self->data->other_primes.len) {
+        if (error && !*error) {
+            *error = g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+                "OpenSSH format doesn't support multi-prime keys");
+        }
+        return FALSE;
+    }
+    bytes = (pass && pass[0]) ?
         foil_key_rsa_private_data_to_openssh_encrypted_bytes(self->data,
             OPENSSH_DEFAULT_CIPHER, OPENSSH_ROUNDS, pass, comment) :
         foil_key_rsa_private_data_to_openssh_bytes(self->data, comment);
@@ -1388,6 +1451,7 @@ foil_key_rsa_private_finalize(
         FOIL_KEY_RSA_PRIVATE_CLEAR_BYTES(&data->dmp1);
         FOIL_KEY_RSA_PRIVATE_CLEAR_BYTES(&data->dmq1);
         FOIL_KEY_RSA_PRIVATE_CLEAR_BYTES(&data->iqmp);
+        FOIL_KEY_RSA_PRIVATE_CLEAR_BYTES(&data->other_primes);
         g_free(self->data);
     }
     G_OBJECT_CLASS(foil_key_rsa_private_parent_class)->finalize(object);
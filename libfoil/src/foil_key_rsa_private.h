@@ -49,6 +49,18 @@
  *   coefficient       INTEGER,  -- (inverse of q) mod p
  *   otherPrimeInfos   OtherPrimeInfos OPTIONAL
  * }
+ *
+ * OtherPrimeInfos ::= SEQUENCE SIZE(1..MAX) OF OtherPrimeInfo
+ *
+ * OtherPrimeInfo ::= SEQUENCE {
+ *   prime             INTEGER,  -- ri
+ *   exponent          INTEGER,  -- di
+ *   coefficient       INTEGER   -- ti
+ * }
+ *
+ * other_primes holds the contents of the OtherPrimeInfos sequence
+ * (i.e. the encoded OtherPrimeInfo blocks) and is empty for the
+ * usual two-prime keys.
  */
 
 typedef struct foil_key_rsa_private_data {
@@ -60,6 +72,7 @@ typedef struct foil_key_rsa_private_data {
     FoilBytes dmp1;
     FoilBytes dmq1;
     FoilBytes iqmp;
+    FoilBytes other_primes;
 } FoilKeyRsaPrivateData;
 
 typedef struct foil_key_rsa_private {
@@ -84,6 +97,15 @@ foil_key_rsa_private_get_public_data(
     FoilKeyRsaPublicData* pub_data)
     FOIL_INTERNAL;
 
+/* Fetches the next OtherPrimeInfo, pos must point into other_primes */
+gboolean
+foil_key_rsa_private_parse_other_prime(
+    GUtilRange* pos,
+    FoilBytes* r,
+    FoilBytes* d,
+    FoilBytes* t)
+    FOIL_INTERNAL;
+
 #endif /* FOIL_KEY_PRIVATE_H */
 
 /*
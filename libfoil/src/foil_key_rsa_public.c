@@ -238,11 +238,9 @@ foil_key_rsa_public_parse_pkcs1(
     FoilKeyRsaPublicData* key,
     const FoilBytes* bytes)
 {
-    guint32 len;
     GUtilRange pos;
     foil_parse_init_data(&pos, bytes);
-    if (foil_asn1_parse_start_sequence(&pos, &len)) {
-        pos.end = pos.ptr + len;
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
         if (foil_asn1_parse_integer_bytes(&pos, &key->n) &&
             foil_asn1_parse_integer_bytes(&pos, &key->e) &&
             pos.ptr == pos.end) {
@@ -337,18 +335,14 @@ foil_key_rsa_public_parse_rfc5208(
     static const guint8 oid_rsa_bytes[] = { ASN1_OID_RSA_BYTES };
     static const FoilBytes oid_rsa = { oid_rsa_bytes, sizeof(oid_rsa_bytes) };
     gboolean ok = FALSE;
-    guint32 len;
     GUtilRange pos;
     foil_parse_init_data(&pos, data);
-    if (foil_asn1_parse_start_sequence(&pos, &len)) {
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
         GUtilRange aid;
-        pos.end = pos.ptr + len;
-        aid = pos;
         /* Check AlgorithmIdentifier */
-        if (foil_asn1_parse_start_sequence(&aid, &len)) {
+        if (foil_asn1_parse_sequence(&pos, &aid)) {
             guint8 unused;
             FoilBytes oid, bits;
-            pos.ptr = aid.ptr + len;
             if (foil_asn1_parse_object_id(&aid, &oid) &&
                 foil_bytes_equal(&oid, &oid_rsa) &&
                 foil_asn1_parse_bit_string(&pos, &bits, &unused) && !unused) {
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_KEY_X25519_P_H
+#define FOIL_KEY_X25519_P_H
+
+#include "foil_private_key_p.h"
+#include "foil_key_x25519.h"
+
+typedef struct foil_key_x25519_public_class FoilKeyX25519PublicClass;
+typedef struct foil_key_x25519_private_class FoilKeyX25519PrivateClass;
+
+typedef struct foil_key_x25519_public {
+    FoilKey super;
+    guint8 pub[FOIL_X25519_KEY_SIZE];
+} FoilKeyX25519Public;
+
+struct foil_key_x25519_public_class {
+    FoilKeyClass key;
+};
+
+typedef struct foil_key_x25519_private {
+    FoilPrivateKey super;
+    guint8 priv[FOIL_X25519_KEY_SIZE];
+    guint8 pub[FOIL_X25519_KEY_SIZE];
+} FoilKeyX25519Private;
+
+struct foil_key_x25519_private_class {
+    FoilPrivateKeyClass key;
+    /* Derives the public key from the private one */
+    gboolean (*fn_init)(FoilKeyX25519Private* key);
+    gboolean (*fn_derive)(FoilKeyX25519Private* key, const guint8* peer,
+        guint8* secret);
+};
+
+#define FOIL_KEY_X25519_PUBLIC_(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, \
+        FOIL_TYPE_KEY_X25519_PUBLIC, FoilKeyX25519Public))
+#define FOIL_KEY_X25519_PUBLIC_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST((klass),\
+        FOIL_TYPE_KEY_X25519_PUBLIC, FoilKeyX25519PublicClass))
+#define FOIL_KEY_X25519_PRIVATE_(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, \
+        FOIL_TYPE_KEY_X25519_PRIVATE, FoilKeyX25519Private))
+#define FOIL_KEY_X25519_PRIVATE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST(\
+        (klass), FOIL_TYPE_KEY_X25519_PRIVATE, FoilKeyX25519PrivateClass))
+#define FOIL_KEY_X25519_PRIVATE_GET_CLASS(obj) G_TYPE_INSTANCE_GET_CLASS(\
+        obj, FOIL_TYPE_KEY_X25519_PRIVATE, FoilKeyX25519PrivateClass)
+
+/* DER encoded SubjectPublicKeyInfo */
+GBytes*
+foil_key_x25519_spki_bytes(
+    const guint8* pub)
+    FOIL_INTERNAL;
+
+GBytes*
+foil_key_x25519_fingerprint(
+    const guint8* pub)
+    FOIL_INTERNAL;
+
+void
+foil_key_x25519_public_set_data(
+    FoilKeyX25519Public* key,
+    const guint8* pub)
+    FOIL_INTERNAL;
+
+#endif /* FOIL_KEY_X25519_P_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,445 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_key_x25519_p.h"
+#include "foil_random.h"
+#include "foil_output.h"
+#include "foil_input.h"
+#include "foil_asn1_p.h"
+#include "foil_util_p.h"
+#include "foil_oid.h"
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_key
+#include "foil_log_p.h"
+
+G_DEFINE_ABSTRACT_TYPE(FoilKeyX25519Private, foil_key_x25519_private,
+        FOIL_TYPE_PRIVATE_KEY);
+
+#define foil_key_x25519_private_write_all(out,data) \
+    foil_output_write_all(out, (data)->val, (data)->len)
+
+#define PKCS8_X25519_VERSION (0)
+#define PKCS8_X25519_VERSION_2 (1) /* RFC 5958 OneAsymmetricKey */
+
+/*
+ * PrivateKeyInfo (RFC 8410) is fixed size, all that changes is
+ * the last 32 bytes:
+ *
+ * SEQUENCE {
+ *   INTEGER 0
+ *   SEQUENCE {
+ *     OBJECT IDENTIFIER 1.3.101.110
+ *   }
+ *   OCTET STRING {
+ *     OCTET STRING (32 bytes)
+ *   }
+ * }
+ */
+static const guint8 x25519_pkcs8_prefix[] = {
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    3 + ASN1_OID_X25519_LENGTH + 4 + FOIL_X25519_KEY_SIZE + 4,
+    ASN1_TAG_INTEGER, 1, PKCS8_X25519_VERSION,
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    ASN1_OID_X25519_LENGTH + 2,
+    ASN1_TAG_OBJECT_ID,
+    ASN1_OID_X25519_LENGTH,
+    ASN1_OID_X25519_BYTES,
+    ASN1_TAG_OCTET_STRING,
+    FOIL_X25519_KEY_SIZE + 2,
+    ASN1_TAG_OCTET_STRING,
+    FOIL_X25519_KEY_SIZE
+};
+
+static const guint8 x25519_private_pem_prefix_data[] = {
+    '-','-','-','-','-','B','E','G','I','N',' ','P','R','I','V','A',
+    'T','E',' ','K','E','Y','-','-','-','-','-'
+};
+static const guint8 x25519_private_pem_suffix_data[] = {
+    '-','-','-','-','-','E','N','D',' ','P','R','I','V','A','T','E',
+    ' ','K','E','Y','-','-','-','-','-'
+};
+static const FoilBytes x25519_private_pem_prefix = {
+    FOIL_ARRAY_AND_SIZE(x25519_private_pem_prefix_data)
+};
+static const FoilBytes x25519_private_pem_suffix = {
+    FOIL_ARRAY_AND_SIZE(x25519_private_pem_suffix_data)
+};
+
+/*
+ * PKCS #8
+ *
+ * https://tools.ietf.org/html/rfc8410 (Section 7)
+ *
+ * Same as Ed25519 except for the OID. PrivateKey is an OCTET STRING
+ * wrapping CurvePrivateKey, which is an OCTET STRING too. Optional
+ * parts are ignored.
+ */
+static
+gboolean
+foil_key_x25519_private_parse_pkcs8(
+    guint8* priv,
+    const FoilBytes* data)
+{
+    static const guint8 oid_x25519_bytes[] = { ASN1_OID_X25519_BYTES };
+    static const FoilBytes oid_x25519 = {
+        FOIL_ARRAY_AND_SIZE(oid_x25519_bytes)
+    };
+    GUtilRange pos;
+
+    foil_parse_init_data(&pos, data);
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
+        gint32 version;
+        GUtilRange aid;
+        FoilBytes oid, octets;
+
+        if (foil_asn1_parse_int32(&pos, &version) &&
+            (version == PKCS8_X25519_VERSION ||
+             version == PKCS8_X25519_VERSION_2) &&
+            foil_asn1_parse_sequence(&pos, &aid) &&
+            foil_asn1_parse_object_id(&aid, &oid) &&
+            foil_bytes_equal(&oid, &oid_x25519) && aid.ptr == aid.end &&
+            foil_asn1_parse_octet_string(&pos, &octets)) {
+            GUtilRange key;
+            FoilBytes bytes;
+
+            foil_parse_init_data(&key, &octets);
+            if (foil_asn1_parse_octet_string(&key, &bytes) &&
+                bytes.len == FOIL_X25519_KEY_SIZE && key.ptr == key.end) {
+                memcpy(priv, bytes.val, bytes.len);
+                return TRUE;
+            }
+        }
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_x25519_private_parse_pem(
+    guint8* priv,
+    const FoilBytes* data)
+{
+    gboolean ok = FALSE;
+    const guint8* start = foil_memmem(data, &x25519_private_pem_prefix);
+
+    if (start) {
+        GUtilRange pos;
+
+        pos.ptr = start + x25519_private_pem_prefix.len;
+        pos.end = data->val + data->len;
+        if (foil_parse_skip_to_next_line(&pos, TRUE)) {
+            GBytes* decoded = foil_parse_base64(&pos,
+                FOIL_INPUT_BASE64_IGNORE_SPACES |
+                FOIL_INPUT_BASE64_STANDARD);
+
+            if (decoded) {
+                if (foil_parse_skip_bytes(&pos, &x25519_private_pem_suffix)) {
+                    FoilBytes b;
+
+                    /* And ignore the rest */
+                    ok = foil_key_x25519_private_parse_pkcs8(priv,
+                        foil_bytes_from_data(&b, decoded));
+                }
+                g_bytes_unref(decoded);
+            }
+        }
+    }
+    return ok;
+}
+
+static
+FoilKeyX25519Private*
+foil_key_x25519_private_new(
+    FoilKeyX25519PrivateClass* klass,
+    const guint8* priv)
+{
+    FoilKeyX25519Private* key = g_object_new(G_TYPE_FROM_CLASS(klass), NULL);
+
+    memcpy(key->priv, priv, sizeof(key->priv));
+    if (klass->fn_init(key)) {
+        return key;
+    }
+    g_object_unref(key);
+    return NULL;
+}
+
+static
+FoilKey*
+foil_key_x25519_private_generate(
+    FoilKeyClass* klass,
+    guint bits)
+{
+    FoilKey* key = NULL;
+
+    if (bits == FOIL_KEY_BITS_DEFAULT || bits == FOIL_X25519_KEY_BITS) {
+        guint8 priv[FOIL_X25519_KEY_SIZE];
+
+        if (foil_random(priv, sizeof(priv))) {
+            key = (FoilKey*) foil_key_x25519_private_new
+                (FOIL_KEY_X25519_PRIVATE_CLASS(klass), priv);
+        }
+        memset(priv, 0, sizeof(priv));
+    } else {
+        GERR("Invalid number of bits for X25519 (%u)", bits);
+    }
+    return key;
+}
+
+static
+FoilKey*
+foil_key_x25519_private_from_data(
+    FoilKeyClass* klass,
+    const void* bytes,
+    gsize size,
+    GHashTable* param,
+    GError** err)
+{
+    FoilKeyX25519Private* key = NULL;
+    guint8 priv[FOIL_X25519_KEY_SIZE];
+    gboolean ok = FALSE;
+    FoilBytes data;
+
+    data.val = bytes;
+    data.len = size;
+    if (foil_key_x25519_private_parse_pem(priv, &data) ||
+        foil_key_x25519_private_parse_pkcs8(priv, &data)) {
+        ok = TRUE;
+    } else if (size == FOIL_X25519_KEY_SIZE) {
+        /* Raw 32-byte private key (RFC 7748) */
+        memcpy(priv, bytes, size);
+        ok = TRUE;
+    }
+
+    if (ok) {
+        key = foil_key_x25519_private_new
+            (FOIL_KEY_X25519_PRIVATE_CLASS(klass), priv);
+        if (key) {
+            g_clear_error(err);
+        }
+    }
+    if (!key && err && !*err) {
+        *err = g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+            "Unrecognized X25519 private key format");
+    }
+    memset(priv, 0, sizeof(priv));
+    return FOIL_KEY(key);
+}
+
+static
+GBytes*
+foil_key_x25519_private_to_pkcs8(
+    FoilKeyX25519Private* self)
+{
+    GByteArray* buf = g_byte_array_sized_new(sizeof(x25519_pkcs8_prefix) +
+        sizeof(self->priv));
+
+    g_byte_array_append(buf, x25519_pkcs8_prefix,
+        sizeof(x25519_pkcs8_prefix));
+    g_byte_array_append(buf, self->priv, sizeof(self->priv));
+    return g_byte_array_free_to_bytes(buf);
+}
+
+static
+GBytes*
+foil_key_x25519_private_to_bytes(
+    FoilKey* key,
+    FoilKeyBinaryFormat format)
+{
+    if (format == FOIL_KEY_BINARY_FORMAT_DEFAULT) {
+        return foil_key_x25519_private_to_pkcs8(FOIL_KEY_X25519_PRIVATE_(key));
+    }
+    /* Invalid/unsupported format */
+    return NULL;
+}
+
+static
+gboolean
+foil_key_x25519_private_export(
+    FoilKey* key,
+    FoilOutput* out,
+    FoilKeyExportFormat format,
+    GHashTable* param,
+    GError** error)
+{
+    FoilKeyX25519Private* self = FOIL_KEY_X25519_PRIVATE_(key);
+    const char* passphrase = NULL;
+    gboolean ok = FALSE;
+
+    if (param) {
+        GVariant* var = g_hash_table_lookup(param, FOIL_KEY_PARAM_PASSPHRASE);
+
+        if (var && g_variant_is_of_type(var, G_VARIANT_TYPE_STRING)) {
+            passphrase = g_variant_get_string(var, NULL);
+        }
+    }
+    if (passphrase && passphrase[0]) {
+        if (error) {
+            g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_UNSUPPORTED,
+                "Encrypted X25519 keys are not supported"));
+        }
+        return FALSE;
+    }
+    switch (format) {
+    case FOIL_KEY_EXPORT_FORMAT_DEFAULT:
+    case FOIL_KEY_EXPORT_FORMAT_PKCS8:
+        if (foil_key_x25519_private_write_all(out,
+            &x25519_private_pem_prefix) &&
+            foil_output_write_eol(out)) {
+            FoilOutput* base64 = foil_output_base64_new_full(out, 0, 64);
+
+            ok = foil_output_write_all(base64, x25519_pkcs8_prefix,
+                sizeof(x25519_pkcs8_prefix)) &&
+                foil_output_write_all(base64, self->priv,
+                sizeof(self->priv)) &&
+                foil_output_flush(base64) &&
+                foil_key_x25519_private_write_all(out,
+                &x25519_private_pem_suffix) &&
+                foil_output_write_eol(out);
+            foil_output_unref(base64);
+        }
+        if (!ok && error) {
+            g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_WRITE, "Output error"));
+        }
+        return ok;
+    case FOIL_KEY_EXPORT_FORMAT_RFC4716:
+    case FOIL_KEY_EXPORT_FORMAT_OPENSSH:
+        break;
+    }
+    if (error) {
+        g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+            "Unsupported export format"));
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_x25519_private_equal(
+    FoilKey* key1,
+    FoilKey* key2)
+{
+    GASSERT(FOIL_IS_KEY_X25519_PRIVATE(key1));
+    if (FOIL_IS_KEY_X25519_PRIVATE(key2)) {
+        FoilKeyX25519Private* x1 = FOIL_KEY_X25519_PRIVATE_(key1);
+        FoilKeyX25519Private* x2 = FOIL_KEY_X25519_PRIVATE_(key2);
+
+        return !memcmp(x1->priv, x2->priv, sizeof(x1->priv));
+    }
+    return FALSE;
+}
+
+static
+GBytes*
+foil_key_x25519_private_fingerprint(
+    FoilKey* key)
+{
+    return foil_key_x25519_fingerprint(FOIL_KEY_X25519_PRIVATE_(key)->pub);
+}
+
+GBytes*
+foil_x25519_derive(
+    FoilPrivateKey* key,
+    FoilKey* peer) /* Since 1.0.31 */
+{
+    if (FOIL_IS_KEY_X25519_PRIVATE(key) && FOIL_IS_KEY_X25519_PUBLIC(peer)) {
+        FoilKeyX25519Private* self = FOIL_KEY_X25519_PRIVATE_(key);
+        guint8* secret = g_malloc(FOIL_X25519_KEY_SIZE);
+
+        if (FOIL_KEY_X25519_PRIVATE_GET_CLASS(self)->fn_derive(self,
+            FOIL_KEY_X25519_PUBLIC_(peer)->pub, secret)) {
+            return g_bytes_new_take(secret, FOIL_X25519_KEY_SIZE);
+        }
+        g_free(secret);
+    }
+    return NULL;
+}
+
+GBytes*
+foil_x25519_public_bytes(
+    FoilKey* key) /* Since 1.0.31 */
+{
+    if (FOIL_IS_KEY_X25519_PUBLIC(key)) {
+        return g_bytes_new(FOIL_KEY_X25519_PUBLIC_(key)->pub,
+            FOIL_X25519_KEY_SIZE);
+    } else if (FOIL_IS_KEY_X25519_PRIVATE(key)) {
+        return g_bytes_new(FOIL_KEY_X25519_PRIVATE_(key)->pub,
+            FOIL_X25519_KEY_SIZE);
+    }
+    return NULL;
+}
+
+static
+void
+foil_key_x25519_private_finalize(
+    GObject* object)
+{
+    FoilKeyX25519Private* self = FOIL_KEY_X25519_PRIVATE_(object);
+
+    memset(self->priv, 0, sizeof(self->priv));
+    G_OBJECT_CLASS(foil_key_x25519_private_parent_class)->finalize(object);
+}
+
+static
+void
+foil_key_x25519_private_init(
+    FoilKeyX25519Private* key)
+{
+}
+
+static
+void
+foil_key_x25519_private_class_init(
+    FoilKeyX25519PrivateClass* klass)
+{
+    FoilKeyClass* key_class = FOIL_KEY_CLASS(klass);
+
+    key_class->fn_generate = foil_key_x25519_private_generate;
+    key_class->fn_equal = foil_key_x25519_private_equal;
+    key_class->fn_from_data = foil_key_x25519_private_from_data;
+    key_class->fn_to_bytes = foil_key_x25519_private_to_bytes;
+    key_class->fn_export = foil_key_x25519_private_export;
+    key_class->fn_fingerprint = foil_key_x25519_private_fingerprint;
+    G_OBJECT_CLASS(klass)->finalize = foil_key_x25519_private_finalize;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_key_x25519_p.h"
+#include "foil_digest.h"
+#include "foil_output.h"
+#include "foil_input.h"
+#include "foil_asn1_p.h"
+#include "foil_util_p.h"
+#include "foil_oid.h"
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_key
+#include "foil_log_p.h"
+
+G_DEFINE_ABSTRACT_TYPE(FoilKeyX25519Public, foil_key_x25519_public,
+        FOIL_TYPE_KEY);
+
+#define foil_key_x25519_public_write_all(out, data) \
+    foil_output_write_all(out, (data)->val, (data)->len)
+
+/*
+ * SubjectPublicKeyInfo (RFC 8410) is fixed size, all that changes
+ * is the last 32 bytes:
+ *
+ * SEQUENCE {
+ *   SEQUENCE {
+ *     OBJECT IDENTIFIER 1.3.101.110
+ *   }
+ *   BIT STRING (256 bits)
+ * }
+ */
+static const guint8 x25519_spki_prefix[] = {
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    ASN1_OID_X25519_LENGTH + 4 + FOIL_X25519_KEY_SIZE + 3,
+    ASN1_CLASS_STRUCTURED | ASN1_TAG_SEQUENCE,
+    ASN1_OID_X25519_LENGTH + 2,
+    ASN1_TAG_OBJECT_ID,
+    ASN1_OID_X25519_LENGTH,
+    ASN1_OID_X25519_BYTES,
+    ASN1_TAG_BIT_STRING,
+    FOIL_X25519_KEY_SIZE + 1,
+    0x00 /* Unused bits */
+};
+
+static const guint8 x25519_public_pem_prefix_data[] = {
+    '-','-','-','-','-','B','E','G','I','N',' ','P','U','B','L','I',
+    'C',' ','K','E','Y','-','-','-','-','-'
+};
+static const guint8 x25519_public_pem_suffix_data[] = {
+    '-','-','-','-','-','E','N','D',' ','P','U','B','L','I','C',' ',
+    'K','E','Y','-','-','-','-','-'
+};
+
+static const FoilBytes x25519_public_pem_prefix = {
+    FOIL_ARRAY_AND_SIZE(x25519_public_pem_prefix_data)
+};
+static const FoilBytes x25519_public_pem_suffix = {
+    FOIL_ARRAY_AND_SIZE(x25519_public_pem_suffix_data)
+};
+
+void
+foil_key_x25519_public_set_data(
+    FoilKeyX25519Public* self,
+    const guint8* pub)
+{
+    memcpy(self->pub, pub, sizeof(self->pub));
+}
+
+GBytes*
+foil_key_x25519_spki_bytes(
+    const guint8* pub)
+{
+    GByteArray* buf = g_byte_array_sized_new(sizeof(x25519_spki_prefix) +
+        FOIL_X25519_KEY_SIZE);
+
+    g_byte_array_append(buf, x25519_spki_prefix, sizeof(x25519_spki_prefix));
+    g_byte_array_append(buf, pub, FOIL_X25519_KEY_SIZE);
+    return g_byte_array_free_to_bytes(buf);
+}
+
+/* There's no ssh format for X25519, MD5 is taken from DER instead */
+GBytes*
+foil_key_x25519_fingerprint(
+    const guint8* pub)
+{
+    GBytes* bytes = foil_key_x25519_spki_bytes(pub);
+    GBytes* fingerprint = foil_digest_bytes(FOIL_DIGEST_MD5, bytes);
+
+    g_bytes_unref(bytes);
+    return fingerprint;
+}
+
+/*
+ * SubjectPublicKeyInfo  ::=  SEQUENCE  {
+ *      algorithm           AlgorithmIdentifier,
+ *      subjectPublicKey    BIT STRING }
+ *
+ * For X25519 the OID is 1.3.101.110 and parameters must be absent.
+ */
+static
+gboolean
+foil_key_x25519_public_parse_spki(
+    guint8* pub,
+    const FoilBytes* data)
+{
+    static const guint8 oid_x25519_bytes[] = { ASN1_OID_X25519_BYTES };
+    static const FoilBytes oid_x25519 = {
+        FOIL_ARRAY_AND_SIZE(oid_x25519_bytes)
+    };
+    GUtilRange pos, aid;
+
+    foil_parse_init_data(&pos, data);
+    if (foil_asn1_parse_sequence(&pos, &pos) &&
+        foil_asn1_parse_sequence(&pos, &aid)) {
+        guint8 unused;
+        FoilBytes oid, bits;
+
+        if (foil_asn1_parse_object_id(&aid, &oid) &&
+            foil_bytes_equal(&oid, &oid_x25519) && aid.ptr == aid.end &&
+            foil_asn1_parse_bit_string(&pos, &bits, &unused) && !unused &&
+            bits.len == FOIL_X25519_KEY_SIZE && pos.ptr == pos.end) {
+            memcpy(pub, bits.val, bits.len);
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_x25519_public_parse_pem(
+    guint8* pub,
+    const FoilBytes* data)
+{
+    gboolean ok = FALSE;
+    GUtilRange pos;
+
+    foil_parse_init_data(&pos, data);
+    foil_parse_skip_spaces(&pos);
+    if (foil_parse_skip_bytes(&pos, &x25519_public_pem_prefix) &&
+        foil_parse_skip_to_next_line(&pos, TRUE)) {
+        GBytes* decoded = foil_parse_base64(&pos,
+            FOIL_INPUT_BASE64_IGNORE_SPACES |
+            FOIL_INPUT_BASE64_STANDARD);
+        if (decoded) {
+            if (foil_parse_skip_bytes(&pos, &x25519_public_pem_suffix)) {
+                foil_parse_skip_spaces(&pos);
+                if (pos.ptr == pos.end) {
+                    FoilBytes b;
+
+                    ok = foil_key_x25519_public_parse_spki(pub,
+                        foil_bytes_from_data(&b, decoded));
+                }
+            }
+            g_bytes_unref(decoded);
+        }
+    }
+    return ok;
+}
+
+static
+FoilKey*
+foil_key_x25519_public_from_data(
+    FoilKeyClass* klass,
+    const void* bytes,
+    gsize size,
+    GHashTable* param,
+    GError** error)
+{
+    guint8 pub[FOIL_X25519_KEY_SIZE];
+    gboolean ok = FALSE;
+    FoilBytes data;
+
+    data.val = bytes;
+    data.len = size;
+    if (foil_key_x25519_public_parse_pem(pub, &data) ||
+        foil_key_x25519_public_parse_spki(pub, &data)) {
+        ok = TRUE;
+    } else if (size == FOIL_X25519_KEY_SIZE) {
+        /* Raw 32-byte public key (RFC 7748) */
+        memcpy(pub, bytes, size);
+        ok = TRUE;
+    }
+    if (ok) {
+        FoilKeyX25519Public* key = g_object_new(G_TYPE_FROM_CLASS(klass),
+            NULL);
+
+        foil_key_x25519_public_set_data(key, pub);
+        g_clear_error(error);
+        return FOIL_KEY(key);
+    }
+    if (error) {
+        g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+            "Unrecognized X25519 public key format"));
+    }
+    GDEBUG("Unsupported X25519 public key format");
+    return NULL;
+}
+
+static
+GBytes*
+foil_key_x25519_public_to_bytes(
+    FoilKey* key,
+    FoilKeyBinaryFormat format)
+{
+    if (format == FOIL_KEY_BINARY_FORMAT_DEFAULT) {
+        return foil_key_x25519_spki_bytes(FOIL_KEY_X25519_PUBLIC_(key)->pub);
+    }
+    /* Invalid/unsupported format */
+    return NULL;
+}
+
+static
+gboolean
+foil_key_x25519_public_export(
+    FoilKey* key,
+    FoilOutput* out,
+    FoilKeyExportFormat format,
+    GHashTable* param,
+    GError** error)
+{
+    FoilKeyX25519Public* self = FOIL_KEY_X25519_PUBLIC_(key);
+    gboolean ok = FALSE;
+
+    switch (format) {
+    case FOIL_KEY_EXPORT_FORMAT_DEFAULT:
+    case FOIL_KEY_EXPORT_FORMAT_PKCS8:
+        ok = foil_key_x25519_public_write_all(out,
+            &x25519_public_pem_prefix) &&
+            foil_output_write_eol(out);
+        if (ok) {
+            FoilOutput* base64 = foil_output_base64_new_full(out, 0, 64);
+
+            ok = foil_output_write_all(base64, x25519_spki_prefix,
+                sizeof(x25519_spki_prefix)) &&
+                foil_output_write_all(base64, self->pub,
+                sizeof(self->pub)) &&
+                foil_output_flush(base64) &&
+                foil_key_x25519_public_write_all(out,
+                &x25519_public_pem_suffix) &&
+                foil_output_write_eol(out);
+            foil_output_unref(base64);
+        }
+        if (!ok && error) {
+            g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+                FOIL_ERROR_KEY_WRITE, "Output error"));
+        }
+        return ok;
+    case FOIL_KEY_EXPORT_FORMAT_RFC4716:
+    case FOIL_KEY_EXPORT_FORMAT_OPENSSH:
+        break;
+    }
+    if (error) {
+        g_propagate_error(error, g_error_new_literal(FOIL_ERROR,
+            FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT,
+            "Unsupported export format"));
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_key_x25519_public_equal(
+    FoilKey* key1,
+    FoilKey* key2)
+{
+    GASSERT(FOIL_IS_KEY_X25519_PUBLIC(key1));
+    if (FOIL_IS_KEY_X25519_PUBLIC(key2)) {
+        FoilKeyX25519Public* x1 = FOIL_KEY_X25519_PUBLIC_(key1);
+        FoilKeyX25519Public* x2 = FOIL_KEY_X25519_PUBLIC_(key2);
+
+        return !memcmp(x1->pub, x2->pub, sizeof(x1->pub));
+    }
+    return FALSE;
+}
+
+static
+GBytes*
+foil_key_x25519_public_fingerprint(
+    FoilKey* key)
+{
+    return foil_key_x25519_fingerprint(FOIL_KEY_X25519_PUBLIC_(key)->pub);
+}
+
+static
+void
+foil_key_x25519_public_init(
+    FoilKeyX25519Public* key)
+{
+}
+
+static
+void
+foil_key_x25519_public_class_init(
+    FoilKeyX25519PublicClass* klass)
+{
+    FoilKeyClass* key_class = FOIL_KEY_CLASS(klass);
+
+    key_class->fn_equal = foil_key_x25519_public_equal;
+    key_class->fn_from_data = foil_key_x25519_public_from_data;
+    key_class->fn_to_bytes = foil_key_x25519_public_to_bytes;
+    key_class->fn_export = foil_key_x25519_public_export;
+    key_class->fn_fingerprint = foil_key_x25519_public_fingerprint;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,423 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE   /* SCHED_IDLE */
+#endif
+
+#include "foil_keygen.h"
+#include "foil_key.h"
+#include "foil_thread_pool_p.h"
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_key
+#include "foil_log_p.h"
+
+#include <sched.h>
+
+/*
+ * Asynchronous and bulk requests run on the thread pool shared by
+ * the whole library.
+ */
+
+/* Pause after a pool thread fails to generate a key */
+#define FOIL_KEY_POOL_RETRY_DELAY (G_TIME_SPAN_SECOND)
+
+typedef struct foil_key_generate_source {
+    GSource source;
+    GMainContext* context;
+    gint done;
+    GType type;
+    guint bits;
+    FoilKey* key;
+    FoilKeyGenerateFunc fn;
+    void* fn_arg;
+} FoilKeyGenerateSource;
+
+typedef struct foil_key_generate_many {
+    GType type;
+    guint bits;
+    guint count;
+    gint next;
+    FoilKey** keys;
+} FoilKeyGenerateMany;
+
+struct foil_key_pool {
+    GType type;
+    guint bits;
+    guint size;
+    guint pending;
+    GThread** threads;
+    guint nthreads;
+    GMutex mutex;
+    GCond cond;
+    GQueue queue;
+    gboolean stop;
+};
+
+/*==========================================================================*
+ * Asynchronous generation
+ *==========================================================================*/
+
+/*
+ * g_source_set_ready_time() appeared in glib 2.36, the worker thread
+ * sets the flag and wakes up the context instead.
+ */
+
+static
+gboolean
+foil_key_generate_source_prepare(
+    GSource* source,
+    gint* timeout)
+{
+    FoilKeyGenerateSource* gen = (FoilKeyGenerateSource*)source;
+
+    *timeout = -1;
+    return g_atomic_int_get(&gen->done);
+}
+
+static
+gboolean
+foil_key_generate_source_check(
+    GSource* source)
+{
+    FoilKeyGenerateSource* gen = (FoilKeyGenerateSource*)source;
+
+    return g_atomic_int_get(&gen->done);
+}
+
+static
+gboolean
+foil_key_generate_source_dispatch(
+    GSource* source,
+    GSourceFunc callback,
+    gpointer user_data)
+{
+    FoilKeyGenerateSource* gen = (FoilKeyGenerateSource*)source;
+
+    if (gen->fn) {
+        gen->fn(gen->key, gen->fn_arg);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+foil_key_generate_source_finalize(
+    GSource* source)
+{
+    FoilKeyGenerateSource* gen = (FoilKeyGenerateSource*)source;
+
+    foil_key_unref(gen->key);
+    g_main_context_unref(gen->context);
+}
+
+static
+void
+foil_key_generate_async_run(
+    gpointer data)
+{
+    FoilKeyGenerateSource* gen = data;
+    GSource* source = &gen->source;
+
+    /* Don't bother if it's been cancelled in the meantime */
+    if (!g_source_is_destroyed(source)) {
+        gen->key = foil_key_generate_new(gen->type, gen->bits);
+        g_atomic_int_set(&gen->done, TRUE);
+        g_main_context_wakeup(gen->context);
+    }
+    g_source_unref(source);
+}
+
+guint
+foil_key_generate_async(
+    GType type,
+    guint bits,
+    FoilKeyGenerateFunc fn,
+    void* arg) /* Since 1.0.31 */
+{
+    if (G_LIKELY(type)) {
+        static GSourceFuncs foil_key_generate_source_funcs = {
+            foil_key_generate_source_prepare,
+            foil_key_generate_source_check,
+            foil_key_generate_source_dispatch,
+            foil_key_generate_source_finalize,
+            NULL,
+            NULL
+        };
+        GSource* source = g_source_new(&foil_key_generate_source_funcs,
+            sizeof(FoilKeyGenerateSource));
+        FoilKeyGenerateSource* gen = (FoilKeyGenerateSource*)source;
+        guint id;
+
+        gen->context = g_main_context_ref_thread_default();
+        gen->type = type;
+        gen->bits = bits;
+        gen->fn = fn;
+        gen->fn_arg = arg;
+        id = g_source_attach(source, gen->context);
+
+        /* The worker thread holds its own reference */
+        foil_thread_pool_push(foil_key_generate_async_run,
+            g_source_ref(source));
+        g_source_unref(source);
+        return id;
+    }
+    return 0;
+}
+
+/*==========================================================================*
+ * Bulk generation
+ *==========================================================================*/
+
+/* Each runner keeps generating keys until they are all taken */
+static
+void
+foil_key_generate_many_run(
+    gpointer data)
+{
+    FoilKeyGenerateMany* many = data;
+    gint i;
+
+    while ((i = g_atomic_int_add(&many->next, 1)) < (gint)many->count) {
+        many->keys[i] = foil_key_generate_new(many->type, many->bits);
+    }
+}
+
+GPtrArray*
+foil_key_generate_many(
+    GType type,
+    guint bits,
+    guint count,
+    guint max_threads) /* Since 1.0.31 */
+{
+    GPtrArray* keys = NULL;
+
+    if (G_LIKELY(type)) {
+        FoilKeyGenerateMany many;
+        const guint nthreads = MIN(max_threads ? max_threads :
+            foil_ncpu(), MAX(count, 1));
+        gboolean ok = TRUE;
+        guint i;
+
+        many.type = type;
+        many.bits = bits;
+        many.count = count;
+        many.next = 0;
+        many.keys = g_new0(FoilKey*, count);
+        if (nthreads > 1) {
+            FoilThreadBatch* batch = foil_thread_batch_new();
+
+            /* This thread is one of the runners */
+            for (i = 1; i < nthreads; i++) {
+                foil_thread_batch_push(batch, foil_key_generate_many_run,
+                    &many);
+            }
+            foil_key_generate_many_run(&many);
+            foil_thread_batch_finish(batch);
+        } else {
+            foil_key_generate_many_run(&many);
+        }
+
+        keys = g_ptr_array_new_full(count, g_object_unref);
+        for (i = 0; i < count; i++) {
+            if (many.keys[i]) {
+                g_ptr_array_add(keys, many.keys[i]);
+            } else {
+                ok = FALSE;
+            }
+        }
+        g_free(many.keys);
+        if (!ok) {
+            GWARN("Failed to generate %u key(s)", count - keys->len);
+            g_ptr_array_free(keys, TRUE);
+            keys = NULL;
+        }
+    }
+    return keys;
+}
+
+/*==========================================================================*
+ * Pool
+ *==========================================================================*/
+
+static
+gpointer
+foil_key_pool_thread(
+    gpointer data)
+{
+    FoilKeyPool* self = data;
+
+#ifdef SCHED_IDLE
+    /* Only use the CPU time which nobody else wants */
+    struct sched_param param;
+
+    memset(&param, 0, sizeof(param));
+    if (sched_setscheduler(0, SCHED_IDLE, &param)) {
+        GDEBUG("Failed to lower keygen thread priority");
+    }
+#endif
+
+    g_mutex_lock(&self->mutex);
+    while (!self->stop) {
+        if (self->queue.length + self->pending < self->size) {
+            FoilKey* key;
+
+            self->pending++;
+            g_mutex_unlock(&self->mutex);
+            key = foil_key_generate_new(self->type, self->bits);
+            g_mutex_lock(&self->mutex);
+            self->pending--;
+            if (key) {
+                g_queue_push_tail(&self->queue, key);
+            } else {
+                /*
+                 * Keep the thread, or else a few failures would leave
+                 * the pool empty for good. Take a break before trying
+                 * again, in case it keeps failing.
+                 */
+                GWARN("Failed to generate a key for the pool");
+                if (!self->stop) {
+                    g_cond_wait_until(&self->cond, &self->mutex,
+                        g_get_monotonic_time() + FOIL_KEY_POOL_RETRY_DELAY);
+                }
+            }
+        } else {
+            g_cond_wait(&self->cond, &self->mutex);
+        }
+    }
+    g_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+FoilKeyPool*
+foil_key_pool_new(
+    GType type,
+    guint bits,
+    guint size,
+    guint threads) /* Since 1.0.31 */
+{
+    if (G_LIKELY(type) && G_LIKELY(size)) {
+        FoilKeyPool* self = g_slice_new0(FoilKeyPool);
+        guint i;
+
+        self->type = type;
+        self->bits = bits;
+        self->size = size;
+        g_mutex_init(&self->mutex);
+        g_cond_init(&self->cond);
+        g_queue_init(&self->queue);
+        self->threads = g_new0(GThread*, MAX(threads, 1));
+        for (i = 0; i < MAX(threads, 1); i++) {
+            GError* error = NULL;
+            GThread* thread = g_thread_try_new("foil-keygen",
+                foil_key_pool_thread, self, &error);
+
+            if (thread) {
+                self->threads[self->nthreads++] = thread;
+            } else {
+                /* Still usable, just without the head start */
+                GWARN("Failed to start keygen thread: %s", GERRMSG(error));
+                g_error_free(error);
+                break;
+            }
+        }
+        return self;
+    }
+    return NULL;
+}
+
+void
+foil_key_pool_free(
+    FoilKeyPool* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        guint i;
+
+        g_mutex_lock(&self->mutex);
+        self->stop = TRUE;
+        g_cond_broadcast(&self->cond);
+        g_mutex_unlock(&self->mutex);
+
+        /* Each thread finishes the key it's working on (if any) */
+        for (i = 0; i < self->nthreads; i++) {
+            g_thread_join(self->threads[i]);
+        }
+        g_free(self->threads);
+        g_queue_foreach(&self->queue, (GFunc) g_object_unref, NULL);
+        g_queue_clear(&self->queue);
+        g_cond_clear(&self->cond);
+        g_mutex_clear(&self->mutex);
+        g_slice_free(FoilKeyPool, self);
+    }
+}
+
+guint
+foil_key_pool_count(
+    FoilKeyPool* self) /* Since 1.0.31 */
+{
+    guint count = 0;
+
+    if (G_LIKELY(self)) {
+        g_mutex_lock(&self->mutex);
+        count = self->queue.length;
+        g_mutex_unlock(&self->mutex);
+    }
+    return count;
+}
+
+FoilKey*
+foil_key_pool_take(
+    FoilKeyPool* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        FoilKey* key;
+
+        g_mutex_lock(&self->mutex);
+        key = g_queue_pop_head(&self->queue);
+        if (key) {
+            /* Wake up a thread to replace it */
+            g_cond_signal(&self->cond);
+        }
+        g_mutex_unlock(&self->mutex);
+        return key ? key : foil_key_generate_new(self->type, self->bits);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#include "foil_keyring.h"
+#include "foil_private_key.h"
+#include "foil_util.h"
+
+#include "foil_log_p.h"
+
+/*
+ * The hashtable key points to the fingerprint of the entry's key,
+ * which allows to look up the entry by FoilBytes without allocating
+ * any memory.
+ */
+
+typedef struct foil_keyring_entry {
+    FoilBytes fingerprint;
+    GBytes* fingerprint_bytes;
+    FoilPrivateKey* key;
+} FoilKeyringEntry;
+
+struct foil_keyring {
+    gint ref_count;
+    GRWLock lock;
+    GHashTable* keys;
+};
+
+static
+guint
+foil_keyring_hash(
+    gconstpointer data)
+{
+    const FoilBytes* bytes = data;
+    const guint8* ptr = bytes->val;
+    const guint8* end = ptr + bytes->len;
+    guint h = 5381;
+
+    while (ptr < end) {
+        h = (h << 5) + h + *ptr++;
+    }
+    return h;
+}
+
+static
+gboolean
+foil_keyring_equal(
+    gconstpointer a,
+    gconstpointer b)
+{
+    return foil_bytes_equal(a, b);
+}
+
+static
+void
+foil_keyring_entry_free(
+    gpointer data)
+{
+    FoilKeyringEntry* entry = data;
+
+    g_bytes_unref(entry->fingerprint_bytes);
+    foil_private_key_unref(entry->key);
+    g_slice_free(FoilKeyringEntry, entry);
+}
+
+FoilKeyring*
+foil_keyring_new(
+    void)
+{
+    FoilKeyring* self = g_slice_new0(FoilKeyring);
+
+    g_atomic_int_set(&self->ref_count, 1);
+    g_rw_lock_init(&self->lock);
+    self->keys = g_hash_table_new_full(foil_keyring_hash,
+        foil_keyring_equal, NULL, foil_keyring_entry_free);
+    return self;
+}
+
+FoilKeyring*
+foil_keyring_ref(
+    FoilKeyring* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        g_atomic_int_inc(&self->ref_count);
+    }
+    return self;
+}
+
+void
+foil_keyring_unref(
+    FoilKeyring* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&self->ref_count)) {
+            g_hash_table_destroy(self->keys);
+            g_rw_lock_clear(&self->lock);
+            g_slice_free(FoilKeyring, self);
+        }
+    }
+}
+
+guint
+foil_keyring_count(
+    FoilKeyring* self)
+{
+    guint count = 0;
+
+    if (G_LIKELY(self)) {
+        g_rw_lock_reader_lock(&self->lock);
+        count = g_hash_table_size(self->keys);
+        g_rw_lock_reader_unlock(&self->lock);
+    }
+    return count;
+}
+
+gboolean
+foil_keyring_add(
+    FoilKeyring* self,
+    FoilPrivateKey* key)
+{
+    gboolean ok = FALSE;
+    GBytes* fingerprint = foil_private_key_fingerprint(key);
+
+    if (G_LIKELY(self) && G_LIKELY(fingerprint)) {
+        FoilKeyringEntry* entry = g_slice_new(FoilKeyringEntry);
+
+        entry->fingerprint_bytes = g_bytes_ref(fingerprint);
+        entry->key = foil_private_key_ref(key);
+        foil_bytes_from_data(&entry->fingerprint, fingerprint);
+
+        g_rw_lock_writer_lock(&self->lock);
+        if (!g_hash_table_contains(self->keys, &entry->fingerprint)) {
+            g_hash_table_insert(self->keys, &entry->fingerprint, entry);
+            ok = TRUE;
+        }
+        g_rw_lock_writer_unlock(&self->lock);
+
+        if (!ok) {
+            foil_keyring_entry_free(entry);
+        }
+    }
+    return ok;
+}
+
+gboolean
+foil_keyring_remove(
+    FoilKeyring* self,
+    const FoilBytes* fingerprint)
+{
+    gboolean removed = FALSE;
+
+    if (G_LIKELY(self) && G_LIKELY(fingerprint)) {
+        g_rw_lock_writer_lock(&self->lock);
+        removed = g_hash_table_remove(self->keys, fingerprint);
+        g_rw_lock_writer_unlock(&self->lock);
+    }
+    return removed;
+}
+
+FoilPrivateKey*
+foil_keyring_find(
+    FoilKeyring* self,
+    const FoilBytes* fingerprint)
+{
+    FoilPrivateKey* key = NULL;
+
+    if (G_LIKELY(self) && G_LIKELY(fingerprint)) {
+        FoilKeyringEntry* entry;
+
+        g_rw_lock_reader_lock(&self->lock);
+        entry = g_hash_table_lookup(self->keys, fingerprint);
+        if (entry) {
+            key = foil_private_key_ref(entry->key);
+        }
+        g_rw_lock_reader_unlock(&self->lock);
+    }
+    return key;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_keywrap.h"
+#include "foil_cipher.h"
+#include "foil_key.h"
+#include "foil_log_p.h"
+
+/*
+ * AES Key Wrap (RFC 3394)
+ *
+ * Since 1.0.31
+ */
+
+#define KEYWRAP_SEMIBLOCK (8)
+#define KEYWRAP_BLOCK (2 * KEYWRAP_SEMIBLOCK)
+#define KEYWRAP_ROUNDS (6)
+
+/* 2.2.3.1 Default Initial Value */
+static const guint8 keywrap_default_iv[KEYWRAP_SEMIBLOCK] = {
+    0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6, 0xa6
+};
+
+static
+FoilCipher*
+foil_keywrap_cipher_new(
+    GType type,
+    FoilKey* kek,
+    const FoilBytes* data,
+    gsize min_size)
+{
+    if (G_LIKELY(data) && data->len >= min_size &&
+        !(data->len % KEYWRAP_SEMIBLOCK)) {
+        FoilCipher* cipher = foil_cipher_new(type, kek);
+
+        if (cipher && foil_cipher_input_block_size(cipher) == KEYWRAP_BLOCK) {
+            return cipher;
+        }
+        foil_cipher_unref(cipher);
+    }
+    return NULL;
+}
+
+/* The 64-bit counter t is XORed into the low bytes of A */
+static
+void
+foil_keywrap_xor_t(
+    guint8* a,
+    guint64 t)
+{
+    int k;
+
+    for (k = KEYWRAP_SEMIBLOCK - 1; k >= 0 && t; k--, t >>= 8) {
+        a[k] ^= (guint8)t;
+    }
+}
+
+/*
+ * 2.2.1 Key Wrap
+ *
+ * For j = 0 to 5
+ *     For i=1 to n
+ *         B = AES(K, A | R[i])
+ *         A = MSB(64, B) ^ t where t = (n*j)+i
+ *         R[i] = LSB(64, B)
+ */
+GBytes*
+foil_keywrap_wrap(
+    FoilKey* kek,
+    const FoilBytes* data)
+{
+    FoilCipher* aes = foil_keywrap_cipher_new(FOIL_CIPHER_AES_ECB_ENCRYPT,
+        kek, data, 2 * KEYWRAP_SEMIBLOCK);
+
+    if (aes) {
+        const gsize n = data->len / KEYWRAP_SEMIBLOCK;
+        const gsize size = data->len + KEYWRAP_SEMIBLOCK;
+        guint8* out = g_malloc(size);
+        guint8* r = out + KEYWRAP_SEMIBLOCK;
+        guint8 b[KEYWRAP_BLOCK];
+        gsize i, j;
+
+        memcpy(out, keywrap_default_iv, KEYWRAP_SEMIBLOCK);
+        memcpy(r, data->val, data->len);
+        for (j = 0; j < KEYWRAP_ROUNDS; j++) {
+            for (i = 0; i < n; i++) {
+                guint8* ri = r + i * KEYWRAP_SEMIBLOCK;
+
+                memcpy(b, out, KEYWRAP_SEMIBLOCK);
+                memcpy(b + KEYWRAP_SEMIBLOCK, ri, KEYWRAP_SEMIBLOCK);
+                foil_cipher_step(aes, b, b);
+                memcpy(out, b, KEYWRAP_SEMIBLOCK);
+                foil_keywrap_xor_t(out, n * j + i + 1);
+                memcpy(ri, b + KEYWRAP_SEMIBLOCK, KEYWRAP_SEMIBLOCK);
+            }
+        }
+        memset(b, 0, sizeof(b));
+        foil_cipher_unref(aes);
+        return g_bytes_new_take(out, size);
+    }
+    return NULL;
+}
+
+/*
+ * 2.2.2 Key Unwrap
+ *
+ * For j = 5 to 0
+ *     For i = n to 1
+ *         B = AES-1(K, (A ^ t) | R[i]) where t = n*j+i
+ *         A = MSB(64, B)
+ *         R[i] = LSB(64, B)
+ */
+GBytes*
+foil_keywrap_unwrap(
+    FoilKey* kek,
+    const FoilBytes* data)
+{
+    FoilCipher* aes = foil_keywrap_cipher_new(FOIL_CIPHER_AES_ECB_DECRYPT,
+        kek, data, 3 * KEYWRAP_SEMIBLOCK);
+
+    if (aes) {
+        const gsize size = data->len - KEYWRAP_SEMIBLOCK;
+        const gsize n = size / KEYWRAP_SEMIBLOCK;
+        guint8* r = g_malloc(size);
+        guint8 a[KEYWRAP_SEMIBLOCK];
+        guint8 b[KEYWRAP_BLOCK];
+        guint8 diff = 0;
+        gsize i, j, k;
+
+        memcpy(a, data->val, KEYWRAP_SEMIBLOCK);
+        memcpy(r, data->val + KEYWRAP_SEMIBLOCK, size);
+        for (j = KEYWRAP_ROUNDS; j > 0; j--) {
+            for (i = n; i > 0; i--) {
+                guint8* ri = r + (i - 1) * KEYWRAP_SEMIBLOCK;
+
+                foil_keywrap_xor_t(a, n * (j - 1) + i);
+                memcpy(b, a, KEYWRAP_SEMIBLOCK);
+                memcpy(b + KEYWRAP_SEMIBLOCK, ri, KEYWRAP_SEMIBLOCK);
+                foil_cipher_step(aes, b, b);
+                memcpy(a, b, KEYWRAP_SEMIBLOCK);
+                memcpy(ri, b + KEYWRAP_SEMIBLOCK, KEYWRAP_SEMIBLOCK);
+            }
+        }
+        memset(b, 0, sizeof(b));
+        foil_cipher_unref(aes);
+
+        /* 2.2.3 Key Data Integrity -- the Initial Value */
+        for (k = 0; k < KEYWRAP_SEMIBLOCK; k++) {
+            diff |= a[k] ^ keywrap_default_iv[k];
+        }
+        if (!diff) {
+            return g_bytes_new_take(r, size);
+        }
+        GDEBUG("Key unwrap integrity check failed");
+        memset(r, 0, size);
+        g_free(r);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -37,6 +37,16 @@
 #define ASN1_OID_RSA_BYTES \
     0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01
 
+/* 1.3.101.110 - X25519 (RFC 8410) */
+#define ASN1_OID_X25519_LENGTH (3)
+#define ASN1_OID_X25519_BYTES \
+    0x2b, 0x65, 0x6e
+
+/* 1.3.101.112 - Ed25519 (RFC 8410) */
+#define ASN1_OID_ED25519_LENGTH (3)
+#define ASN1_OID_ED25519_BYTES \
+    0x2b, 0x65, 0x70
+
 /* 1.2.840.113549.1.5.12 - PBKDF2 (Key Derivation Function) */
 #define ASN1_OID_PBKDF2_LENGTH (9)
 #define ASN1_OID_PBKDF2_BYTES \
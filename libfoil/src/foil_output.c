@@ -96,6 +96,88 @@ foil_output_write(
     return -1;
 }
 
+static
+gssize
+foil_output_writev_default(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n)
+{
+    gssize total = 0;
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        const FoilBytes* buf = bufs + i;
+
+        if (buf->len) {
+            const gssize written = out->fn->fn_write(out, buf->val, buf->len);
+
+            if (written < 0) {
+                return total ? total : written;
+            }
+            total += written;
+            if ((gsize)written < buf->len) {
+                break;
+            }
+        }
+    }
+    return total;
+}
+
+/**
+ * Writes several buffers in one go. Returns the total number of bytes
+ * written, which is less than the sum of the lengths if the write stops
+ * half way, or -1 if nothing could be written at all.
+ */
+gssize
+foil_output_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n) /* Since 1.0.31 */
+{
+    if (G_LIKELY(out) && !out->closed) {
+        GASSERT(out->ref_count > 0);
+        if (G_LIKELY(bufs) && G_LIKELY(n)) {
+            gsize size = 0;
+            guint i;
+
+            for (i = 0; i < n; i++) {
+                size += bufs[i].len;
+            }
+            if (size) {
+                const gssize written = out->fn->fn_writev ?
+                    out->fn->fn_writev(out, bufs, n) :
+                    foil_output_writev_default(out, bufs, n);
+
+                if (written > 0) {
+                    GASSERT((gsize)written <= size);
+                    out->bytes_written += written;
+                }
+                return written;
+            }
+        }
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * Tells the output that at least this many more bytes are about to be
+ * written. The output may use this hint to preallocate storage. Returns
+ * TRUE if the hint has been acted upon.
+ */
+gboolean
+foil_output_reserve(
+    FoilOutput* out,
+    gsize size) /* Since 1.0.31 */
+{
+    if (G_LIKELY(out) && !out->closed) {
+        GASSERT(out->ref_count > 0);
+        return size && out->fn->fn_reserve && out->fn->fn_reserve(out, size);
+    }
+    return FALSE;
+}
+
 gssize
 foil_output_write_bytes(
     FoilOutput* out,
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_output_p.h"
+#include "foil_arena.h"
+
+#include <gutil_macros.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_output
+#include "foil_log_p.h"
+
+#define FOIL_OUTPUT_ARENA_MIN_ALLOC (64)
+
+/* The output itself lives in the arena too */
+typedef struct foil_output_arena {
+    FoilOutput parent;
+    FoilArena* arena;
+    FoilBytes* result;
+    guint8* buf;
+    gsize len;
+    gsize alloc;
+} FoilOutputArena;
+
+static
+void
+foil_output_arena_grow(
+    FoilOutputArena* self,
+    gsize size)
+{
+    if (size > self->alloc) {
+        gsize alloc = MAX(self->alloc * 2, FOIL_OUTPUT_ARENA_MIN_ALLOC);
+
+        while (alloc < size) {
+            alloc *= 2;
+        }
+        self->buf = foil_arena_realloc(self->arena, self->buf, self->len,
+            alloc);
+        self->alloc = alloc;
+        self->result->val = self->buf;
+    }
+}
+
+static
+gssize
+foil_output_arena_write(
+    FoilOutput* out,
+    const void* buf,
+    gsize size)
+{
+    FoilOutputArena* self = G_CAST(out, FoilOutputArena, parent);
+
+    foil_output_arena_grow(self, self->len + size);
+    memcpy(self->buf + self->len, buf, size);
+    self->result->len = (self->len += size);
+    return size;
+}
+
+static
+gboolean
+foil_output_arena_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputArena* self = G_CAST(out, FoilOutputArena, parent);
+
+    if (size <= G_MAXSIZE - self->len) {
+        const gsize total = self->len + size;
+
+        /* Exact size, the caller knows better */
+        if (total > self->alloc) {
+            self->buf = foil_arena_realloc(self->arena, self->buf, self->len,
+                total);
+            self->alloc = total;
+            self->result->val = self->buf;
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_output_arena_flush(
+    FoilOutput* out)
+{
+    return TRUE;
+}
+
+static
+gboolean
+foil_output_arena_reset(
+    FoilOutput* out)
+{
+    FoilOutputArena* self = G_CAST(out, FoilOutputArena, parent);
+
+    self->result->len = self->len = 0;
+    return TRUE;
+}
+
+static
+GBytes*
+foil_output_arena_to_bytes(
+    FoilOutput* out)
+{
+    FoilOutputArena* self = G_CAST(out, FoilOutputArena, parent);
+
+    /* The arena owns the buffer, it has to be copied */
+    return g_bytes_new(self->buf, self->len);
+}
+
+static
+void
+foil_output_arena_close(
+    FoilOutput* out)
+{
+}
+
+static
+void
+foil_output_arena_free(
+    FoilOutput* out)
+{
+    /* The memory is released together with the arena */
+}
+
+FoilOutput*
+foil_output_arena_new(
+    FoilArena* arena,
+    FoilBytes* result) /* Since 1.0.31 */
+{
+    if (G_LIKELY(arena) && G_LIKELY(result)) {
+        static const FoilOutputFunc foil_output_arena_fn = {
+            foil_output_arena_write,    /* fn_write */
+            NULL,                       /* fn_writev */
+            foil_output_arena_reserve,  /* fn_reserve */
+            foil_output_arena_flush,    /* fn_flush */
+            foil_output_arena_reset,    /* fn_reset */
+            foil_output_arena_to_bytes, /* fn_to_bytes */
+            foil_output_arena_close,    /* fn_close */
+            foil_output_arena_free      /* fn_free */
+        };
+        FoilOutputArena* self = foil_arena_new0(arena, FoilOutputArena);
+
+        self->arena = arena;
+        self->result = result;
+        result->val = NULL;
+        result->len = 0;
+        return foil_output_init(&self->parent, &foil_output_arena_fn);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
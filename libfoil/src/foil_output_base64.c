@@ -136,59 +136,48 @@ foil_output_base64_linebreak(
     }
 }
 
-static
-gboolean
-foil_output_base64_linebreak_check(
-    FoilOutputBase64* self)
-{
-    return !self->base64_count ||
-        (self->base64_count % self->linebreak) ||
-        foil_output_base64_linebreak(self);
-}
-
 static
 gboolean
 foil_output_base64_write_chunk(
     FoilOutputBase64* self,
     char* chunk)
 {
-    gsize size = BASE64_ENCODE_OUTPUT_CHUNK;
+    const gsize size = BASE64_ENCODE_OUTPUT_CHUNK;
     if (self->linebreak) {
-        if (!foil_output_base64_linebreak_check(self)) {
-            return FALSE;
-        } else {
-            const gsize lines1 = self->base64_count/self->linebreak;
-            const gsize lines2 = (self->base64_count + size)/self->linebreak;
-            if (lines1 == lines2) {
-                if (foil_output_write_all(self->out, chunk, size)) {
-                    self->base64_count += size;
-                    self->total_count += size;
-                    return TRUE;
-                } else {
-                    return FALSE;
-                }
-            } else {
-                while (size > 0) {
-                    gsize lines = self->base64_count/self->linebreak;
-                    gsize n = (lines+1) * self->linebreak - self->base64_count;
-                    if (!foil_output_base64_linebreak_check(self)) {
-                        return FALSE;
-                    } else if (n > size) {
-                        if (foil_output_write_all(self->out, chunk, size)) {
-                            n = size;
-                        } else {
-                            return FALSE;
-                        }
-                    } else if (!foil_output_write_all(self->out, chunk, n)) {
-                        return FALSE;
-                    }
-                    self->base64_count += n;
-                    self->total_count += n;
-                    size -= n;
-                    chunk += n;
-                }
-                return TRUE;
+        static const guint8 eol = '\n';
+        /* Each output character may be preceded by a line break */
+        FoilBytes parts[2 * BASE64_ENCODE_OUTPUT_CHUNK];
+        const guint8* ptr = (const guint8*)chunk;
+        gsize pos = self->base64_count;
+        gsize left = size;
+        gsize total = size;
+        guint n = 0;
+
+        /* Gather the chunk and the line breaks into a single write */
+        while (left > 0) {
+            gsize k = self->linebreak - (pos % self->linebreak);
+            if (pos && !(pos % self->linebreak)) {
+                parts[n].val = &eol;
+                parts[n].len = 1;
+                total++;
+                n++;
+            }
+            if (k > left) {
+                k = left;
             }
+            parts[n].val = ptr;
+            parts[n].len = k;
+            n++;
+            ptr += k;
+            pos += k;
+            left -= k;
+        }
+        if (foil_output_writev(self->out, parts, n) == (gssize)total) {
+            self->base64_count += size;
+            self->total_count += total;
+            return TRUE;
+        } else {
+            return FALSE;
         }
     } else if (foil_output_write_all(self->out, chunk, size)) {
         self->base64_count += size;
@@ -250,6 +239,22 @@ foil_output_base64_write(
     return written;
 }
 
+static
+gboolean
+foil_output_base64_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputBase64* self = G_CAST(out, FoilOutputBase64, parent);
+    gsize total = ((self->bufsize + size + BASE64_ENCODE_INPUT_CHUNK - 1) /
+        BASE64_ENCODE_INPUT_CHUNK) * BASE64_ENCODE_OUTPUT_CHUNK;
+
+    if (self->linebreak) {
+        total += total / self->linebreak + 1;
+    }
+    return foil_output_reserve(self->out, total);
+}
+
 static
 gboolean
 foil_output_base64_flush(
@@ -357,6 +362,8 @@ foil_output_base64_new_full(
 {
     static const FoilOutputFunc foil_output_base64_fn = {
         foil_output_base64_write,       /* fn_write */
+        NULL,                           /* fn_writev */
+        foil_output_base64_reserve,     /* fn_reserve */
         foil_output_base64_flush,       /* fn_flush */
         foil_output_base64_reset,       /* fn_reset */
         foil_output_base64_to_bytes,    /* fn_to_bytes */
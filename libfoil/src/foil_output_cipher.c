@@ -129,6 +129,21 @@ foil_output_cipher_finish(
     return ok;
 }
 
+static
+gboolean
+foil_output_cipher_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputCipher* self = G_CAST(out, FoilOutputCipher, parent);
+    const gsize in_size = self->in_block_size;
+    const gsize out_size = foil_cipher_output_block_size(self->cipher);
+
+    /* One extra block for padding */
+    return foil_output_reserve(self->out, out_size *
+        ((self->in_block_used + size + in_size - 1) / in_size + 1));
+}
+
 static
 gboolean
 foil_output_cipher_flush(
@@ -198,6 +213,8 @@ foil_output_cipher_internal_new(
 {
     static const FoilOutputFunc foil_output_cipher_fn = {
         foil_output_cipher_write,       /* fn_write */
+        NULL,                           /* fn_writev */
+        foil_output_cipher_reserve,     /* fn_reserve */
         foil_output_cipher_flush,       /* fn_flush */
         foil_output_cipher_reset,       /* fn_reset */
         foil_output_cipher_to_bytes,    /* fn_to_bytes */
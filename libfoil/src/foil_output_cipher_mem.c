@@ -112,6 +112,43 @@ foil_output_cipher_mem_write(
     return size;
 }
 
+static
+gssize
+foil_output_cipher_mem_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n)
+{
+    FoilOutputCipherMem* self = G_CAST(out, FoilOutputCipherMem, parent);
+    GByteArray* buf = self->buf;
+    const guint prev_len = buf->len;
+    gsize total = 0, blocks;
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        total += bufs[i].len;
+    }
+
+    /*
+     * Reserve room for all the output blocks at once. GByteArray never
+     * shrinks its allocation, so the following set_size calls made by
+     * foil_output_cipher_mem_write() won't have to reallocate anything.
+     */
+    blocks = (self->in_block_used + total) / self->in_block_size;
+    if (blocks) {
+        g_byte_array_set_size(buf, prev_len + blocks * self->out_block_size);
+        g_byte_array_set_size(buf, prev_len);
+    }
+
+    for (i = 0; i < n; i++) {
+        if (bufs[i].len && foil_output_cipher_mem_write(out,
+            bufs[i].val, bufs[i].len) < 0) {
+            return -1;
+        }
+    }
+    return total;
+}
+
 static
 gboolean
 foil_output_cipher_mem_finish(
@@ -141,6 +178,28 @@ foil_output_cipher_mem_finish(
     return (nout >= 0);
 }
 
+static
+gboolean
+foil_output_cipher_mem_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputCipherMem* self = G_CAST(out, FoilOutputCipherMem, parent);
+    GByteArray* buf = self->buf;
+    const guint len = buf->len;
+    const gsize in_size = self->in_block_size;
+    /* One extra block for padding */
+    const gsize out_size = self->out_block_size *
+        ((self->in_block_used + size + in_size - 1) / in_size + 1);
+
+    if (out_size <= G_MAXUINT - len) {
+        g_byte_array_set_size(buf, len + out_size);
+        g_byte_array_set_size(buf, len);
+        return TRUE;
+    }
+    return FALSE;
+}
+
 static
 gboolean
 foil_output_cipher_mem_flush(
@@ -220,6 +279,8 @@ foil_output_cipher_mem_internal_new(
 {
     static const FoilOutputFunc foil_output_cipher_fn = {
         foil_output_cipher_mem_write,       /* fn_write */
+        foil_output_cipher_mem_writev,      /* fn_writev */
+        foil_output_cipher_mem_reserve,     /* fn_reserve */
         foil_output_cipher_mem_flush,       /* fn_flush */
         foil_output_cipher_mem_reset,       /* fn_reset */
         foil_output_cipher_mem_to_bytes,    /* fn_to_bytes */
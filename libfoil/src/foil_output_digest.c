@@ -57,6 +57,42 @@ foil_output_digest_write(
     return written;
 }
 
+static
+gssize
+foil_output_digest_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n)
+{
+    FoilOutputDigest* self = G_CAST(out, FoilOutputDigest, parent);
+    const gssize written = foil_output_writev(self->out, bufs, n);
+
+    if (written > 0) {
+        gsize left = written;
+        guint i;
+
+        /* Only digest what has actually been written */
+        for (i = 0; i < n && left > 0; i++) {
+            const gsize len = MIN(bufs[i].len, left);
+
+            foil_digest_update(self->digest, bufs[i].val, len);
+            left -= len;
+        }
+    }
+    return written;
+}
+
+static
+gboolean
+foil_output_digest_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputDigest* self = G_CAST(out, FoilOutputDigest, parent);
+
+    return foil_output_reserve(self->out, size);
+}
+
 static
 gboolean
 foil_output_digest_flush(
@@ -116,6 +152,8 @@ foil_output_digest_new(
 {
     static const FoilOutputFunc foil_output_digest_fn = {
         foil_output_digest_write,       /* fn_write */
+        foil_output_digest_writev,      /* fn_writev */
+        foil_output_digest_reserve,     /* fn_reserve */
         foil_output_digest_flush,       /* fn_flush */
         foil_output_digest_reset,       /* fn_reset */
         foil_output_digest_to_bytes,    /* fn_to_bytes */
@@ -28,6 +28,7 @@
  */
 
 #include "foil_output_p.h"
+#include "foil_file_p.h"
 
 #include <gutil_macros.h>
 #include <glib/gstdio.h>
@@ -52,19 +53,36 @@ typedef struct foil_output_file_map {
     char* tmpdir;
 } FoilOutputFileMap;
 
+/* stdio based output */
 typedef struct foil_output_file {
     FoilOutput parent;
     FILE* file;
     guint flags;
 } FoilOutputFile;
 
+/* File descriptor based output */
+typedef struct foil_output_fd {
+    FoilOutput parent;
+    int fd;
+    guint flags;
+    gboolean direct;
+    gboolean seekable;
+    FoilFileBuffer buf;
+    guint64 offset;     /* File offset of the first byte in the buffer */
+    guint64 wb_prev;    /* Previous write-behind window */
+    guint64 wb_start;   /* Current write-behind window */
+} FoilOutputFd;
+
 typedef struct foil_output_path {
-    FoilOutputFile parent;
+    FoilOutputFd parent;
     char* path;
     char* tmpdir;
     gboolean delete_when_closed;
 } FoilOutputPath;
 
+#define FOIL_OUTPUT_FILE_FD_FLAGS (FOIL_OUTPUT_FILE_CLOSE | \
+    FOIL_OUTPUT_FILE_DIRECT | FOIL_OUTPUT_FILE_WRITEBEHIND)
+
 static
 void
 foil_output_file_map_free(
@@ -89,6 +107,10 @@ foil_output_file_unref_mapped_file(
     g_mapped_file_unref(data);
 }
 
+/*==========================================================================*
+ * stdio
+ *==========================================================================*/
+
 static
 gssize
 foil_output_file_write(
@@ -97,8 +119,33 @@ foil_output_file_write(
     gsize size)
 {
     FoilOutputFile* self = G_CAST(out, FoilOutputFile, parent);
-    /* self->file can be NULL if foil_output_path_reset() fails */
-    return self->file ? (gssize)fwrite(buf, 1, size, self->file) : -1;
+    return (gssize)fwrite(buf, 1, size, self->file);
+}
+
+static
+gssize
+foil_output_file_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n)
+{
+    FoilOutputFile* self = G_CAST(out, FoilOutputFile, parent);
+
+    /* Whatever is buffered by stdio has to go first */
+    return fflush(self->file) ? -1 :
+        foil_file_writev(fileno(self->file), bufs, n);
+}
+
+static
+gboolean
+foil_output_file_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputFile* self = G_CAST(out, FoilOutputFile, parent);
+    const off_t pos = ftello(self->file);
+
+    return pos >= 0 && foil_file_preallocate(fileno(self->file), pos, size);
 }
 
 static
@@ -107,8 +154,7 @@ foil_output_file_flush(
     FoilOutput* out)
 {
     FoilOutputFile* self = G_CAST(out, FoilOutputFile, parent);
-    /* self->file can be NULL if foil_output_path_reset() fails */
-    return self->file && fflush(self->file) == 0;
+    return fflush(self->file) == 0;
 }
 
 static
@@ -117,7 +163,6 @@ foil_output_file_close(
     FoilOutput* out)
 {
     FoilOutputFile* self = G_CAST(out, FoilOutputFile, parent);
-    /* self->file can be NULL if foil_output_path_reset() fails */
     if (self->file) {
         if (self->flags & FOIL_OUTPUT_FILE_CLOSE) {
             fclose(self->file);
@@ -136,17 +181,285 @@ foil_output_file_free(
     g_slice_free(FoilOutputFile, self);
 }
 
+/*==========================================================================*
+ * File descriptor
+ *==========================================================================*/
+
+static
+void
+foil_output_fd_writebehind(
+    FoilOutputFd* self)
+{
+    if ((self->flags & FOIL_OUTPUT_FILE_WRITEBEHIND) && self->seekable &&
+        self->offset >= self->wb_start + FOIL_FILE_WRITEBEHIND_WINDOW) {
+        foil_file_writebehind(self->fd, self->wb_prev, self->wb_start,
+            self->offset);
+        self->wb_prev = self->wb_start;
+        self->wb_start = self->offset;
+    }
+}
+
+static
+gboolean
+foil_output_fd_write_direct(
+    FoilOutputFd* self,
+    const void* data,
+    gsize size)
+{
+    if (foil_file_write(self->fd, data, size) == (gssize)size) {
+        self->offset += size;
+        foil_output_fd_writebehind(self);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_output_fd_write_buffer(
+    FoilOutputFd* self)
+{
+    FoilFileBuffer* buf = &self->buf;
+
+    if (buf->len) {
+        if (!foil_output_fd_write_direct(self, buf->data, buf->len)) {
+            return FALSE;
+        }
+        buf->len = 0;
+    }
+    return TRUE;
+}
+
+static
+gssize
+foil_output_fd_write(
+    FoilOutput* out,
+    const void* data,
+    gsize size)
+{
+    FoilOutputFd* self = G_CAST(out, FoilOutputFd, parent);
+    FoilFileBuffer* buf = &self->buf;
+    const guint8* ptr = data;
+    gsize left = size;
+
+    /* self->fd can be negative if foil_output_path_reset() fails */
+    if (self->fd < 0) {
+        return -1;
+    }
+
+    while (left > 0) {
+        if (!buf->len && left >= buf->size && !self->direct) {
+            /* Large write, bypass the buffer */
+            return foil_output_fd_write_direct(self, ptr, left) ? size : -1;
+        } else {
+            const gsize n = MIN(left, buf->size - buf->len);
+
+            memcpy(buf->data + buf->len, ptr, n);
+            buf->len += n;
+            ptr += n;
+            left -= n;
+
+            /* With O_DIRECT only full (aligned) buffers get written */
+            if (buf->len == buf->size && !foil_output_fd_write_buffer(self)) {
+                return -1;
+            }
+        }
+    }
+    return size;
+}
+
+static
+gssize
+foil_output_fd_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n)
+{
+    FoilOutputFd* self = G_CAST(out, FoilOutputFd, parent);
+    FoilFileBuffer* buf = &self->buf;
+    gsize total = 0;
+    guint i;
+
+    if (self->fd < 0) {
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        total += bufs[i].len;
+    }
+
+    if (self->direct || (buf->len + total) <= buf->size) {
+        /* Everything goes through the buffer */
+        for (i = 0; i < n; i++) {
+            if (bufs[i].len && foil_output_fd_write(out, bufs[i].val,
+                bufs[i].len) < 0) {
+                return -1;
+            }
+        }
+    } else {
+        /* Write the buffered data together with the new data */
+        FoilBytes stack_parts[8];
+        FoilBytes* parts = (n < G_N_ELEMENTS(stack_parts)) ? stack_parts :
+            g_new(FoilBytes, n + 1);
+        const gsize size = buf->len + total;
+        gboolean ok;
+
+        parts[0].val = buf->data;
+        parts[0].len = buf->len;
+        memcpy(parts + 1, bufs, sizeof(bufs[0]) * n);
+        ok = foil_file_writev(self->fd, parts, n + 1) == (gssize)size;
+        if (parts != stack_parts) {
+            g_free(parts);
+        }
+        if (!ok) {
+            return -1;
+        }
+        self->offset += size;
+        buf->len = 0;
+        foil_output_fd_writebehind(self);
+    }
+    return total;
+}
+
+static
+gboolean
+foil_output_fd_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputFd* self = G_CAST(out, FoilOutputFd, parent);
+
+    return self->fd >= 0 && self->seekable && size &&
+        foil_file_preallocate(self->fd, self->offset + self->buf.len, size);
+}
+
+static
+gboolean
+foil_output_fd_flush(
+    FoilOutput* out)
+{
+    FoilOutputFd* self = G_CAST(out, FoilOutputFd, parent);
+
+    if (self->fd < 0) {
+        return FALSE;
+    }
+    if (self->direct && (self->buf.len % FOIL_FILE_DIRECT_ALIGN)) {
+        /*
+         * The tail isn't aligned and can't be written with O_DIRECT.
+         * Normally flush only happens at the very end, so we just
+         * switch back to the normal I/O.
+         */
+        GVERIFY(foil_file_set_direct(self->fd, FALSE));
+        self->direct = FALSE;
+    }
+    return foil_output_fd_write_buffer(self);
+}
+
+static
+void
+foil_output_fd_close(
+    FoilOutput* out)
+{
+    FoilOutputFd* self = G_CAST(out, FoilOutputFd, parent);
+
+    /* self->fd can be negative if foil_output_path_reset() fails */
+    if (self->fd >= 0) {
+        if (self->flags & FOIL_OUTPUT_FILE_CLOSE) {
+            close(self->fd);
+        } else if (self->direct) {
+            /* Don't leave O_DIRECT set on somebody else's descriptor */
+            foil_file_set_direct(self->fd, FALSE);
+        }
+        self->fd = -1;
+    }
+    self->buf.len = 0;
+}
+
+static
+void
+foil_output_fd_free(
+    FoilOutput* out)
+{
+    FoilOutputFd* self = G_CAST(out, FoilOutputFd, parent);
+
+    GASSERT(self->fd < 0);
+    foil_file_buffer_deinit(&self->buf);
+    g_slice_free(FoilOutputFd, self);
+}
+
+static
+void
+foil_output_fd_update_direct(
+    FoilOutputFd* self)
+{
+    if (self->flags & FOIL_OUTPUT_FILE_DIRECT) {
+        /* O_DIRECT requires aligned buffer, file offset and size */
+        self->direct = self->buf.aligned && self->seekable &&
+            !(self->offset % FOIL_FILE_DIRECT_ALIGN) &&
+            foil_file_set_direct(self->fd, TRUE);
+        if (!self->direct) {
+            foil_file_set_direct(self->fd, FALSE);
+        }
+    }
+}
+
+static
+FoilOutput*
+foil_output_fd_init(
+    FoilOutputFd* self,
+    const FoilOutputFunc* fn,
+    int fd,
+    guint flags,
+    gsize bufsize)
+{
+    const off_t pos = lseek(fd, 0, SEEK_CUR);
+
+    self->fd = fd;
+    self->flags = flags;
+    if (pos >= 0) {
+        self->seekable = TRUE;
+        self->offset = self->wb_prev = self->wb_start = pos;
+    }
+    foil_file_buffer_init(&self->buf, bufsize,
+        (flags & FOIL_OUTPUT_FILE_DIRECT) != 0);
+    foil_output_fd_update_direct(self);
+    return foil_output_init(&self->parent, fn);
+}
+
+/*==========================================================================*
+ * Path
+ *==========================================================================*/
+
+static
+int
+foil_output_path_open(
+    const char* path,
+    guint flags)
+{
+    return foil_file_open(path, O_WRONLY | O_CREAT | O_TRUNC,
+        (flags & FOIL_OUTPUT_FILE_DIRECT) != 0);
+}
+
 static
 gboolean
 foil_output_path_reset(
     FoilOutput* out)
 {
     FoilOutputPath* self = G_CAST(out, FoilOutputPath, parent.parent);
-    if (self->parent.file) {
-        fclose(self->parent.file);
+    FoilOutputFd* fd = &self->parent;
+
+    if (fd->fd >= 0) {
+        close(fd->fd);
+    }
+    fd->buf.len = 0;
+    fd->offset = fd->wb_prev = fd->wb_start = 0;
+    fd->fd = foil_output_path_open(self->path, fd->flags);
+    if (fd->fd >= 0) {
+        foil_output_fd_update_direct(fd);
+        return TRUE;
     }
-    self->parent.file = fopen(self->path, "wb");
-    return (self->parent.file != NULL);
+    fd->direct = FALSE;
+    return FALSE;
 }
 
 static
@@ -156,10 +469,10 @@ foil_output_path_to_bytes(
 {
     FoilOutputPath* self = G_CAST(out, FoilOutputPath, parent.parent);
     GBytes* bytes = NULL;
-    if (self->parent.file) {
+    if (self->parent.fd >= 0) {
         GMappedFile* map;
         GError* error = NULL;
-        foil_output_file_close(out);
+        foil_output_fd_close(out);
         map = g_mapped_file_new(self->path, FALSE, &error);
         if (map) {
             if (self->delete_when_closed) {
@@ -194,7 +507,7 @@ foil_output_path_close(
     FoilOutput* out)
 {
     FoilOutputPath* self = G_CAST(out, FoilOutputPath, parent.parent);
-    foil_output_file_close(out);
+    foil_output_fd_close(out);
     if (self->delete_when_closed) {
         remove(self->path);
     }
@@ -208,13 +521,29 @@ void
 foil_output_path_free(
     FoilOutput* out)
 {
-    FoilOutputPath* self = G_CAST(out, FoilOutputPath, parent);
-    GASSERT(!self->parent.file);
+    FoilOutputPath* self = G_CAST(out, FoilOutputPath, parent.parent);
+    GASSERT(self->parent.fd < 0);
+    foil_file_buffer_deinit(&self->parent.buf);
     g_free(self->path);
     g_free(self->tmpdir);
     g_slice_free(FoilOutputPath, self);
 }
 
+static const FoilOutputFunc foil_output_path_fn = {
+    foil_output_fd_write,       /* fn_write */
+    foil_output_fd_writev,      /* fn_writev */
+    foil_output_fd_reserve,     /* fn_reserve */
+    foil_output_fd_flush,       /* fn_flush */
+    foil_output_path_reset,     /* fn_reset */
+    foil_output_path_to_bytes,  /* fn_to_bytes */
+    foil_output_path_close,     /* fn_close */
+    foil_output_path_free       /* fn_free */
+};
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
 /* Since 1.0.1 */
 FoilOutput*
 foil_output_file_new(
@@ -222,12 +551,14 @@ foil_output_file_new(
     guint flags)
 {
     static const FoilOutputFunc foil_output_file_fn = {
-        foil_output_file_write, /* fn_write */
-        foil_output_file_flush, /* fn_flush */
-        NULL,                   /* fn_reset */
-        NULL,                   /* fn_to_bytes */
-        foil_output_file_close, /* fn_close */
-        foil_output_file_free   /* fn_free */
+        foil_output_file_write,     /* fn_write */
+        foil_output_file_writev,    /* fn_writev */
+        foil_output_file_reserve,   /* fn_reserve */
+        foil_output_file_flush,     /* fn_flush */
+        NULL,                       /* fn_reset */
+        NULL,                       /* fn_to_bytes */
+        foil_output_file_close,     /* fn_close */
+        foil_output_file_free       /* fn_free */
     };
 
     if (file) {
@@ -239,28 +570,58 @@ foil_output_file_new(
     return NULL;
 }
 
-static const FoilOutputFunc foil_output_path_fn = {
-    foil_output_file_write,     /* fn_write */
-    foil_output_file_flush,     /* fn_flush */
-    foil_output_path_reset,     /* fn_reset */
-    foil_output_path_to_bytes,  /* fn_to_bytes */
-    foil_output_path_close,     /* fn_close */
-    foil_output_path_free       /* fn_free */
-};
+/* Since 1.0.31 */
+FoilOutput*
+foil_output_file_new_fd(
+    int fd,
+    guint flags,
+    gsize bufsize)
+{
+    static const FoilOutputFunc foil_output_fd_fn = {
+        foil_output_fd_write,       /* fn_write */
+        foil_output_fd_writev,      /* fn_writev */
+        foil_output_fd_reserve,     /* fn_reserve */
+        foil_output_fd_flush,       /* fn_flush */
+        NULL,                       /* fn_reset */
+        NULL,                       /* fn_to_bytes */
+        foil_output_fd_close,       /* fn_close */
+        foil_output_fd_free         /* fn_free */
+    };
+
+    if (fd >= 0) {
+        return foil_output_fd_init(g_slice_new0(FoilOutputFd),
+            &foil_output_fd_fn, fd, flags & FOIL_OUTPUT_FILE_FD_FLAGS,
+            bufsize);
+    } else {
+        errno = EBADF;
+    }
+    return NULL;
+}
 
 FoilOutput*
 foil_output_file_new_open(
     const char* path)
+{
+    return foil_output_file_new_open_full(path, 0, 0);
+}
+
+/* Since 1.0.31 */
+FoilOutput*
+foil_output_file_new_open_full(
+    const char* path,
+    guint flags,
+    gsize bufsize)
 {
     if (path) {
-        FILE* file = fopen(path, "wb");
-        if (file) {
+        const int fd = foil_output_path_open(path, flags);
+
+        if (fd >= 0) {
             FoilOutputPath* self = g_slice_new0(FoilOutputPath);
-            FoilOutputFile* parent = &self->parent;
+
             self->path = g_strdup(path);
-            parent->file = file;
-            parent->flags = FOIL_OUTPUT_FILE_CLOSE;
-            return foil_output_init(&parent->parent, &foil_output_path_fn);
+            return foil_output_fd_init(&self->parent, &foil_output_path_fn,
+                fd, (flags & FOIL_OUTPUT_FILE_FD_FLAGS) |
+                FOIL_OUTPUT_FILE_CLOSE, bufsize);
         }
     } else {
         errno = EINVAL;
@@ -270,30 +631,36 @@ foil_output_file_new_open(
 
 FoilOutput*
 foil_output_file_new_tmp(void)
+{
+    return foil_output_file_new_tmp_full(0, 0, 0);
+}
+
+/* Since 1.0.31 */
+FoilOutput*
+foil_output_file_new_tmp_full(
+    guint flags,
+    gsize bufsize,
+    gsize size)
 {
     char* tmpdir = g_dir_make_tmp("foil_XXXXXX", NULL);
     if (tmpdir) {
         if (!g_chmod(tmpdir, 0700)) {
             char* path = g_build_filename(tmpdir, "tmp", NULL);
-            int fd = creat(path, 0600);
+            int fd = foil_output_path_open(path, flags);
             if (fd >= 0) {
-                FILE* file = fdopen(fd, "wb");
-#ifdef _WIN32
-                /* Microsoft's fdopen ignores the "b" flag */
-                _setmode(fd, _O_BINARY);
-#endif
-                if (file) {
-                    FoilOutputPath* self = g_slice_new0(FoilOutputPath);
-                    FoilOutputFile* parent = &self->parent;
-                    FoilOutput* out = &parent->parent;
-                    self->path = path;
-                    self->tmpdir = tmpdir;
-                    self->delete_when_closed = TRUE;
-                    parent->file = file;
-                    parent->flags = FOIL_OUTPUT_FILE_CLOSE;
-                    return foil_output_init(out, &foil_output_path_fn);
+                FoilOutputPath* self = g_slice_new0(FoilOutputPath);
+                FoilOutput* out;
+
+                self->path = path;
+                self->tmpdir = tmpdir;
+                self->delete_when_closed = TRUE;
+                out = foil_output_fd_init(&self->parent, &foil_output_path_fn,
+                    fd, (flags & FOIL_OUTPUT_FILE_FD_FLAGS) |
+                    FOIL_OUTPUT_FILE_CLOSE, bufsize);
+                if (size) {
+                    foil_output_reserve(out, size);
                 }
-                close(fd);
+                return out;
             } else {
                 GERR("Failed to create %s", path);
             }
@@ -59,6 +59,54 @@ foil_output_mem_write(
     return size;
 }
 
+static
+gssize
+foil_output_mem_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n)
+{
+    FoilOutputMem* self = G_CAST(out, FoilOutputMem, parent);
+    GByteArray* buf = self->buf;
+    guint8* ptr;
+    gsize total = 0;
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        total += bufs[i].len;
+    }
+
+    /* Grow the buffer once and copy the pieces in */
+    g_byte_array_set_size(buf, buf->len + total);
+    ptr = buf->data + (buf->len - total);
+    for (i = 0; i < n; i++) {
+        if (bufs[i].len) {
+            memcpy(ptr, bufs[i].val, bufs[i].len);
+            ptr += bufs[i].len;
+        }
+    }
+    return total;
+}
+
+static
+gboolean
+foil_output_mem_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputMem* self = G_CAST(out, FoilOutputMem, parent);
+    GByteArray* buf = self->buf;
+    const guint len = buf->len;
+
+    /* GByteArray doesn't shrink the allocated buffer */
+    if (size <= G_MAXUINT - len) {
+        g_byte_array_set_size(buf, len + size);
+        g_byte_array_set_size(buf, len);
+        return TRUE;
+    }
+    return FALSE;
+}
+
 static
 gboolean
 foil_output_mem_flush(
@@ -133,6 +181,8 @@ foil_output_mem_new(
 {
     static const FoilOutputFunc foil_output_mem_fn = {
         foil_output_mem_write,      /* fn_write */
+        foil_output_mem_writev,     /* fn_writev */
+        foil_output_mem_reserve,    /* fn_reserve */
         foil_output_mem_flush,      /* fn_flush */
         foil_output_mem_reset,      /* fn_reset */
         foil_output_mem_to_bytes,   /* fn_to_bytes */
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_output_p.h"
+#include "foil_digest.h"
+
+#include <gutil_macros.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_output
+#include "foil_log_p.h"
+
+/*
+ * Unlike a chain of foil_output_digest_new() stages, each write is
+ * dispatched once and walked in cache-sized chunks by all the digests.
+ */
+
+typedef struct foil_output_multi_digest {
+    FoilOutput parent;
+    FoilOutput* out;
+    FoilDigestMulti* digests;
+} FoilOutputMultiDigest;
+
+static
+gssize
+foil_output_multi_digest_write(
+    FoilOutput* out,
+    const void* buf,
+    gsize size)
+{
+    FoilOutputMultiDigest* self = G_CAST(out, FoilOutputMultiDigest, parent);
+    const gssize written = self->out ?
+        foil_output_write(self->out, buf, size) : (gssize)size;
+
+    if (written > 0) {
+        foil_digest_multi_update(self->digests, buf, written);
+    }
+    return written;
+}
+
+static
+gssize
+foil_output_multi_digest_writev(
+    FoilOutput* out,
+    const FoilBytes* bufs,
+    guint n)
+{
+    FoilOutputMultiDigest* self = G_CAST(out, FoilOutputMultiDigest, parent);
+    gssize written;
+
+    if (self->out) {
+        written = foil_output_writev(self->out, bufs, n);
+    } else {
+        guint i;
+
+        for (i = 0, written = 0; i < n; i++) {
+            written += bufs[i].len;
+        }
+    }
+    if (written > 0) {
+        gsize left = written;
+        guint i;
+
+        /* Only digest what has actually been written */
+        for (i = 0; i < n && left > 0; i++) {
+            const gsize len = MIN(bufs[i].len, left);
+
+            foil_digest_multi_update(self->digests, bufs[i].val, len);
+            left -= len;
+        }
+    }
+    return written;
+}
+
+static
+gboolean
+foil_output_multi_digest_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputMultiDigest* self = G_CAST(out, FoilOutputMultiDigest, parent);
+
+    return !self->out || foil_output_reserve(self->out, size);
+}
+
+static
+gboolean
+foil_output_multi_digest_flush(
+    FoilOutput* out)
+{
+    return TRUE;
+}
+
+static
+gboolean
+foil_output_multi_digest_reset(
+    FoilOutput* out)
+{
+    return FALSE;
+}
+
+static
+GBytes*
+foil_output_multi_digest_to_bytes(
+    FoilOutput* out)
+{
+    FoilOutputMultiDigest* self = G_CAST(out, FoilOutputMultiDigest, parent);
+    GBytes* bytes = foil_output_free_to_bytes(self->out);
+
+    foil_digest_multi_unref(self->digests);
+    self->out = NULL;
+    self->digests = NULL;
+    return bytes;
+}
+
+static
+void
+foil_output_multi_digest_close(
+    FoilOutput* out)
+{
+    FoilOutputMultiDigest* self = G_CAST(out, FoilOutputMultiDigest, parent);
+
+    foil_output_unref(self->out);
+    foil_digest_multi_unref(self->digests);
+    self->out = NULL;
+    self->digests = NULL;
+}
+
+static
+void
+foil_output_multi_digest_free(
+    FoilOutput* out)
+{
+    FoilOutputMultiDigest* self = G_CAST(out, FoilOutputMultiDigest, parent);
+
+    GASSERT(!self->out);
+    GASSERT(!self->digests);
+    g_slice_free(FoilOutputMultiDigest, self);
+}
+
+FoilOutput*
+foil_output_multi_digest_new(
+    FoilOutput* out,
+    FoilDigestMulti* digests) /* Since 1.0.31 */
+{
+    static const FoilOutputFunc foil_output_multi_digest_fn = {
+        foil_output_multi_digest_write,     /* fn_write */
+        foil_output_multi_digest_writev,    /* fn_writev */
+        foil_output_multi_digest_reserve,   /* fn_reserve */
+        foil_output_multi_digest_flush,     /* fn_flush */
+        foil_output_multi_digest_reset,     /* fn_reset */
+        foil_output_multi_digest_to_bytes,  /* fn_to_bytes */
+        foil_output_multi_digest_close,     /* fn_close */
+        foil_output_multi_digest_free       /* fn_free */
+    };
+
+    if (G_LIKELY(digests)) {
+        FoilOutputMultiDigest* self = g_slice_new0(FoilOutputMultiDigest);
+
+        self->out = foil_output_ref(out);
+        self->digests = foil_digest_multi_ref(digests);
+        return foil_output_init(&self->parent, &foil_output_multi_digest_fn);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -40,6 +40,8 @@
 
 typedef struct foil_output_func {
     gssize (*fn_write)(FoilOutput* out, const void* buf, gsize size);
+    gssize (*fn_writev)(FoilOutput* out, const FoilBytes* bufs, guint n);
+    gboolean (*fn_reserve)(FoilOutput* out, gsize size);
     gboolean (*fn_flush)(FoilOutput* out);
     gboolean (*fn_reset)(FoilOutput* out);
     GBytes* (*fn_to_bytes)(FoilOutput* out);
@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_output_p.h"
+#include "foil_uring_p.h"
+#include "foil_file_p.h"
+
+#include <gutil_macros.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+#define GLOG_MODULE_NAME foil_log_output
+#include "foil_log_p.h"
+
+/*
+ * io_uring based output. The data are collected in registered buffers,
+ * each full buffer is handed over to the kernel and the next one is
+ * being filled while the previous ones are being written. Up to depth
+ * writes are kept in flight.
+ */
+
+typedef struct foil_output_uring_slot {
+    guint64 offset;     /* File offset of the first byte */
+    gsize len;          /* Number of bytes in the buffer */
+    gsize pos;          /* Number of bytes written */
+    gboolean busy;      /* Write is in flight */
+} FoilOutputUringSlot;
+
+typedef struct foil_output_uring {
+    FoilOutput parent;
+    int fd;
+    guint flags;
+    FoilUring* ring;
+    gsize bufsize;
+    guint depth;
+    guint current;
+    guint64 next_offset;
+    int error;
+    FoilOutputUringSlot* slots;
+} FoilOutputUring;
+
+static
+void
+foil_output_uring_submit(
+    FoilOutputUring* self,
+    guint index)
+{
+    FoilOutputUringSlot* slot = self->slots + index;
+
+    GASSERT(!slot->busy);
+    if (foil_uring_write(self->ring, self->fd, index, slot->pos,
+        slot->len - slot->pos, slot->offset + slot->pos)) {
+        slot->busy = TRUE;
+    } else {
+        self->error = EIO;
+        slot->len = slot->pos = 0;
+    }
+}
+
+static
+gboolean
+foil_output_uring_complete(
+    FoilOutputUring* self)
+{
+    guint index;
+    int res;
+
+    if (foil_uring_wait(self->ring, &index, &res) && index < self->depth) {
+        FoilOutputUringSlot* slot = self->slots + index;
+
+        slot->busy = FALSE;
+        if (res > 0) {
+            slot->pos += res;
+            if (slot->pos < slot->len) {
+                /* Short write, submit the rest */
+                foil_output_uring_submit(self, index);
+            } else {
+                slot->len = slot->pos = 0;
+            }
+        } else if (res == -EINTR || res == -EAGAIN) {
+            foil_output_uring_submit(self, index);
+        } else {
+            /* Zero-length write should never happen, treat it as EIO */
+            GDEBUG("io_uring write error %d", res);
+            self->error = res ? -res : EIO;
+            slot->len = slot->pos = 0;
+        }
+        return TRUE;
+    }
+    self->error = EIO;
+    return FALSE;
+}
+
+static
+gboolean
+foil_output_uring_wait_slot(
+    FoilOutputUring* self,
+    guint index)
+{
+    while (self->slots[index].busy) {
+        if (!foil_output_uring_complete(self)) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static
+gboolean
+foil_output_uring_drain(
+    FoilOutputUring* self)
+{
+    guint i;
+
+    for (i = 0; i < self->depth; i++) {
+        if (!foil_output_uring_wait_slot(self, i)) {
+            return FALSE;
+        }
+    }
+    return !self->error;
+}
+
+static
+gboolean
+foil_output_uring_push(
+    FoilOutputUring* self)
+{
+    FoilOutputUringSlot* slot = self->slots + self->current;
+
+    /* Submit the current buffer and wait for the next one to become free */
+    slot->offset = self->next_offset;
+    slot->pos = 0;
+    self->next_offset += slot->len;
+    foil_output_uring_submit(self, self->current);
+    self->current = (self->current + 1) % self->depth;
+    return foil_output_uring_wait_slot(self, self->current) && !self->error;
+}
+
+static
+gssize
+foil_output_uring_write(
+    FoilOutput* out,
+    const void* buf,
+    gsize size)
+{
+    FoilOutputUring* self = G_CAST(out, FoilOutputUring, parent);
+    const guint8* ptr = buf;
+    gsize total = 0;
+
+    if (self->fd < 0 || self->error) {
+        return -1;
+    }
+    while (total < size) {
+        FoilOutputUringSlot* slot = self->slots + self->current;
+        const gsize n = MIN(self->bufsize - slot->len, size - total);
+
+        GASSERT(!slot->busy);
+        memcpy(foil_uring_buffer(self->ring, self->current) + slot->len,
+            ptr + total, n);
+        slot->len += n;
+        total += n;
+        if (slot->len == self->bufsize && !foil_output_uring_push(self)) {
+            /* The data have been accepted but not necessarily written */
+            break;
+        }
+    }
+    return total ? (gssize)total : -1;
+}
+
+static
+gboolean
+foil_output_uring_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputUring* self = G_CAST(out, FoilOutputUring, parent);
+
+    return self->fd >= 0 && size && foil_file_preallocate(self->fd,
+        self->next_offset + self->slots[self->current].len, size);
+}
+
+static
+gboolean
+foil_output_uring_flush(
+    FoilOutput* out)
+{
+    FoilOutputUring* self = G_CAST(out, FoilOutputUring, parent);
+
+    if (self->fd < 0) {
+        return FALSE;
+    }
+    if (self->slots[self->current].len) {
+        foil_output_uring_push(self);
+    }
+    return foil_output_uring_drain(self);
+}
+
+static
+void
+foil_output_uring_close(
+    FoilOutput* out)
+{
+    FoilOutputUring* self = G_CAST(out, FoilOutputUring, parent);
+
+    /* foil_output_close() has already flushed everything */
+    foil_output_uring_drain(self);
+    if (self->flags & FOIL_OUTPUT_FILE_CLOSE) {
+        close(self->fd);
+    } else {
+        /* Leave the descriptor positioned at the end of our output */
+        lseek(self->fd, self->next_offset, SEEK_SET);
+    }
+    self->fd = -1;
+}
+
+static
+void
+foil_output_uring_free(
+    FoilOutput* out)
+{
+    FoilOutputUring* self = G_CAST(out, FoilOutputUring, parent);
+
+    GASSERT(self->fd < 0);
+    foil_uring_free(self->ring);
+    g_free(self->slots);
+    gutil_slice_free(self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+/* Since 1.0.31 */
+FoilOutput*
+foil_output_uring_new(
+    int fd,
+    guint flags,
+    gsize bufsize,
+    guint depth)
+{
+    if (fd >= 0) {
+        const gint64 start = lseek(fd, 0, SEEK_CUR);
+        gboolean ok = (start >= 0);
+
+        if (!bufsize) {
+            bufsize = FOIL_FILE_DEFAULT_BUFFER_SIZE;
+        } else if (bufsize > FOIL_URING_MAX_BUFFER_SIZE) {
+            bufsize = FOIL_URING_MAX_BUFFER_SIZE;
+        }
+        if (!depth) {
+            depth = FOIL_URING_DEFAULT_DEPTH;
+        } else if (depth > FOIL_URING_MAX_DEPTH) {
+            depth = FOIL_URING_MAX_DEPTH;
+        }
+
+#ifdef F_GETFL
+        /* Writes go to explicit offsets which doesn't work for O_APPEND */
+        if (ok) {
+            const int fl = fcntl(fd, F_GETFL);
+
+            ok = (fl >= 0 && !(fl & O_APPEND));
+        }
+#endif
+
+        if (ok) {
+            FoilUring* ring = foil_uring_new(depth, bufsize);
+
+            if (ring) {
+                static const FoilOutputFunc foil_output_uring_fn = {
+                    foil_output_uring_write,    /* fn_write */
+                    NULL,                       /* fn_writev */
+                    foil_output_uring_reserve,  /* fn_reserve */
+                    foil_output_uring_flush,    /* fn_flush */
+                    NULL,                       /* fn_reset */
+                    NULL,                       /* fn_to_bytes */
+                    foil_output_uring_close,    /* fn_close */
+                    foil_output_uring_free      /* fn_free */
+                };
+                FoilOutputUring* self = g_slice_new0(FoilOutputUring);
+
+                self->fd = fd;
+                self->flags = flags & FOIL_OUTPUT_FILE_CLOSE;
+                self->ring = ring;
+                self->bufsize = bufsize;
+                self->depth = depth;
+                self->next_offset = start;
+                self->slots = g_new0(FoilOutputUringSlot, depth);
+                return foil_output_init(&self->parent, &foil_output_uring_fn);
+            }
+        }
+
+        /* Fall back to synchronous writes */
+        return foil_output_file_new_fd(fd, flags, bufsize);
+    } else {
+        errno = EBADF;
+    }
+    return NULL;
+}
+
+/* Since 1.0.31 */
+FoilOutput*
+foil_output_uring_new_open(
+    const char* path)
+{
+    if (path) {
+        const int fd = foil_file_open(path, O_WRONLY | O_CREAT | O_TRUNC,
+            FALSE);
+
+        if (fd >= 0) {
+            return foil_output_uring_new(fd, FOIL_OUTPUT_FILE_CLOSE, 0, 0);
+        }
+    } else {
+        errno = EINVAL;
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
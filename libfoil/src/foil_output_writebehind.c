@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_output_p.h"
+
+#include <gutil_macros.h>
+
+#include <string.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_output
+#include "foil_log_p.h"
+
+/*
+ * Collects the data in a bounded ring of buffers and writes them to
+ * the wrapped stream on a helper thread. The wrapped stream belongs
+ * to the helper thread and must not be touched by anyone else.
+ * The calling thread only touches the wrapped stream (flush, reset
+ * and such) when the helper thread is idle.
+ */
+
+#define FOIL_OUTPUT_WRITEBEHIND_DEFAULT_CHUNK  (0x10000)
+#define FOIL_OUTPUT_WRITEBEHIND_DEFAULT_DEPTH  (4)
+
+typedef struct foil_output_writebehind {
+    FoilOutput parent;
+    FoilOutput* out;
+    GThread* thread;
+    GMutex mutex;
+    GCond cond;
+    gsize chunk;
+    guint depth;
+    guint8** bufs;
+    gsize* lens;
+    guint head;         /* The oldest queued buffer */
+    guint count;        /* Number of queued buffers */
+    gsize fill;         /* Number of bytes in the buffer being filled */
+    gboolean error;
+    gboolean stop;
+} FoilOutputWriteBehind;
+
+static
+gpointer
+foil_output_writebehind_thread(
+    gpointer data)
+{
+    FoilOutputWriteBehind* self = data;
+
+    g_mutex_lock(&self->mutex);
+    for (;;) {
+        guint index;
+        gboolean ok;
+
+        while (!self->count && !self->stop) {
+            g_cond_wait(&self->cond, &self->mutex);
+        }
+        if (!self->count) {
+            break;
+        }
+        index = self->head;
+        g_mutex_unlock(&self->mutex);
+
+        /* The buffer remains queued (and untouched) until it's written */
+        ok = foil_output_write_all(self->out, self->bufs[index],
+            self->lens[index]);
+
+        g_mutex_lock(&self->mutex);
+        if (!ok) {
+            self->error = TRUE;
+        }
+        self->head = (self->head + 1) % self->depth;
+        self->count--;
+        g_cond_broadcast(&self->cond);
+    }
+    g_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+static
+gboolean
+foil_output_writebehind_submit(
+    FoilOutputWriteBehind* self)
+{
+    gboolean ok;
+
+    /* Queue the buffer being filled and wait for a free one */
+    g_mutex_lock(&self->mutex);
+    self->lens[(self->head + self->count) % self->depth] = self->fill;
+    self->count++;
+    self->fill = 0;
+    g_cond_broadcast(&self->cond);
+    while (self->count == self->depth && !self->error) {
+        g_cond_wait(&self->cond, &self->mutex);
+    }
+    ok = !self->error;
+    g_mutex_unlock(&self->mutex);
+    return ok;
+}
+
+static
+gboolean
+foil_output_writebehind_wait_idle(
+    FoilOutputWriteBehind* self)
+{
+    gboolean ok;
+
+    g_mutex_lock(&self->mutex);
+    while (self->count) {
+        g_cond_wait(&self->cond, &self->mutex);
+    }
+    ok = !self->error;
+    g_mutex_unlock(&self->mutex);
+    return ok;
+}
+
+static
+void
+foil_output_writebehind_stop(
+    FoilOutputWriteBehind* self)
+{
+    if (self->thread) {
+        g_mutex_lock(&self->mutex);
+        self->stop = TRUE;
+        g_cond_broadcast(&self->cond);
+        g_mutex_unlock(&self->mutex);
+        g_thread_join(self->thread);
+        self->thread = NULL;
+    }
+}
+
+static
+gssize
+foil_output_writebehind_write(
+    FoilOutput* out,
+    const void* buf,
+    gsize size)
+{
+    FoilOutputWriteBehind* self = G_CAST(out, FoilOutputWriteBehind, parent);
+    const guint8* ptr = buf;
+    gsize total = 0;
+    guint index;
+
+    g_mutex_lock(&self->mutex);
+    if (self->error) {
+        g_mutex_unlock(&self->mutex);
+        return -1;
+    }
+    /* Only this thread moves head + count, the helper thread doesn't */
+    index = (self->head + self->count) % self->depth;
+    g_mutex_unlock(&self->mutex);
+
+    while (total < size) {
+        const gsize n = MIN(self->chunk - self->fill, size - total);
+
+        memcpy(self->bufs[index] + self->fill, ptr + total, n);
+        self->fill += n;
+        total += n;
+        if (self->fill == self->chunk) {
+            if (!foil_output_writebehind_submit(self)) {
+                /*
+                 * Something that had been queued earlier couldn't be
+                 * written, the output is broken. Don't pretend that
+                 * this data went anywhere.
+                 */
+                return -1;
+            }
+            index = (index + 1) % self->depth;
+        }
+    }
+    return total;
+}
+
+static
+gboolean
+foil_output_writebehind_reserve(
+    FoilOutput* out,
+    gsize size)
+{
+    FoilOutputWriteBehind* self = G_CAST(out, FoilOutputWriteBehind, parent);
+
+    return foil_output_writebehind_wait_idle(self) &&
+        foil_output_reserve(self->out, size + self->fill);
+}
+
+static
+gboolean
+foil_output_writebehind_flush(
+    FoilOutput* out)
+{
+    FoilOutputWriteBehind* self = G_CAST(out, FoilOutputWriteBehind, parent);
+
+    if (self->fill && !foil_output_writebehind_submit(self)) {
+        return FALSE;
+    }
+    return foil_output_writebehind_wait_idle(self) &&
+        foil_output_flush(self->out);
+}
+
+static
+gboolean
+foil_output_writebehind_reset(
+    FoilOutput* out)
+{
+    FoilOutputWriteBehind* self = G_CAST(out, FoilOutputWriteBehind, parent);
+
+    /* Let the helper thread finish what's already been queued */
+    foil_output_writebehind_wait_idle(self);
+    self->fill = 0;
+    if (foil_output_reset(self->out)) {
+        g_mutex_lock(&self->mutex);
+        self->error = FALSE;
+        g_mutex_unlock(&self->mutex);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+GBytes*
+foil_output_writebehind_to_bytes(
+    FoilOutput* out)
+{
+    FoilOutputWriteBehind* self = G_CAST(out, FoilOutputWriteBehind, parent);
+    GBytes* bytes;
+
+    /* Everything has been flushed by now */
+    foil_output_writebehind_stop(self);
+    bytes = foil_output_free_to_bytes(self->out);
+    self->out = NULL;
+    return bytes;
+}
+
+static
+void
+foil_output_writebehind_close(
+    FoilOutput* out)
+{
+    FoilOutputWriteBehind* self = G_CAST(out, FoilOutputWriteBehind, parent);
+
+    foil_output_writebehind_stop(self);
+    foil_output_unref(self->out);
+    self->out = NULL;
+}
+
+static
+void
+foil_output_writebehind_free(
+    FoilOutput* out)
+{
+    FoilOutputWriteBehind* self = G_CAST(out, FoilOutputWriteBehind, parent);
+    guint i;
+
+    GASSERT(!self->out);
+    GASSERT(!self->thread);
+    for (i = 0; i < self->depth; i++) {
+        g_free(self->bufs[i]);
+    }
+    g_free(self->bufs);
+    g_free(self->lens);
+    g_cond_clear(&self->cond);
+    g_mutex_clear(&self->mutex);
+    gutil_slice_free(self);
+}
+
+/* Since 1.0.31 */
+FoilOutput*
+foil_output_writebehind_new(
+    FoilOutput* out,
+    gsize chunk,
+    guint depth)
+{
+    static const FoilOutputFunc foil_output_writebehind_fn = {
+        foil_output_writebehind_write,      /* fn_write */
+        NULL,                               /* fn_writev */
+        foil_output_writebehind_reserve,    /* fn_reserve */
+        foil_output_writebehind_flush,      /* fn_flush */
+        foil_output_writebehind_reset,      /* fn_reset */
+        foil_output_writebehind_to_bytes,   /* fn_to_bytes */
+        foil_output_writebehind_close,      /* fn_close */
+        foil_output_writebehind_free        /* fn_free */
+    };
+    if (G_LIKELY(out)) {
+        FoilOutputWriteBehind* self = g_slice_new0(FoilOutputWriteBehind);
+        GError* error = NULL;
+        guint i;
+
+        self->out = foil_output_ref(out);
+        self->chunk = chunk ? chunk : FOIL_OUTPUT_WRITEBEHIND_DEFAULT_CHUNK;
+        self->depth = depth ? depth : FOIL_OUTPUT_WRITEBEHIND_DEFAULT_DEPTH;
+        self->bufs = g_new(guint8*, self->depth);
+        self->lens = g_new0(gsize, self->depth);
+        for (i = 0; i < self->depth; i++) {
+            self->bufs[i] = g_malloc(self->chunk);
+        }
+        g_mutex_init(&self->mutex);
+        g_cond_init(&self->cond);
+        self->thread = g_thread_try_new("foil-writebehind",
+            foil_output_writebehind_thread, self, &error);
+        if (self->thread) {
+            return foil_output_init(&self->parent,
+                &foil_output_writebehind_fn);
+        }
+
+        /* No thread, no write-behind */
+        GWARN("Failed to start write-behind thread: %s", GERRMSG(error));
+        g_error_free(error);
+        foil_output_unref(self->out);
+        self->out = NULL;
+        foil_output_writebehind_free(&self->parent);
+        return foil_output_ref(out);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
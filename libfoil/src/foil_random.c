@@ -62,10 +62,18 @@ FoilRandomClass*
 foil_random_get_default(
     void)
 {
-    if (!foil_random_default) {
-        foil_random_default = foil_random_class_ref(FOIL_RANDOM_DEFAULT);
+    FoilRandomClass* klass = g_atomic_pointer_get(&foil_random_default);
+
+    if (!klass) {
+        klass = foil_random_class_ref(FOIL_RANDOM_DEFAULT);
+        if (!g_atomic_pointer_compare_and_exchange(&foil_random_default,
+            NULL, klass)) {
+            /* Lost the race, possibly to foil_random_set_default() */
+            g_type_class_unref(klass);
+            klass = g_atomic_pointer_get(&foil_random_default);
+        }
     }
-    return foil_random_default;
+    return klass;
 }
 
 gboolean
@@ -85,6 +93,28 @@ foil_random_generate(
     return ok;
 }
 
+gboolean
+foil_random_set_default(
+    GType type) /* Since 1.0.31 */
+{
+    FoilRandomClass* klass = foil_random_class_ref(type ? type :
+        FOIL_RANDOM_DEFAULT);
+
+    if (G_LIKELY(klass)) {
+        FoilRandomClass* prev = g_atomic_pointer_get(&foil_random_default);
+
+        while (!g_atomic_pointer_compare_and_exchange(&foil_random_default,
+            prev, klass)) {
+            prev = g_atomic_pointer_get(&foil_random_default);
+        }
+        if (prev) {
+            g_type_class_unref(prev);
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
 GBytes*
 foil_random_generate_bytes(
     GType type,
@@ -31,8 +31,27 @@
 #include "foil_cipher.h"
 #include "foil_digest.h"
 #include "foil_key.h"
+#include "foil_input.h"
+#include "foil_output.h"
+#include "foil_private_key.h"
 #include "foil_util_p.h"
 
+#include "foil_log_p.h"
+
+struct foil_signer {
+    gint ref_count;
+    GType cipher_type;
+    FoilDigest* digest;
+    FoilPrivateKey* priv;
+};
+
+struct foil_verifier {
+    gint ref_count;
+    GType cipher_type;
+    FoilDigest* digest;
+    FoilKey* pub;
+};
+
 GBytes*
 foil_sign(
     const FoilBytes* bytes,
@@ -74,6 +93,191 @@ foil_verify(
     return ok;
 }
 
+/*==========================================================================*
+ * Signer
+ *==========================================================================*/
+
+FoilSigner*
+foil_signer_new(
+    GType digest_type,
+    GType cipher_type,
+    FoilPrivateKey* priv) /* Since 1.0.31 */
+{
+    if (G_LIKELY(priv) && G_LIKELY(cipher_type)) {
+        FoilDigest* digest = foil_digest_new(digest_type);
+
+        if (digest) {
+            FoilSigner* self = g_slice_new0(FoilSigner);
+
+            g_atomic_int_set(&self->ref_count, 1);
+            self->cipher_type = cipher_type;
+            self->digest = digest;
+            self->priv = foil_private_key_ref(priv);
+            return self;
+        }
+    }
+    return NULL;
+}
+
+FoilSigner*
+foil_signer_ref(
+    FoilSigner* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        g_atomic_int_inc(&self->ref_count);
+    }
+    return self;
+}
+
+void
+foil_signer_unref(
+    FoilSigner* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&self->ref_count)) {
+            foil_digest_unref(self->digest);
+            foil_private_key_unref(self->priv);
+            g_slice_free(FoilSigner, self);
+        }
+    }
+}
+
+gboolean
+foil_signer_update(
+    FoilSigner* self,
+    const void* data,
+    gsize size) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) && G_LIKELY(self->priv) &&
+        foil_digest_update(self->digest, data, size);
+}
+
+GBytes*
+foil_signer_finish(
+    FoilSigner* self) /* Since 1.0.31 */
+{
+    GBytes* sign = NULL;
+
+    /* The private key is dropped as soon as it's no longer needed */
+    if (G_LIKELY(self) && G_LIKELY(self->priv)) {
+        GBytes* digest = foil_digest_finish(self->digest);
+
+        if (digest) {
+            sign = foil_cipher_bytes(self->cipher_type, FOIL_KEY(self->priv),
+                digest);
+        }
+        foil_private_key_unref(self->priv);
+        self->priv = NULL;
+    }
+    return sign;
+}
+
+FoilOutput*
+foil_output_sign_new(
+    FoilOutput* out,
+    FoilSigner* signer) /* Since 1.0.31 */
+{
+    return G_LIKELY(signer) ? foil_output_digest_new(out, signer->digest) :
+        NULL;
+}
+
+/*==========================================================================*
+ * Verifier
+ *==========================================================================*/
+
+FoilVerifier*
+foil_verifier_new(
+    GType digest_type,
+    GType cipher_type,
+    FoilKey* pub) /* Since 1.0.31 */
+{
+    if (G_LIKELY(pub) && G_LIKELY(cipher_type)) {
+        FoilDigest* digest = foil_digest_new(digest_type);
+
+        if (digest) {
+            FoilVerifier* self = g_slice_new0(FoilVerifier);
+
+            g_atomic_int_set(&self->ref_count, 1);
+            self->cipher_type = cipher_type;
+            self->digest = digest;
+            self->pub = foil_key_ref(pub);
+            return self;
+        }
+    }
+    return NULL;
+}
+
+FoilVerifier*
+foil_verifier_ref(
+    FoilVerifier* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        g_atomic_int_inc(&self->ref_count);
+    }
+    return self;
+}
+
+void
+foil_verifier_unref(
+    FoilVerifier* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->ref_count > 0);
+        if (g_atomic_int_dec_and_test(&self->ref_count)) {
+            foil_digest_unref(self->digest);
+            foil_key_unref(self->pub);
+            g_slice_free(FoilVerifier, self);
+        }
+    }
+}
+
+gboolean
+foil_verifier_update(
+    FoilVerifier* self,
+    const void* data,
+    gsize size) /* Since 1.0.31 */
+{
+    return G_LIKELY(self) && G_LIKELY(self->pub) &&
+        foil_digest_update(self->digest, data, size);
+}
+
+gboolean
+foil_verifier_finish(
+    FoilVerifier* self,
+    const FoilBytes* sign) /* Since 1.0.31 */
+{
+    gboolean ok = FALSE;
+
+    if (G_LIKELY(self) && G_LIKELY(self->pub)) {
+        GBytes* d2 = foil_digest_finish(self->digest);
+
+        if (d2 && G_LIKELY(sign)) {
+            GBytes* d1 = foil_cipher_data(self->cipher_type, self->pub,
+                sign->val, sign->len);
+
+            if (d1) {
+                ok = g_bytes_equal(d1, d2);
+                g_bytes_unref(d1);
+            }
+        }
+        foil_key_unref(self->pub);
+        self->pub = NULL;
+    }
+    return ok;
+}
+
+FoilInput*
+foil_input_verify_new(
+    FoilInput* in,
+    FoilVerifier* verifier) /* Since 1.0.31 */
+{
+    return G_LIKELY(verifier) ? foil_input_digest_new(in, verifier->digest) :
+        NULL;
+}
+
 /*
  * Local Variables:
  * mode: C
@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_stats_p.h"
+
+#include "foil_log_p.h"
+
+#include <time.h>
+
+/*
+ * Each thread has its own array of counters which only that thread
+ * updates, so counting requires no locking. Counters are identified
+ * by the slot index. Slots are allocated from the global registry on
+ * the first use of the (kind, id, op) combination and each thread
+ * caches the mapping, the registry is only locked on cache misses.
+ * When a thread exits, its counters are added to the retired ones.
+ * Counters only ever go up, foil_stats_reset() remembers the totals
+ * and foil_stats_snapshot() reports the difference.
+ */
+
+#define FOIL_STATS_MAX_SLOTS (256)
+
+/* Bits in foil_stats_flags */
+#define FOIL_STATS_ACTIVE_COUNT (0x01)
+#define FOIL_STATS_ACTIVE_TRACE (0x02)
+
+typedef struct foil_stats_key {
+    FoilStatsKind kind;
+    gconstpointer id;
+    const char* op;
+} FoilStatsKey;
+
+typedef struct foil_stats_slot {
+    FoilStatsKey key;
+    const char* name;
+} FoilStatsSlot;
+
+typedef struct foil_stats_counter {
+    guint64 ops;
+    guint64 bytes;
+    guint64 nsec;
+} FoilStatsCounter;
+
+/*
+ * The trace function and its data are published together as a single
+ * pointer, so that foil_stats_end() can pick them up without locking.
+ * These are never modified or freed once published, because another
+ * thread may still be looking at the old one. Identical pairs are
+ * reused, so the list only grows with the number of distinct ones.
+ */
+typedef struct foil_stats_trace {
+    FoilStatsTraceFunc fn;
+    void* user_data;
+} FoilStatsTrace;
+
+typedef struct foil_stats_thread {
+    GHashTable* slots;
+    FoilStatsCounter counter[FOIL_STATS_MAX_SLOTS];
+} FoilStatsThread;
+
+gint foil_stats_flags = 0;
+
+static GMutex foil_stats_mutex;
+static FoilStatsTrace* foil_stats_trace = NULL;
+static GSList* foil_stats_traces = NULL;
+static GHashTable* foil_stats_registry = NULL;
+static FoilStatsSlot foil_stats_slot[FOIL_STATS_MAX_SLOTS];
+static guint foil_stats_nslots = 0;
+static GSList* foil_stats_threads = NULL;
+static FoilStatsCounter foil_stats_retired[FOIL_STATS_MAX_SLOTS];
+static FoilStatsCounter foil_stats_base[FOIL_STATS_MAX_SLOTS];
+
+static
+guint
+foil_stats_key_hash(
+    gconstpointer data)
+{
+    const FoilStatsKey* key = data;
+
+    return GPOINTER_TO_UINT(key->id) * 31 + g_str_hash(key->op) + key->kind;
+}
+
+static
+gboolean
+foil_stats_key_equal(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const FoilStatsKey* k1 = a;
+    const FoilStatsKey* k2 = b;
+
+    return k1->kind == k2->kind && k1->id == k2->id &&
+        !strcmp(k1->op, k2->op);
+}
+
+static
+void
+foil_stats_add(
+    FoilStatsCounter* dest,
+    const FoilStatsCounter* src,
+    guint n)
+{
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        dest[i].ops += src[i].ops;
+        dest[i].bytes += src[i].bytes;
+        dest[i].nsec += src[i].nsec;
+    }
+}
+
+/* Must be called under foil_stats_mutex */
+static
+void
+foil_stats_total(
+    FoilStatsCounter* total,
+    guint n)
+{
+    GSList* l;
+
+    memcpy(total, foil_stats_retired, sizeof(total[0]) * n);
+    for (l = foil_stats_threads; l; l = l->next) {
+        const FoilStatsThread* thread = l->data;
+
+        foil_stats_add(total, thread->counter, n);
+    }
+}
+
+static inline
+guint64
+foil_stats_diff(
+    guint64 value,
+    guint64 base)
+{
+    /* Reading a counter being updated may produce garbage */
+    return (value > base) ? (value - base) : 0;
+}
+
+static
+void
+foil_stats_thread_free(
+    gpointer data)
+{
+    FoilStatsThread* thread = data;
+
+    g_mutex_lock(&foil_stats_mutex);
+    foil_stats_add(foil_stats_retired, thread->counter, foil_stats_nslots);
+    foil_stats_threads = g_slist_remove(foil_stats_threads, thread);
+    g_mutex_unlock(&foil_stats_mutex);
+    g_hash_table_destroy(thread->slots);
+    g_free(thread);
+}
+
+static GPrivate foil_stats_thread_key = G_PRIVATE_INIT(foil_stats_thread_free);
+
+static
+FoilStatsThread*
+foil_stats_thread(
+    void)
+{
+    FoilStatsThread* thread = g_private_get(&foil_stats_thread_key);
+
+    if (!thread) {
+        thread = g_new0(FoilStatsThread, 1);
+        thread->slots = g_hash_table_new(foil_stats_key_hash,
+            foil_stats_key_equal);
+        g_mutex_lock(&foil_stats_mutex);
+        foil_stats_threads = g_slist_prepend(foil_stats_threads, thread);
+        g_mutex_unlock(&foil_stats_mutex);
+        g_private_set(&foil_stats_thread_key, thread);
+    }
+    return thread;
+}
+
+/* Returns NULL if we have run out of slots */
+static
+FoilStatsCounter*
+foil_stats_counter(
+    FoilStatsKind kind,
+    gconstpointer id,
+    const char* name,
+    const char* op)
+{
+    FoilStatsThread* thread = foil_stats_thread();
+    FoilStatsKey key;
+    gpointer value;
+
+    key.kind = kind;
+    key.id = id;
+    key.op = op;
+    value = g_hash_table_lookup(thread->slots, &key);
+    if (!value) {
+        g_mutex_lock(&foil_stats_mutex);
+        if (!foil_stats_registry) {
+            foil_stats_registry = g_hash_table_new(foil_stats_key_hash,
+                foil_stats_key_equal);
+        }
+        value = g_hash_table_lookup(foil_stats_registry, &key);
+        if (!value && foil_stats_nslots < FOIL_STATS_MAX_SLOTS) {
+            FoilStatsSlot* slot = foil_stats_slot + foil_stats_nslots;
+
+            slot->key = key;
+            slot->name = name;
+            value = GUINT_TO_POINTER(++foil_stats_nslots);
+            g_hash_table_insert(foil_stats_registry, &slot->key, value);
+        }
+        g_mutex_unlock(&foil_stats_mutex);
+        if (!value) {
+            return NULL;
+        }
+
+        /* Registry slots never go away, the key can be shared */
+        g_hash_table_insert(thread->slots, &foil_stats_slot
+            [GPOINTER_TO_UINT(value) - 1].key, value);
+    }
+    return thread->counter + (GPOINTER_TO_UINT(value) - 1);
+}
+
+static
+void
+foil_stats_update_active(
+    gboolean count)
+{
+    g_atomic_int_set(&foil_stats_flags,
+        (count ? FOIL_STATS_ACTIVE_COUNT : 0) |
+        (foil_stats_trace ? FOIL_STATS_ACTIVE_TRACE : 0));
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+void
+foil_stats_enable(
+    gboolean enable) /* Since 1.0.31 */
+{
+    g_mutex_lock(&foil_stats_mutex);
+    foil_stats_update_active(enable);
+    g_mutex_unlock(&foil_stats_mutex);
+}
+
+gboolean
+foil_stats_enabled(
+    void) /* Since 1.0.31 */
+{
+    return (g_atomic_int_get(&foil_stats_flags) &
+        FOIL_STATS_ACTIVE_COUNT) != 0;
+}
+
+gboolean
+foil_stats_active(
+    void) /* Since 1.0.31 */
+{
+    return g_atomic_int_get(&foil_stats_flags) != 0;
+}
+
+FoilStats*
+foil_stats_snapshot(
+    void) /* Since 1.0.31 */
+{
+    FoilStats* stats;
+    FoilStatsEntry* entries;
+    FoilStatsCounter* total;
+    guint i, n;
+
+    g_mutex_lock(&foil_stats_mutex);
+    n = foil_stats_nslots;
+    total = g_new(FoilStatsCounter, MAX(n, 1));
+    foil_stats_total(total, n);
+
+    /* Entries follow the header in the same block of memory */
+    stats = g_malloc0(sizeof(FoilStats) + sizeof(FoilStatsEntry) * n);
+    entries = (FoilStatsEntry*)(stats + 1);
+    for (i = 0; i < n; i++) {
+        const FoilStatsSlot* slot = foil_stats_slot + i;
+        FoilStatsEntry* entry = entries + i;
+
+        entry->kind = slot->key.kind;
+        entry->name = slot->name;
+        entry->op = slot->key.op;
+        entry->ops = foil_stats_diff(total[i].ops, foil_stats_base[i].ops);
+        entry->bytes = foil_stats_diff(total[i].bytes,
+            foil_stats_base[i].bytes);
+        entry->nsec = foil_stats_diff(total[i].nsec,
+            foil_stats_base[i].nsec);
+    }
+    g_mutex_unlock(&foil_stats_mutex);
+    g_free(total);
+    stats->entries = entries;
+    stats->count = n;
+    return stats;
+}
+
+void
+foil_stats_free(
+    FoilStats* stats) /* Since 1.0.31 */
+{
+    g_free(stats);
+}
+
+void
+foil_stats_reset(
+    void) /* Since 1.0.31 */
+{
+    /* Other threads may be updating their counters, leave them alone */
+    g_mutex_lock(&foil_stats_mutex);
+    foil_stats_total(foil_stats_base, foil_stats_nslots);
+    g_mutex_unlock(&foil_stats_mutex);
+}
+
+void
+foil_stats_set_trace_func(
+    FoilStatsTraceFunc fn,
+    void* user_data) /* Since 1.0.31 */
+{
+    FoilStatsTrace* trace = NULL;
+
+    g_mutex_lock(&foil_stats_mutex);
+    if (fn) {
+        GSList* l;
+
+        for (l = foil_stats_traces; l && !trace; l = l->next) {
+            FoilStatsTrace* t = l->data;
+
+            if (t->fn == fn && t->user_data == user_data) {
+                trace = t;
+            }
+        }
+        if (!trace) {
+            trace = g_new(FoilStatsTrace, 1);
+            trace->fn = fn;
+            trace->user_data = user_data;
+            foil_stats_traces = g_slist_prepend(foil_stats_traces, trace);
+        }
+    }
+    g_atomic_pointer_set(&foil_stats_trace, trace);
+    foil_stats_update_active(foil_stats_enabled());
+    g_mutex_unlock(&foil_stats_mutex);
+}
+
+gint64
+foil_stats_begin(
+    void) /* Since 1.0.31 */
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((gint64)ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void
+foil_stats_end(
+    FoilStatsKind kind,
+    gconstpointer id,
+    const char* name,
+    const char* op,
+    guint64 bytes,
+    gint64 start) /* Since 1.0.31 */
+{
+    const gint active = g_atomic_int_get(&foil_stats_flags);
+    const gint64 nsec = foil_stats_begin() - start;
+
+    if (active & FOIL_STATS_ACTIVE_COUNT) {
+        FoilStatsCounter* counter = foil_stats_counter(kind, id, name, op);
+
+        if (counter) {
+            counter->ops++;
+            counter->bytes += bytes;
+            counter->nsec += nsec;
+        }
+    }
+    if (active & FOIL_STATS_ACTIVE_TRACE) {
+        const FoilStatsTrace* trace = g_atomic_pointer_get(&foil_stats_trace);
+
+        if (trace) {
+            FoilStatsSpan span;
+
+            span.kind = kind;
+            span.name = name;
+            span.op = op;
+            span.bytes = bytes;
+            span.start = start;
+            span.nsec = nsec;
+            trace->fn(&span, trace->user_data);
+        }
+    }
+}
+
+void
+foil_stats_count(
+    FoilStatsKind kind,
+    gconstpointer id,
+    const char* name,
+    const char* op) /* Since 1.0.31 */
+{
+    if (g_atomic_int_get(&foil_stats_flags) & FOIL_STATS_ACTIVE_COUNT) {
+        FoilStatsCounter* counter = foil_stats_counter(kind, id, name, op);
+
+        if (counter) {
+            counter->ops++;
+        }
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,272 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_thread_pool_p.h"
+#include "foil_util.h"
+#include "foil_log_p.h"
+
+#include <unistd.h>
+
+/*
+ * The pool is created on demand and stays around. Idle threads are
+ * eventually let go by glib. Each batch keeps no more pool tasks in
+ * flight than there are pool threads, each task runs the batch's jobs
+ * until there are none left.
+ */
+
+typedef struct foil_thread_job {
+    FoilThreadFunc fn;
+    gpointer data;
+} FoilThreadJob;
+
+typedef struct foil_parallel_call {
+    FoilParallelFunc fn;
+    gpointer user_data;
+    guint count;
+    gint next;
+} FoilParallelCall;
+
+struct foil_thread_batch {
+    gint ref_count;
+    GMutex mutex;
+    GCond cond;
+    GQueue jobs;        /* Not started yet */
+    guint running;      /* Being run by the pool threads */
+    guint tasks;        /* Pool tasks queued or running */
+};
+
+static
+FoilThreadBatch*
+foil_thread_batch_ref(
+    FoilThreadBatch* batch)
+{
+    GASSERT(batch->ref_count > 0);
+    g_atomic_int_inc(&batch->ref_count);
+    return batch;
+}
+
+static
+void
+foil_thread_batch_unref(
+    FoilThreadBatch* batch)
+{
+    GASSERT(batch->ref_count > 0);
+    if (g_atomic_int_dec_and_test(&batch->ref_count)) {
+        GASSERT(!batch->jobs.length);
+        GASSERT(!batch->running);
+        g_cond_clear(&batch->cond);
+        g_mutex_clear(&batch->mutex);
+        g_slice_free(FoilThreadBatch, batch);
+    }
+}
+
+static
+void
+foil_thread_job_run(
+    FoilThreadJob* job)
+{
+    job->fn(job->data);
+    g_slice_free(FoilThreadJob, job);
+}
+
+static
+void
+foil_thread_pool_task(
+    gpointer data,
+    gpointer user_data)
+{
+    FoilThreadBatch* batch = data;
+    FoilThreadJob* job;
+
+    g_mutex_lock(&batch->mutex);
+    while ((job = g_queue_pop_head(&batch->jobs)) != NULL) {
+        batch->running++;
+        g_mutex_unlock(&batch->mutex);
+        foil_thread_job_run(job);
+        g_mutex_lock(&batch->mutex);
+        if (!--batch->running) {
+            g_cond_broadcast(&batch->cond);
+        }
+    }
+    batch->tasks--;
+    g_mutex_unlock(&batch->mutex);
+    foil_thread_batch_unref(batch);
+}
+
+static
+GThreadPool*
+foil_thread_pool(
+    void)
+{
+    static gsize pool = 0;
+
+    if (g_once_init_enter(&pool)) {
+        g_once_init_leave(&pool, (gsize) g_thread_pool_new
+            (foil_thread_pool_task, NULL, foil_ncpu(), FALSE, NULL));
+    }
+    return (GThreadPool*)pool;
+}
+
+guint
+foil_ncpu(
+    void)
+{
+    static gsize ncpu = 0;
+
+    if (g_once_init_enter(&ncpu)) {
+        const long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+        g_once_init_leave(&ncpu, (gsize)MAX(n, 1));
+    }
+    return (guint)ncpu;
+}
+
+void
+foil_thread_pool_push(
+    FoilThreadFunc fn,
+    gpointer data)
+{
+    FoilThreadBatch* batch = foil_thread_batch_new();
+
+    /* The pool task holds its own reference */
+    foil_thread_batch_push(batch, fn, data);
+    foil_thread_batch_unref(batch);
+}
+
+FoilThreadBatch*
+foil_thread_batch_new(
+    void)
+{
+    FoilThreadBatch* batch = g_slice_new0(FoilThreadBatch);
+
+    g_atomic_int_set(&batch->ref_count, 1);
+    g_mutex_init(&batch->mutex);
+    g_cond_init(&batch->cond);
+    g_queue_init(&batch->jobs);
+    return batch;
+}
+
+void
+foil_thread_batch_push(
+    FoilThreadBatch* batch,
+    FoilThreadFunc fn,
+    gpointer data)
+{
+    FoilThreadJob* job = g_slice_new(FoilThreadJob);
+    gboolean new_task = FALSE;
+
+    job->fn = fn;
+    job->data = data;
+    g_mutex_lock(&batch->mutex);
+    g_queue_push_tail(&batch->jobs, job);
+    if (batch->tasks < foil_ncpu()) {
+        batch->tasks++;
+        new_task = TRUE;
+    }
+    g_mutex_unlock(&batch->mutex);
+    if (new_task) {
+        g_thread_pool_push(foil_thread_pool(),
+            foil_thread_batch_ref(batch), NULL);
+    }
+}
+
+void
+foil_thread_batch_finish(
+    FoilThreadBatch* batch)
+{
+    FoilThreadJob* job;
+
+    /* Don't just sit there, help */
+    g_mutex_lock(&batch->mutex);
+    while ((job = g_queue_pop_head(&batch->jobs)) != NULL) {
+        g_mutex_unlock(&batch->mutex);
+        foil_thread_job_run(job);
+        g_mutex_lock(&batch->mutex);
+    }
+    while (batch->running) {
+        g_cond_wait(&batch->cond, &batch->mutex);
+    }
+    g_mutex_unlock(&batch->mutex);
+    foil_thread_batch_unref(batch);
+}
+
+
+/* Each runner keeps making calls until all indices are taken */
+static
+void
+foil_parallel_run_calls(
+    gpointer data)
+{
+    FoilParallelCall* call = data;
+    gint i;
+
+    while ((i = g_atomic_int_add(&call->next, 1)) < (gint)call->count) {
+        call->fn(i, call->user_data);
+    }
+}
+
+void
+foil_parallel_run(
+    guint count,
+    FoilParallelFunc fn,
+    gpointer user_data) /* Since 1.0.31 */
+{
+    if (G_LIKELY(fn) && count) {
+        const guint nthreads = MIN(foil_ncpu(), count);
+        FoilParallelCall call;
+
+        call.fn = fn;
+        call.user_data = user_data;
+        call.count = count;
+        call.next = 0;
+        if (nthreads > 1) {
+            FoilThreadBatch* batch = foil_thread_batch_new();
+            guint i;
+
+            for (i = 1; i < nthreads; i++) {
+                foil_thread_batch_push(batch, foil_parallel_run_calls, &call);
+            }
+            foil_parallel_run_calls(&call);
+            foil_thread_batch_finish(batch);
+        } else {
+            foil_parallel_run_calls(&call);
+        }
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_THREAD_POOL_P_H
+#define FOIL_THREAD_POOL_P_H
+
+#include "foil_types_p.h"
+
+/*
+ * The thread pool shared by the whole library, with as many threads
+ * as there are CPUs. Jobs are grouped into batches, the thread which
+ * waits for a batch runs the jobs which the pool threads haven't picked
+ * up yet. Therefore, jobs may wait for their own (nested) batches
+ * without running the risk of a deadlock.
+ */
+
+typedef struct foil_thread_batch FoilThreadBatch;
+
+typedef
+void
+(*FoilThreadFunc)(
+    gpointer data);
+
+guint
+foil_ncpu(
+    void)
+    FOIL_INTERNAL;
+
+/* Fire and forget */
+void
+foil_thread_pool_push(
+    FoilThreadFunc fn,
+    gpointer data)
+    FOIL_INTERNAL;
+
+FoilThreadBatch*
+foil_thread_batch_new(
+    void)
+    FOIL_INTERNAL;
+
+void
+foil_thread_batch_push(
+    FoilThreadBatch* batch,
+    FoilThreadFunc fn,
+    gpointer data)
+    FOIL_INTERNAL;
+
+/* Waits for all jobs to complete and frees the batch */
+void
+foil_thread_batch_finish(
+    FoilThreadBatch* batch)
+    FOIL_INTERNAL;
+
+#endif /* FOIL_THREAD_POOL_P_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
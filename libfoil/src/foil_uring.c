@@ -0,0 +1,451 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_uring_p.h"
+
+#include <gutil_macros.h>
+
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    include <sys/syscall.h>
+#    if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+        defined(__NR_io_uring_register)
+#      define FOIL_HAVE_URING
+#    endif
+#  endif
+#endif
+
+#include "foil_log_p.h"
+
+#ifdef FOIL_HAVE_URING
+
+#include <linux/io_uring.h>
+
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+struct foil_uring {
+    int fd;
+    guint depth;
+    gsize bufsize;
+    guint8** bufs;
+    void* sq_ptr;
+    gsize sq_size;
+    void* cq_ptr;
+    gsize cq_size;
+    struct io_uring_sqe* sqes;
+    gsize sqes_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_entries;
+    unsigned* sq_array;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    gboolean broken;
+};
+
+static
+int
+foil_uring_setup(
+    unsigned entries,
+    struct io_uring_params* p)
+{
+    return (int) syscall(__NR_io_uring_setup, entries, p);
+}
+
+static
+int
+foil_uring_enter(
+    int fd,
+    unsigned to_submit,
+    unsigned min_complete,
+    unsigned flags)
+{
+    int ret;
+
+    do {
+        ret = (int) syscall(__NR_io_uring_enter, fd, to_submit,
+            min_complete, flags, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+    return ret;
+}
+
+static
+int
+foil_uring_register(
+    int fd,
+    unsigned opcode,
+    const void* arg,
+    unsigned nr_args)
+{
+    return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static
+void
+foil_uring_unmap(
+    FoilUring* ring)
+{
+    if (ring->sqes) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ptr && ring->cq_ptr != ring->sq_ptr) {
+        munmap(ring->cq_ptr, ring->cq_size);
+    }
+    if (ring->sq_ptr) {
+        munmap(ring->sq_ptr, ring->sq_size);
+    }
+}
+
+static
+gboolean
+foil_uring_map(
+    FoilUring* ring,
+    const struct io_uring_params* p)
+{
+    guint8* sq;
+    guint8* cq;
+
+    ring->sq_size = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+    ring->cq_size = p->cq_off.cqes + p->cq_entries *
+        sizeof(struct io_uring_cqe);
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        ring->sq_size = ring->cq_size = MAX(ring->sq_size, ring->cq_size);
+    }
+
+    ring->sq_ptr = mmap(NULL, ring->sq_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED) {
+        ring->sq_ptr = NULL;
+        return FALSE;
+    }
+
+    if (p->features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ptr = ring->sq_ptr;
+    } else {
+        ring->cq_ptr = mmap(NULL, ring->cq_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ptr == MAP_FAILED) {
+            ring->cq_ptr = NULL;
+            return FALSE;
+        }
+    }
+
+    ring->sqes_size = p->sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        return FALSE;
+    }
+
+    sq = ring->sq_ptr;
+    ring->sq_head = (unsigned*)(sq + p->sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + p->sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + p->sq_off.ring_mask);
+    ring->sq_entries = (unsigned*)(sq + p->sq_off.ring_entries);
+    ring->sq_array = (unsigned*)(sq + p->sq_off.array);
+
+    cq = ring->cq_ptr;
+    ring->cq_head = (unsigned*)(cq + p->cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + p->cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + p->cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + p->cq_off.cqes);
+    return TRUE;
+}
+
+static
+gboolean
+foil_uring_alloc_buffers(
+    FoilUring* ring)
+{
+    struct iovec* iov = g_new(struct iovec, ring->depth);
+    guint i;
+    int ret;
+
+    ring->bufs = g_new0(guint8*, ring->depth);
+    for (i = 0; i < ring->depth; i++) {
+        void* ptr = NULL;
+
+        if (posix_memalign(&ptr, 0x1000, ring->bufsize)) {
+            g_free(iov);
+            return FALSE;
+        }
+        ring->bufs[i] = ptr;
+        iov[i].iov_base = ptr;
+        iov[i].iov_len = ring->bufsize;
+    }
+
+    /* This may fail e.g. because of RLIMIT_MEMLOCK */
+    ret = foil_uring_register(ring->fd, IORING_REGISTER_BUFFERS, iov,
+        ring->depth);
+    g_free(iov);
+    if (ret < 0) {
+        GDEBUG("Failed to register io_uring buffers: %s", strerror(errno));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static
+gboolean
+foil_uring_submit(
+    FoilUring* ring,
+    guint8 opcode,
+    int fd,
+    guint index,
+    gsize pos,
+    gsize len,
+    guint64 offset)
+{
+    const unsigned tail = *ring->sq_tail;
+    const unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    GASSERT(index < ring->depth);
+    GASSERT(pos + len <= ring->bufsize);
+    if (!ring->broken && tail - head < *ring->sq_entries) {
+        const unsigned i = tail & *ring->sq_mask;
+        struct io_uring_sqe* sqe = ring->sqes + i;
+        int ret;
+
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->off = offset;
+        sqe->addr = (guint64)(gsize)(ring->bufs[index] + pos);
+        sqe->len = (guint32)len;
+        sqe->buf_index = (guint16)index;
+        sqe->user_data = index;
+        ring->sq_array[i] = i;
+        __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+        ret = foil_uring_enter(ring->fd, 1, 0, 0);
+        if (ret > 0) {
+            return TRUE;
+        }
+        GWARN("io_uring_enter failed: %s", ret ? strerror(errno) :
+            "nothing submitted");
+
+        /*
+         * Without SQPOLL the kernel only picks up entries inside
+         * io_uring_enter, so if it didn't consume this one, take
+         * it back. Otherwise the next submit would send it again.
+         */
+        if (__atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == tail) {
+            __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+        } else {
+            /* Don't know what happened to it, stop using the ring */
+            ring->broken = TRUE;
+        }
+    }
+    return FALSE;
+}
+
+FoilUring*
+foil_uring_new(
+    guint depth,
+    gsize bufsize)
+{
+    struct io_uring_params params;
+    FoilUring* ring = g_slice_new0(FoilUring);
+
+    ring->depth = MIN(MAX(depth, 1), FOIL_URING_MAX_DEPTH);
+    ring->bufsize = MIN(bufsize, FOIL_URING_MAX_BUFFER_SIZE);
+    memset(&params, 0, sizeof(params));
+    ring->fd = foil_uring_setup(ring->depth, &params);
+    if (ring->fd >= 0) {
+        if (foil_uring_map(ring, &params) &&
+            foil_uring_alloc_buffers(ring)) {
+            return ring;
+        }
+    } else {
+        GDEBUG("io_uring is not available: %s", strerror(errno));
+    }
+    foil_uring_free(ring);
+    return NULL;
+}
+
+void
+foil_uring_free(
+    FoilUring* ring)
+{
+    if (ring) {
+        /* Closing the ring releases the registered buffers */
+        foil_uring_unmap(ring);
+        if (ring->fd >= 0) {
+            close(ring->fd);
+        }
+        if (ring->bufs) {
+            guint i;
+
+            for (i = 0; i < ring->depth; i++) {
+                free(ring->bufs[i]);
+            }
+            g_free(ring->bufs);
+        }
+        gutil_slice_free(ring);
+    }
+}
+
+guint8*
+foil_uring_buffer(
+    FoilUring* ring,
+    guint index)
+{
+    return (index < ring->depth) ? ring->bufs[index] : NULL;
+}
+
+gboolean
+foil_uring_read(
+    FoilUring* ring,
+    int fd,
+    guint index,
+    gsize pos,
+    gsize len,
+    guint64 offset)
+{
+    return foil_uring_submit(ring, IORING_OP_READ_FIXED, fd, index,
+        pos, len, offset);
+}
+
+gboolean
+foil_uring_write(
+    FoilUring* ring,
+    int fd,
+    guint index,
+    gsize pos,
+    gsize len,
+    guint64 offset)
+{
+    return foil_uring_submit(ring, IORING_OP_WRITE_FIXED, fd, index,
+        pos, len, offset);
+}
+
+gboolean
+foil_uring_wait(
+    FoilUring* ring,
+    guint* index,
+    int* res)
+{
+    for (;;) {
+        const unsigned head = *ring->cq_head;
+        const unsigned tail = __atomic_load_n(ring->cq_tail,
+            __ATOMIC_ACQUIRE);
+
+        if (head != tail) {
+            const struct io_uring_cqe* cqe = ring->cqes +
+                (head & *ring->cq_mask);
+
+            *index = (guint)cqe->user_data;
+            *res = cqe->res;
+            __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+            return TRUE;
+        } else if (foil_uring_enter(ring->fd, 0, 1,
+            IORING_ENTER_GETEVENTS) < 0) {
+            GWARN("io_uring_enter failed: %s", strerror(errno));
+            return FALSE;
+        }
+    }
+}
+
+#else /* !FOIL_HAVE_URING */
+
+FoilUring*
+foil_uring_new(
+    guint depth,
+    gsize bufsize)
+{
+    return NULL;
+}
+
+void
+foil_uring_free(
+    FoilUring* ring)
+{
+}
+
+guint8*
+foil_uring_buffer(
+    FoilUring* ring,
+    guint index)
+{
+    return NULL;
+}
+
+gboolean
+foil_uring_read(
+    FoilUring* ring,
+    int fd,
+    guint index,
+    gsize pos,
+    gsize len,
+    guint64 offset)
+{
+    return FALSE;
+}
+
+gboolean
+foil_uring_write(
+    FoilUring* ring,
+    int fd,
+    guint index,
+    gsize pos,
+    gsize len,
+    guint64 offset)
+{
+    return FALSE;
+}
+
+gboolean
+foil_uring_wait(
+    FoilUring* ring,
+    guint* index,
+    int* res)
+{
+    return FALSE;
+}
+
+#endif /* !FOIL_HAVE_URING */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
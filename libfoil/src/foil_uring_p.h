@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FOIL_URING_P_H
+#define FOIL_URING_P_H
+
+#include "foil_types_p.h"
+
+/*
+ * Minimal io_uring wrapper (Linux only). Each ring owns a fixed set
+ * of equally sized buffers registered with the kernel, requests are
+ * identified by the buffer index. foil_uring_new() returns NULL if
+ * io_uring is not available, in which case the caller is expected to
+ * fall back to synchronous I/O.
+ */
+
+typedef struct foil_uring FoilUring;
+
+#define FOIL_URING_DEFAULT_DEPTH    (4)
+#define FOIL_URING_MAX_DEPTH        (64)
+#define FOIL_URING_MAX_BUFFER_SIZE  (0x10000000)
+
+FoilUring*
+foil_uring_new(
+    guint depth,
+    gsize bufsize)
+    FOIL_INTERNAL;
+
+void
+foil_uring_free(
+    FoilUring* ring)
+    FOIL_INTERNAL;
+
+guint8*
+foil_uring_buffer(
+    FoilUring* ring,
+    guint index)
+    FOIL_INTERNAL;
+
+gboolean
+foil_uring_read(
+    FoilUring* ring,
+    int fd,
+    guint index,
+    gsize pos,
+    gsize len,
+    guint64 offset)
+    FOIL_INTERNAL;
+
+gboolean
+foil_uring_write(
+    FoilUring* ring,
+    int fd,
+    guint index,
+    gsize pos,
+    gsize len,
+    guint64 offset)
+    FOIL_INTERNAL;
+
+gboolean
+foil_uring_wait(
+    FoilUring* ring,
+    guint* index,
+    int* res)
+    FOIL_INTERNAL;
+
+#endif /* FOIL_URING_P_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
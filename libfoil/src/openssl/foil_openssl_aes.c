@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_openssl_aes.h"
+
+static
+void
+foil_openssl_aes_expand_encrypt_key(
+    FoilKeyAes* key,
+    gpointer schedule)
+{
+    AES_set_encrypt_key(key->key, FOIL_KEY_AES_GET_CLASS(key)->size * 8,
+        schedule);
+}
+
+static
+void
+foil_openssl_aes_expand_decrypt_key(
+    FoilKeyAes* key,
+    gpointer schedule)
+{
+    AES_set_decrypt_key(key->key, FOIL_KEY_AES_GET_CLASS(key)->size * 8,
+        schedule);
+}
+
+const AES_KEY*
+foil_openssl_aes_encrypt_key(
+    FoilKey* key)
+{
+    return foil_key_aes_schedule(FOIL_KEY_AES_(key),
+        FOIL_KEY_AES_SCHEDULE_ENCRYPT, sizeof(AES_KEY),
+        foil_openssl_aes_expand_encrypt_key);
+}
+
+const AES_KEY*
+foil_openssl_aes_decrypt_key(
+    FoilKey* key)
+{
+    return foil_key_aes_schedule(FOIL_KEY_AES_(key),
+        FOIL_KEY_AES_SCHEDULE_DECRYPT, sizeof(AES_KEY),
+        foil_openssl_aes_expand_decrypt_key);
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
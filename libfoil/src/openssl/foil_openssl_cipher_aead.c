@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_openssl_aes.h"
+#include "foil_util_p.h"
+
+#include <openssl/evp.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_cipher
+#include "foil_log_p.h"
+
+/*
+ * Authenticated encryption with OpenSSL EVP, which picks the best
+ * implementation available on the CPU. For AES-GCM that's AES-NI and
+ * carry-less multiplication on x86, ChaCha20-Poly1305 is vectorized
+ * and doesn't need any special instructions to be fast.
+ *
+ * Both take the key material from AES keys (ChaCha20 only accepts
+ * 256-bit ones) and use the first 12 bytes of the IV as the nonce.
+ * That makes the key good for one message only, see foil_cipher.h
+ *
+ * The data are processed in large blocks, passing them to EVP 16
+ * bytes at a time would defeat the purpose. There's no padding,
+ * the last block can be of any size.
+ */
+#define FOIL_AEAD_NONCE_SIZE (12)
+#define FOIL_AEAD_TAG_SIZE (16)
+#define FOIL_AEAD_BLOCK_SIZE (4096)
+
+typedef struct foil_openssl_cipher_aead {
+    FoilCipherAes parent;
+    EVP_CIPHER_CTX* ctx;
+    guint8 tag[FOIL_AEAD_TAG_SIZE];
+    gboolean ready;
+    gboolean tag_set;
+    gboolean finished;
+} FoilOpensslCipherAead;
+
+typedef struct foil_openssl_cipher_aead_class {
+    FoilCipherAesClass aes;
+    const EVP_CIPHER* (*fn_evp)(guint key_size);
+    int enc;
+} FoilOpensslCipherAeadClass;
+
+typedef FoilOpensslCipherAeadClass FoilOpensslCipherAesGcmClass;
+typedef FoilOpensslCipherAeadClass FoilOpensslCipherAesGcmEncryptClass;
+typedef FoilOpensslCipherAeadClass FoilOpensslCipherAesGcmDecryptClass;
+typedef FoilOpensslCipherAeadClass FoilOpensslCipherChaCha20Poly1305Class;
+typedef FoilOpensslCipherAeadClass
+    FoilOpensslCipherChaCha20Poly1305EncryptClass;
+typedef FoilOpensslCipherAeadClass
+    FoilOpensslCipherChaCha20Poly1305DecryptClass;
+typedef FoilOpensslCipherAead FoilOpensslCipherAesGcm;
+typedef FoilOpensslCipherAead FoilOpensslCipherAesGcmEncrypt;
+typedef FoilOpensslCipherAead FoilOpensslCipherAesGcmDecrypt;
+typedef FoilOpensslCipherAead FoilOpensslCipherChaCha20Poly1305;
+typedef FoilOpensslCipherAead FoilOpensslCipherChaCha20Poly1305Encrypt;
+typedef FoilOpensslCipherAead FoilOpensslCipherChaCha20Poly1305Decrypt;
+
+GType foil_openssl_cipher_aead_get_type() FOIL_INTERNAL;
+GType foil_openssl_cipher_aes_gcm_get_type() FOIL_INTERNAL;
+GType foil_openssl_cipher_aes_gcm_encrypt_get_type() FOIL_INTERNAL;
+GType foil_openssl_cipher_aes_gcm_decrypt_get_type() FOIL_INTERNAL;
+GType foil_openssl_cipher_chacha20_poly1305_get_type() FOIL_INTERNAL;
+GType foil_openssl_cipher_chacha20_poly1305_encrypt_get_type() FOIL_INTERNAL;
+GType foil_openssl_cipher_chacha20_poly1305_decrypt_get_type() FOIL_INTERNAL;
+
+G_DEFINE_ABSTRACT_TYPE(FoilOpensslCipherAead,
+    foil_openssl_cipher_aead, FOIL_TYPE_CIPHER_AES)
+
+#define FOIL_TYPE_OPENSSL_CIPHER_AEAD \
+    foil_openssl_cipher_aead_get_type()
+#define FOIL_TYPE_OPENSSL_CIPHER_AES_GCM \
+    foil_openssl_cipher_aes_gcm_get_type()
+#define FOIL_TYPE_OPENSSL_CIPHER_CHACHA20_POLY1305 \
+    foil_openssl_cipher_chacha20_poly1305_get_type()
+#define FOIL_OPENSSL_CIPHER_AEAD(obj) \
+    G_TYPE_CHECK_INSTANCE_CAST(obj, FOIL_TYPE_OPENSSL_CIPHER_AEAD, \
+    FoilOpensslCipherAead)
+#define FOIL_OPENSSL_CIPHER_AEAD_GET_CLASS(obj) \
+    G_TYPE_INSTANCE_GET_CLASS(obj, FOIL_TYPE_OPENSSL_CIPHER_AEAD, \
+    FoilOpensslCipherAeadClass)
+
+#define foil_openssl_cipher_aes_gcm_init \
+    foil_openssl_cipher_aead_init
+#define foil_openssl_cipher_aes_gcm_encrypt_init \
+    foil_openssl_cipher_aead_init
+#define foil_openssl_cipher_aes_gcm_decrypt_init \
+    foil_openssl_cipher_aead_init
+#define foil_openssl_cipher_chacha20_poly1305_init \
+    foil_openssl_cipher_aead_init
+#define foil_openssl_cipher_chacha20_poly1305_encrypt_init \
+    foil_openssl_cipher_aead_init
+#define foil_openssl_cipher_chacha20_poly1305_decrypt_init \
+    foil_openssl_cipher_aead_init
+
+#define foil_openssl_cipher_aes_gcm_encrypt_class_init \
+    foil_openssl_cipher_aead_encrypt_class_init
+#define foil_openssl_cipher_aes_gcm_decrypt_class_init \
+    foil_openssl_cipher_aead_decrypt_class_init
+#define foil_openssl_cipher_chacha20_poly1305_encrypt_class_init \
+    foil_openssl_cipher_aead_encrypt_class_init
+#define foil_openssl_cipher_chacha20_poly1305_decrypt_class_init \
+    foil_openssl_cipher_aead_decrypt_class_init
+
+G_DEFINE_ABSTRACT_TYPE(FoilOpensslCipherAesGcm,
+    foil_openssl_cipher_aes_gcm,
+    FOIL_TYPE_OPENSSL_CIPHER_AEAD)
+G_DEFINE_TYPE(FoilOpensslCipherAesGcmEncrypt,
+    foil_openssl_cipher_aes_gcm_encrypt,
+    FOIL_TYPE_OPENSSL_CIPHER_AES_GCM)
+G_DEFINE_TYPE(FoilOpensslCipherAesGcmDecrypt,
+    foil_openssl_cipher_aes_gcm_decrypt,
+    FOIL_TYPE_OPENSSL_CIPHER_AES_GCM)
+G_DEFINE_ABSTRACT_TYPE(FoilOpensslCipherChaCha20Poly1305,
+    foil_openssl_cipher_chacha20_poly1305,
+    FOIL_TYPE_OPENSSL_CIPHER_AEAD)
+G_DEFINE_TYPE(FoilOpensslCipherChaCha20Poly1305Encrypt,
+    foil_openssl_cipher_chacha20_poly1305_encrypt,
+    FOIL_TYPE_OPENSSL_CIPHER_CHACHA20_POLY1305)
+G_DEFINE_TYPE(FoilOpensslCipherChaCha20Poly1305Decrypt,
+    foil_openssl_cipher_chacha20_poly1305_decrypt,
+    FOIL_TYPE_OPENSSL_CIPHER_CHACHA20_POLY1305)
+
+#define SUPER_CLASS foil_openssl_cipher_aead_parent_class
+
+GType foil_impl_cipher_aes_gcm_encrypt_get_type()
+{
+    return foil_openssl_cipher_aes_gcm_encrypt_get_type();
+}
+
+GType foil_impl_cipher_aes_gcm_decrypt_get_type()
+{
+    return foil_openssl_cipher_aes_gcm_decrypt_get_type();
+}
+
+GType foil_impl_cipher_chacha20_poly1305_encrypt_get_type()
+{
+    return foil_openssl_cipher_chacha20_poly1305_encrypt_get_type();
+}
+
+GType foil_impl_cipher_chacha20_poly1305_decrypt_get_type()
+{
+    return foil_openssl_cipher_chacha20_poly1305_decrypt_get_type();
+}
+
+static
+const EVP_CIPHER*
+foil_openssl_cipher_aes_gcm_evp(
+    guint key_size)
+{
+    switch (key_size) {
+    case 16: return EVP_aes_128_gcm();
+    case 24: return EVP_aes_192_gcm();
+    case 32: return EVP_aes_256_gcm();
+    }
+    return NULL;
+}
+
+static
+const EVP_CIPHER*
+foil_openssl_cipher_chacha20_poly1305_evp(
+    guint key_size)
+{
+    return (key_size == 32) ? EVP_chacha20_poly1305() : NULL;
+}
+
+static
+gboolean
+foil_openssl_cipher_chacha20_poly1305_supports_key(
+    FoilCipherClass* klass,
+    GType key_type)
+{
+    FoilKeyAesClass* key_klass =
+        foil_abstract_class_ref(key_type, FOIL_TYPE_KEY_AES);
+
+    if (key_klass) {
+        const gboolean ok = (key_klass->size == 32);
+
+        g_type_class_unref(key_klass);
+        return ok;
+    }
+    return FALSE;
+}
+
+static
+void
+foil_openssl_cipher_aead_reset(
+    FoilOpensslCipherAead* self)
+{
+    /* Keep the context around, it may be reused */
+    if (self->ctx) {
+        EVP_CIPHER_CTX_reset(self->ctx);
+    }
+    self->ready = FALSE;
+    self->tag_set = FALSE;
+    self->finished = FALSE;
+    memset(self->tag, 0, sizeof(self->tag));
+}
+
+static
+void
+foil_openssl_cipher_aead_init_with_key(
+    FoilCipher* cipher,
+    FoilKey* key)
+{
+    FoilOpensslCipherAead* self = FOIL_OPENSSL_CIPHER_AEAD(cipher);
+    FoilOpensslCipherAeadClass* klass =
+        FOIL_OPENSSL_CIPHER_AEAD_GET_CLASS(self);
+    FoilKeyAes* aes_key = FOIL_KEY_AES_(key);
+    const EVP_CIPHER* evp = klass->fn_evp(FOIL_KEY_AES_GET_CLASS(key)->size);
+
+    FOIL_CIPHER_CLASS(SUPER_CLASS)->fn_init_with_key(cipher, key);
+    cipher->input_block_size = FOIL_AEAD_BLOCK_SIZE;
+    cipher->output_block_size = FOIL_AEAD_BLOCK_SIZE;
+    foil_openssl_cipher_aead_reset(self);
+    if (!self->ctx) {
+        self->ctx = EVP_CIPHER_CTX_new();
+    }
+    if (evp && self->ctx &&
+        EVP_CipherInit_ex(self->ctx, evp, NULL, NULL, NULL, klass->enc) &&
+        EVP_CIPHER_CTX_ctrl(self->ctx, EVP_CTRL_AEAD_SET_IVLEN,
+            FOIL_AEAD_NONCE_SIZE, NULL) &&
+        EVP_CipherInit_ex(self->ctx, NULL, NULL, aes_key->key,
+            aes_key->iv, klass->enc)) {
+        self->ready = TRUE;
+    } else {
+        GWARN("Failed to initialize %s", FOIL_CIPHER_CLASS(klass)->name);
+    }
+}
+
+static
+void
+foil_openssl_cipher_aead_copy(
+    FoilCipher* dest,
+    FoilCipher* src)
+{
+    FoilOpensslCipherAead* self = FOIL_OPENSSL_CIPHER_AEAD(dest);
+    FoilOpensslCipherAead* other = FOIL_OPENSSL_CIPHER_AEAD(src);
+
+    FOIL_CIPHER_CLASS(SUPER_CLASS)->fn_copy(dest, src);
+    self->ready = self->ctx && other->ready &&
+        EVP_CIPHER_CTX_copy(self->ctx, other->ctx);
+    memcpy(self->tag, other->tag, sizeof(self->tag));
+    self->tag_set = other->tag_set;
+    self->finished = other->finished;
+}
+
+static
+void
+foil_openssl_cipher_aead_clear_key(
+    FoilCipher* cipher)
+{
+    foil_openssl_cipher_aead_reset(FOIL_OPENSSL_CIPHER_AEAD(cipher));
+    FOIL_CIPHER_CLASS(SUPER_CLASS)->fn_clear_key(cipher);
+}
+
+static
+gboolean
+foil_openssl_cipher_aead_add_aad(
+    FoilCipher* cipher,
+    const void* aad,
+    gsize size)
+{
+    FoilOpensslCipherAead* self = FOIL_OPENSSL_CIPHER_AEAD(cipher);
+    int len;
+
+    /* OpenSSL fails the call if the data has already been processed */
+    return self->ready && !self->finished && size <= G_MAXINT &&
+        (!size || EVP_CipherUpdate(self->ctx, NULL, &len, aad, (int)size));
+}
+
+static
+gboolean
+foil_openssl_cipher_aead_get_tag(
+    FoilCipher* cipher,
+    void* tag,
+    gsize size)
+{
+    FoilOpensslCipherAead* self = FOIL_OPENSSL_CIPHER_AEAD(cipher);
+
+    /* Only the encrypting cipher produces the tag */
+    if (self->finished && FOIL_OPENSSL_CIPHER_AEAD_GET_CLASS(self)->enc) {
+        memcpy(tag, self->tag, size);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+gboolean
+foil_openssl_cipher_aead_set_tag(
+    FoilCipher* cipher,
+    const void* tag,
+    gsize size)
+{
+    FoilOpensslCipherAead* self = FOIL_OPENSSL_CIPHER_AEAD(cipher);
+
+    /* And the decrypting one needs it before foil_cipher_finish */
+    if (self->ready && !self->finished &&
+        !FOIL_OPENSSL_CIPHER_AEAD_GET_CLASS(self)->enc &&
+        EVP_CIPHER_CTX_ctrl(self->ctx, EVP_CTRL_AEAD_SET_TAG, (int)size,
+        (void*)tag)) {
+        self->tag_set = TRUE;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+int
+foil_openssl_cipher_aead_step(
+    FoilCipher* cipher,
+    const void* in,
+    void* out)
+{
+    FoilOpensslCipherAead* self = FOIL_OPENSSL_CIPHER_AEAD(cipher);
+    int len;
+
+    return (self->ready && !self->finished &&
+        EVP_CipherUpdate(self->ctx, out, &len, in, cipher->input_block_size))
+        ? len : -1;
+}
+
+static
+int
+foil_openssl_cipher_aead_finish(
+    FoilCipher* cipher,
+    const void* in,
+    int n,
+    void* out)
+{
+    FoilOpensslCipherAead* self = FOIL_OPENSSL_CIPHER_AEAD(cipher);
+    const int enc = FOIL_OPENSSL_CIPHER_AEAD_GET_CLASS(self)->enc;
+    guint8 last[FOIL_AES_BLOCK_SIZE];
+    int len = 0, tail = 0;
+
+    if (!self->ready || self->finished || (!enc && !self->tag_set) ||
+        n < 0 || n > cipher->input_block_size) {
+        return -1;
+    } else if (n > 0 && !EVP_CipherUpdate(self->ctx, out, &len, in, n)) {
+        return -1;
+    } else if (!EVP_CipherFinal_ex(self->ctx, last, &tail)) {
+        /* That's what happens if the tag doesn't match */
+        GDEBUG("%s authentication failed", FOIL_CIPHER_GET_CLASS(self)->name);
+        return -1;
+    }
+    GASSERT(!tail);
+    self->finished = TRUE;
+    if (enc && !EVP_CIPHER_CTX_ctrl(self->ctx, EVP_CTRL_AEAD_GET_TAG,
+        FOIL_AEAD_TAG_SIZE, self->tag)) {
+        return -1;
+    }
+    return len;
+}
+
+static
+void
+foil_openssl_cipher_aead_finalize(
+    GObject* object)
+{
+    EVP_CIPHER_CTX_free(FOIL_OPENSSL_CIPHER_AEAD(object)->ctx);
+    G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
+}
+
+static
+void
+foil_openssl_cipher_aead_init(
+    FoilOpensslCipherAead* self)
+{
+}
+
+static
+void
+foil_openssl_cipher_aead_class_init(
+    FoilOpensslCipherAeadClass* klass)
+{
+    FoilCipherClass* cipher = FOIL_CIPHER_CLASS(klass);
+    cipher->tag_size = FOIL_AEAD_TAG_SIZE;
+    cipher->fn_init_with_key = foil_openssl_cipher_aead_init_with_key;
+    cipher->fn_copy = foil_openssl_cipher_aead_copy;
+    cipher->fn_clear_key = foil_openssl_cipher_aead_clear_key;
+    cipher->fn_step = foil_openssl_cipher_aead_step;
+    cipher->fn_finish = foil_openssl_cipher_aead_finish;
+    cipher->fn_add_aad = foil_openssl_cipher_aead_add_aad;
+    cipher->fn_get_tag = foil_openssl_cipher_aead_get_tag;
+    cipher->fn_set_tag = foil_openssl_cipher_aead_set_tag;
+    G_OBJECT_CLASS(klass)->finalize = foil_openssl_cipher_aead_finalize;
+}
+
+static
+void
+foil_openssl_cipher_aead_encrypt_class_init(
+    FoilOpensslCipherAeadClass* klass)
+{
+    FOIL_CIPHER_CLASS(klass)->flags |= FOIL_CIPHER_ENCRYPT;
+    klass->enc = 1;
+}
+
+static
+void
+foil_openssl_cipher_aead_decrypt_class_init(
+    FoilOpensslCipherAeadClass* klass)
+{
+    FOIL_CIPHER_CLASS(klass)->flags |= FOIL_CIPHER_DECRYPT;
+    klass->enc = 0;
+}
+
+static
+void
+foil_openssl_cipher_aes_gcm_class_init(
+    FoilOpensslCipherAesGcmClass* klass)
+{
+    FOIL_CIPHER_CLASS(klass)->name = "AESGCM";
+    klass->fn_evp = foil_openssl_cipher_aes_gcm_evp;
+}
+
+static
+void
+foil_openssl_cipher_chacha20_poly1305_class_init(
+    FoilOpensslCipherChaCha20Poly1305Class* klass)
+{
+    FoilCipherClass* cipher = FOIL_CIPHER_CLASS(klass);
+    cipher->name = "ChaCha20Poly1305";
+    cipher->fn_supports_key =
+        foil_openssl_cipher_chacha20_poly1305_supports_key;
+    klass->fn_evp = foil_openssl_cipher_chacha20_poly1305_evp;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -30,22 +30,18 @@
  * any official policies, either expressed or implied.
  */
 
-#include "foil_cipher_aes.h"
+#include "foil_openssl_aes.h"
 
-/* Yes we know that this API is deprecated */
-#define OPENSSL_SUPPRESS_DEPRECATED
-
-#include <openssl/aes.h>
 #include <openssl/modes.h>
 
 typedef struct foil_openssl_cipher_aes_decrypt {
     FoilCipherAes parent;
-    AES_KEY aes;
+    const AES_KEY* aes;  /* Owned by the key */
 } FoilOpensslCipherAesDecrypt;
 
 typedef struct foil_openssl_cipher_aes_decrypt_class {
     FoilCipherAesClass parent;
-    int (*fn_set_key)(const unsigned char* data, const int bits, AES_KEY *key);
+    const AES_KEY* (*fn_key)(FoilKey* key);
     void (*fn_reset)(FoilOpensslCipherAesDecrypt* self);
 } FoilOpensslCipherAesDecryptClass;
 
@@ -132,7 +128,7 @@ foil_openssl_cipher_aes_cbc_decrypt_step(
     void* out)
 {
     FoilOpensslCipherAesDecrypt* self = FOIL_OPENSSL_CIPHER_AES_DECRYPT(cipher);
-    AES_cbc_encrypt(in, out, FOIL_AES_BLOCK_SIZE, &self->aes,
+    AES_cbc_encrypt(in, out, FOIL_AES_BLOCK_SIZE, self->aes,
         self->parent.block, AES_DECRYPT);
     return FOIL_AES_BLOCK_SIZE;
 }
@@ -146,7 +142,7 @@ foil_openssl_cipher_aes_cfb_decrypt_step(
 {
     int num = 0;
     FoilOpensslCipherAesDecrypt* self = FOIL_OPENSSL_CIPHER_AES_DECRYPT(cipher);
-    AES_cfb128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, &self->aes,
+    AES_cfb128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, self->aes,
         self->parent.block, &num, AES_DECRYPT);
     return FOIL_AES_BLOCK_SIZE;
 }
@@ -161,7 +157,7 @@ foil_openssl_cipher_aes_ctr_decrypt_step(
     unsigned int num = 0;
     FoilOpensslCipherAesCtrDecrypt* self =
         FOIL_OPENSSL_CIPHER_AES_CTR_DECRYPT(cipher);
-    CRYPTO_ctr128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, &self->parent.aes,
+    CRYPTO_ctr128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, self->parent.aes,
         self->iv, self->parent.parent.block, &num, (block128_f) AES_encrypt);
     return FOIL_AES_BLOCK_SIZE;
 }
@@ -174,7 +170,7 @@ foil_openssl_cipher_aes_ecb_decrypt_step(
     void* out)
 {
     FoilOpensslCipherAesDecrypt* self = FOIL_OPENSSL_CIPHER_AES_DECRYPT(cipher);
-    AES_ecb_encrypt(in, out, &self->aes, AES_DECRYPT);
+    AES_ecb_encrypt(in, out, self->aes, AES_DECRYPT);
     return FOIL_AES_BLOCK_SIZE;
 }
 
@@ -183,10 +179,8 @@ void
 foil_openssl_cipher_aes_decrypt_reset(
     FoilOpensslCipherAesDecrypt* self)
 {
-    FoilKey* key = FOIL_CIPHER(self)->key;
-    FoilKeyAes* aes_key = FOIL_KEY_AES_(key);
-    FOIL_OPENSSL_CIPHER_AES_DECRYPT_GET_CLASS(self)->fn_set_key(aes_key->key,
-        FOIL_KEY_AES_GET_CLASS(key)->size * 8, &self->aes);
+    self->aes = FOIL_OPENSSL_CIPHER_AES_DECRYPT_GET_CLASS(self)->
+        fn_key(FOIL_CIPHER(self)->key);
 }
 
 static
@@ -251,7 +245,7 @@ foil_openssl_cipher_aes_decrypt_class_init(
     cipher->flags |= FOIL_CIPHER_DECRYPT;
     cipher->fn_init_with_key = foil_openssl_cipher_aes_decrypt_init_with_key;
     cipher->fn_copy = foil_openssl_cipher_aes_decrypt_copy;
-    klass->fn_set_key = AES_set_decrypt_key;
+    klass->fn_key = foil_openssl_aes_decrypt_key;
     klass->fn_reset = foil_openssl_cipher_aes_decrypt_reset;
 }
 
@@ -273,7 +267,7 @@ foil_openssl_cipher_aes_cfb_decrypt_class_init(
     FoilCipherClass* cipher = FOIL_CIPHER_CLASS(klass);
     cipher->name = "AESCFB(Decrypt)";
     cipher->fn_step = foil_openssl_cipher_aes_cfb_decrypt_step;
-    klass->fn_set_key = AES_set_encrypt_key;
+    klass->fn_key = foil_openssl_aes_encrypt_key;
 }
 
 static
@@ -284,7 +278,7 @@ foil_openssl_cipher_aes_ctr_decrypt_class_init(
     FoilCipherClass* cipher = FOIL_CIPHER_CLASS(klass);
     cipher->name = "AESCTR(Decrypt)";
     cipher->fn_step = foil_openssl_cipher_aes_ctr_decrypt_step;
-    klass->fn_set_key = AES_set_encrypt_key;
+    klass->fn_key = foil_openssl_aes_encrypt_key;
     klass->fn_reset = foil_openssl_cipher_aes_ctr_decrypt_reset;
 }
 
@@ -30,17 +30,13 @@
  * any official policies, either expressed or implied.
  */
 
-#include "foil_cipher_aes.h"
+#include "foil_openssl_aes.h"
 
-/* Yes we know that this API is deprecated */
-#define OPENSSL_SUPPRESS_DEPRECATED
-
-#include <openssl/aes.h>
 #include <openssl/modes.h>
 
 typedef struct foil_openssl_cipher_aes_encrypt {
     FoilCipherAes parent;
-    AES_KEY aes;
+    const AES_KEY* aes;  /* Owned by the key */
 } FoilOpensslCipherAesEncrypt;
 
 typedef struct foil_openssl_cipher_aes_ctr_encrypt {
@@ -135,7 +131,7 @@ foil_openssl_cipher_aes_cbc_encrypt_step(
     void* out)
 {
     FoilOpensslCipherAesEncrypt* self = FOIL_OPENSSL_CIPHER_AES_ENCRYPT(cipher);
-    AES_cbc_encrypt(in, out, FOIL_AES_BLOCK_SIZE, &self->aes,
+    AES_cbc_encrypt(in, out, FOIL_AES_BLOCK_SIZE, self->aes,
         self->parent.block, AES_ENCRYPT);
     return FOIL_AES_BLOCK_SIZE;
 }
@@ -149,7 +145,7 @@ foil_openssl_cipher_aes_cfb_encrypt_step(
 {
     int num = 0;
     FoilOpensslCipherAesEncrypt* self = FOIL_OPENSSL_CIPHER_AES_ENCRYPT(cipher);
-    AES_cfb128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, &self->aes,
+    AES_cfb128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, self->aes,
         self->parent.block, &num, AES_ENCRYPT);
     return FOIL_AES_BLOCK_SIZE;
 }
@@ -164,7 +160,7 @@ foil_openssl_cipher_aes_ctr_encrypt_step(
     unsigned int num = 0;
     FoilOpensslCipherAesCtrEncrypt* self =
         FOIL_OPENSSL_CIPHER_AES_CTR_ENCRYPT(cipher);
-    CRYPTO_ctr128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, &self->parent.aes,
+    CRYPTO_ctr128_encrypt(in, out, FOIL_AES_BLOCK_SIZE, self->parent.aes,
         self->iv, FOIL_CIPHER_AES(cipher)->block, &num,
         (block128_f) AES_encrypt);
     return FOIL_AES_BLOCK_SIZE;
@@ -178,7 +174,7 @@ foil_openssl_cipher_aes_ecb_encrypt_step(
     void* out)
 {
     FoilOpensslCipherAesEncrypt* self = FOIL_OPENSSL_CIPHER_AES_ENCRYPT(cipher);
-    AES_ecb_encrypt(in, out, &self->aes, AES_ENCRYPT);
+    AES_ecb_encrypt(in, out, self->aes, AES_ENCRYPT);
     return FOIL_AES_BLOCK_SIZE;
 }
 
@@ -187,9 +183,7 @@ void
 foil_openssl_cipher_aes_encrypt_reset(
     FoilOpensslCipherAesEncrypt* self)
 {
-    FoilKey* key = FOIL_CIPHER(self)->key;
-    AES_set_encrypt_key(FOIL_KEY_AES_(key)->key,
-        FOIL_KEY_AES_GET_CLASS(key)->size * 8, &self->aes);
+    self->aes = foil_openssl_aes_encrypt_key(FOIL_CIPHER(self)->key);
 }
 
 static
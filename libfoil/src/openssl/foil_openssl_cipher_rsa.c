@@ -32,11 +32,30 @@
 
 #include "foil_cipher_p.h"
 #include "foil_openssl_rsa.h"
+#include "foil_thread_pool_p.h"
 
 /* Logging */
 #define GLOG_MODULE_NAME foil_log_cipher
 #include "foil_log_p.h"
 
+/*
+ * Blocks are independent of each other, so a long run of them can be
+ * split between threads. Each thread gets a few blocks at least,
+ * otherwise it's not worth the trouble of duplicating the RSA handle.
+ * Every worker uses its own copy of the RSA key, so that the threads
+ * don't fight over the blinding state.
+ */
+#define FOIL_OPENSSL_CIPHER_RSA_MIN_BLOCKS_PER_THREAD (4)
+
+typedef struct foil_openssl_cipher_rsa_job {
+    FoilOpensslCipherRsa* cipher;
+    RSA* rsa;
+    const guint8* in;
+    guint8* out;
+    int* nout;
+    guint n;
+} FoilOpensslCipherRsaJob;
+
 G_DEFINE_ABSTRACT_TYPE(FoilOpensslCipherRsa, foil_openssl_cipher_rsa,
         FOIL_TYPE_CIPHER)
 #define FOIL_OPENSSL_CIPHER_RSA(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, \
@@ -65,14 +84,14 @@ foil_openssl_cipher_rsa_supports_key(
 
 static
 int
-foil_openssl_cipher_rsa_block(
-    FoilCipher* cipher,
+foil_openssl_cipher_rsa_proc(
+    FoilOpensslCipherRsa* self,
+    RSA* rsa,
     const void* from,
     int flen,
     void* to)
 {
-    FoilOpensslCipherRsa* self = FOIL_OPENSSL_CIPHER_RSA(cipher);
-    int ret = self->proc(flen, from, to, self->rsa, self->padding);
+    int ret = self->proc(flen, from, to, rsa, self->padding);
     if (ret < 0) {
         if (GLOG_ENABLED(GLOG_LEVEL_ERR)) {
             ERR_load_crypto_strings();
@@ -82,6 +101,19 @@ foil_openssl_cipher_rsa_block(
     return ret;
 }
 
+static
+int
+foil_openssl_cipher_rsa_block(
+    FoilCipher* cipher,
+    const void* from,
+    int flen,
+    void* to)
+{
+    FoilOpensslCipherRsa* self = FOIL_OPENSSL_CIPHER_RSA(cipher);
+
+    return foil_openssl_cipher_rsa_proc(self, self->rsa, from, flen, to);
+}
+
 static
 int
 foil_openssl_cipher_rsa_step(
@@ -93,6 +125,88 @@ foil_openssl_cipher_rsa_step(
         cipher->input_block_size, to);
 }
 
+static
+void
+foil_openssl_cipher_rsa_job_run(
+    gpointer data)
+{
+    FoilOpensslCipherRsaJob* job = data;
+    FoilOpensslCipherRsa* self = job->cipher;
+    FoilCipher* cipher = &self->cipher;
+    const int in_size = cipher->input_block_size;
+    const int out_size = cipher->output_block_size;
+    guint i;
+
+    for (i = 0; i < job->n; i++) {
+        job->nout[i] = foil_openssl_cipher_rsa_proc(self, job->rsa,
+            job->in + i * in_size, in_size, job->out + i * out_size);
+    }
+}
+
+static
+gboolean
+foil_openssl_cipher_rsa_steps(
+    FoilCipher* cipher,
+    const void* in,
+    void* out,
+    int* nout,
+    guint n)
+{
+    FoilOpensslCipherRsa* self = FOIL_OPENSSL_CIPHER_RSA(cipher);
+    const guint nthreads = MIN(foil_ncpu(),
+        n / FOIL_OPENSSL_CIPHER_RSA_MIN_BLOCKS_PER_THREAD);
+    const guint njobs = MAX(nthreads, 1);
+    FoilOpensslCipherRsaJob* jobs = g_new0(FoilOpensslCipherRsaJob, njobs);
+    FoilThreadBatch* batch = (njobs > 1) ? foil_thread_batch_new() : NULL;
+    guint i, start = 0;
+
+    /* Split the blocks into contiguous chunks, one per thread */
+    for (i = 0; i < njobs; i++) {
+        FoilOpensslCipherRsaJob* job = jobs + i;
+        const guint count = n / njobs + (i < n % njobs);
+
+        job->cipher = self;
+        job->in = (const guint8*)in + start * cipher->input_block_size;
+        job->out = (guint8*)out + start * cipher->output_block_size;
+        job->nout = nout + start;
+        job->n = count;
+        start += count;
+    }
+    GASSERT(start == n);
+
+    /* The first chunk is processed by this thread */
+    jobs[0].rsa = self->rsa;
+    for (i = 1; i < njobs; i++) {
+        FoilOpensslCipherRsaJob* job = jobs + i;
+
+        job->rsa = self->dup(self->rsa);
+        if (job->rsa) {
+            foil_thread_batch_push(batch, foil_openssl_cipher_rsa_job_run,
+                job);
+        }
+    }
+    foil_openssl_cipher_rsa_job_run(jobs);
+
+    /* Whatever couldn't be handed over is done here too */
+    for (i = 1; i < njobs; i++) {
+        if (!jobs[i].rsa) {
+            jobs[i].rsa = self->rsa;
+            foil_openssl_cipher_rsa_job_run(jobs + i);
+            jobs[i].rsa = NULL;
+        }
+    }
+
+    /* Wait for the workers */
+    if (batch) {
+        foil_thread_batch_finish(batch);
+    }
+    for (i = 1; i < njobs; i++) {
+        RSA_free(jobs[i].rsa);
+    }
+    g_free(jobs);
+    return TRUE;
+}
+
 static
 void
 foil_openssl_cipher_rsa_copy(
@@ -110,6 +224,19 @@ foil_openssl_cipher_rsa_copy(
     self->dup = that->dup;
 }
 
+static
+void
+foil_openssl_cipher_rsa_clear_key(
+    FoilCipher* cipher)
+{
+    FoilOpensslCipherRsa* self = FOIL_OPENSSL_CIPHER_RSA(cipher);
+
+    /* Don't let private key components survive switching to a public key */
+    RSA_free(self->rsa);
+    self->rsa = RSA_new();
+    FOIL_CIPHER_CLASS(SUPER_CLASS)->fn_clear_key(cipher);
+}
+
 static
 void
 foil_openssl_cipher_rsa_finalize(
@@ -137,8 +264,10 @@ foil_openssl_cipher_rsa_class_init(
     cipher->name = "RSA";
     cipher->fn_supports_key = foil_openssl_cipher_rsa_supports_key;
     cipher->fn_copy = foil_openssl_cipher_rsa_copy;
+    cipher->fn_clear_key = foil_openssl_cipher_rsa_clear_key;
     cipher->fn_step = foil_openssl_cipher_rsa_step;
     cipher->fn_finish = foil_openssl_cipher_rsa_block;
+    cipher->fn_steps = foil_openssl_cipher_rsa_steps;
     G_OBJECT_CLASS(klass)->finalize = foil_openssl_cipher_rsa_finalize;
 }
 
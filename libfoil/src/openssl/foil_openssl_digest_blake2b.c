@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_digest_p.h"
+
+#include <openssl/evp.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_digest
+#include "foil_log_p.h"
+
+/* There's no low-level BLAKE2 API, hence EVP */
+typedef FoilDigestBLAKE2BClass FoilOpensslDigestBLAKE2BClass;
+typedef struct foil_openssl_digest_blake2b {
+    FoilDigestBLAKE2B blake2b;
+    EVP_MD_CTX* ctx;
+} FoilOpensslDigestBLAKE2B;
+
+#define THIS_TYPE foil_openssl_digest_blake2b_get_type()
+#define THIS(obj) (G_TYPE_CHECK_INSTANCE_CAST(obj, THIS_TYPE, \
+    FoilOpensslDigestBLAKE2B))
+#define SUPER_CLASS foil_openssl_digest_blake2b_parent_class
+
+GType THIS_TYPE FOIL_INTERNAL;
+G_DEFINE_TYPE(FoilOpensslDigestBLAKE2B, foil_openssl_digest_blake2b, \
+    FOIL_TYPE_DIGEST_BLAKE2B)
+
+GType
+foil_impl_digest_blake2b_get_type()
+{
+    return THIS_TYPE;
+}
+
+static
+void
+foil_openssl_digest_blake2b_copy(
+    FoilDigest* digest,
+    FoilDigest* source)
+{
+    EVP_MD_CTX_copy_ex(THIS(digest)->ctx, THIS(source)->ctx);
+}
+
+static
+void
+foil_openssl_digest_blake2b_reset(
+    FoilDigest* digest)
+{
+    EVP_DigestInit_ex(THIS(digest)->ctx, EVP_blake2b512(), NULL);
+}
+
+static
+void
+foil_openssl_digest_blake2b_update(
+    FoilDigest* digest,
+    const void* data,
+    size_t size)
+{
+    EVP_DigestUpdate(THIS(digest)->ctx, data, size);
+}
+
+static
+void
+foil_openssl_digest_blake2b_finish(
+    FoilDigest* digest,
+    void* md)
+{
+    FoilOpensslDigestBLAKE2B* self = THIS(digest);
+
+    if (G_LIKELY(md)) {
+        EVP_DigestFinal_ex(self->ctx, md, NULL);
+    } else {
+        EVP_MD_CTX_reset(self->ctx);
+    }
+}
+
+static
+void
+foil_openssl_digest_blake2b_digest(
+    const void* data,
+    size_t size,
+    void* digest)
+{
+    EVP_Digest(data, size, digest, NULL, EVP_blake2b512(), NULL);
+}
+
+static
+void
+foil_openssl_digest_blake2b_finalize(
+    GObject* object)
+{
+    EVP_MD_CTX_free(THIS(object)->ctx);
+    G_OBJECT_CLASS(SUPER_CLASS)->finalize(object);
+}
+
+static
+void
+foil_openssl_digest_blake2b_init(
+    FoilOpensslDigestBLAKE2B* self)
+{
+    self->ctx = EVP_MD_CTX_new();
+    EVP_DigestInit_ex(self->ctx, EVP_blake2b512(), NULL);
+}
+
+static
+void
+foil_openssl_digest_blake2b_class_init(
+    FoilOpensslDigestBLAKE2BClass* klass)
+{
+    GASSERT(klass->size == (gsize)EVP_MD_size(EVP_blake2b512()));
+    klass->fn_copy = foil_openssl_digest_blake2b_copy;
+    klass->fn_reset = foil_openssl_digest_blake2b_reset;
+    klass->fn_digest = foil_openssl_digest_blake2b_digest;
+    klass->fn_update = foil_openssl_digest_blake2b_update;
+    klass->fn_finish = foil_openssl_digest_blake2b_finish;
+    G_OBJECT_CLASS(klass)->finalize = foil_openssl_digest_blake2b_finalize;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
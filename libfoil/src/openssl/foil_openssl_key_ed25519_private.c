@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_key_ed25519_p.h"
+#include "foil_openssl_random.h"
+
+#include <openssl/evp.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_key
+#include "foil_log_p.h"
+
+typedef FoilKeyEd25519PrivateClass FoilOpensslKeyEd25519PrivateClass;
+typedef struct foil_openssl_key_ed25519_private {
+    FoilKeyEd25519Private super;
+    EVP_PKEY* pkey;
+} FoilOpensslKeyEd25519Private;
+
+G_DEFINE_TYPE(FoilOpensslKeyEd25519Private, foil_openssl_key_ed25519_private,
+    FOIL_TYPE_KEY_ED25519_PRIVATE);
+#define FOIL_OPENSSL_TYPE_KEY_ED25519_PRIVATE \
+    foil_openssl_key_ed25519_private_get_type()
+#define FOIL_OPENSSL_KEY_ED25519_PRIVATE(obj) G_TYPE_CHECK_INSTANCE_CAST(obj, \
+    FOIL_OPENSSL_TYPE_KEY_ED25519_PRIVATE, FoilOpensslKeyEd25519Private)
+
+GType
+foil_impl_key_ed25519_private_get_type()
+{
+    return FOIL_OPENSSL_TYPE_KEY_ED25519_PRIVATE;
+}
+
+static
+gboolean
+foil_openssl_key_ed25519_private_init_key(
+    FoilKeyEd25519Private* key)
+{
+    FoilOpensslKeyEd25519Private* self =
+        FOIL_OPENSSL_KEY_ED25519_PRIVATE(key);
+    size_t len = sizeof(key->pub);
+
+    /*
+     * Deriving the public key costs about as much as signing, so
+     * EVP_PKEY is created once and reused for all signatures.
+     */
+    GASSERT(!self->pkey);
+    self->pkey = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, NULL,
+        key->seed, sizeof(key->seed));
+    return self->pkey &&
+        EVP_PKEY_get_raw_public_key(self->pkey, key->pub, &len) > 0 &&
+        len == sizeof(key->pub);
+}
+
+static
+GBytes*
+foil_openssl_key_ed25519_private_sign(
+    FoilKeyEd25519Private* key,
+    const void* data,
+    gsize len)
+{
+    FoilOpensslKeyEd25519Private* self =
+        FOIL_OPENSSL_KEY_ED25519_PRIVATE(key);
+    GBytes* sig = NULL;
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+
+    if (ctx) {
+        guint8* buf = g_malloc(FOIL_ED25519_SIGNATURE_SIZE);
+        size_t siglen = FOIL_ED25519_SIGNATURE_SIZE;
+
+        /* Ed25519 does its own hashing, hence no digest */
+        if (EVP_DigestSignInit(ctx, NULL, NULL, NULL, self->pkey) > 0 &&
+            EVP_DigestSign(ctx, buf, &siglen, data, len) > 0 &&
+            siglen == FOIL_ED25519_SIGNATURE_SIZE) {
+            sig = g_bytes_new_take(buf, siglen);
+        } else {
+            GWARN("Ed25519 signing failed");
+            g_free(buf);
+        }
+        EVP_MD_CTX_free(ctx);
+    }
+    return sig;
+}
+
+static
+FoilKey*
+foil_openssl_key_ed25519_private_generate(
+    FoilKeyClass* klass,
+    guint bits)
+{
+    /* Make sure RNG is seeded */
+    GTypeClass* rng = g_type_class_ref(foil_openssl_random_get_type());
+    FoilKey* key = FOIL_KEY_CLASS(foil_openssl_key_ed25519_private_parent_class)
+        ->fn_generate(klass, bits);
+
+    g_type_class_unref(rng);
+    return key;
+}
+
+static
+FoilKey*
+foil_openssl_key_ed25519_private_create_public(
+    FoilPrivateKey* key)
+{
+    FoilKeyEd25519Private* self = FOIL_KEY_ED25519_PRIVATE_(key);
+    FoilKeyEd25519Public* pub = g_object_new(FOIL_KEY_ED25519_PUBLIC, NULL);
+
+    foil_key_ed25519_public_set_data(pub, self->pub);
+    return FOIL_KEY(pub);
+}
+
+static
+void
+foil_openssl_key_ed25519_private_finalize(
+    GObject* object)
+{
+    FoilOpensslKeyEd25519Private* self =
+        FOIL_OPENSSL_KEY_ED25519_PRIVATE(object);
+
+    if (self->pkey) {
+        EVP_PKEY_free(self->pkey);
+    }
+    G_OBJECT_CLASS(foil_openssl_key_ed25519_private_parent_class)->
+        finalize(object);
+}
+
+static
+void
+foil_openssl_key_ed25519_private_init(
+    FoilOpensslKeyEd25519Private* self)
+{
+}
+
+static
+void
+foil_openssl_key_ed25519_private_class_init(
+    FoilOpensslKeyEd25519PrivateClass* klass)
+{
+    FOIL_KEY_CLASS(klass)->fn_generate =
+        foil_openssl_key_ed25519_private_generate;
+    FOIL_PRIVATE_KEY_CLASS(klass)->fn_create_public =
+        foil_openssl_key_ed25519_private_create_public;
+    klass->fn_init = foil_openssl_key_ed25519_private_init_key;
+    klass->fn_sign = foil_openssl_key_ed25519_private_sign;
+    G_OBJECT_CLASS(klass)->finalize =
+        foil_openssl_key_ed25519_private_finalize;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
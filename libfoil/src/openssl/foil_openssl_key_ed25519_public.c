@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_key_ed25519_p.h"
+
+#include <openssl/evp.h>
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_key
+#include "foil_log_p.h"
+
+typedef FoilKeyEd25519PublicClass FoilOpensslKeyEd25519PublicClass;
+typedef FoilKeyEd25519Public FoilOpensslKeyEd25519Public;
+
+G_DEFINE_TYPE(FoilOpensslKeyEd25519Public, foil_openssl_key_ed25519_public,
+    FOIL_TYPE_KEY_ED25519_PUBLIC);
+#define FOIL_OPENSSL_TYPE_KEY_ED25519_PUBLIC \
+    foil_openssl_key_ed25519_public_get_type()
+
+GType
+foil_impl_key_ed25519_public_get_type()
+{
+    return FOIL_OPENSSL_TYPE_KEY_ED25519_PUBLIC;
+}
+
+static
+gboolean
+foil_openssl_key_ed25519_public_verify(
+    FoilKeyEd25519Public* key,
+    const void* data,
+    gsize len,
+    const guint8* sig)
+{
+    gboolean ok = FALSE;
+    EVP_PKEY* pkey = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL,
+        key->pub, sizeof(key->pub));
+
+    if (pkey) {
+        EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+
+        if (ctx) {
+            /* Ed25519 does its own hashing, hence no digest */
+            if (EVP_DigestVerifyInit(ctx, NULL, NULL, NULL, pkey) > 0 &&
+                EVP_DigestVerify(ctx, sig, FOIL_ED25519_SIGNATURE_SIZE,
+                data, len) > 0) {
+                ok = TRUE;
+            } else {
+                GDEBUG("Ed25519 signature verification failed");
+            }
+            EVP_MD_CTX_free(ctx);
+        }
+        EVP_PKEY_free(pkey);
+    }
+    return ok;
+}
+
+static
+void
+foil_openssl_key_ed25519_public_init(
+    FoilOpensslKeyEd25519Public* self)
+{
+}
+
+static
+void
+foil_openssl_key_ed25519_public_class_init(
+    FoilOpensslKeyEd25519PublicClass* klass)
+{
+    klass->fn_verify = foil_openssl_key_ed25519_public_verify;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -35,6 +35,10 @@
 #include "foil_openssl_rsa.h"
 #include "foil_openssl_random.h"
 
+#include "foil_asn1.h"
+#include "foil_output.h"
+#include "foil_util_p.h"
+
 /* Logging */
 #define GLOG_MODULE_NAME foil_log_key
 #include "foil_log_p.h"
@@ -51,6 +55,55 @@ foil_impl_key_rsa_private_get_type()
     return FOIL_OPENSSL_TYPE_KEY_RSA_PRIVATE;
 }
 
+static
+guint
+foil_openssl_key_rsa_private_other_count(
+    const FoilBytes* other_primes)
+{
+    FoilBytes r, d, t;
+    GUtilRange pos;
+    guint count = 0;
+
+    foil_parse_init_data(&pos, other_primes);
+    while (foil_key_rsa_private_parse_other_prime(&pos, &r, &d, &t)) {
+        count++;
+    }
+    return count;
+}
+
+static
+gboolean
+foil_openssl_key_rsa_private_apply_other(
+    RSA* rsa,
+    const FoilBytes* other_primes)
+{
+    const guint n = foil_openssl_key_rsa_private_other_count(other_primes);
+    BIGNUM** bn = g_new(BIGNUM*, 3 * n);
+    BIGNUM** r = bn;
+    BIGNUM** d = r + n;
+    BIGNUM** t = d + n;
+    FoilBytes rb, db, tb;
+    GUtilRange pos;
+    gboolean ok;
+    guint i;
+
+    foil_parse_init_data(&pos, other_primes);
+    for (i = 0; i < n; i++) {
+        GVERIFY(foil_key_rsa_private_parse_other_prime(&pos, &rb, &db, &tb));
+        r[i] = BN_bin2bn(rb.val, rb.len, NULL);
+        d[i] = BN_bin2bn(db.val, db.len, NULL);
+        t[i] = BN_bin2bn(tb.val, tb.len, NULL);
+    }
+    ok = foil_openssl_rsa_set_other_primes(rsa, r, d, t, n);
+    if (!ok) {
+        for (i = 0; i < 3 * n; i++) {
+            BN_clear_free(bn[i]);
+        }
+    }
+    g_free(bn);
+    return ok;
+}
+
 void
 foil_openssl_key_rsa_private_apply(
     FoilKeyRsaPrivate* key,
@@ -58,8 +111,90 @@ foil_openssl_key_rsa_private_apply(
 {
     const FoilKeyRsaPrivateData* data = key->data;
     foil_openssl_rsa_set_key(rsa, &data->n, &data->e, &data->d);
-    foil_openssl_rsa_set_factors(rsa, &data->p, &data->q);
-    foil_openssl_rsa_set_params(rsa, &data->dmp1, &data->dmq1, &data->iqmp);
+    if (!data->other_primes.len) {
+        foil_openssl_rsa_set_factors(rsa, &data->p, &data->q);
+        foil_openssl_rsa_set_params(rsa, &data->dmp1, &data->dmq1,
+            &data->iqmp);
+    } else if (foil_openssl_rsa_multi_prime_supported()) {
+        /* CRT with all the primes, that's what makes it fast */
+        foil_openssl_rsa_set_factors(rsa, &data->p, &data->q);
+        foil_openssl_rsa_set_params(rsa, &data->dmp1, &data->dmq1,
+            &data->iqmp);
+        if (!foil_openssl_key_rsa_private_apply_other(rsa,
+            &data->other_primes)) {
+            /* OpenSSL checks CRT results and falls back to d */
+            GWARN("Failed to apply %u extra RSA primes",
+                foil_openssl_key_rsa_private_other_count
+                    (&data->other_primes));
+        }
+    } else {
+        /*
+         * Two-prime CRT would produce garbage for a multi-prime key,
+         * leave the factors unset and let OpenSSL use d directly.
+         */
+        GDEBUG("Multi-prime RSA is not supported by OpenSSL");
+    }
+}
+
+/* Positive DER INTEGER contents, with the leading zero if necessary */
+static
+void
+foil_openssl_key_rsa_private_bn_bytes(
+    const BIGNUM* bn,
+    guint8* buf,
+    FoilBytes* bytes)
+{
+    buf[0] = 0;
+    bytes->len = BN_bn2bin(bn, buf + 1);
+    if (bytes->len && !(buf[1] & 0x80)) {
+        bytes->val = buf + 1;
+    } else {
+        bytes->val = buf;
+        bytes->len++;
+    }
+}
+
+/* Encodes the contents of OtherPrimeInfos, returns NULL for two primes */
+static
+GByteArray*
+foil_openssl_key_rsa_private_other_primes(
+    RSA* rsa)
+{
+    const guint n = foil_openssl_rsa_get_other_prime_count(rsa);
+
+    if (n) {
+        const BIGNUM** bn = g_new0(const BIGNUM*, 3 * n);
+        const BIGNUM** r = bn;
+        const BIGNUM** d = r + n;
+        const BIGNUM** t = d + n;
+        const gsize size = BN_num_bytes(FOIL_RSA_FIELD(rsa,n)) + 1;
+        guint8* buf = g_malloc(3 * size);
+        GByteArray* other = g_byte_array_new();
+        FoilOutput* out = foil_output_mem_new(other);
+        guint i;
+
+        foil_openssl_rsa_get_other_primes(rsa, r, d, t);
+        for (i = 0; i < n; i++) {
+            FoilBytes rb, db, tb;
+
+            foil_openssl_key_rsa_private_bn_bytes(r[i], buf, &rb);
+            foil_openssl_key_rsa_private_bn_bytes(d[i], buf + size, &db);
+            foil_openssl_key_rsa_private_bn_bytes(t[i], buf + 2 * size, &tb);
+            foil_asn1_encode_sequence_header(out,
+                foil_asn1_block_length(rb.len) +
+                foil_asn1_block_length(db.len) +
+                foil_asn1_block_length(tb.len));
+            foil_asn1_encode_integer_bytes(out, &rb);
+            foil_asn1_encode_integer_bytes(out, &db);
+            foil_asn1_encode_integer_bytes(out, &tb);
+        }
+        foil_output_unref(out);
+        memset(buf, 0, 3 * size);
+        g_free(buf);
+        g_free(bn);
+        return other;
+    }
+    return NULL;
 }
 
 static
@@ -75,10 +210,12 @@ foil_key_rsa_private_data_from_rsa(
     const int dmp1len = BN_num_bytes(FOIL_RSA_FIELD(rsa,dmp1));
     const int dmq1len = BN_num_bytes(FOIL_RSA_FIELD(rsa,dmq1));
     const int iqmplen = BN_num_bytes(FOIL_RSA_FIELD(rsa,iqmp));
+    GByteArray* other = foil_openssl_key_rsa_private_other_primes(rsa);
+    const gsize otherlen = other ? other->len : 0;
     const gsize total = FOIL_ALIGN(sizeof(FoilKeyRsaPrivateData)) +
         FOIL_ALIGN(nlen) + FOIL_ALIGN(elen) + FOIL_ALIGN(dlen) +
         FOIL_ALIGN(plen) + FOIL_ALIGN(qlen) + FOIL_ALIGN(dmp1len) +
-        FOIL_ALIGN(dmq1len) + FOIL_ALIGN(iqmplen);
+        FOIL_ALIGN(dmq1len) + FOIL_ALIGN(iqmplen) + FOIL_ALIGN(otherlen);
     FoilKeyRsaPrivateData* data = g_malloc(total);
     guint8* ptr = ((guint8*)data) + FOIL_ALIGN(sizeof(*data));
     BN_bn2bin(FOIL_RSA_FIELD(rsa,n), ptr); data->n.val = ptr;
@@ -97,15 +234,23 @@ foil_key_rsa_private_data_from_rsa(
     ptr += FOIL_ALIGN(data->dmq1.len = dmq1len);
     BN_bn2bin(FOIL_RSA_FIELD(rsa,iqmp), ptr); data->iqmp.val = ptr;
     ptr += FOIL_ALIGN(data->iqmp.len = iqmplen);
+    data->other_primes.val = ptr;
+    data->other_primes.len = otherlen;
+    if (other) {
+        memcpy(ptr, other->data, otherlen);
+        memset(other->data, 0, otherlen);
+        g_byte_array_free(other, TRUE);
+        ptr += FOIL_ALIGN(otherlen);
+    }
     GASSERT((gsize)(ptr - ((guint8*)data)) == total);
     return data;
 }
 
 static
 FoilKey*
-foil_openssl_key_rsa_private_generate(
-    FoilKeyClass* klass,
-    guint bits)
+foil_openssl_key_rsa_private_generate_primes(
+    guint bits,
+    guint primes)
 {
     FoilKey* key = NULL;
     BIGNUM* pub_exp = BN_new();
@@ -115,7 +260,8 @@ foil_openssl_key_rsa_private_generate(
         if (BN_set_word(pub_exp, RSA_F4)) {
             RSA* rsa = RSA_new();
             if (rsa) {
-                if (RSA_generate_key_ex(rsa, bits, pub_exp, NULL)) {
+                if (foil_openssl_rsa_generate_key(rsa, bits, primes,
+                    pub_exp)) {
                     FoilKeyRsaPrivate* priv = g_object_new
                         (FOIL_OPENSSL_TYPE_KEY_RSA_PRIVATE, NULL);
                     priv->data = foil_key_rsa_private_data_from_rsa(rsa);
@@ -130,6 +276,37 @@ foil_openssl_key_rsa_private_generate(
     return key;
 }
 
+static
+FoilKey*
+foil_openssl_key_rsa_private_generate(
+    FoilKeyClass* klass,
+    guint bits)
+{
+    return foil_openssl_key_rsa_private_generate_primes(bits, 2);
+}
+
+static
+FoilKey*
+foil_openssl_key_rsa_private_generate_full(
+    FoilKeyClass* klass,
+    guint bits,
+    GHashTable* param)
+{
+    guint primes = 2;
+
+    if (param) {
+        GVariant* var = g_hash_table_lookup(param, FOIL_KEY_PARAM_PRIMES);
+        if (var && g_variant_is_of_type(var, G_VARIANT_TYPE_UINT32)) {
+            primes = g_variant_get_uint32(var);
+        }
+    }
+    if (primes < 2) {
+        GWARN("Invalid number of RSA primes %u", primes);
+        return NULL;
+    }
+    return foil_openssl_key_rsa_private_generate_primes(bits, primes);
+}
+
 static
 FoilKey*
 foil_openssl_key_rsa_private_create_public(
@@ -156,6 +333,8 @@ foil_openssl_key_rsa_private_class_init(
     FoilOpensslKeyRsaPrivateClass* klass)
 {
     FOIL_KEY_CLASS(klass)->fn_generate = foil_openssl_key_rsa_private_generate;
+    FOIL_KEY_CLASS(klass)->fn_generate_full =
+        foil_openssl_key_rsa_private_generate_full;
     FOIL_PRIVATE_KEY_CLASS(klass)->fn_create_public =
         foil_openssl_key_rsa_private_create_public;
 }
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_key_x25519_p.h"
+
+typedef FoilKeyX25519PublicClass FoilOpensslKeyX25519PublicClass;
+typedef FoilKeyX25519Public FoilOpensslKeyX25519Public;
+
+G_DEFINE_TYPE(FoilOpensslKeyX25519Public, foil_openssl_key_x25519_public,
+    FOIL_TYPE_KEY_X25519_PUBLIC);
+#define FOIL_OPENSSL_TYPE_KEY_X25519_PUBLIC \
+    foil_openssl_key_x25519_public_get_type()
+
+GType
+foil_impl_key_x25519_public_get_type()
+{
+    return FOIL_OPENSSL_TYPE_KEY_X25519_PUBLIC;
+}
+
+static
+void
+foil_openssl_key_x25519_public_init(
+    FoilOpensslKeyX25519Public* self)
+{
+}
+
+static
+void
+foil_openssl_key_x25519_public_class_init(
+    FoilOpensslKeyX25519PublicClass* klass)
+{
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
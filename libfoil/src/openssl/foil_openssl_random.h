@@ -44,6 +44,11 @@ foil_openssl_random_get_type(
     void)
     FOIL_INTERNAL;
 
+GType
+foil_openssl_random_buffered_get_type(
+    void)
+    FOIL_INTERNAL;
+
 #endif /* FOIL_OPENSSL_RANDOM_H */
 
 /*
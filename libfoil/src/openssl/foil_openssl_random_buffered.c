@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foil_openssl_random.h"
+#include "foil_random_p.h"
+
+/* Logging */
+#define GLOG_MODULE_NAME foil_log_random
+#include "foil_log_p.h"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+
+#include <pthread.h>
+
+/*
+ * Per-thread AES-256-CTR generator with fast key erasure. Every refill
+ * of the buffer immediately replaces the key and the counter with the
+ * first bytes of the fresh keystream, so the state can't be used to
+ * recover the output which has already been handed out. Consumed bytes
+ * are wiped from the buffer as well.
+ *
+ * The generator is reseeded from the OpenSSL RNG after producing
+ * FOIL_RANDOM_BUFFERED_RESEED_BYTES, after FOIL_RANDOM_BUFFERED_RESEED_TIME
+ * and in the child process after fork.
+ */
+
+#define FOIL_RANDOM_BUFFERED_KEY_SIZE (32)
+#define FOIL_RANDOM_BUFFERED_IV_SIZE (16)
+#define FOIL_RANDOM_BUFFERED_SEED_SIZE \
+    (FOIL_RANDOM_BUFFERED_KEY_SIZE + FOIL_RANDOM_BUFFERED_IV_SIZE)
+#define FOIL_RANDOM_BUFFERED_BUF_SIZE (1024)
+#define FOIL_RANDOM_BUFFERED_RESEED_BYTES (0x100000)
+#define FOIL_RANDOM_BUFFERED_RESEED_TIME (300 * G_USEC_PER_SEC)
+
+typedef FoilRandom FoilOpensslRandomBuffered;
+typedef FoilRandomClass FoilOpensslRandomBufferedClass;
+
+typedef struct foil_openssl_random_buffered_state {
+    EVP_CIPHER_CTX* ctx;
+    guint fork_count;
+    guint64 generated;
+    gint64 reseed_time;
+    guint pos;
+    guint8 buf[FOIL_RANDOM_BUFFERED_BUF_SIZE];
+} FoilOpensslRandomBufferedState;
+
+/* There's no need to instantiate this class, make it abstract */
+G_DEFINE_ABSTRACT_TYPE(FoilOpensslRandomBuffered,
+    foil_openssl_random_buffered, FOIL_TYPE_RANDOM)
+
+GType
+foil_impl_random_buffered_get_type() /* Since 1.0.31 */
+{
+    return foil_openssl_random_buffered_get_type();
+}
+
+static guint foil_openssl_random_buffered_fork_count = 0;
+
+static
+void
+foil_openssl_random_buffered_state_free(
+    gpointer data)
+{
+    FoilOpensslRandomBufferedState* state = data;
+
+    EVP_CIPHER_CTX_free(state->ctx);
+    OPENSSL_cleanse(state, sizeof(*state));
+    g_slice_free(FoilOpensslRandomBufferedState, state);
+}
+
+static GPrivate foil_openssl_random_buffered_key =
+    G_PRIVATE_INIT(foil_openssl_random_buffered_state_free);
+
+static
+void
+foil_openssl_random_buffered_atfork_child(
+    void)
+{
+    /* Forces every thread's state to reseed in the child */
+    g_atomic_int_inc(&foil_openssl_random_buffered_fork_count);
+}
+
+static
+gboolean
+foil_openssl_random_buffered_rekey(
+    FoilOpensslRandomBufferedState* state,
+    const guint8* seed)
+{
+    return EVP_EncryptInit_ex(state->ctx, EVP_aes_256_ctr(), NULL, seed,
+        seed + FOIL_RANDOM_BUFFERED_KEY_SIZE) > 0;
+}
+
+static
+gboolean
+foil_openssl_random_buffered_keystream(
+    FoilOpensslRandomBufferedState* state,
+    guint8* data,
+    guint size)
+{
+    int len = 0;
+
+    memset(data, 0, size);
+    return EVP_EncryptUpdate(state->ctx, data, &len, data, size) > 0 &&
+        len == (int)size;
+}
+
+static
+gboolean
+foil_openssl_random_buffered_reseed(
+    FoilOpensslRandomBufferedState* state)
+{
+    guint8 seed[FOIL_RANDOM_BUFFERED_SEED_SIZE];
+    gboolean ok = FALSE;
+
+    if (RAND_bytes(seed, sizeof(seed)) > 0 &&
+        foil_openssl_random_buffered_rekey(state, seed)) {
+        state->fork_count =
+            g_atomic_int_get(&foil_openssl_random_buffered_fork_count);
+        state->generated = 0;
+        state->reseed_time = g_get_monotonic_time() +
+            FOIL_RANDOM_BUFFERED_RESEED_TIME;
+        OPENSSL_cleanse(state->buf, sizeof(state->buf));
+        state->pos = sizeof(state->buf);
+        ok = TRUE;
+    } else {
+        GWARN("Failed to seed the generator");
+    }
+    OPENSSL_cleanse(seed, sizeof(seed));
+    return ok;
+}
+
+static
+gboolean
+foil_openssl_random_buffered_refill(
+    FoilOpensslRandomBufferedState* state)
+{
+    guint8* buf = state->buf;
+
+    if ((state->generated >= FOIL_RANDOM_BUFFERED_RESEED_BYTES ||
+        g_get_monotonic_time() >= state->reseed_time) &&
+        !foil_openssl_random_buffered_reseed(state)) {
+        return FALSE;
+    }
+
+    /* The first bytes of the keystream become the next key */
+    if (foil_openssl_random_buffered_keystream(state, buf, sizeof(state->buf))
+        && foil_openssl_random_buffered_rekey(state, buf)) {
+        OPENSSL_cleanse(buf, FOIL_RANDOM_BUFFERED_SEED_SIZE);
+        state->pos = FOIL_RANDOM_BUFFERED_SEED_SIZE;
+        state->generated += sizeof(state->buf);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+FoilOpensslRandomBufferedState*
+foil_openssl_random_buffered_state(
+    void)
+{
+    FoilOpensslRandomBufferedState* state =
+        g_private_get(&foil_openssl_random_buffered_key);
+
+    if (!state) {
+        state = g_slice_new0(FoilOpensslRandomBufferedState);
+        state->ctx = EVP_CIPHER_CTX_new();
+        if (!state->ctx || !foil_openssl_random_buffered_reseed(state)) {
+            foil_openssl_random_buffered_state_free(state);
+            return NULL;
+        }
+        g_private_set(&foil_openssl_random_buffered_key, state);
+    } else if (state->fork_count !=
+        g_atomic_int_get(&foil_openssl_random_buffered_fork_count) &&
+        !foil_openssl_random_buffered_reseed(state)) {
+        return NULL;
+    }
+    return state;
+}
+
+static
+gboolean
+foil_openssl_random_buffered_generate(
+    void* data,
+    guint size)
+{
+    FoilOpensslRandomBufferedState* state =
+        foil_openssl_random_buffered_state();
+    guint8* ptr = data;
+
+    if (!state) {
+        return FALSE;
+    }
+
+    /* Large requests bypass the buffer */
+    if (size >= sizeof(state->buf)) {
+        const guint bulk = size - size % sizeof(state->buf);
+
+        if (!foil_openssl_random_buffered_keystream(state, ptr, bulk)) {
+            return FALSE;
+        }
+        state->generated += bulk;
+        ptr += bulk;
+        size -= bulk;
+        /* Rekey so that the bulk output can't be reproduced */
+        if (!foil_openssl_random_buffered_refill(state)) {
+            return FALSE;
+        }
+    }
+
+    while (size > 0) {
+        guint n;
+
+        if (state->pos == sizeof(state->buf) &&
+            !foil_openssl_random_buffered_refill(state)) {
+            return FALSE;
+        }
+        n = MIN(size, sizeof(state->buf) - state->pos);
+        memcpy(ptr, state->buf + state->pos, n);
+        OPENSSL_cleanse(state->buf + state->pos, n);
+        state->pos += n;
+        ptr += n;
+        size -= n;
+    }
+    return TRUE;
+}
+
+static
+void
+foil_openssl_random_buffered_init(
+    FoilOpensslRandomBuffered* self)
+{
+}
+
+static
+void
+foil_openssl_random_buffered_class_init(
+    FoilOpensslRandomBufferedClass* klass)
+{
+    pthread_atfork(NULL, NULL, foil_openssl_random_buffered_atfork_child);
+    klass->name = "Buffered";
+    klass->fn_generate = foil_openssl_random_buffered_generate;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
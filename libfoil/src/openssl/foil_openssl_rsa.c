@@ -104,6 +104,44 @@ RSA_set0_crt_params(
     BIGNUM* iqmp)
     FOIL_WEAK_FN;
 
+/* Multi-prime RSA appeared in OpenSSL 1.1.1 */
+
+int
+RSA_generate_multi_prime_key(
+    RSA* rsa,
+    int bits,
+    int primes,
+    BIGNUM* e,
+    BN_GENCB* cb)
+    FOIL_WEAK_FN;
+
+int
+RSA_get_multi_prime_extra_count(
+    const RSA* r)
+    FOIL_WEAK_FN;
+
+int
+RSA_get0_multi_prime_factors(
+    const RSA* r,
+    const BIGNUM* primes[])
+    FOIL_WEAK_FN;
+
+int
+RSA_get0_multi_prime_crt_params(
+    const RSA* r,
+    const BIGNUM* exps[],
+    const BIGNUM* coeffs[])
+    FOIL_WEAK_FN;
+
+int
+RSA_set0_multi_prime_params(
+    RSA* r,
+    BIGNUM* primes[],
+    BIGNUM* exps[],
+    BIGNUM* coeffs[],
+    int pnum)
+    FOIL_WEAK_FN;
+
 /* Getters for RSA fields */
 
 const BIGNUM*
@@ -277,6 +315,73 @@ foil_openssl_rsa_set_params(
     }
 }
 
+/* Multi-prime keys */
+
+gboolean
+foil_openssl_rsa_multi_prime_supported()
+{
+    return RSA_generate_multi_prime_key &&
+        RSA_get_multi_prime_extra_count &&
+        RSA_get0_multi_prime_factors &&
+        RSA_get0_multi_prime_crt_params &&
+        RSA_set0_multi_prime_params;
+}
+
+gboolean
+foil_openssl_rsa_generate_key(
+    RSA* rsa,
+    int bits,
+    int primes,
+    BIGNUM* e)
+{
+    if (primes <= 2) {
+        return RSA_generate_key_ex(rsa, bits, e, NULL) > 0;
+    } else if (foil_openssl_rsa_multi_prime_supported()) {
+        return RSA_generate_multi_prime_key(rsa, bits, primes, e, NULL) > 0;
+    } else {
+        return FALSE;
+    }
+}
+
+guint
+foil_openssl_rsa_get_other_prime_count(
+    const RSA* rsa)
+{
+    if (foil_openssl_rsa_multi_prime_supported()) {
+        const int count = RSA_get_multi_prime_extra_count(rsa);
+
+        return MAX(count, 0);
+    }
+    return 0;
+}
+
+void
+foil_openssl_rsa_get_other_primes(
+    const RSA* rsa,
+    const BIGNUM* r[],
+    const BIGNUM* d[],
+    const BIGNUM* t[])
+{
+    /* Arrays must have room for foil_openssl_rsa_get_other_prime_count */
+    if (foil_openssl_rsa_multi_prime_supported()) {
+        RSA_get0_multi_prime_factors(rsa, r);
+        RSA_get0_multi_prime_crt_params(rsa, d, t);
+    }
+}
+
+gboolean
+foil_openssl_rsa_set_other_primes(
+    RSA* rsa,
+    BIGNUM* r[],
+    BIGNUM* d[],
+    BIGNUM* t[],
+    guint count)
+{
+    /* Takes ownership of BIGNUMs on success, p and q must be already set */
+    return foil_openssl_rsa_multi_prime_supported() &&
+        RSA_set0_multi_prime_params(rsa, r, d, t, count);
+}
+
 /*
  * Local Variables:
  * mode: C
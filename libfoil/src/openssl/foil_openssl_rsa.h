@@ -163,6 +163,43 @@ foil_openssl_rsa_set_params(
     const FoilBytes* iqmp)
     FOIL_INTERNAL;
 
+/* Multi-prime keys (not supported by OpenSSL < 1.1.1) */
+
+gboolean
+foil_openssl_rsa_multi_prime_supported(
+    void)
+    FOIL_INTERNAL;
+
+gboolean
+foil_openssl_rsa_generate_key(
+    RSA* rsa,
+    int bits,
+    int primes,
+    BIGNUM* e)
+    FOIL_INTERNAL;
+
+guint
+foil_openssl_rsa_get_other_prime_count(
+    const RSA* rsa)
+    FOIL_INTERNAL;
+
+void
+foil_openssl_rsa_get_other_primes(
+    const RSA* rsa,
+    const BIGNUM* r[],
+    const BIGNUM* d[],
+    const BIGNUM* t[])
+    FOIL_INTERNAL;
+
+gboolean
+foil_openssl_rsa_set_other_primes(
+    RSA* rsa,
+    BIGNUM* r[],
+    BIGNUM* d[],
+    BIGNUM* t[],
+    guint count)
+    FOIL_INTERNAL;
+
 #define FOIL_RSA_PKCS1_OAEP_PADDING_SIZE 42
 
 #endif /* FOIL_OPENSSL_RSA_H */
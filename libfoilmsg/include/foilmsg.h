@@ -51,19 +51,39 @@ typedef struct foilmsg_encrypt_key {
 
 /* Valid tags for various blocks */
 #define FOILMSG_FINGERPRINT_SSH_RSA       (1)
+#define FOILMSG_FINGERPRINT_SSH_ED25519   (2) /* Since 1.0.31 */
+#define FOILMSG_FINGERPRINT_X25519        (3) /* Since 1.0.31 */
 
 #define FOILMSG_ENCRYPT_KEY_FORMAT_AES128 (1) /* 16 bytes key + 16 bytes IV */
 #define FOILMSG_ENCRYPT_KEY_FORMAT_AES192 (2) /* 24 bytes key + 16 bytes IV */
 #define FOILMSG_ENCRYPT_KEY_FORMAT_AES256 (3) /* 32 bytes key + 16 bytes IV */
 
+/*
+ * The same keys wrapped for X25519 recipients (Since 1.0.31). Each
+ * encryptedKey is a 32-byte ephemeral X25519 public key followed by
+ * the AES key (and IV) wrapped with RFC 3394 AES key wrap. The KEK
+ * is the first 32 bytes of HKDF-SHA256 output (no salt) keyed by the
+ * X25519 shared secret, with info = "FOILMSG X25519" || ephemeral
+ * public key || recipient's public key.
+ */
+#define FOILMSG_ENCRYPT_KEY_FORMAT_AES128_X25519 (4)
+#define FOILMSG_ENCRYPT_KEY_FORMAT_AES192_X25519 (5)
+#define FOILMSG_ENCRYPT_KEY_FORMAT_AES256_X25519 (6)
+
 #define FOILMSG_ENCRYPT_FORMAT_AES_CBC    (1)
 #define FOILMSG_ENCRYPT_FORMAT_AES_CFB    (2)
 #define FOILMSG_ENCRYPT_FORMAT_AES_CTR    (3) /* Since 1.0.28 */
+#define FOILMSG_ENCRYPT_FORMAT_AES_GCM    (4) /* Since 1.0.31 */
+#define FOILMSG_ENCRYPT_FORMAT_CHACHA20_POLY1305 (5) /* Since 1.0.31 */
 
 #define FOILMSG_SIGNATURE_FORMAT_MD5_RSA    (1)
 #define FOILMSG_SIGNATURE_FORMAT_SHA1_RSA   (2)
 #define FOILMSG_SIGNATURE_FORMAT_SHA256_RSA (3)
 #define FOILMSG_SIGNATURE_FORMAT_SHA512_RSA (4)
+#define FOILMSG_SIGNATURE_FORMAT_SHA256_ED25519 (5) /* Since 1.0.31 */
+#define FOILMSG_SIGNATURE_FORMAT_SHA512_ED25519 (6) /* Since 1.0.31 */
+#define FOILMSG_SIGNATURE_FORMAT_BLAKE3_RSA (7) /* Since 1.0.31 */
+#define FOILMSG_SIGNATURE_FORMAT_BLAKE3_ED25519 (8) /* Since 1.0.31 */
 
 /* N.B. Must be freed with foilmsg_info_free */
 typedef struct foilmsg_info {
@@ -74,6 +94,7 @@ typedef struct foilmsg_info {
     const FoilMsgEncryptKey* encrypt_keys;
     FoilMsgTaggedData encrypted;
     FoilMsgTaggedData signature;
+    FoilBytes header; /* Parts 1-3 (Since 1.0.31) */
 } FoilMsgInfo;
 
 typedef struct foilmsg_header {
@@ -107,14 +128,20 @@ typedef enum foilmsg_key_type {
 typedef enum foilmsg_cipher {
     FOILMSG_CIPHER_AES_CBC,
     FOILMSG_CIPHER_AES_CFB,
-    FOILMSG_CIPHER_AES_CTR  /* Since 1.0.28 */
+    FOILMSG_CIPHER_AES_CTR, /* Since 1.0.28 */
+    FOILMSG_CIPHER_AES_GCM, /* Since 1.0.31 */
+    FOILMSG_CIPHER_CHACHA20_POLY1305 /* Since 1.0.31, 256-bit key only */
 } FOILMSG_CIPHER;
 
 typedef enum foilmsg_signature {
     FOILMSG_SIGNATURE_MD5_RSA,
     FOILMSG_SIGNATURE_SHA1_RSA,
     FOILMSG_SIGNATURE_SHA256_RSA,
-    FOILMSG_SIGNATURE_SHA512_RSA
+    FOILMSG_SIGNATURE_SHA512_RSA,
+    FOILMSG_SIGNATURE_SHA256_ED25519, /* Since 1.0.31 */
+    FOILMSG_SIGNATURE_SHA512_ED25519, /* Since 1.0.31 */
+    FOILMSG_SIGNATURE_BLAKE3_RSA,     /* Since 1.0.31 */
+    FOILMSG_SIGNATURE_BLAKE3_ED25519  /* Since 1.0.31 */
 } FOILMSG_SIGNATURE;
 
 #define FOILMSG_KEY_TYPE_DEFAULT (FOILMSG_KEY_AES_256)
@@ -129,11 +156,23 @@ typedef struct foilmsg_encrypt_options {
  * FOILMSG_FLAG_ENCRYPT_FOR_SELF - encrypt the key with sender's public
  * key (in addition to recipient's public key). If this flag is specified
  * then the recipient's public key may be omitted, i.e. the data will be
- * encrypted only for the sender itself.
+ * encrypted only for the sender itself. Ed25519 keys can only sign,
+ * so the flag is ignored for Ed25519 senders (which therefore need at
+ * least one recipient).
  */
 #define FOILMSG_FLAG_ENCRYPT_FOR_SELF (0x01)
 
     FOILMSG_CIPHER cipher;
+
+/*
+ * The signature must match the sender's key. RSA senders use one of
+ * the *_RSA signatures, Ed25519 senders use one of the *_ED25519 ones
+ * (the digest gets signed with Ed25519). Recipients' keys are either
+ * all RSA or all X25519 (Since 1.0.31), regardless of the sender's key
+ * type. RSA and X25519 recipients can't be mixed in one message, since
+ * the key format applies to all recipients. That includes the sender's
+ * own RSA key added by FOILMSG_FLAG_ENCRYPT_FOR_SELF.
+ */
     FOILMSG_SIGNATURE signature;
 } FoilMsgEncryptOptions;
 
@@ -144,6 +183,16 @@ typedef struct foilmsg_encrypt_options {
  */
 extern const FoilBytes foilmsg_prefix;
 
+/*
+ * The message is written to the output in one pass. If encryption fails
+ * half way through, the output is left with an incomplete message (and
+ * zero is returned), it's up to the caller to discard or truncate it.
+ *
+ * If foilmsg_encrypt is given the tmp output, the message is written
+ * there first and then copied to the actual output, only if it has been
+ * successfully encoded. The tmp output gets reset and closed.
+ */
+
 FoilMsgEncryptOptions*
 foilmsg_encrypt_defaults(
     FoilMsgEncryptOptions* opt);
@@ -159,6 +208,33 @@ foilmsg_encrypt(
     const FoilMsgEncryptOptions* opt,   /* optional */
     FoilOutput* tmp);                   /* optional */
 
+/*
+ * foilmsg_encrypt_multi encrypts the data once for any number of
+ * recipients, the AES key is encrypted with each recipient's public
+ * key. With many recipients that's done in parallel.
+ */
+
+gsize
+foilmsg_encrypt_multi(
+    FoilOutput* out,
+    const FoilBytes* data,
+    const char* content_type,           /* optional */
+    const FoilMsgHeaders* headers,      /* optional */
+    FoilPrivateKey* sender,
+    FoilKey* const* recipients,
+    guint num_recipients,
+    const FoilMsgEncryptOptions* opt /* optional */); /* Since 1.0.31 */
+
+GBytes*
+foilmsg_encrypt_multi_to_bytes(
+    const FoilBytes* data,
+    const char* content_type,           /* optional */
+    const FoilMsgHeaders* headers,      /* optional */
+    FoilPrivateKey* sender,
+    FoilKey* const* recipients,
+    guint num_recipients,
+    const FoilMsgEncryptOptions* opt /* optional */); /* Since 1.0.31 */
+
 GString*
 foilmsg_encrypt_text(
     const char* plain_text,
@@ -183,6 +259,46 @@ foilmsg_encrypt_to_bytes(
     FoilKey* recipient,
     const FoilMsgEncryptOptions* opt);  /* optional */
 
+/*
+ * FoilMsgEncryptor is bound to the sender, the recipient and the options.
+ * It generates the AES keys and encrypts them with the public keys on
+ * a background thread, ahead of demand, so that encrypting a message
+ * doesn't have to wait for the RSA public key operations. Each prepared
+ * key is used for a single message. If the prepared keys run out, the
+ * key is generated synchronously. Depth is the maximum number of keys
+ * prepared in advance, zero means the default.
+ *
+ * The encryptor may be used from several threads at the same time.
+ */
+
+typedef struct foilmsg_encryptor FoilMsgEncryptor; /* Since 1.0.31 */
+
+FoilMsgEncryptor*
+foilmsg_encryptor_new(
+    FoilPrivateKey* sender,
+    FoilKey* recipient,                 /* optional with ENCRYPT_FOR_SELF */
+    const FoilMsgEncryptOptions* opt,   /* optional */
+    guint depth); /* Since 1.0.31 */
+
+void
+foilmsg_encryptor_free(
+    FoilMsgEncryptor* enc); /* Since 1.0.31 */
+
+gsize
+foilmsg_encryptor_encrypt(
+    FoilMsgEncryptor* enc,
+    FoilOutput* out,
+    const FoilBytes* data,
+    const char* content_type,           /* optional */
+    const FoilMsgHeaders* headers /* optional */); /* Since 1.0.31 */
+
+GBytes*
+foilmsg_encryptor_encrypt_to_bytes(
+    FoilMsgEncryptor* enc,
+    const FoilBytes* data,
+    const char* content_type,           /* optional */
+    const FoilMsgHeaders* headers /* optional */); /* Since 1.0.31 */
+
 /*
  * foilmsg_parse checks the structure of the encrypted message.
  * Returns NULL if parsing fails. FoilMsgInfo contains pointers
@@ -226,6 +342,13 @@ foilmsg_to_binary(
  *
  * If FoilOutput is NULL, the message will be processed in RAM (it's your
  * responsibility then to ensure that there's enough RAM).
+ *
+ * Otherwise, the decrypted data is written to the output as it's being
+ * decrypted. With authenticated encryption (AES-GCM, ChaCha20-Poly1305)
+ * the tag can only be checked after the last block, so whatever has been
+ * written to the output is unauthenticated until the call returns
+ * non-NULL. If it returns NULL, the output may contain partial and
+ * possibly forged data which must be discarded.
  */
 
 FoilMsg*
@@ -234,6 +357,17 @@ foilmsg_decrypt(
     const FoilBytes* bytes,
     FoilOutput* out);   /* optional */
 
+/*
+ * Same as foilmsg_decrypt() but picks the recipient's private key from
+ * the keyring. Recipients found in the keyring are tried in the order
+ * they appear in the message, until one of them works.
+ */
+FoilMsg*
+foilmsg_decrypt_with_keyring(
+    FoilKeyring* keyring,
+    const FoilBytes* bytes,
+    FoilOutput* out /* optional */);    /* Since 1.0.31 */
+
 FoilMsg*
 foilmsg_decrypt_file(
     FoilPrivateKey* recipient,
@@ -32,24 +32,30 @@
 
 #include "foilmsg_p.h"
 
+#include <foil_arena.h>
 #include <foil_input.h>
+#include <foil_keyring.h>
+#include <foil_keywrap.h>
 #include <foil_output.h>
+#include <foil_stats.h>
 #include <foil_util.h>
 
 #include <gutil_macros.h>
-#include <gutil_strv.h>
 #include <gutil_log.h>
 
 #include <ctype.h>
 
+/*
+ * Everything except the data and the fingerprint (which are GBytes
+ * for historical reasons) is allocated from the arena, including the
+ * FoilMsgPriv structure itself.
+ */
 typedef struct foilmsg_priv {
     FoilMsg msg;
-    GBytes* sig;
-    GBytes* sig_digest;
-    GType sig_cipher_type;
-    char* content_type;
-    FoilMsgHeader* headers;
-    char** header_strings;
+    FoilArena* arena;
+    FoilBytes sig;
+    FoilBytes sig_digest;
+    GType sig_cipher_type; /* Zero for Ed25519 */
 } FoilMsgPriv;
 
 typedef struct foilmsg_decrypt_context {
@@ -59,6 +65,8 @@ typedef struct foilmsg_decrypt_context {
     FoilBytes fingerprint_data;
     FoilBytes sig_data;
     FoilBytes enc_data;
+    FoilBytes header;
+    FoilBytes tag;
 } FoilMsgDecrypt;
 
 #define foilmsg_priv_cast(x) G_CAST(x,FoilMsgPriv,msg)
@@ -73,37 +81,32 @@ enum foilmsg_block {
     FOILMSG_BLOCK_COUNT
 };
 
-/* Takes ownership of content_type and headers */
+/* Takes ownership of the arena */
 static
 FoilMsg*
 foilmsg_alloc(
-    char* content_type,
-    char** headers,
+    FoilArena* arena,
+    const char* content_type,
+    const FoilMsgHeaders* headers,
     FoilOutput* out,
     FoilDigest* digest,
     GType sig_cipher_type,
     const FoilBytes* fingerprint,
     const FoilBytes* signature)
 {
-    FoilMsgPriv* priv = g_slice_new0(FoilMsgPriv);
+    FoilMsgPriv* priv = foil_arena_new0(arena, FoilMsgPriv);
     FoilMsg* msg = &priv->msg;
-    msg->content_type = priv->content_type = content_type;
+    FoilBytes digest_bytes;
+
+    priv->arena = arena;
+    msg->content_type = content_type;
+    msg->headers = *headers;
     msg->data = foil_output_free_to_bytes(foil_output_ref(out));
     msg->fingerprint = g_bytes_new(fingerprint->val, fingerprint->len);
-    msg->headers.count = gutil_strv_length(headers)/2;
-    if (msg->headers.count > 0) {
-        guint i;
-        msg->headers.header =
-        priv->headers = g_new(FoilMsgHeader, msg->headers.count);
-        for (i=0; i<msg->headers.count; i++) {
-            priv->headers[i].name = headers[2*i];
-            priv->headers[i].value = headers[2*i+1];
-        }
-    }
-    priv->header_strings = headers;
     priv->sig_cipher_type = sig_cipher_type;
-    priv->sig_digest = g_bytes_ref(foil_digest_finish(digest));
-    priv->sig = g_bytes_new(signature->val, signature->len);
+    foil_arena_copy_bytes(arena, &priv->sig_digest,
+        foil_bytes_from_data(&digest_bytes, foil_digest_finish(digest)));
+    foil_arena_copy_bytes(arena, &priv->sig, signature);
     return msg;
 }
 
@@ -113,14 +116,9 @@ foilmsg_free(
 {
     if (G_LIKELY(msg)) {
         FoilMsgPriv* priv = foilmsg_priv_cast(msg);
-        g_strfreev(priv->header_strings);
-        g_free(priv->content_type);
-        g_free(priv->headers);
         g_bytes_unref(msg->data);
         g_bytes_unref(msg->fingerprint);
-        g_bytes_unref(priv->sig);
-        g_bytes_unref(priv->sig_digest);
-        g_slice_free(FoilMsgPriv, priv);
+        foil_arena_free(priv->arena);
     }
 }
 
@@ -147,17 +145,13 @@ foilmsg_decode_tagged_data(
     GUtilRange* pos,
     FoilMsgTaggedData* block)
 {
-    guint32 len;
-    if (foil_asn1_parse_start_sequence(pos, &len)) {
-        GUtilRange seq;
-        seq.ptr = pos->ptr;
-        seq.end = pos->ptr + len;
-        if (foil_asn1_parse_int32(&seq, &block->tag) &&
-            foil_asn1_parse_octet_string(&seq, &block->data) &&
-            seq.ptr == seq.end) {
-            pos->ptr = seq.ptr;
-            return TRUE;
-        }
+    GUtilRange tmp = *pos, seq;
+    if (foil_asn1_parse_sequence(&tmp, &seq) &&
+        foil_asn1_parse_int32(&seq, &block->tag) &&
+        foil_asn1_parse_octet_string(&seq, &block->data) &&
+        seq.ptr == seq.end) {
+        pos->ptr = tmp.ptr;
+        return TRUE;
     }
     return FALSE;
 }
@@ -175,12 +169,16 @@ foilmsg_decode_tagged_data(
  */
 
 static
-void
-foilmsg_free_encrypt_key(
-    gpointer ptr)
+gboolean
+foilmsg_decode_encrypt_key(
+    GUtilRange* pos,
+    FoilMsgEncryptKey* key)
 {
-    FoilMsgEncryptKey* key = ptr;
-    g_slice_free1(sizeof(*key), key);
+    GUtilRange seq;
+    return foil_asn1_parse_sequence(pos, &seq) &&
+        foilmsg_decode_tagged_data(&seq, &key->fingerprint) &&
+        foil_asn1_parse_octet_string(&seq, &key->data) &&
+        seq.ptr == seq.end;
 }
 
 static
@@ -188,54 +186,40 @@ FoilMsgInfo*
 foilmsg_parse_encrypted_keys(
     GUtilRange* pos)
 {
-    FoilMsgInfo* msg = NULL;
-    guint32 len;
-    if (foil_asn1_parse_start_sequence(pos, &len)) {
-        gint32 key_format;
-        GUtilRange seq;
-        seq.ptr = pos->ptr;
-        seq.end = pos->ptr + len;
-        if (foil_asn1_parse_int32(&seq, &key_format)) {
-            FoilMsgEncryptKey* key;
-            GSList* keys = NULL;
-            guint i, nkeys = 0;
-            while (foil_asn1_parse_start_sequence(&seq, &len)) {
-                GUtilRange seq2;
-                seq2.ptr = seq.ptr;
-                seq2.end = seq.ptr + len;
-                key = g_slice_new(FoilMsgEncryptKey);
-                keys = g_slist_append(keys, key);
-                if (foilmsg_decode_tagged_data(&seq2, &key->fingerprint) &&
-                    foil_asn1_parse_octet_string(&seq2, &key->data)) {
-                    seq.ptr = seq2.ptr;
-                    nkeys++;
-                    continue;
-                }
+    GUtilRange tmp = *pos, seq;
+    gint32 key_format;
+    if (foil_asn1_parse_sequence(&tmp, &seq) &&
+        foil_asn1_parse_int32(&seq, &key_format)) {
+        const GUtilRange start = seq;
+        FoilMsgInfo* msg;
+        FoilMsgEncryptKey* keys;
+        FoilMsgEncryptKey key;
+        guint i, nkeys = 0;
+
+        /* Validate and count the keys, to allocate the result in one go */
+        while (seq.ptr < seq.end) {
+            if (foilmsg_decode_encrypt_key(&seq, &key)) {
+                nkeys++;
+            } else {
                 /* Broken data stream */
-                g_slist_free_full(keys, foilmsg_free_encrypt_key);
                 return NULL;
             }
+        }
 
-            /* Must reach the end of the sequence */
-            if (seq.ptr == seq.end) {
-                pos->ptr = seq.ptr;
-                msg = g_malloc0(sizeof(*msg) + nkeys*sizeof(*key));
-                key = (FoilMsgEncryptKey*)(msg+1);
-                msg->encrypt_keys = key;
-                msg->encrypt_key_format = key_format;
-                msg->num_encrypt_keys = nkeys;
-                for (i=0; i<nkeys; i++) {
-                    memcpy(key, keys->data, sizeof(*key));
-                    foilmsg_free_encrypt_key(keys->data);
-                    keys = g_slist_delete_link(keys, keys);
-                    key++;
-                }
-            }
-
-            g_slist_free_full(keys, foilmsg_free_encrypt_key);
+        /* The second pass can't fail */
+        seq = start;
+        msg = g_malloc0(sizeof(*msg) + nkeys*sizeof(key));
+        keys = (FoilMsgEncryptKey*)(msg+1);
+        msg->encrypt_keys = keys;
+        msg->encrypt_key_format = key_format;
+        msg->num_encrypt_keys = nkeys;
+        for (i=0; i<nkeys; i++) {
+            GVERIFY(foilmsg_decode_encrypt_key(&seq, keys + i));
         }
+        pos->ptr = tmp.ptr;
+        return msg;
     }
-    return msg;
+    return NULL;
 }
 
 void
@@ -246,6 +230,15 @@ foilmsg_info_free(
     g_free(info);
 }
 
+static
+gboolean
+foilmsg_recipient_fingerprint_format(
+    gint32 tag)
+{
+    return tag == FOILMSG_FINGERPRINT_FORMAT ||
+        tag == FOILMSG_FINGERPRINT_X25519;
+}
+
 static
 gboolean
 foilmsg_decrypt_find_key(
@@ -258,7 +251,7 @@ foilmsg_decrypt_find_key(
     foil_bytes_from_data(&fp_bytes, fingerprint);
     for (i=0; i<msg->num_encrypt_keys; i++) {
         const FoilMsgEncryptKey* key = msg->encrypt_keys + i;
-        if (key->fingerprint.tag == FOILMSG_FINGERPRINT_FORMAT &&
+        if (foilmsg_recipient_fingerprint_format(key->fingerprint.tag) &&
             foil_bytes_equal(&key->fingerprint.data, &fp_bytes)) {
             key_block->tag = msg->encrypt_key_format;
             key_block->data = key->data;
@@ -272,7 +265,7 @@ static
 gboolean
 foilmsg_decrypt_init_signature(
     FoilMsgDecrypt* dec,
-    FoilMsgTaggedData* sig)
+    const FoilMsgTaggedData* sig)
 {
     switch (sig->tag) {
     case FOILMSG_SIGNATURE_FORMAT_MD5_RSA:
@@ -291,6 +284,23 @@ foilmsg_decrypt_init_signature(
         dec->sig_digest_type = FOIL_DIGEST_SHA512;
         dec->sig_cipher_type = FOIL_CIPHER_RSA_DECRYPT;
         break;
+    case FOILMSG_SIGNATURE_FORMAT_BLAKE3_RSA:
+        dec->sig_digest_type = FOIL_DIGEST_BLAKE3;
+        dec->sig_cipher_type = FOIL_CIPHER_RSA_DECRYPT;
+        break;
+    /* Ed25519 signatures are verified directly, there's no cipher */
+    case FOILMSG_SIGNATURE_FORMAT_SHA256_ED25519:
+        dec->sig_digest_type = FOIL_DIGEST_SHA256;
+        dec->sig_cipher_type = 0;
+        break;
+    case FOILMSG_SIGNATURE_FORMAT_SHA512_ED25519:
+        dec->sig_digest_type = FOIL_DIGEST_SHA512;
+        dec->sig_cipher_type = 0;
+        break;
+    case FOILMSG_SIGNATURE_FORMAT_BLAKE3_ED25519:
+        dec->sig_digest_type = FOIL_DIGEST_BLAKE3;
+        dec->sig_cipher_type = 0;
+        break;
     default:
         return FALSE;
     }
@@ -298,6 +308,45 @@ foilmsg_decrypt_init_signature(
     return TRUE;
 }
 
+/* Reverses foilmsg_x25519_wrap_key */
+static
+GBytes*
+foilmsg_x25519_unwrap_key(
+    FoilPrivateKey* recipient,
+    const FoilBytes* enc)
+{
+    GBytes* key_data = NULL;
+
+    if (FOIL_IS_KEY_X25519_PRIVATE(recipient) &&
+        enc->len > FOIL_X25519_KEY_SIZE) {
+        FoilKey* eph = foil_key_new_from_data(FOIL_KEY_X25519_PUBLIC,
+            enc->val, FOIL_X25519_KEY_SIZE);
+
+        if (eph) {
+            GBytes* secret = foil_x25519_derive(recipient, eph);
+
+            if (secret) {
+                GBytes* pub = foil_x25519_public_bytes(FOIL_KEY(recipient));
+                FoilKey* kek = foilmsg_x25519_kek(secret, enc->val,
+                    g_bytes_get_data(pub, NULL));
+
+                if (kek) {
+                    FoilBytes wrapped;
+
+                    wrapped.val = enc->val + FOIL_X25519_KEY_SIZE;
+                    wrapped.len = enc->len - FOIL_X25519_KEY_SIZE;
+                    key_data = foil_keywrap_unwrap(kek, &wrapped);
+                    foil_key_unref(kek);
+                }
+                g_bytes_unref(pub);
+                g_bytes_unref(secret);
+            }
+            foil_key_unref(eph);
+        }
+    }
+    return key_data;
+}
+
 static
 gboolean
 foilmsg_decrypt_init_cipher(
@@ -308,16 +357,25 @@ foilmsg_decrypt_init_cipher(
 {
     GType block_key_type = 0;
     GType block_cipher_type = 0;
-    GType block_key_decrypt_type = FOIL_CIPHER_RSA_DECRYPT;
+    gboolean x25519 = FALSE;
 
     /* Make sure that key and cipher types match each other */
     switch (enc_key->tag) {
+    case FOILMSG_ENCRYPT_KEY_FORMAT_AES128_X25519:
+        x25519 = TRUE;
+        /* fallthrough */
     case FOILMSG_ENCRYPT_KEY_FORMAT_AES128:
         block_key_type = FOIL_KEY_AES128;
         break;
+    case FOILMSG_ENCRYPT_KEY_FORMAT_AES192_X25519:
+        x25519 = TRUE;
+        /* fallthrough */
     case FOILMSG_ENCRYPT_KEY_FORMAT_AES192:
         block_key_type = FOIL_KEY_AES192;
         break;
+    case FOILMSG_ENCRYPT_KEY_FORMAT_AES256_X25519:
+        x25519 = TRUE;
+        /* fallthrough */
     case FOILMSG_ENCRYPT_KEY_FORMAT_AES256:
         block_key_type = FOIL_KEY_AES256;
         break;
@@ -336,6 +394,12 @@ foilmsg_decrypt_init_cipher(
     case FOILMSG_ENCRYPT_FORMAT_AES_CTR:
         block_cipher_type = FOIL_CIPHER_AES_CTR_DECRYPT;
         break;
+    case FOILMSG_ENCRYPT_FORMAT_AES_GCM:
+        block_cipher_type = FOIL_CIPHER_AES_GCM_DECRYPT;
+        break;
+    case FOILMSG_ENCRYPT_FORMAT_CHACHA20_POLY1305:
+        block_cipher_type = FOIL_CIPHER_CHACHA20_POLY1305_DECRYPT;
+        break;
     default:
         GDEBUG("Unsupported cipher tag %d", enc_data_tag);
         break;
@@ -343,8 +407,10 @@ foilmsg_decrypt_init_cipher(
 
     /* Decrypt the key and initialize the cipher */
     if (block_key_type && block_cipher_type) {
-        GBytes* key_data = foil_cipher_data(block_key_decrypt_type,
-            FOIL_KEY(recipient), enc_key->data.val, enc_key->data.len);
+        GBytes* key_data = x25519 ?
+            foilmsg_x25519_unwrap_key(recipient, &enc_key->data) :
+            foil_cipher_data(FOIL_CIPHER_RSA_DECRYPT, FOIL_KEY(recipient),
+                enc_key->data.val, enc_key->data.len);
         if (key_data) {
             FoilKey* key = foil_key_new_from_bytes(block_key_type, key_data);
             dec->cipher = foil_cipher_new(block_cipher_type, key);
@@ -363,14 +429,13 @@ FoilMsgInfo*
 foilmsg_parse(
     const FoilBytes* bytes)
 {
-    guint32 len;
     GUtilRange pos;
     pos.ptr = bytes->val;
     pos.end = pos.ptr + bytes->len;
-    if (foil_asn1_parse_start_sequence(&pos, &len)) {
+    if (foil_asn1_parse_sequence(&pos, &pos)) {
+        const guint8* start = pos.ptr;
         gint32 format;
         FoilMsgTaggedData fingerprint;
-        pos.end = pos.ptr + len;
 
         /* formatVersion */
         if (!foil_asn1_parse_int32(&pos, &format)) {
@@ -389,6 +454,8 @@ foilmsg_parse(
                 GDEBUG("Error parsing encryption key");
                 /* encryptedData */
             } else {
+                msg->header.val = start;
+                msg->header.len = pos.ptr - start;
                 if (!foilmsg_decode_tagged_data(&pos, &msg->encrypted)) {
                     GDEBUG("Error parsing encryption data block");
                     /* signature */
@@ -408,6 +475,49 @@ foilmsg_parse(
     return NULL;
 }
 
+static
+gboolean
+foilmsg_decrypt_init_key(
+    FoilMsgDecrypt* dec,
+    const FoilMsgInfo* msg,
+    FoilPrivateKey* recipient,
+    const FoilMsgTaggedData* enc_key)
+{
+    const FoilMsgTaggedData* fp = &msg->sender_fingerprint;
+    if (fp->tag != FOILMSG_FINGERPRINT_SSH_RSA &&
+        fp->tag != FOILMSG_FINGERPRINT_SSH_ED25519) {
+        GDEBUG("Unsuported fingerprint format %d", fp->tag);
+    } else if (!foilmsg_decrypt_init_signature(dec, &msg->signature)) {
+        GDEBUG("Unsupported signature type %d", msg->signature.tag);
+    } else if (!foilmsg_decrypt_init_cipher(dec, recipient, enc_key,
+        msg->encrypted.tag)) {
+        GDEBUG("Error initializing decryption cipher");
+    } else {
+        const guint tag_size = foil_cipher_tag_size(dec->cipher);
+
+        dec->fingerprint_data = fp->data;
+        dec->enc_data = msg->encrypted.data;
+        if (!tag_size) {
+            return TRUE;
+        } else if (dec->enc_data.len < tag_size) {
+            GDEBUG("Encrypted data is too short");
+        } else {
+            /* The authentication tag follows the ciphertext */
+            dec->enc_data.len -= tag_size;
+            dec->tag.val = dec->enc_data.val + dec->enc_data.len;
+            dec->tag.len = tag_size;
+            dec->header = msg->header;
+            if (foil_cipher_add_aad(dec->cipher, dec->header.val,
+                dec->header.len) && foil_cipher_set_tag(dec->cipher,
+                dec->tag.val, dec->tag.len)) {
+                return TRUE;
+            }
+            GDEBUG("Failed to initialize authenticated decryption");
+        }
+    }
+    return FALSE;
+}
+
 static
 gboolean
 foilmsg_decrypt_init(
@@ -419,22 +529,60 @@ foilmsg_decrypt_init(
     gboolean ok = FALSE;
     memset(dec, 0, sizeof(*dec));
     if (msg) {
-        const FoilMsgTaggedData* fp = &msg->sender_fingerprint;
         FoilMsgTaggedData enc_key;
-        if (fp->tag != FOILMSG_FINGERPRINT_FORMAT) {
-            GDEBUG("Unsuported fingerprint format %d", fp->tag);
-        } else if (!foilmsg_decrypt_find_key(msg,
+        if (!foilmsg_decrypt_find_key(msg,
             foil_private_key_fingerprint(recipient), &enc_key)) {
             GDEBUG("Recipient's fingerprint is missing");
-        } else if (!foilmsg_decrypt_init_signature(dec, &msg->signature)) {
-            GDEBUG("Unsupported signature type %d", msg->signature.tag);
-        } else if (!foilmsg_decrypt_init_cipher(dec, recipient, &enc_key,
-            msg->encrypted.tag)) {
-            GDEBUG("Error initializing decryption cipher");
         } else {
-            dec->fingerprint_data = fp->data;
-            dec->enc_data = msg->encrypted.data;
-            ok = TRUE;
+            ok = foilmsg_decrypt_init_key(dec, msg, recipient, &enc_key);
+        }
+        foilmsg_info_free(msg);
+    }
+    return ok;
+}
+
+static
+gboolean
+foilmsg_decrypt_init_keyring(
+    FoilMsgDecrypt* dec,
+    FoilKeyring* keyring,
+    const FoilBytes* bytes)
+{
+    FoilMsgInfo* msg = foilmsg_parse(bytes);
+    gboolean ok = FALSE;
+    memset(dec, 0, sizeof(*dec));
+    if (msg) {
+        gboolean found = FALSE;
+        int i;
+
+        /*
+         * The message is parsed once, each recipient is a hash lookup.
+         * If the key doesn't work, keep trying the other recipients.
+         */
+        for (i=0; i<msg->num_encrypt_keys && !ok; i++) {
+            const FoilMsgEncryptKey* key = msg->encrypt_keys + i;
+            if (foilmsg_recipient_fingerprint_format(key->fingerprint.tag)) {
+                FoilPrivateKey* recipient = foil_keyring_find(keyring,
+                    &key->fingerprint.data);
+                if (recipient) {
+                    FoilMsgTaggedData enc_key;
+
+                    found = TRUE;
+                    enc_key.tag = msg->encrypt_key_format;
+                    enc_key.data = key->data;
+                    ok = foilmsg_decrypt_init_key(dec, msg, recipient,
+                        &enc_key);
+                    foil_private_key_unref(recipient);
+                    if (!ok) {
+                        GDEBUG("Recipient %d didn't work", i);
+                        foil_cipher_unref(dec->cipher);
+                        memset(dec, 0, sizeof(*dec));
+                    }
+                }
+            }
+        }
+        if (!found) {
+            GDEBUG("None of the recipients is in the keyring");
         }
         foilmsg_info_free(msg);
     }
@@ -457,33 +605,144 @@ foilmsg_decrypt_deinit(
  */
 
 static
-char**
+gboolean
+foilmsg_decrypt_parse_header(
+    GUtilRange* seq,
+    FoilBytes* name,
+    FoilBytes* value)
+{
+    return foil_asn1_parse_ia5_string(seq, name) && name->len <= MAX_LEN &&
+        foil_asn1_parse_ia5_string(seq, value) && value->len <= MAX_LEN;
+}
+
+static
+void
+foilmsg_decrypt_parse_headers(
+    FoilMsgHeaders* headers,
+    FoilArena* arena,
+    const void* data,
+    guint32 len)
+{
+    GUtilRange start, pos, seq;
+    FoilBytes name, value;
+    guint n = 0;
+
+    start.ptr = data;
+    start.end = start.ptr + len;
+
+    /* Count the headers, to allocate the array in one go */
+    pos = start;
+    while (foil_asn1_parse_sequence(&pos, &seq)) {
+        if (foilmsg_decrypt_parse_header(&seq, &name, &value)) {
+            n++;
+        }
+    }
+
+    if (n) {
+        FoilMsgHeader* header = foil_arena_new_array(arena, FoilMsgHeader, n);
+
+        headers->header = header;
+        headers->count = n;
+        pos = start;
+        while (foil_asn1_parse_sequence(&pos, &seq)) {
+            if (foilmsg_decrypt_parse_header(&seq, &name, &value)) {
+                header->name = foil_arena_strndup(arena,
+                    (const char*)name.val, name.len);
+                header->value = foil_arena_strndup(arena,
+                    (const char*)value.val, value.len);
+                header++;
+            }
+        }
+    }
+}
+
+static
+void
 foilmsg_decrypt_read_headers(
+    FoilMsgHeaders* headers,
+    FoilArena* arena,
     FoilInput* in,
     guint32 len)
 {
-    FoilInput* headers_in = foil_input_range_new(in, 0, len);
-    GPtrArray* strings = g_ptr_array_new();
-    guint32 header_len;
-    while (foil_asn1_read_sequence_header(headers_in, &header_len) &&
-           foil_input_has_available(headers_in, header_len)) {
-        FoilInput* hdr_in = foil_input_range_new(headers_in, 0, header_len);
-        char* name = foil_asn1_read_ia5_string(hdr_in, MAX_LEN, NULL);
-        char* value = foil_asn1_read_ia5_string(hdr_in, MAX_LEN, NULL);
-        if (name && value) {
-            g_ptr_array_add(strings, name);
-            g_ptr_array_add(strings, value);
-        } else {
+    const void* data = (len <= MAX_LEN) ? foil_input_peek(in, len, NULL) :
+        NULL;
+    if (data) {
+        /* Parse the whole thing in place */
+        foilmsg_decrypt_parse_headers(headers, arena, data, len);
+        foil_input_skip(in, len);
+    } else {
+        /* Unusually large (or truncated) block, read it header by header */
+        GArray* array = g_array_new(FALSE, FALSE, sizeof(FoilMsgHeader));
+        FoilInput* headers_in = foil_input_range_new(in, 0, len);
+        guint32 header_len;
+        while (foil_asn1_read_sequence_header(headers_in, &header_len) &&
+               foil_input_has_available(headers_in, header_len)) {
+            FoilInput* hdr_in = foil_input_range_new(headers_in, 0,
+                header_len);
+            gsize name_len, value_len;
+            char* name = foil_asn1_read_ia5_string(hdr_in, MAX_LEN,
+                &name_len);
+            char* value = foil_asn1_read_ia5_string(hdr_in, MAX_LEN,
+                &value_len);
+            if (name && value) {
+                FoilMsgHeader header;
+
+                header.name = foil_arena_strndup(arena, name, name_len);
+                header.value = foil_arena_strndup(arena, value, value_len);
+                g_array_append_val(array, header);
+            }
             g_free(name);
             g_free(value);
+            foil_input_skip(hdr_in, header_len - foil_input_bytes_read(hdr_in));
+            foil_input_unref(hdr_in);
+        }
+        foil_input_skip(headers_in, len - foil_input_bytes_read(headers_in));
+        foil_input_unref(headers_in);
+        if (array->len) {
+            headers->header = foil_arena_memdup(arena, array->data,
+                sizeof(FoilMsgHeader) * array->len);
+            headers->count = array->len;
+        }
+        g_array_free(array, TRUE);
+    }
+}
+
+/* Reads IA5String straight into the arena */
+static
+const char*
+foilmsg_decrypt_read_string(
+    FoilArena* arena,
+    FoilInput* in)
+{
+    gsize avail = 0;
+
+    /* Tag and up to 5 bytes of length */
+    foil_input_peek(in, 6, &avail);
+    if (avail) {
+        GUtilRange pos;
+        guint32 len;
+        gboolean def;
+
+        pos.ptr = foil_input_peek(in, avail, NULL);
+        pos.end = pos.ptr + avail;
+        if (foil_asn1_is_ia5_string(&pos)) {
+            pos.ptr++;
+            if (foil_asn1_parse_len(&pos, &len, &def) && def &&
+                len <= MAX_LEN) {
+                const void* data;
+
+                foil_input_skip(in, avail - (pos.end - pos.ptr));
+                data = len ? foil_input_peek(in, len, NULL) : "";
+                if (data) {
+                    char* str = foil_arena_strndup(arena, data, len);
+
+                    foil_input_skip(in, len);
+                    return str;
+                }
+            }
         }
-        foil_input_skip(hdr_in, header_len - foil_input_bytes_read(hdr_in));
-        foil_input_unref(hdr_in);
     }
-    foil_input_skip(headers_in, len - foil_input_bytes_read(headers_in));
-    foil_input_unref(headers_in);
-    g_ptr_array_add(strings, NULL);
-    return (char**)g_ptr_array_free(strings, FALSE);
+    return NULL;
 }
 
 /*
@@ -502,14 +761,26 @@ foilmsg_decrypt_run(
     FoilOutput* out)
 {
     FoilMsg* msg = NULL;
+    const gint64 start = foil_stats_active() ? foil_stats_begin() : 0;
+    FoilArena* arena = foil_arena_new(0);
     FoilDigest* digest = foil_digest_new(dec->sig_digest_type);
     FoilInput* enc_in = foil_input_mem_new_bytes(&dec->enc_data);
     FoilInput* dec_in = foil_input_cipher_new(dec->cipher, enc_in);
-    FoilInput* digest_in = foil_input_digest_new(dec_in, digest);
+    FoilInput* digest_in;
     guint32 plain_data_len;
+
+    if (dec->tag.len) {
+        /* The signature covers the header and the tag, not the data */
+        foil_digest_update(digest, dec->header.val, dec->header.len);
+        foil_digest_update(digest, dec->tag.val, dec->tag.len);
+        digest_in = foil_input_ref(dec_in);
+    } else {
+        digest_in = foil_input_digest_new(dec_in, digest);
+    }
     if (foil_asn1_read_sequence_header(digest_in, &plain_data_len)) {
         FoilInput* range = foil_input_range_new(dec_in, 0, plain_data_len);
-        FoilInput* in = foil_input_digest_new(range, digest);
+        FoilInput* in = dec->tag.len ? foil_input_ref(range) :
+            foil_input_digest_new(range, digest);
         gint32 format;
         if (!foil_asn1_read_int32(in, &format)) {
             GDEBUG("Failed to read plain data format");
@@ -517,32 +788,43 @@ foilmsg_decrypt_run(
             GDEBUG("Unexpected plain data format %u", format);
         } else {
             guint32 headers_len, data_len;
-            char* content_type = foil_asn1_read_ia5_string(in, MAX_LEN, NULL);
-            char** headers = NULL;
+            const char* content_type = foilmsg_decrypt_read_string(arena, in);
+            FoilMsgHeaders headers;
+
+            memset(&headers, 0, sizeof(headers));
             if (foil_asn1_read_sequence_header(in, &headers_len)) {
-                headers = foilmsg_decrypt_read_headers(in, headers_len);
+                foilmsg_decrypt_read_headers(&headers, arena, in,
+                    headers_len);
             }
             if (foil_asn1_read_octet_string_header(in, &data_len)) {
-                gssize copied = foil_input_copy(in, out, data_len);
-                if (copied >= 0 && copied == (gssize)data_len) {
-                    msg = foilmsg_alloc(content_type, headers, out, digest,
-                        dec->sig_cipher_type, &dec->fingerprint_data,
+                gssize copied;
+
+                foil_output_reserve(out, data_len);
+                copied = foil_input_copy(in, out, data_len);
+                if (copied >= 0 && copied == (gssize)data_len &&
+                    /* The tag is checked after the last block */
+                    (!dec->tag.len || !foil_input_has_available(enc_in, 1))) {
+                    msg = foilmsg_alloc(arena, content_type, &headers, out,
+                        digest, dec->sig_cipher_type, &dec->fingerprint_data,
                         &dec->sig_data);
-                    /* foilmsg_alloc takes ownership of these */
-                    content_type = NULL;
-                    headers = NULL;
+                    /* foilmsg_alloc takes ownership of the arena */
+                    arena = NULL;
                 }
             }
-            g_free(content_type);
-            g_strfreev(headers);
         }
         foil_input_unref(range);
         foil_input_unref(in);
     }
+    foil_arena_free(arena);
     foil_digest_unref(digest);
     foil_input_unref(digest_in);
     foil_input_unref(dec_in);
     foil_input_unref(enc_in);
+    if (G_UNLIKELY(start) && msg) {
+        foil_stats_end(FOIL_STATS_MSG, GSIZE_TO_POINTER
+            (G_TYPE_FROM_INSTANCE(dec->cipher)), foil_cipher_name
+            (dec->cipher), "decrypt", dec->enc_data.len, start);
+    }
     return msg;
 }
 
@@ -566,6 +848,26 @@ foilmsg_decrypt(
     return msg;
 }
 
+FoilMsg*
+foilmsg_decrypt_with_keyring(
+    FoilKeyring* keyring,
+    const FoilBytes* bytes,
+    FoilOutput* out) /* Since 1.0.31 */
+{
+    FoilMsg* msg = NULL;
+    if (G_LIKELY(keyring) && G_LIKELY(bytes)) {
+        FoilMsgDecrypt dec;
+        /* Writing to memory by default */
+        out = out ? foil_output_ref(out) : foil_output_mem_new(NULL);
+        if (foilmsg_decrypt_init_keyring(&dec, keyring, bytes)) {
+            msg = foilmsg_decrypt_run(&dec, out);
+            foilmsg_decrypt_deinit(&dec);
+        }
+        foil_output_unref(out);
+    }
+    return msg;
+}
+
 FoilMsg*
 foilmsg_decrypt_file(
     FoilPrivateKey* recipient,
@@ -687,14 +989,24 @@ foilmsg_verify(
         GBytes* fp = foil_key_fingerprint(sender);
         if (G_LIKELY(fp) && g_bytes_equal(fp, msg->fingerprint)) {
             FoilMsgPriv* priv = foilmsg_priv_cast(msg);
-            gsize digest_size = g_bytes_get_size(priv->sig_digest);
-            const void* digest_bytes = g_bytes_get_data(priv->sig_digest,
-                &digest_size);
-            GBytes* digest2 = foil_cipher_bytes(priv->sig_cipher_type,
-                sender, priv->sig);
+            const gsize digest_size = priv->sig_digest.len;
+            GBytes* digest2;
+
+            if (!priv->sig_cipher_type) {
+                /* Ed25519 signature of the digest */
+                const gboolean ok = foil_ed25519_verify(priv->sig_digest.val,
+                    digest_size, &priv->sig, sender);
+                if (!ok) {
+                    GDEBUG("Signature verification failed");
+                }
+                return ok;
+            }
+            digest2 = foil_cipher_data(priv->sig_cipher_type,
+                sender, priv->sig.val, priv->sig.len);
             if (digest2 && g_bytes_get_size(digest2) >= digest_size) {
                 const void* digest2_bytes = g_bytes_get_data(digest2, NULL);
-                gboolean ok = !memcmp(digest2_bytes, digest_bytes, digest_size);
+                gboolean ok = !memcmp(digest2_bytes, priv->sig_digest.val,
+                    digest_size);
                 if (!ok) {
                     GDEBUG("Signature verification failed");
                 }
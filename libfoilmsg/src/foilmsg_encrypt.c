@@ -31,11 +31,18 @@
  */
 
 #include "foilmsg_p.h"
+#include <foil_arena.h>
+#include <foil_kdf.h>
+#include <foil_keywrap.h>
 #include <foil_output.h>
 #include <foil_random.h>
+#include <foil_stats.h>
 #include <foil_util.h>
 #include <gutil_log.h>
 
+/* Large enough for any authentication tag */
+#define FOILMSG_MAX_TAG_SIZE (16)
+
 /* Text prefix for BASE64 encoded foilmsg blob */
 const FoilBytes foilmsg_prefix = {
     (const void*)FOILMSG_PREFIX,
@@ -44,48 +51,38 @@ const FoilBytes foilmsg_prefix = {
 
 /* SEQUENCE { tag INTEGER data OCTET STRING } */
 static
-gboolean
-foilmsg_encode_tagged_bytes(
-    FoilOutput* out,
+gsize
+foilmsg_tagged_data_length(
     int tag,
-    const FoilBytes* bytes)
+    gsize data_len)
 {
-    gsize tag_len;
-    GBytes* tag_bytes = foil_asn1_encode_integer_value(tag);
-    const void* tag_data = g_bytes_get_data(tag_bytes, &tag_len);
-    gsize data_size = foil_asn1_block_length(bytes->len);
-    gboolean ok = foil_asn1_encode_sequence_header(out, tag_len + data_size) &&
-        foil_output_write_all(out, tag_data, tag_len) &&
-        foil_asn1_encode_octet_string(out, bytes);
-    g_bytes_unref(tag_bytes);
-    return ok;
+    return foil_asn1_block_length(foil_asn1_integer_length(tag) +
+        foil_asn1_block_length(data_len));
 }
 
 static
 gboolean
-foilmsg_encode_tagged_data(
+foilmsg_encode_tagged_bytes(
     FoilOutput* out,
     int tag,
-    GBytes* data)
+    const FoilBytes* bytes)
 {
-    FoilBytes bytes;
-    bytes.val = g_bytes_get_data(data, &bytes.len);
-    return foilmsg_encode_tagged_bytes(out, tag, &bytes);
+    return foil_asn1_encode_sequence_header(out,
+        foil_asn1_integer_length(tag) + foil_asn1_block_length(bytes->len)) &&
+        foil_asn1_encode_integer(out, tag) &&
+        foil_asn1_encode_octet_string(out, bytes);
 }
 
 static
 gboolean
-foilmsg_encode_unref_tagged_data(
+foilmsg_encode_tagged_data(
     FoilOutput* out,
     int tag,
     GBytes* data)
 {
-    gboolean ok;
     FoilBytes bytes;
     bytes.val = g_bytes_get_data(data, &bytes.len);
-    ok = foilmsg_encode_tagged_bytes(out, tag, &bytes);
-    g_bytes_unref(data);
-    return ok;
+    return foilmsg_encode_tagged_bytes(out, tag, &bytes);
 }
 
 /* Part 1 - format version */
@@ -98,18 +95,108 @@ foilmsg_encode_part1(
 }
 
 /* Part 2 - fingerprint  */
+static
+int
+foilmsg_sender_fingerprint_format(
+    FoilPrivateKey* sender)
+{
+    return FOIL_IS_KEY_ED25519_PRIVATE(sender) ?
+        FOILMSG_FINGERPRINT_SSH_ED25519 : FOILMSG_FINGERPRINT_FORMAT;
+}
+
 static
 void
 foilmsg_encode_part2(
     FoilOutput* out,
     FoilPrivateKey* sender)
 {
-    foilmsg_encode_tagged_data(out, FOILMSG_FINGERPRINT_FORMAT,
+    foilmsg_encode_tagged_data(out, foilmsg_sender_fingerprint_format(sender),
         foil_private_key_fingerprint(sender));
 }
 
 /* Part 3 - encrypted keys  */
 
+FoilKey*
+foilmsg_x25519_kek(
+    GBytes* secret,
+    const guint8* eph_pub,
+    const guint8* pub)
+{
+    static const char info_prefix[] = "FOILMSG X25519";
+    const gsize prefix_len = sizeof(info_prefix) - 1;
+    guint8 info_buf[sizeof(info_prefix) - 1 + 2 * FOIL_X25519_KEY_SIZE];
+    FoilKey* kek = NULL;
+    FoilBytes ikm, info;
+    GBytes* okm;
+
+    memcpy(info_buf, info_prefix, prefix_len);
+    memcpy(info_buf + prefix_len, eph_pub, FOIL_X25519_KEY_SIZE);
+    memcpy(info_buf + prefix_len + FOIL_X25519_KEY_SIZE, pub,
+        FOIL_X25519_KEY_SIZE);
+    info.val = info_buf;
+    info.len = sizeof(info_buf);
+
+    /* AES-256 key (32 bytes) followed by the IV which isn't used */
+    okm = foil_kdf_hkdf(FOIL_DIGEST_SHA256, foil_bytes_from_data(&ikm,
+        secret), NULL, &info, 32 + 16);
+    if (okm) {
+        kek = foil_key_new_from_bytes(FOIL_KEY_AES256, okm);
+        g_bytes_unref(okm);
+    }
+    return kek;
+}
+
+/*
+ * encryptedKey for an X25519 recipient is the ephemeral public key
+ * followed by the wrapped AES key. A new ephemeral key is generated
+ * for each recipient.
+ */
+static
+GBytes*
+foilmsg_x25519_wrap_key(
+    FoilKey* pubkey,
+    GBytes* key)
+{
+    GBytes* enc = NULL;
+    FoilKey* eph = foil_key_generate_new(FOIL_KEY_X25519_PRIVATE,
+        FOIL_KEY_BITS_DEFAULT);
+
+    if (eph) {
+        GBytes* secret = foil_x25519_derive(FOIL_PRIVATE_KEY(eph), pubkey);
+
+        if (secret) {
+            GBytes* eph_pub = foil_x25519_public_bytes(eph);
+            GBytes* pub = foil_x25519_public_bytes(pubkey);
+            FoilKey* kek = foilmsg_x25519_kek(secret,
+                g_bytes_get_data(eph_pub, NULL), g_bytes_get_data(pub, NULL));
+
+            if (kek) {
+                FoilBytes data;
+                GBytes* wrapped = foil_keywrap_wrap(kek,
+                    foil_bytes_from_data(&data, key));
+
+                if (wrapped) {
+                    GByteArray* buf = g_byte_array_sized_new
+                        (FOIL_X25519_KEY_SIZE + g_bytes_get_size(wrapped));
+
+                    g_byte_array_append(buf, g_bytes_get_data(eph_pub,
+                        NULL), FOIL_X25519_KEY_SIZE);
+                    g_byte_array_append(buf, g_bytes_get_data(wrapped,
+                        NULL), g_bytes_get_size(wrapped));
+                    enc = g_byte_array_free_to_bytes(buf);
+                    g_bytes_unref(wrapped);
+                }
+                foil_key_unref(kek);
+            }
+            g_bytes_unref(pub);
+            g_bytes_unref(eph_pub);
+            g_bytes_unref(secret);
+        }
+        foil_key_unref(eph);
+    }
+    return enc;
+}
+
 /*
  * EncryptedKey ::= SEQUENCE {
  *     fingerprint     TaggedData,
@@ -124,65 +211,211 @@ foilmsg_encode_encrypt_key(
     GBytes* key)
 {
     gsize res = 0;
+    const gboolean x25519 = FOIL_IS_KEY_X25519_PUBLIC(pubkey);
+    const int fp_tag = x25519 ? FOILMSG_FINGERPRINT_X25519 :
+        FOILMSG_FINGERPRINT_FORMAT;
     /* encryptedKey */
-    GBytes* enc = foil_cipher_bytes(FOIL_CIPHER_RSA_ENCRYPT, pubkey, key);
+    GBytes* enc = x25519 ? foilmsg_x25519_wrap_key(pubkey, key) :
+        foil_cipher_bytes(FOIL_CIPHER_RSA_ENCRYPT, pubkey, key);
     if (enc) {
-        GBytes* tmp_bytes;
-        FoilBytes part[2];
-        const FoilBytes* bytes[G_N_ELEMENTS(part)];
-        FoilOutput* tmp = foil_output_mem_new(NULL);
-
-        /* fingerprint  */
-        foilmsg_encode_tagged_data(tmp, FOILMSG_FINGERPRINT_FORMAT,
-            foil_key_fingerprint(pubkey));
+        GBytes* fp = foil_key_fingerprint(pubkey);
+        const gsize seq_len =
+            foilmsg_tagged_data_length(fp_tag, g_bytes_get_size(fp)) +
+            foil_asn1_block_length(g_bytes_get_size(enc));
+        FoilBytes enc_bytes;
 
         /* Pack fingerprint and encryptedKey into a SEQUENCE */
-        foil_asn1_encode_octet_string_header(tmp, g_bytes_get_size(enc));
-        tmp_bytes = foil_output_free_to_bytes(tmp);
-        bytes[0] = foil_bytes_from_data(part + 0, tmp_bytes);
-        bytes[1] = foil_bytes_from_data(part + 1, enc);
-        res = foil_asn1_encode_sequence(out, bytes, G_N_ELEMENTS(bytes));
-
-        g_bytes_unref(tmp_bytes);
+        if (foil_asn1_encode_sequence_header(out, seq_len) &&
+            foilmsg_encode_tagged_data(out, fp_tag, fp) &&
+            foil_asn1_encode_octet_string(out,
+                foil_bytes_from_data(&enc_bytes, enc))) {
+            res = foil_asn1_block_length(seq_len);
+        }
         g_bytes_unref(enc);
     }
     return res;
 }
 
+/*
+ * Wrapping the key for a large number of recipients is spread across
+ * the libfoil thread pool. Public key RSA operations are relatively
+ * cheap, so it only pays off if there are enough of them.
+ */
+#define FOILMSG_PARALLEL_MIN_KEYS (8)
+
+typedef struct foilmsg_encrypt_key_job {
+    FoilKey* pubkey;
+    GBytes* key;
+    GBytes* result;
+} FoilMsgEncryptKeyJob;
+
+static
+void
+foilmsg_encrypt_key_job_run(
+    guint index,
+    gpointer user_data)
+{
+    FoilMsgEncryptKeyJob* job = (FoilMsgEncryptKeyJob*)user_data + index;
+    FoilOutput* out = foil_output_mem_new(NULL);
+
+    if (foilmsg_encode_encrypt_key(out, job->pubkey, job->key)) {
+        job->result = foil_output_free_to_bytes(out);
+    } else {
+        foil_output_unref(out);
+    }
+}
+
+/* Fails if any key couldn't be wrapped */
+static
+gboolean
+foilmsg_encode_keys_parallel(
+    FoilOutput* out,
+    GPtrArray* pubkeys,
+    GBytes* key)
+{
+    const guint n = pubkeys->len;
+    FoilMsgEncryptKeyJob* jobs = g_new0(FoilMsgEncryptKeyJob, n);
+    gboolean ok = TRUE;
+    guint i;
+
+    for (i = 0; i < n; i++) {
+        FoilMsgEncryptKeyJob* job = jobs + i;
+
+        job->pubkey = pubkeys->pdata[i];
+        job->key = key;
+    }
+    foil_parallel_run(n, foilmsg_encrypt_key_job_run, jobs);
+
+    /* Output the results in the original order */
+    for (i = 0; i < n; i++) {
+        GBytes* result = jobs[i].result;
+
+        if (result) {
+            ok = ok && foil_output_write_bytes_all(out, result);
+            g_bytes_unref(result);
+        } else {
+            GWARN("Failed to encrypt the key for recipient %u", i);
+            ok = FALSE;
+        }
+    }
+    g_free(jobs);
+    return ok;
+}
+
 /*
  * EncryptedKeys ::= SEQUENCE {
  *     keyFormat       INTEGER
  *     keys            SEQUENCE OF EncryptedKey,
  * }
+ *
+ * Returns NULL if the key couldn't be encrypted for every recipient.
  */
-static
-void
+GBytes*
 foilmsg_encode_part3(
-    FoilOutput* out,
     GPtrArray* pubkeys,
-    GBytes* key,
+    FoilKey* key,
     int key_tag)
 {
-    guint i;
-    FoilBytes part[2];
-    const FoilBytes* bytes[G_N_ELEMENTS(part)];
-    FoilOutput* keys_out = foil_output_mem_new(NULL);
-    GBytes* keys;
-    /* keyFormat */
-    GBytes* key_format = foil_asn1_encode_integer_value(key_tag);
+    GByteArray* keys = g_byte_array_new();
+    FoilOutput* keys_out = foil_output_mem_new(keys);
+    GBytes* key_bytes = foil_key_to_bytes(key);
+    gboolean ok = TRUE;
+    GByteArray* buf;
+    FoilOutput* out;
+    gsize seq_len;
+
     /* keys */
-    for (i=0; i<pubkeys->len; i++) {
-        GVERIFY(foilmsg_encode_encrypt_key(keys_out, pubkeys->pdata[i], key));
+    if (pubkeys->len >= FOILMSG_PARALLEL_MIN_KEYS) {
+        ok = foilmsg_encode_keys_parallel(keys_out, pubkeys, key_bytes);
+    } else {
+        guint i;
+
+        for (i=0; i<pubkeys->len && ok; i++) {
+            if (!foilmsg_encode_encrypt_key(keys_out, pubkeys->pdata[i],
+                key_bytes)) {
+                GWARN("Failed to encrypt the key for recipient %u", i);
+                ok = FALSE;
+            }
+        }
+    }
+    foil_output_unref(keys_out);
+    g_bytes_unref(key_bytes);
+    if (!ok) {
+        /* Don't leave anyone out */
+        g_byte_array_unref(keys);
+        return NULL;
+    }
+
+    /* foilmsg_encrypt_pubkeys makes sure that key types aren't mixed */
+    if (pubkeys->len && FOIL_IS_KEY_X25519_PUBLIC(pubkeys->pdata[0])) {
+        key_tag += FOILMSG_X25519_KEY_FORMAT_OFFSET;
     }
-    keys = foil_output_free_to_bytes(keys_out);
 
     /* Pack keyFormat and keys into a SEQUENCE */
-    bytes[0] = foil_bytes_from_data(part + 0, key_format);
-    bytes[1] = foil_bytes_from_data(part + 1, keys);
-    foil_asn1_encode_sequence(out, bytes, G_N_ELEMENTS(bytes));
+    seq_len = foil_asn1_integer_length(key_tag) + keys->len;
+    buf = g_byte_array_sized_new(foil_asn1_block_length(seq_len));
+    out = foil_output_mem_new(buf);
+    foil_asn1_encode_sequence_header(out, seq_len);
+    foil_asn1_encode_integer(out, key_tag); /* keyFormat */
+    foil_output_write(out, keys->data, keys->len);
+    foil_output_unref(out);
+    g_byte_array_unref(keys);
+
+    GASSERT(buf->len == foil_asn1_block_length(seq_len));
+    return g_byte_array_free_to_bytes(buf);
+}
+
+/*
+ * Collects public keys which the AES key gets encrypted with. Returns
+ * an empty array if any recipient is missing or if RSA and X25519 keys
+ * are mixed.
+ */
+GPtrArray*
+foilmsg_encrypt_pubkeys(
+    FoilPrivateKey* sender,
+    FoilKey* const* recipients,
+    guint count,
+    const FoilMsgEncryptOptions* opt)
+{
+    GPtrArray* pubkeys = g_ptr_array_new_full(count + 1, g_object_unref);
+    guint i;
+
+    for (i = 0; i < count; i++) {
+        if (G_UNLIKELY(!recipients[i])) {
+            GWARN("Recipient %u is missing", i);
+            g_ptr_array_set_size(pubkeys, 0);
+            return pubkeys;
+        }
+        g_ptr_array_add(pubkeys, foil_key_ref(recipients[i]));
+    }
+    if (opt && (opt->flags & FOILMSG_FLAG_ENCRYPT_FOR_SELF) &&
+        FOIL_IS_KEY_RSA_PRIVATE(sender)) {
+        FoilKey* pub = foil_public_key_new_from_private(sender);
+        gboolean duplicate = FALSE;
+
+        for (i = 0; i < count && !duplicate; i++) {
+            duplicate = foil_key_equal(pub, recipients[i]);
+        }
+        if (duplicate) {
+            GDEBUG("Not adding duplicate sender's public key");
+            foil_key_unref(pub);
+        } else {
+            g_ptr_array_add(pubkeys, pub);
+        }
+    }
+    if (pubkeys->len) {
+        const gboolean x25519 = FOIL_IS_KEY_X25519_PUBLIC(pubkeys->pdata[0]);
 
-    g_bytes_unref(key_format);
-    g_bytes_unref(keys);
+        /* All keys must be wrapped the same way */
+        for (i = 1; i < pubkeys->len; i++) {
+            if (FOIL_IS_KEY_X25519_PUBLIC(pubkeys->pdata[i]) != x25519) {
+                GWARN("Can't mix RSA and X25519 recipients");
+                g_ptr_array_set_size(pubkeys, 0);
+                break;
+            }
+        }
+    }
+    return pubkeys;
 }
 
 /* Part 4 - AES encrypted data */
@@ -194,31 +427,46 @@ foilmsg_encode_part3(
  * }
  * Headers ::= SEQUENCE OF Header
  */
+static
+gsize
+foilmsg_header_length(
+    const FoilMsgHeader* header)
+{
+    return foil_asn1_block_length(strlen(header->name)) +
+        foil_asn1_block_length(strlen(header->value));
+}
+
+static
+gsize
+foilmsg_headers_length(
+    const FoilMsgHeaders* headers)
+{
+    gsize total = 0;
+    guint i;
+
+    for (i=0; i<headers->count; i++) {
+        total += foil_asn1_block_length(foilmsg_header_length
+            (headers->header + i));
+    }
+    return total;
+}
+
 static
 void
 foilmsg_encode_headers(
     FoilOutput* out,
-    const FoilMsgHeaders* headers)
+    const FoilMsgHeaders* headers,
+    gsize total)
 {
-    if (headers) {
-        gsize* size = g_new(gsize, headers->count);
-        gsize total = 0;
-        guint i;
-
-        for (i=0; i<headers->count; i++) {
-            total += foil_asn1_block_length(size[i] =
-                foil_asn1_block_length(strlen(headers->header[i].name)) +
-                foil_asn1_block_length(strlen(headers->header[i].value)));
-        }
+    guint i;
 
-        foil_asn1_encode_sequence_header(out, total);
-        for (i=0; i<headers->count; i++) {
-            foil_asn1_encode_sequence_header(out, size[i]);
-            foil_asn1_encode_ia5_string(out, headers->header[i].name);
-            foil_asn1_encode_ia5_string(out, headers->header[i].value);
-        }
+    foil_asn1_encode_sequence_header(out, total);
+    for (i=0; i<headers->count; i++) {
+        const FoilMsgHeader* header = headers->header + i;
 
-        g_free(size);
+        foil_asn1_encode_sequence_header(out, foilmsg_header_length(header));
+        foil_asn1_encode_ia5_string(out, header->name);
+        foil_asn1_encode_ia5_string(out, header->value);
     }
 }
 
@@ -229,7 +477,61 @@ foilmsg_encode_headers(
  *     headers SEQUENCE OF Header OPTIONAL,
  *     data OCTET STRING
  * }
+ *
+ * Everything preceding the data itself is small, it's encoded into
+ * an exactly sized buffer allocated from the arena, which then gets
+ * encrypted together with the data. Returns the length of the whole
+ * PlainData block.
  */
+static
+gsize
+foilmsg_encode_plain_header(
+    FoilArena* arena,
+    FoilBytes* plain_header,
+    const FoilBytes* data,
+    const char* content_type,
+    const FoilMsgHeaders* headers)
+{
+    const gsize headers_len = headers ? foilmsg_headers_length(headers) : 0;
+    const gsize plain_len = foil_asn1_integer_length(FOILMSG_PLAIN_DATA_FORMAT)
+        + (content_type ? foil_asn1_block_length(strlen(content_type)) : 0)
+        + (headers ? foil_asn1_block_length(headers_len) : 0)
+        + foil_asn1_block_length(data->len);
+    const gsize total_len = foil_asn1_block_length(plain_len);
+    FoilOutput* out = foil_output_arena_new(arena, plain_header);
+
+    foil_output_reserve(out, total_len - data->len);
+    foil_asn1_encode_sequence_header(out, plain_len);
+    foil_asn1_encode_integer(out, FOILMSG_PLAIN_DATA_FORMAT);
+    foil_asn1_encode_ia5_string(out, content_type);
+    if (headers) {
+        foilmsg_encode_headers(out, headers, headers_len);
+    }
+    foil_asn1_encode_octet_string_header(out, data->len);
+    foil_output_unref(out);
+
+    GASSERT(plain_header->len + data->len == total_len);
+    return total_len;
+}
+
+/*
+ * We assume that the data size is preserved, just rounded up to
+ * the nearest block boundary. Authenticated encryption doesn't pad
+ * the data but appends the tag to it.
+ */
+static
+gsize
+foilmsg_encrypted_length(
+    FoilCipher* cipher,
+    gsize plain_len)
+{
+    const int block_size = foil_cipher_output_block_size(cipher);
+    const guint tag_size = foil_cipher_tag_size(cipher);
+
+    GASSERT(block_size == foil_cipher_input_block_size(cipher));
+    return tag_size ? (plain_len + tag_size) :
+        ((plain_len + block_size - 1) / block_size * block_size);
+}
 
 static
 gboolean
@@ -237,89 +539,109 @@ foilmsg_encode_part4(
     FoilOutput* out,
     FoilCipher* cipher,
     int tag,
+    const FoilBytes* plain_header,
     const FoilBytes* data,
-    const char* content_type,
-    const FoilMsgHeaders* headers,
+    gsize enc_len,
+    FoilDigest* digest)
+{
+    FoilBytes blocks[2];
+
+    blocks[0] = *plain_header;
+    blocks[1] = *data;
+    if (foil_asn1_encode_sequence_header(out,
+        foil_asn1_integer_length(tag) + foil_asn1_block_length(enc_len)) &&
+        foil_asn1_encode_integer(out, tag) &&
+        foil_asn1_encode_octet_string_header(out, enc_len)) {
+        const guint tag_size = foil_cipher_tag_size(cipher);
+
+        if (tag_size) {
+            /*
+             * The ciphertext is followed by the authentication tag.
+             * The signature covers the tag rather than the plain data.
+             */
+            guint8 auth_tag[FOILMSG_MAX_TAG_SIZE];
+
+            GASSERT(tag_size <= sizeof(auth_tag));
+            return foil_cipher_write_data_blocks(cipher, blocks,
+                G_N_ELEMENTS(blocks), out, NULL) &&
+                foil_cipher_get_tag(cipher, auth_tag, tag_size) &&
+                foil_output_write_all(out, auth_tag, tag_size) &&
+                foil_digest_update(digest, auth_tag, tag_size);
+        } else {
+            return foil_cipher_write_data_blocks(cipher, blocks,
+                G_N_ELEMENTS(blocks), out, digest);
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Part 5 - Signature of part 4
+ *
+ * The digest followed by the same number of random bytes, encrypted
+ * with the sender's private key. RSA turns each input block (including
+ * the last partial one) into exactly one output block.
+ */
+static
+gsize
+foilmsg_signature_length(
+    FoilCipher* rsa,
     FoilDigest* digest)
+{
+    const gsize len = 2 * foil_digest_size(digest);
+    const int in = foil_cipher_input_block_size(rsa);
+    const int out = foil_cipher_output_block_size(rsa);
+
+    return (len + in - 1) / in * out;
+}
+
+static
+gboolean
+foilmsg_encode_part5(
+    FoilOutput* out,
+    FoilArena* arena,
+    FoilCipher* rsa,
+    GBytes* digest,
+    int tag,
+    gsize sig_len)
 {
     gboolean ok;
-    const int block_size = foil_cipher_output_block_size(cipher);
-    FoilOutput* prefix_out = foil_output_mem_new(NULL);
-    FoilOutput* out0 = foil_output_mem_new(NULL);
-    FoilOutput* out1 = foil_output_mem_new(NULL);
-    GBytes* prefix_bytes;
-    GBytes* bytes0;
-    GBytes* bytes1;
-    FoilBytes prefix_data;
-    FoilBytes blocks[3];
-    gsize total_len = 0;
-
-    /* First elements of plain text sequence (except the actual data) */
-    foil_asn1_encode_integer(out1, FOILMSG_PLAIN_DATA_FORMAT);
-    foil_asn1_encode_ia5_string(out1, content_type);
-    foilmsg_encode_headers(out1, headers);
-    foil_asn1_encode_octet_string_header(out1, data->len);
-
-    /* No we can calculate the length of the whole plain data sequence */
-    bytes1 = foil_output_free_to_bytes(out1);
-    blocks[1].val = g_bytes_get_data(bytes1, &blocks[1].len);
-    total_len += blocks[1].len;
-
-    /* Encode the sequence header */
-    foil_asn1_encode_sequence_header(out0, blocks[1].len + data->len);
-    bytes0 = foil_output_free_to_bytes(out0);
-    blocks[0].val = g_bytes_get_data(bytes0, &blocks[0].len);
-    total_len += blocks[0].len;
-
-    /*
-     * We assume that the data size is preserved, just rounded up to
-     * the nearest block boundary.
-     */
-    blocks[2] = *data;
-    total_len += blocks[2].len;
-    total_len = (total_len + block_size - 1) / block_size * block_size;
-    GASSERT(block_size == foil_cipher_input_block_size(cipher));
+    gsize len;
+    const void* data = g_bytes_get_data(digest, &len);
+    guint8* buf = foil_arena_alloc(arena, 2*len);
 
-    /* Add the cipher tag + octet string header */
-    foil_asn1_encode_integer(prefix_out, tag);
-    foil_asn1_encode_octet_string_header(prefix_out, total_len);
-    prefix_bytes = foil_output_free_to_bytes(prefix_out);
-    prefix_data.val = g_bytes_get_data(prefix_bytes, &prefix_data.len);
-    total_len += prefix_data.len;
-
-    /* Put the whole thing together and encrypt it. */
-    ok = foil_asn1_encode_sequence_header(out, total_len) &&
-        foil_output_write_all(out, prefix_data.val, prefix_data.len) &&
-        foil_cipher_write_data_blocks(cipher, blocks, G_N_ELEMENTS(blocks),
-            out, digest);
-
-    g_bytes_unref(bytes0);
-    g_bytes_unref(bytes1);
-    g_bytes_unref(prefix_bytes);
+    memcpy(buf, data, len);
+    foil_random(buf + len, len);
+    ok = foil_asn1_encode_sequence_header(out,
+        foil_asn1_integer_length(tag) + foil_asn1_block_length(sig_len)) &&
+        foil_asn1_encode_integer(out, tag) &&
+        foil_asn1_encode_octet_string_header(out, sig_len) &&
+        foil_cipher_write_data(rsa, buf, 2*len, out, NULL);
     return ok;
 }
 
-/* Part 5 - Signature of part 4 */
+/* Ed25519 signature of the digest, always the same size */
 static
-void
-foilmsg_encode_part5(
+gboolean
+foilmsg_encode_part5_ed25519(
     FoilOutput* out,
     FoilPrivateKey* sender,
     GBytes* digest,
     int tag)
 {
+    gboolean ok = FALSE;
     gsize len;
     const void* data = g_bytes_get_data(digest, &len);
-    GByteArray* buf = g_byte_array_sized_new(2*len);
-    g_byte_array_set_size(buf, 2*len);
-    memcpy(buf->data, data, len);
-    foil_random(buf->data + len, len);
-    foilmsg_encode_unref_tagged_data(out, tag, foil_cipher_data
-        (FOIL_CIPHER_RSA_ENCRYPT, FOIL_KEY(sender), buf->data, buf->len));
-    g_byte_array_free(buf, TRUE);
+    GBytes* sig = foil_ed25519_sign(data, len, sender);
+
+    if (sig) {
+        ok = g_bytes_get_size(sig) == FOIL_ED25519_SIGNATURE_SIZE &&
+            foilmsg_encode_tagged_data(out, tag, sig);
+        g_bytes_unref(sig);
+    }
+    return ok;
 }
 
-static
 FoilKey*
 foilmsg_encrypt_generate_key(
     const FoilMsgEncryptOptions* opt,
@@ -364,14 +686,24 @@ foilmsg_encrypt_cipher(
         type = FOIL_CIPHER_AES_CTR_ENCRYPT;
         *tag = FOILMSG_ENCRYPT_FORMAT_AES_CTR;
         break;
+    case FOILMSG_CIPHER_AES_GCM:
+        type = FOIL_CIPHER_AES_GCM_ENCRYPT;
+        *tag = FOILMSG_ENCRYPT_FORMAT_AES_GCM;
+        break;
+    case FOILMSG_CIPHER_CHACHA20_POLY1305:
+        type = FOIL_CIPHER_CHACHA20_POLY1305_ENCRYPT;
+        *tag = FOILMSG_ENCRYPT_FORMAT_CHACHA20_POLY1305;
+        break;
     }
     return foil_cipher_new(type, key);
 }
 
+/* Returns NULL if the signature doesn't match the sender's key type */
 static
 FoilDigest*
 foilmsg_encrypt_signature_digest(
     const FoilMsgEncryptOptions* opt,
+    gboolean ed25519,
     int* tag)
 {
     GType type = 0; /* Will remain zero if we miss all the cases */
@@ -392,6 +724,28 @@ foilmsg_encrypt_signature_digest(
         type = FOIL_DIGEST_SHA512;
         *tag = FOILMSG_SIGNATURE_FORMAT_SHA512_RSA;
         break;
+    case FOILMSG_SIGNATURE_SHA256_ED25519:
+        type = FOIL_DIGEST_SHA256;
+        *tag = FOILMSG_SIGNATURE_FORMAT_SHA256_ED25519;
+        break;
+    case FOILMSG_SIGNATURE_SHA512_ED25519:
+        type = FOIL_DIGEST_SHA512;
+        *tag = FOILMSG_SIGNATURE_FORMAT_SHA512_ED25519;
+        break;
+    case FOILMSG_SIGNATURE_BLAKE3_RSA:
+        type = FOIL_DIGEST_BLAKE3;
+        *tag = FOILMSG_SIGNATURE_FORMAT_BLAKE3_RSA;
+        break;
+    case FOILMSG_SIGNATURE_BLAKE3_ED25519:
+        type = FOIL_DIGEST_BLAKE3;
+        *tag = FOILMSG_SIGNATURE_FORMAT_BLAKE3_ED25519;
+        break;
+    }
+    if ((*tag == FOILMSG_SIGNATURE_FORMAT_SHA256_ED25519 ||
+        *tag == FOILMSG_SIGNATURE_FORMAT_SHA512_ED25519 ||
+        *tag == FOILMSG_SIGNATURE_FORMAT_BLAKE3_ED25519) != ed25519) {
+        GDEBUG("Signature %d doesn't match the sender's key", *tag);
+        return NULL;
     }
     return foil_digest_new(type);
 }
@@ -410,113 +764,240 @@ foilmsg_encrypt_defaults(
     return opt;
 }
 
-/* Encrypt to the binary format */
-gsize
-foilmsg_encrypt(
+/*
+ * Parts 1 to 3. Authenticated encryption uses them as additional
+ * authenticated data, and they are signed together with the tag.
+ */
+static
+gboolean
+foilmsg_encode_header(
     FoilOutput* out,
+    FoilArena* arena,
+    FoilCipher* cipher,
+    FoilDigest* digest,
+    FoilPrivateKey* sender,
+    GBytes* bytes3)
+{
+    if (foil_cipher_tag_size(cipher)) {
+        FoilBytes header[2];
+        FoilOutput* tmp = foil_output_arena_new(arena, header);
+        guint i;
+
+        /* Part 1 - format version */
+        foilmsg_encode_part1(tmp);
+        /* Part 2 - fingerprint */
+        foilmsg_encode_part2(tmp, sender);
+        foil_output_unref(tmp);
+        /* Part 3 - encrypted keys */
+        foil_bytes_from_data(header + 1, bytes3);
+        for (i = 0; i < G_N_ELEMENTS(header); i++) {
+            if (!foil_output_write_all(out, header[i].val, header[i].len) ||
+                !foil_cipher_add_aad(cipher, header[i].val, header[i].len) ||
+                !foil_digest_update(digest, header[i].val, header[i].len)) {
+                return FALSE;
+            }
+        }
+        return TRUE;
+    } else {
+        /* Part 1 - format version */
+        foilmsg_encode_part1(out);
+        /* Part 2 - fingerprint */
+        foilmsg_encode_part2(out, sender);
+        /* Part 3 - encrypted keys */
+        return foil_output_write_bytes_all(out, bytes3);
+    }
+}
+
+/*
+ * Encrypts the data with the AES key which has already been encrypted
+ * with the public keys, the result of that is passed in as part3.
+ *
+ * The length of each part is known in advance, so the whole message
+ * is written to the output in one pass without intermediate buffers.
+ * Unless tmp is given, in which case the message is written there
+ * first and copied to the output only if the whole thing succeeds.
+ */
+gsize
+foilmsg_encrypt_with_key(
+    FoilOutput* dest,
     const FoilBytes* data,
     const char* ctype,
     const FoilMsgHeaders* hdrs,
     FoilPrivateKey* sender,
-    FoilKey* recipient,
+    FoilKey* key,
+    GBytes* bytes3,
     const FoilMsgEncryptOptions* opt,
-    FoilOutput* part4)
+    FoilOutput* tmp)
 {
     gboolean ok = FALSE;
-    gsize prev_written = foil_output_bytes_written(out);
-    gboolean for_self = opt && (opt->flags & FOILMSG_FLAG_ENCRYPT_FOR_SELF);
-    int ktag = 0, ctag = 0, stag = 0;
-    FoilKey* key = foilmsg_encrypt_generate_key(opt, &ktag);
+    gsize dest_written = 0;
+    FoilOutput* out = tmp ? foil_output_ref(tmp) : dest;
+    const gint64 start = foil_stats_active() ? foil_stats_begin() : 0;
+    int ctag = 0, stag = 0;
+    const gboolean ed25519 = FOIL_IS_KEY_ED25519_PRIVATE(sender);
     FoilCipher* cipher = foilmsg_encrypt_cipher(opt, key, &ctag);
-    FoilDigest* md = foilmsg_encrypt_signature_digest(opt, &stag);
-    if (G_LIKELY(cipher) && G_LIKELY(out) && G_LIKELY(data) && G_LIKELY(md) &&
-        G_LIKELY(sender) && G_LIKELY(recipient || for_self)) {
-        GBytes* key_bytes = foil_key_to_bytes(key);
-
-        /* part4 could be large and may point to a temporary file */
-        if (part4) {
-            foil_output_ref(part4);
-            foil_output_reset(part4);
+    FoilDigest* md = foilmsg_encrypt_signature_digest(opt, ed25519, &stag);
+    FoilCipher* rsa = (sender && !ed25519) ?
+        foil_cipher_new(FOIL_CIPHER_RSA_ENCRYPT, FOIL_KEY(sender)) : NULL;
+    if (tmp) {
+        foil_output_reset(tmp);
+    }
+    if (G_LIKELY(cipher) && G_LIKELY(dest) && G_LIKELY(data) &&
+        G_LIKELY(md) && G_LIKELY(rsa || ed25519) && G_LIKELY(bytes3)) {
+        const gsize prev_written = foil_output_bytes_written(out);
+        /* Per-message temporaries */
+        FoilArena* arena = foil_arena_new(0);
+        FoilBytes plain_header;
+        const gsize enc_len = foilmsg_encrypted_length(cipher,
+            foilmsg_encode_plain_header(arena, &plain_header, data, ctype,
+                hdrs));
+        const gsize sig_len = ed25519 ? FOIL_ED25519_SIGNATURE_SIZE :
+            foilmsg_signature_length(rsa, md);
+        const gsize len1 = foil_asn1_integer_length(FOILMSG_FORMAT_VERSION);
+        const gsize len2 = foilmsg_tagged_data_length
+            (foilmsg_sender_fingerprint_format(sender), g_bytes_get_size
+                (foil_private_key_fingerprint(sender)));
+        const gsize len3 = g_bytes_get_size(bytes3);
+        const gsize len4 = foilmsg_tagged_data_length(ctag, enc_len);
+        const gsize len5 = foilmsg_tagged_data_length(stag, sig_len);
+        const gsize total = len1 + len2 + len3 + len4 + len5;
+
+        dest_written = foil_output_bytes_written(dest);
+
+        /* Let the output preallocate the space if it can */
+        foil_output_reserve(out, foil_asn1_block_length(total));
+
+        /* Write the whole thing as an ASN.1 sequence */
+        if (foil_asn1_encode_sequence_header(out, total) &&
+            /* Parts 1 to 3 - format, fingerprint and encrypted keys */
+            foilmsg_encode_header(out, arena, cipher, md, sender, bytes3) &&
+            /* Part 4 - AES encrypted text */
+            foilmsg_encode_part4(out, cipher, ctag, &plain_header, data,
+                enc_len, md)) {
+            /* Part 5 - Signature of part 4 (or parts 1-3 and the tag) */
+            GBytes* digest_bytes = foil_digest_finish(md);
+
+            ok = (ed25519 ?
+                foilmsg_encode_part5_ed25519(out, sender, digest_bytes,
+                    stag) :
+                foilmsg_encode_part5(out, arena, rsa, digest_bytes,
+                    stag, sig_len)) && (foil_output_bytes_written(out) -
+                prev_written) == foil_asn1_block_length(total);
+        }
+        foil_arena_free(arena);
+    }
+    if (tmp) {
+        /* Copy the message to the actual output if it's complete */
+        if (ok) {
+            GBytes* bytes = foil_output_free_to_bytes(out);
+
+            ok = bytes && foil_output_write_bytes_all(dest, bytes);
+            g_bytes_unref(bytes);
         } else {
-            part4 = foil_output_mem_new(NULL);
+            foil_output_unref(out);
         }
+    }
+    if (G_UNLIKELY(start) && ok) {
+        foil_stats_end(FOIL_STATS_MSG, GSIZE_TO_POINTER
+            (G_TYPE_FROM_INSTANCE(cipher)), foil_cipher_name(cipher),
+            "encrypt", data->len, start);
+    }
+    foil_cipher_unref(cipher);
+    foil_cipher_unref(rsa);
+    foil_digest_unref(md);
+    return ok ? (foil_output_bytes_written(dest) - dest_written) : 0;
+}
 
-        /* Part 4 - AES encrypted text */
-        if (foilmsg_encode_part4(part4, cipher, ctag, data, ctype, hdrs, md)) {
-            GBytes* bytes4 = foil_output_free_to_bytes(part4);
-            if (bytes4) {
-                gsize total = 0;
-                GBytes* digest_bytes = foil_digest_finish(md);
-                FoilOutput* part1 = foil_output_mem_new(NULL);
-                FoilOutput* part2 = foil_output_mem_new(NULL);
-                FoilOutput* part3 = foil_output_mem_new(NULL);
-                FoilOutput* part5 = foil_output_mem_new(NULL);
-                GPtrArray* pubkeys = g_ptr_array_new_full(2, g_object_unref);
-                GBytes* bytes1;
-                GBytes* bytes2;
-                GBytes* bytes3;
-                GBytes* bytes5;
-                const void* data[5];
-                gsize len[5];
-
-                /* Collect public keys */
-                if (recipient) {
-                    g_ptr_array_add(pubkeys, foil_key_ref(recipient));
-                }
-                if (for_self) {
-                    FoilKey* pub = foil_public_key_new_from_private(sender);
-                    if (foil_key_equal(pub, recipient)) {
-                        GDEBUG("Not adding duplicate sender's public key");
-                        foil_key_unref(pub);
-                    } else {
-                        g_ptr_array_add(pubkeys, pub);
-                    }
-                }
+static
+gsize
+foilmsg_encrypt_full(
+    FoilOutput* out,
+    const FoilBytes* data,
+    const char* ctype,
+    const FoilMsgHeaders* hdrs,
+    FoilPrivateKey* sender,
+    FoilKey* const* recipients,
+    guint count,
+    const FoilMsgEncryptOptions* opt,
+    FoilOutput* tmp)
+{
+    gsize written = 0;
+    gboolean for_self = opt && (opt->flags & FOILMSG_FLAG_ENCRYPT_FOR_SELF);
+    if (G_LIKELY(out) && G_LIKELY(data) && G_LIKELY(sender) &&
+        G_LIKELY(count || for_self) && G_LIKELY(recipients || !count)) {
+        int ktag = 0;
+        FoilKey* key = foilmsg_encrypt_generate_key(opt, &ktag);
+        if (G_LIKELY(key)) {
+            GPtrArray* pubkeys = foilmsg_encrypt_pubkeys(sender, recipients,
+                count, opt);
 
-                /* Part 1 - format version */
-                foilmsg_encode_part1(part1);
-                /* Part 2 - fingerprint */
-                foilmsg_encode_part2(part2, sender);
+            /* Nobody would be able to decrypt a message without keys */
+            if (pubkeys->len) {
                 /* Part 3 - encrypted keys */
-                foilmsg_encode_part3(part3, pubkeys, key_bytes, ktag);
-                /* Part 5 - Signature of part 4 */
-                foilmsg_encode_part5(part5, sender, digest_bytes, stag);
-
-                bytes1 = foil_output_free_to_bytes(part1);
-                bytes2 = foil_output_free_to_bytes(part2);
-                bytes3 = foil_output_free_to_bytes(part3);
-                bytes5 = foil_output_free_to_bytes(part5);
-
-                data[0] = g_bytes_get_data(bytes1, len);
-                data[1] = g_bytes_get_data(bytes2, len + 1);
-                data[2] = g_bytes_get_data(bytes3, len + 2);
-                data[3] = g_bytes_get_data(bytes4, len + 3);
-                data[4] = g_bytes_get_data(bytes5, len + 4);
-
-                /* Combine the whole thing into an ASN.1 sequence */
-                total = len[0] + len[1] + len[2] + len[3] + len[4];
-                ok = foil_asn1_encode_sequence_header(out, total) &&
-                    foil_output_write_all(out, data[0], len[0]) &&
-                    foil_output_write_all(out, data[1], len[1]) &&
-                    foil_output_write_all(out, data[2], len[2]) &&
-                    foil_output_write_all(out, data[3], len[3]) &&
-                    foil_output_write_all(out, data[4], len[4]);
-
-                g_bytes_unref(bytes1);
-                g_bytes_unref(bytes2);
-                g_bytes_unref(bytes3);
-                g_bytes_unref(bytes4);
-                g_bytes_unref(bytes5);
-                g_ptr_array_free(pubkeys, TRUE);
+                GBytes* bytes3 = foilmsg_encode_part3(pubkeys, key, ktag);
+
+                if (bytes3) {
+                    written = foilmsg_encrypt_with_key(out, data, ctype,
+                        hdrs, sender, key, bytes3, opt, tmp);
+                    g_bytes_unref(bytes3);
+                }
             }
+            g_ptr_array_free(pubkeys, TRUE);
+            foil_key_unref(key);
         }
+    }
+    return written;
+}
+
+/* Encrypt to the binary format */
+gsize
+foilmsg_encrypt(
+    FoilOutput* out,
+    const FoilBytes* data,
+    const char* ctype,
+    const FoilMsgHeaders* hdrs,
+    FoilPrivateKey* sender,
+    FoilKey* recipient,
+    const FoilMsgEncryptOptions* opt,
+    FoilOutput* tmp)
+{
+    return foilmsg_encrypt_full(out, data, ctype, hdrs, sender, &recipient,
+        recipient ? 1 : 0, opt, tmp);
+}
+
+gsize
+foilmsg_encrypt_multi(
+    FoilOutput* out,
+    const FoilBytes* data,
+    const char* ctype,
+    const FoilMsgHeaders* hdrs,
+    FoilPrivateKey* sender,
+    FoilKey* const* recipients,
+    guint count,
+    const FoilMsgEncryptOptions* opt) /* Since 1.0.31 */
+{
+    return foilmsg_encrypt_full(out, data, ctype, hdrs, sender, recipients,
+        count, opt, NULL);
+}
 
-        g_bytes_unref(key_bytes);
+GBytes*
+foilmsg_encrypt_multi_to_bytes(
+    const FoilBytes* data,
+    const char* type,
+    const FoilMsgHeaders* headers,
+    FoilPrivateKey* from,
+    FoilKey* const* to,
+    guint count,
+    const FoilMsgEncryptOptions* opt) /* Since 1.0.31 */
+{
+    FoilOutput* out = foil_output_mem_new(NULL);
+    if (foilmsg_encrypt_multi(out, data, type, headers, from, to, count,
+        opt)) {
+        return foil_output_free_to_bytes(out);
+    } else {
+        foil_output_unref(out);
+        return NULL;
     }
-    foil_cipher_unref(cipher);
-    foil_digest_unref(md);
-    foil_key_unref(key);
-    return ok ? (foil_output_bytes_written(out) - prev_written) : 0;
 }
 
 GString*
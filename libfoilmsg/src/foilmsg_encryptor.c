@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "foilmsg_p.h"
+#include <foil_output.h>
+#include <gutil_log.h>
+
+/*
+ * Generating the AES key and encrypting it with each recipient's public
+ * key costs an RSA operation per recipient. FoilMsgEncryptor does that
+ * ahead of time on a background thread, keeping up to depth prepared
+ * keys in the queue. Each prepared key is handed out exactly once.
+ */
+
+#define FOILMSG_ENCRYPTOR_DEFAULT_DEPTH (4)
+
+/* Pause after the background thread fails to prepare a key */
+#define FOILMSG_ENCRYPTOR_RETRY_DELAY (G_TIME_SPAN_SECOND)
+
+typedef struct foilmsg_encryptor_key {
+    FoilKey* key;
+    GBytes* encrypted_keys;
+} FoilMsgEncryptorKey;
+
+struct foilmsg_encryptor {
+    FoilPrivateKey* sender;
+    FoilMsgEncryptOptions opt;
+    GPtrArray* pubkeys;
+    guint depth;
+    GThread* thread;
+    GMutex mutex;
+    GCond cond;
+    GQueue queue;
+    gboolean stop;
+};
+
+static
+FoilMsgEncryptorKey*
+foilmsg_encryptor_key_new(
+    FoilMsgEncryptor* self)
+{
+    int tag = 0;
+    FoilKey* key = foilmsg_encrypt_generate_key(&self->opt, &tag);
+
+    if (key) {
+        GBytes* encrypted_keys = foilmsg_encode_part3(self->pubkeys,
+            key, tag);
+
+        if (encrypted_keys) {
+            FoilMsgEncryptorKey* prepared = g_slice_new(FoilMsgEncryptorKey);
+
+            prepared->key = key;
+            prepared->encrypted_keys = encrypted_keys;
+            return prepared;
+        }
+        foil_key_unref(key);
+    }
+    return NULL;
+}
+
+static
+void
+foilmsg_encryptor_key_free(
+    gpointer data)
+{
+    FoilMsgEncryptorKey* prepared = data;
+
+    foil_key_unref(prepared->key);
+    g_bytes_unref(prepared->encrypted_keys);
+    g_slice_free(FoilMsgEncryptorKey, prepared);
+}
+
+static
+gpointer
+foilmsg_encryptor_thread(
+    gpointer data)
+{
+    FoilMsgEncryptor* self = data;
+
+    g_mutex_lock(&self->mutex);
+    while (!self->stop) {
+        if (self->queue.length < self->depth) {
+            FoilMsgEncryptorKey* prepared;
+
+            g_mutex_unlock(&self->mutex);
+            prepared = foilmsg_encryptor_key_new(self);
+            g_mutex_lock(&self->mutex);
+            if (prepared) {
+                g_queue_push_tail(&self->queue, prepared);
+            } else {
+                /*
+                 * Meanwhile the encrypting thread prepares its own keys.
+                 * Don't give up on the first failure though, take a break
+                 * and try again.
+                 */
+                GWARN("Failed to prepare a message key");
+                if (!self->stop) {
+                    g_cond_wait_until(&self->cond, &self->mutex,
+                        g_get_monotonic_time() +
+                        FOILMSG_ENCRYPTOR_RETRY_DELAY);
+                }
+            }
+        } else {
+            g_cond_wait(&self->cond, &self->mutex);
+        }
+    }
+    g_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+static
+FoilMsgEncryptorKey*
+foilmsg_encryptor_take_key(
+    FoilMsgEncryptor* self)
+{
+    FoilMsgEncryptorKey* prepared;
+
+    g_mutex_lock(&self->mutex);
+    prepared = g_queue_pop_head(&self->queue);
+    g_cond_signal(&self->cond);
+    g_mutex_unlock(&self->mutex);
+
+    /* If the background thread hasn't caught up, do it synchronously */
+    return prepared ? prepared : foilmsg_encryptor_key_new(self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+FoilMsgEncryptor*
+foilmsg_encryptor_new(
+    FoilPrivateKey* sender,
+    FoilKey* recipient,
+    const FoilMsgEncryptOptions* opt,
+    guint depth) /* Since 1.0.31 */
+{
+    const gboolean for_self = opt &&
+        (opt->flags & FOILMSG_FLAG_ENCRYPT_FOR_SELF);
+
+    if (G_LIKELY(sender) && G_LIKELY(recipient || for_self)) {
+        GPtrArray* pubkeys = foilmsg_encrypt_pubkeys(sender, &recipient,
+            recipient ? 1 : 0, opt);
+
+        /* Ed25519 sender can't be a recipient */
+        if (pubkeys->len) {
+            FoilMsgEncryptor* self = g_slice_new0(FoilMsgEncryptor);
+            GError* error = NULL;
+
+            self->sender = foil_private_key_ref(sender);
+            if (opt) {
+                self->opt = *opt;
+            } else {
+                foilmsg_encrypt_defaults(&self->opt);
+            }
+            self->pubkeys = pubkeys;
+            self->depth = depth ? depth : FOILMSG_ENCRYPTOR_DEFAULT_DEPTH;
+            g_mutex_init(&self->mutex);
+            g_cond_init(&self->cond);
+            g_queue_init(&self->queue);
+            self->thread = g_thread_try_new("foilmsg-encryptor",
+                foilmsg_encryptor_thread, self, &error);
+            if (!self->thread) {
+                /* Still usable, just without the head start */
+                GWARN("Failed to start encryptor thread: %s",
+                    GERRMSG(error));
+                g_error_free(error);
+            }
+            return self;
+        }
+        g_ptr_array_free(pubkeys, TRUE);
+    }
+    return NULL;
+}
+
+void
+foilmsg_encryptor_free(
+    FoilMsgEncryptor* self) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self)) {
+        if (self->thread) {
+            g_mutex_lock(&self->mutex);
+            self->stop = TRUE;
+            g_cond_signal(&self->cond);
+            g_mutex_unlock(&self->mutex);
+            g_thread_join(self->thread);
+        }
+        g_queue_foreach(&self->queue, (GFunc) foilmsg_encryptor_key_free,
+            NULL);
+        g_queue_clear(&self->queue);
+        g_ptr_array_free(self->pubkeys, TRUE);
+        foil_private_key_unref(self->sender);
+        g_cond_clear(&self->cond);
+        g_mutex_clear(&self->mutex);
+        g_slice_free(FoilMsgEncryptor, self);
+    }
+}
+
+gsize
+foilmsg_encryptor_encrypt(
+    FoilMsgEncryptor* self,
+    FoilOutput* out,
+    const FoilBytes* data,
+    const char* content_type,
+    const FoilMsgHeaders* headers) /* Since 1.0.31 */
+{
+    gsize written = 0;
+
+    if (G_LIKELY(self) && G_LIKELY(out) && G_LIKELY(data)) {
+        FoilMsgEncryptorKey* prepared = foilmsg_encryptor_take_key(self);
+
+        if (G_LIKELY(prepared)) {
+            written = foilmsg_encrypt_with_key(out, data, content_type,
+                headers, self->sender, prepared->key,
+                prepared->encrypted_keys, &self->opt, NULL);
+            foilmsg_encryptor_key_free(prepared);
+        }
+    }
+    return written;
+}
+
+GBytes*
+foilmsg_encryptor_encrypt_to_bytes(
+    FoilMsgEncryptor* self,
+    const FoilBytes* data,
+    const char* content_type,
+    const FoilMsgHeaders* headers) /* Since 1.0.31 */
+{
+    if (G_LIKELY(self) && G_LIKELY(data)) {
+        FoilOutput* out = foil_output_mem_new(NULL);
+
+        if (foilmsg_encryptor_encrypt(self, out, data, content_type,
+            headers)) {
+            return foil_output_free_to_bytes(out);
+        }
+        foil_output_unref(out);
+    }
+    return NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
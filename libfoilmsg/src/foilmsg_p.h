@@ -39,6 +39,8 @@
 #include <foil_digest.h>
 #include <foil_cipher.h>
 #include <foil_key.h>
+#include <foil_key_ed25519.h>
+#include <foil_key_x25519.h>
 #include <foil_private_key.h>
 #include <foil_sign.h>
 
@@ -49,6 +51,53 @@
 #define FOILMSG_PREFIX                   "FOILMSG"
 #define FOILMSG_PREFIX_LENGTH             (7)
 
+#define FOILMSG_INTERNAL G_GNUC_INTERNAL
+
+#define FOILMSG_X25519_KEY_FORMAT_OFFSET \
+    (FOILMSG_ENCRYPT_KEY_FORMAT_AES128_X25519 - \
+     FOILMSG_ENCRYPT_KEY_FORMAT_AES128)
+
+FoilKey*
+foilmsg_x25519_kek(
+    GBytes* secret,
+    const guint8* eph_pub,
+    const guint8* pub)
+    FOILMSG_INTERNAL;
+
+FoilKey*
+foilmsg_encrypt_generate_key(
+    const FoilMsgEncryptOptions* opt,
+    int* tag)
+    FOILMSG_INTERNAL;
+
+GPtrArray*
+foilmsg_encrypt_pubkeys(
+    FoilPrivateKey* sender,
+    FoilKey* const* recipients,
+    guint count,
+    const FoilMsgEncryptOptions* opt)
+    FOILMSG_INTERNAL;
+
+GBytes*
+foilmsg_encode_part3(
+    GPtrArray* pubkeys,
+    FoilKey* key,
+    int key_tag)
+    FOILMSG_INTERNAL;
+
+gsize
+foilmsg_encrypt_with_key(
+    FoilOutput* out,
+    const FoilBytes* data,
+    const char* content_type,
+    const FoilMsgHeaders* headers,
+    FoilPrivateKey* sender,
+    FoilKey* key,
+    GBytes* encrypted_keys,
+    const FoilMsgEncryptOptions* opt,
+    FoilOutput* tmp)
+    FOILMSG_INTERNAL;
+
 #endif /* FOILMSG_P_H */
 
 /*
@@ -120,6 +120,8 @@ test_output_mem_new(
 {
     static const FoilOutputFunc test_output_mem_fn = {
         test_output_mem_write,      /* fn_write */
+        NULL,                       /* fn_writev */
+        NULL,                       /* fn_reserve */
         test_output_mem_flush,      /* fn_flush */
         test_output_mem_reset,      /* fn_reset */
         test_output_mem_to_bytes,   /* fn_to_bytes */
@@ -33,6 +33,7 @@
 #include "test_common.h"
 
 #include "foil_util_p.h"
+#include "foil_arena.h"
 #include "foil_asn1.h"
 #include "foil_digest.h"
 #include "foil_input.h"
@@ -170,6 +171,36 @@ test_random(
     g_bytes_unref(bytes2);
 }
 
+static
+void
+test_random_buffered(
+    void)
+{
+    static const guint sizes[] = { 1, 16, 47, 1023, 1024, 1025, 5000 };
+    guint8 buf1[5000 + 1];
+    guint8 buf2[sizeof(buf1)];
+    guint i;
+
+    g_assert(!foil_random_set_default(FOIL_DIGEST_MD5));
+    g_assert(foil_random_set_default(FOIL_RANDOM_BUFFERED));
+    for (i = 0; i < G_N_ELEMENTS(sizes); i++) {
+        const guint len = sizes[i];
+
+        memset(buf1, 0, sizeof(buf1));
+        memset(buf2, 0, sizeof(buf2));
+        g_assert(foil_random_generate(FOIL_RANDOM_BUFFERED, buf1, len));
+        g_assert(foil_random(buf2, len));
+        if (len >= 16) {
+            g_assert(memcmp(buf1, buf2, len));
+        }
+        /* Nothing is written past the end */
+        g_assert(!buf1[len]);
+        g_assert(!buf2[len]);
+    }
+    g_assert(foil_random_set_default(0));
+    g_assert(foil_random(buf1, sizeof(buf1)));
+}
+
 static
 void
 test_skip(
@@ -424,6 +455,125 @@ test_pool(
     g_assert(n2 == 1);
 }
 
+static
+void
+test_parallel_cb(
+    guint index,
+    gpointer data)
+{
+    g_atomic_int_inc((gint*)data + index);
+}
+
+static
+void
+test_parallel(
+    void)
+{
+    gint counts[100];
+    guint i;
+
+    memset(counts, 0, sizeof(counts));
+    foil_parallel_run(0, test_parallel_cb, counts);  /* No effect */
+    foil_parallel_run(G_N_ELEMENTS(counts), NULL, counts); /* No effect */
+    foil_parallel_run(G_N_ELEMENTS(counts), test_parallel_cb, counts);
+
+    /* Each index is visited exactly once */
+    for (i = 0; i < G_N_ELEMENTS(counts); i++) {
+        g_assert_cmpint(counts[i], == ,1);
+    }
+}
+
+static
+void
+test_arena(
+    void)
+{
+    static const char str[] = "test";
+    FoilArena* arena = foil_arena_new(64);
+    FoilBytes src, copy;
+    guint8* block;
+    guint8* large;
+    guint8* p;
+    char* s;
+    int n = 0;
+
+    /* NULL resistance */
+    foil_arena_free(NULL);
+    foil_arena_reset(NULL);
+    foil_arena_add(NULL, &n, test_pool_cb);
+    foil_arena_add(arena, &n, NULL);
+    g_assert(!foil_arena_alloc(NULL, 1));
+    g_assert(!foil_arena_alloc0(NULL, 1));
+    g_assert(!foil_arena_realloc(NULL, NULL, 0, 1));
+    g_assert(!foil_arena_memdup(NULL, str, 1));
+    g_assert(!foil_arena_memdup(arena, NULL, 1));
+    g_assert(!foil_arena_strdup(arena, NULL));
+    g_assert(!foil_arena_strndup(NULL, str, 1));
+    g_assert(!foil_arena_copy_bytes(arena, NULL, &src));
+    g_assert(!foil_arena_copy_bytes(arena, &copy, NULL));
+
+    /* Blocks are aligned */
+    block = foil_arena_alloc(arena, 1);
+    p = foil_arena_alloc0(arena, 3);
+    g_assert(!(GPOINTER_TO_SIZE(block) % (2 * sizeof(gpointer))));
+    g_assert(!(GPOINTER_TO_SIZE(p) % (2 * sizeof(gpointer))));
+    g_assert(p > block);
+    g_assert(!p[0] && !p[1] && !p[2]);
+
+    /* The most recent block is resized in place */
+    g_assert(foil_arena_realloc(arena, p, 3, 16) == p);
+    g_assert(foil_arena_realloc(arena, p, 16, 1) == p);
+    /* The other one is not */
+    block[0] = 1;
+    p = foil_arena_realloc(arena, block, 1, 8);
+    g_assert(p != block);
+    g_assert(p[0] == 1);
+    g_assert(foil_arena_realloc(arena, block, 1, 1) == block);
+    g_assert(foil_arena_realloc(arena, NULL, 0, 1));
+
+    /* Large blocks get a chunk of their own */
+    large = foil_arena_alloc(arena, 1000);
+    memset(large, 0xff, 1000);
+    p = foil_arena_alloc(arena, 1);
+    g_assert(foil_arena_realloc(arena, p, 1, 2) == p);
+
+    /* Strings */
+    s = foil_arena_strdup(arena, str);
+    g_assert_cmpstr(s, == ,str);
+    s = foil_arena_strndup(arena, str, 2);
+    g_assert_cmpstr(s, == ,"te");
+    src.val = (const void*)str;
+    src.len = sizeof(str);
+    g_assert(foil_arena_copy_bytes(arena, &copy, &src) == &copy);
+    g_assert(foil_bytes_equal(&copy, &src));
+    g_assert(copy.val != src.val);
+    src.len = 0;
+    g_assert(foil_arena_copy_bytes(arena, &copy, &src) == &copy);
+    g_assert(!copy.val);
+    g_assert(!copy.len);
+
+    /* Overflow the first chunk */
+    for (n = 0; n < 100; n++) {
+        memset(foil_arena_alloc(arena, 10), n, 10);
+    }
+
+    /* Destroy callbacks */
+    n = 0;
+    foil_arena_add(arena, &n, test_pool_cb);
+    foil_arena_reset(arena);
+    g_assert_cmpint(n, == ,1);
+    foil_arena_add(arena, &n, test_pool_cb);
+    g_assert(foil_arena_alloc(arena, 1));
+    foil_arena_free(arena);
+    g_assert_cmpint(n, == ,2);
+
+    /* Default chunk size */
+    arena = foil_arena_new(0);
+    g_assert(foil_arena_new0(arena, FoilBytes));
+    g_assert(foil_arena_new_array(arena, FoilBytes, 10));
+    foil_arena_free(arena);
+}
+
 static
 void
 test_asn1_len(
@@ -1139,6 +1289,8 @@ test_asn1_integer(
             enc2 = foil_output_free_to_bytes(out);
             TEST_DEBUG_HEXDUMP_BYTES(enc1);
             g_assert(gutil_bytes_equal(enc1, subtest->data, subtest->len));
+            g_assert_cmpuint(foil_asn1_integer_length(subtest->value), ==,
+                subtest->len);
             TEST_DEBUG_HEXDUMP_BYTES(enc2);
             g_assert(gutil_bytes_equal(enc2, subtest->data, subtest->len));
             g_bytes_unref(enc1);
@@ -1203,8 +1355,11 @@ test_asn1_tag(
         guint8 id = 0;
         guint tag = 0;
 
+        /* Peeking doesn't move the position */
         pos.ptr = data->val;
         pos.end = pos.ptr + data->len;
+        g_assert(foil_asn1_peek_tag(&pos, NULL, NULL) == ok);
+        g_assert(pos.ptr == data->val);
         g_assert(foil_asn1_parse_tag(&pos, NULL, NULL) == ok);
 
         pos.ptr = data->val;
@@ -1222,6 +1377,67 @@ test_asn1_tag(
     }
 }
 
+static
+void
+test_asn1_cursor(
+    void)
+{
+    static const guint8 data [] = {
+        0x30, 0x06,             /* SEQUENCE */
+        0x02, 0x01, 0x05,       /*   INTEGER 5 */
+        0x04, 0x01, 0xaa,       /*   OCTET STRING aa */
+        0x05, 0x00              /* NULL */
+    };
+    static const guint8 short_seq [] = { 0x30, 0x03, 0x02, 0x01 };
+    static const guint8 indefinite [] = { 0x30, 0x80, 0x00, 0x00 };
+
+    GUtilRange pos, seq;
+    FoilBytes bytes;
+    gint32 value;
+    guint8 id;
+
+    POS_SET(pos, data);
+    g_assert(foil_asn1_peek_tag(&pos, &id, NULL));
+    g_assert_cmpuint(id, == ,0x30);
+    g_assert(foil_asn1_parse_sequence(&pos, &seq));
+    g_assert(seq.ptr == data + 2);
+    g_assert(seq.end == data + 8);
+    g_assert(pos.ptr == seq.end);
+    g_assert(pos.end == data + sizeof(data));
+    g_assert(foil_asn1_parse_int32(&seq, &value));
+    g_assert_cmpint(value, == ,5);
+    g_assert(foil_asn1_parse_octet_string(&seq, &bytes));
+    g_assert(bytes.val == data + 7);
+    g_assert_cmpuint(bytes.len, == ,1);
+    g_assert(seq.ptr == seq.end);
+    g_assert(!foil_asn1_parse_sequence(&pos, NULL));
+    g_assert(foil_asn1_parse_skip(&pos));
+    g_assert(pos.ptr == pos.end);
+    g_assert(!foil_asn1_parse_skip(&pos));
+    g_assert(!foil_asn1_peek_tag(&pos, NULL, NULL));
+
+    /* Parsing into the same range */
+    POS_SET(pos, data);
+    g_assert(foil_asn1_parse_sequence(&pos, &pos));
+    g_assert(pos.ptr == data + 2);
+    g_assert(pos.end == data + 8);
+
+    /* Skipping the whole sequence */
+    POS_SET(pos, data);
+    g_assert(foil_asn1_parse_skip(&pos));
+    g_assert(pos.ptr == data + 8);
+
+    /* Broken data doesn't move the position */
+    POS_SET(pos, short_seq);
+    g_assert(!foil_asn1_parse_sequence(&pos, &seq));
+    g_assert(!foil_asn1_parse_skip(&pos));
+    g_assert(pos.ptr == short_seq);
+    POS_SET(pos, indefinite);
+    g_assert(!foil_asn1_parse_sequence(&pos, &seq));
+    g_assert(!foil_asn1_parse_skip(&pos));
+    g_assert(pos.ptr == indefinite);
+}
+
 #define TEST_(name) "/basic/" name
 
 int main(int argc, char* argv[])
@@ -1229,12 +1445,15 @@ int main(int argc, char* argv[])
     g_test_init(&argc, &argv, NULL);
     g_test_add_func(TEST_("bytes"), test_bytes);
     g_test_add_func(TEST_("random"), test_random);
+    g_test_add_func(TEST_("random_buffered"), test_random_buffered);
     g_test_add_func(TEST_("skip"), test_skip);
     g_test_add_func(TEST_("format_header"), test_format_header);
     g_test_add_func(TEST_("parse_headers"), test_parse_headers);
     g_test_add_func(TEST_("base64"), test_base64);
     g_test_add_func(TEST_("memmem"), test_memmem);
     g_test_add_func(TEST_("pool"), test_pool);
+    g_test_add_func(TEST_("parallel"), test_parallel);
+    g_test_add_func(TEST_("arena"), test_arena);
     g_test_add_func(TEST_("asn1/Len"), test_asn1_len);
     g_test_add_func(TEST_("asn1/Seq"), test_asn1_seq);
     g_test_add_func(TEST_("asn1/BitString"), test_asn1_bit_string);
@@ -1243,6 +1462,7 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("asn1/IA5String"), test_asn1_ia5_string);
     g_test_add_func(TEST_("asn1/Integer"), test_asn1_integer);
     g_test_add_func(TEST_("asn1/Tag"), test_asn1_tag);
+    g_test_add_func(TEST_("asn1/Cursor"), test_asn1_cursor);
     return test_run();
 }
 
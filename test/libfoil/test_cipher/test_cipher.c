@@ -31,6 +31,26 @@
 
 #include "foil_key.h"
 #include "foil_cipher.h"
+#include "foil_output.h"
+
+static const guint8 test_data[32] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+static
+GBytes*
+test_cipher_data(
+    FoilCipher* cipher)
+{
+    FoilOutput* out = foil_output_mem_new(NULL);
+
+    g_assert(foil_cipher_write_data(cipher, TEST_ARRAY_AND_SIZE(test_data),
+        out, NULL));
+    return foil_output_free_to_bytes(out);
+}
 
 static
 void
@@ -52,6 +72,13 @@ test_cipher_null(
     g_assert(!foil_cipher_new(0, NULL));
     g_assert(!foil_cipher_new(0, key));
     g_assert(!foil_cipher_clone(NULL));
+    g_assert(!foil_cipher_rekey(NULL, NULL));
+    g_assert(!foil_cipher_rekey(NULL, key));
+    g_assert(!foil_cipher_rekey(enc, NULL));
+    g_assert(!foil_cipher_reset(NULL));
+    g_assert(!foil_cipher_pool_get(0, NULL));
+    g_assert(!foil_cipher_pool_get(0, key));
+    foil_cipher_pool_put(NULL);
     g_assert(!foil_cipher_ref(NULL));
     g_assert(!foil_cipher_key(NULL));
     g_assert(!foil_cipher_name(NULL));
@@ -76,12 +103,117 @@ test_cipher_null(
     foil_cipher_unref(dec);
 }
 
+static
+void
+test_cipher_rekey(
+    void)
+{
+    FoilKey* key1 = foil_key_generate_new(FOIL_KEY_AES128, 0);
+    FoilKey* key2 = foil_key_generate_new(FOIL_KEY_AES256, 0);
+    FoilKey* des = foil_key_generate_new(FOIL_KEY_DES, 0);
+    FoilCipher* cipher = foil_cipher_new(FOIL_CIPHER_AES_CBC_ENCRYPT, key1);
+    GBytes* out1 = foil_cipher_data(FOIL_CIPHER_AES_CBC_ENCRYPT, key1,
+        TEST_ARRAY_AND_SIZE(test_data));
+    GBytes* out2 = foil_cipher_data(FOIL_CIPHER_AES_CBC_ENCRYPT, key2,
+        TEST_ARRAY_AND_SIZE(test_data));
+    GBytes* out;
+
+    /* Reset restores the IV */
+    out = test_cipher_data(cipher);
+    g_assert(g_bytes_equal(out, out1));
+    g_bytes_unref(out);
+    g_assert(foil_cipher_reset(cipher));
+    g_assert(foil_cipher_key(cipher) == key1);
+    out = test_cipher_data(cipher);
+    g_assert(g_bytes_equal(out, out1));
+    g_bytes_unref(out);
+
+    /* Switch to another key, of a different size */
+    g_assert(foil_cipher_rekey(cipher, key2));
+    g_assert(foil_cipher_key(cipher) == key2);
+    out = test_cipher_data(cipher);
+    g_assert(g_bytes_equal(out, out2));
+    g_bytes_unref(out);
+
+    /* Unsupported key leaves the cipher alone */
+    g_assert(!foil_cipher_rekey(cipher, des));
+    g_assert(foil_cipher_key(cipher) == key2);
+
+    /* And back */
+    g_assert(foil_cipher_rekey(cipher, key1));
+    out = test_cipher_data(cipher);
+    g_assert(g_bytes_equal(out, out1));
+    g_bytes_unref(out);
+
+    foil_cipher_unref(cipher);
+    g_bytes_unref(out1);
+    g_bytes_unref(out2);
+    foil_key_unref(key1);
+    foil_key_unref(key2);
+    foil_key_unref(des);
+}
+
+static
+void
+test_cipher_pool(
+    void)
+{
+    const GType type = FOIL_CIPHER_AES_CTR_ENCRYPT;
+    FoilKey* key1 = foil_key_generate_new(FOIL_KEY_AES128, 0);
+    FoilKey* key2 = foil_key_generate_new(FOIL_KEY_AES192, 0);
+    FoilKey* des = foil_key_generate_new(FOIL_KEY_DES, 0);
+    GBytes* out1 = foil_cipher_data(type, key1, TEST_ARRAY_AND_SIZE(test_data));
+    GBytes* out2 = foil_cipher_data(type, key2, TEST_ARRAY_AND_SIZE(test_data));
+    FoilCipher* cipher1 = foil_cipher_pool_get(type, key1);
+    FoilCipher* cipher2;
+    GBytes* out;
+
+    g_assert(cipher1);
+    out = test_cipher_data(cipher1);
+    g_assert(g_bytes_equal(out, out1));
+    g_bytes_unref(out);
+
+    /* The same instance comes back, with the new key */
+    foil_cipher_pool_put(cipher1);
+    g_assert(!foil_cipher_pool_get(type, des));
+    cipher2 = foil_cipher_pool_get(type, key2);
+    g_assert(cipher2 == cipher1);
+    g_assert(foil_cipher_key(cipher2) == key2);
+    out = test_cipher_data(cipher2);
+    g_assert(g_bytes_equal(out, out2));
+    g_bytes_unref(out);
+
+    /* The pool is empty now */
+    cipher1 = foil_cipher_pool_get(type, key1);
+    g_assert(cipher1 != cipher2);
+    out = test_cipher_data(cipher1);
+    g_assert(g_bytes_equal(out, out1));
+    g_bytes_unref(out);
+
+    /* Ciphers referenced elsewhere are not recycled */
+    foil_cipher_ref(cipher1);
+    foil_cipher_pool_put(cipher1);
+    g_assert(foil_cipher_key(cipher1) == key1);
+    foil_cipher_pool_put(cipher1);
+    foil_cipher_pool_put(cipher2);
+    foil_cipher_pool_clear();
+    foil_cipher_pool_clear();
+
+    g_bytes_unref(out1);
+    g_bytes_unref(out2);
+    foil_key_unref(key1);
+    foil_key_unref(key2);
+    foil_key_unref(des);
+}
+
 #define TEST_(name) "/cipher/" name
 
 int main(int argc, char* argv[])
 {
     g_test_init(&argc, &argv, NULL);
     g_test_add_func(TEST_("null"), test_cipher_null);
+    g_test_add_func(TEST_("rekey"), test_cipher_rekey);
+    g_test_add_func(TEST_("pool"), test_cipher_pool);
     return test_run();
 }
 
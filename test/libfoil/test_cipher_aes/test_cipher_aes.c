@@ -32,7 +32,7 @@
 
 #include "test_common.h"
 
-#include "foil_key.h"
+#include "foil_key_aes.h"
 #include "foil_cipher.h"
 #include "foil_output.h"
 
@@ -343,6 +343,235 @@ test_cipher_aes_clone(
     g_free(key_path);
 }
 
+static
+void
+test_cipher_aes_schedule(
+    void)
+{
+    static const guint8 iv[FOIL_AES_BLOCK_SIZE] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+    };
+    static const guint8 data[] = {
+        0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+        0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+        0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+        0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51
+    };
+    GBytes* in = g_bytes_new_static(data, sizeof(data));
+    FoilKey* key1 = foil_key_generate_new(FOIL_KEY_AES256, 256);
+    FoilKey* key2;
+    FoilKey* key3;
+    FoilCipher* enc1 = foil_cipher_new(FOIL_CIPHER_AES_CBC_ENCRYPT, key1);
+    FoilCipher* dec1 = foil_cipher_new(FOIL_CIPHER_AES_CBC_DECRYPT, key1);
+    FoilCipher* enc2;
+    FoilCipher* enc3;
+    FoilCipher* dec2;
+    GBytes* bytes;
+    GBytes* out1;
+    GBytes* out2;
+    GBytes* out3;
+
+    /* Both schedules are cached by key1 by now, key2 inherits them */
+    key2 = foil_key_set_iv(key1, iv, sizeof(iv));
+    g_assert(key2);
+    g_assert(key2 != key1);
+    enc2 = foil_cipher_new(FOIL_CIPHER_AES_CBC_ENCRYPT, key2);
+    dec2 = foil_cipher_new(FOIL_CIPHER_AES_CBC_DECRYPT, key2);
+
+    /* key3 is the same as key2 but starts from scratch */
+    bytes = foil_key_to_bytes(key2);
+    key3 = foil_key_new_from_bytes(FOIL_KEY_AES256, bytes);
+    g_bytes_unref(bytes);
+    g_assert(foil_key_equal(key2, key3));
+    enc3 = foil_cipher_new(FOIL_CIPHER_AES_CBC_ENCRYPT, key3);
+
+    out1 = test_cipher_bytes(enc1, in);
+    out2 = test_cipher_bytes(enc2, in);
+    out3 = test_cipher_bytes(enc3, in);
+    g_assert(!g_bytes_equal(out1, out2));
+    g_assert(g_bytes_equal(out2, out3));
+
+    bytes = test_cipher_bytes(dec1, out1);
+    g_assert(g_bytes_equal(bytes, in));
+    g_bytes_unref(bytes);
+    bytes = test_cipher_bytes(dec2, out3);
+    g_assert(g_bytes_equal(bytes, in));
+    g_bytes_unref(bytes);
+
+    g_bytes_unref(in);
+    g_bytes_unref(out1);
+    g_bytes_unref(out2);
+    g_bytes_unref(out3);
+    foil_cipher_unref(enc1);
+    foil_cipher_unref(enc2);
+    foil_cipher_unref(enc3);
+    foil_cipher_unref(dec1);
+    foil_cipher_unref(dec2);
+    foil_key_unref(key1);
+    foil_key_unref(key2);
+    foil_key_unref(key3);
+}
+
+static
+void
+test_cipher_aes_gcm(
+    void)
+{
+    /* Test Case 4 from the GCM specification */
+    GBytes* key_bytes = gutil_hex2bytes("feffe9928665731c6d6a8f9467308308"
+        "cafebabefacedbaddecaf88800000000", -1);
+    GBytes* aad = gutil_hex2bytes("feedfacedeadbeeffeedfacedeadbeef"
+        "abaddad2", -1);
+    GBytes* in = gutil_hex2bytes("d9313225f88406e5a55909c5aff5269a"
+        "86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525"
+        "b16aedf5aa0de657ba637b39", -1);
+    GBytes* out_expected = gutil_hex2bytes("42831ec2217774244b7221b784d0d49c"
+        "e3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa05"
+        "1ba30b396a0ac973d58e091", -1);
+    GBytes* tag_expected = gutil_hex2bytes("5bc94fbc3221a5db94fae95ae7121a47",
+        -1);
+    FoilKey* key = foil_key_new_from_bytes(FOIL_KEY_AES128, key_bytes);
+    FoilCipher* enc = foil_cipher_new(FOIL_CIPHER_AES_GCM_ENCRYPT, key);
+    FoilCipher* dec = foil_cipher_new(FOIL_CIPHER_AES_GCM_DECRYPT, key);
+    FoilCipher* cbc = foil_cipher_new(FOIL_CIPHER_AES_CBC_ENCRYPT, key);
+    FoilCipher* dec2;
+    gsize aad_size, tag_size;
+    const void* aad_data = g_bytes_get_data(aad, &aad_size);
+    const void* tag_data = g_bytes_get_data(tag_expected, &tag_size);
+    guint8 tag[16];
+    guint8* block;
+    GBytes* out;
+    GBytes* res;
+
+    g_assert(key);
+    g_assert(enc);
+    g_assert(dec);
+    g_assert_cmpuint(foil_cipher_tag_size(enc), == ,sizeof(tag));
+    g_assert_cmpuint(foil_cipher_tag_size(dec), == ,sizeof(tag));
+    g_assert_cmpuint(foil_cipher_tag_size(cbc), == ,0);
+    g_assert_cmpuint(foil_cipher_tag_size(NULL), == ,0);
+    g_assert(!foil_cipher_add_aad(NULL, aad_data, aad_size));
+    g_assert(!foil_cipher_add_aad(cbc, aad_data, aad_size));
+    g_assert(!foil_cipher_set_tag(cbc, tag, sizeof(tag)));
+    g_assert(!foil_cipher_get_tag(cbc, tag, sizeof(tag)));
+    g_assert(!foil_cipher_get_tag(enc, tag, sizeof(tag) + 1));
+    g_assert(!foil_cipher_set_tag(enc, tag, sizeof(tag)));
+
+    /* Encrypt */
+    g_assert(foil_cipher_add_aad(enc, aad_data, aad_size));
+    g_assert(!foil_cipher_get_tag(enc, tag, sizeof(tag)));
+    out = test_cipher_bytes(enc, in);
+    g_assert(g_bytes_equal(out, out_expected));
+    g_assert(foil_cipher_get_tag(enc, tag, sizeof(tag)));
+    g_assert_cmpuint(tag_size, == ,sizeof(tag));
+    g_assert(!memcmp(tag, tag_data, tag_size));
+    g_assert(!foil_cipher_add_aad(enc, aad_data, aad_size));
+
+    /* Decrypt a clone, the original gets the wrong tag */
+    g_assert(foil_cipher_add_aad(dec, aad_data, aad_size));
+    g_assert(!foil_cipher_get_tag(dec, tag, sizeof(tag)));
+    dec2 = foil_cipher_clone(dec);
+    g_assert(foil_cipher_set_tag(dec2, tag, sizeof(tag)));
+    res = test_cipher_bytes(dec2, out);
+    g_assert(g_bytes_equal(res, in));
+    g_bytes_unref(res);
+
+    tag[0] ^= 0x01;
+    g_assert(foil_cipher_set_tag(dec, tag, sizeof(tag)));
+    block = g_malloc(foil_cipher_output_block_size(dec));
+    g_assert_cmpint(foil_cipher_finish(dec, g_bytes_get_data(out, NULL),
+        g_bytes_get_size(out), block), < ,0);
+    g_free(block);
+
+    g_bytes_unref(key_bytes);
+    g_bytes_unref(aad);
+    g_bytes_unref(in);
+    g_bytes_unref(out);
+    g_bytes_unref(out_expected);
+    g_bytes_unref(tag_expected);
+    foil_cipher_unref(enc);
+    foil_cipher_unref(dec);
+    foil_cipher_unref(dec2);
+    foil_cipher_unref(cbc);
+    foil_key_unref(key);
+}
+
+static
+void
+test_cipher_chacha20_poly1305(
+    void)
+{
+    /* RFC 8439, section 2.8.2 */
+    static const char text[] = "Ladies and Gentlemen of the class of '99: "
+        "If I could offer you only one tip for the future, sunscreen would "
+        "be it.";
+    GBytes* key_bytes = gutil_hex2bytes("808182838485868788898a8b8c8d8e8f"
+        "909192939495969798999a9b9c9d9e9f07000000404142434445464700000000",
+        -1);
+    GBytes* aad = gutil_hex2bytes("50515253c0c1c2c3c4c5c6c7", -1);
+    GBytes* in = g_bytes_new_static(text, sizeof(text) - 1);
+    GBytes* out_expected = gutil_hex2bytes("d31a8d34648e60db7b86afbc53ef7ec2"
+        "a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b"
+        "1a71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58"
+        "fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b"
+        "6116", -1);
+    GBytes* tag_expected = gutil_hex2bytes("1ae10b594f09e26a7e902ecbd0600691",
+        -1);
+    FoilKey* key = foil_key_new_from_bytes(FOIL_KEY_AES256, key_bytes);
+    FoilKey* key128 = foil_key_generate_new(FOIL_KEY_AES128, 128);
+    FoilCipher* enc = foil_cipher_new(FOIL_CIPHER_CHACHA20_POLY1305_ENCRYPT,
+        key);
+    FoilCipher* dec = foil_cipher_new(FOIL_CIPHER_CHACHA20_POLY1305_DECRYPT,
+        key);
+    gsize aad_size;
+    const void* aad_data = g_bytes_get_data(aad, &aad_size);
+    guint8 tag[16];
+    GBytes* out;
+    GBytes* res;
+
+    /* Only 256-bit keys */
+    g_assert(key);
+    g_assert(!foil_cipher_new(FOIL_CIPHER_CHACHA20_POLY1305_ENCRYPT, key128));
+    g_assert(enc);
+    g_assert(dec);
+    g_assert_cmpuint(foil_cipher_tag_size(enc), == ,sizeof(tag));
+
+    g_assert(foil_cipher_add_aad(enc, aad_data, aad_size));
+    out = test_cipher_bytes(enc, in);
+    g_assert(g_bytes_equal(out, out_expected));
+    g_assert(foil_cipher_get_tag(enc, tag, sizeof(tag)));
+    g_assert(gutil_bytes_equal(tag_expected, tag, sizeof(tag)));
+
+    g_assert(foil_cipher_add_aad(dec, aad_data, aad_size));
+    g_assert(foil_cipher_set_tag(dec, tag, sizeof(tag)));
+    res = test_cipher_bytes(dec, out);
+    g_assert(g_bytes_equal(res, in));
+    g_bytes_unref(res);
+
+    /* Reset starts it from scratch */
+    memset(tag, 0, sizeof(tag));
+    g_assert(foil_cipher_reset(enc));
+    g_assert(!foil_cipher_get_tag(enc, tag, sizeof(tag)));
+    g_assert(foil_cipher_add_aad(enc, aad_data, aad_size));
+    res = test_cipher_bytes(enc, in);
+    g_assert(g_bytes_equal(res, out_expected));
+    g_assert(foil_cipher_get_tag(enc, tag, sizeof(tag)));
+    g_assert(gutil_bytes_equal(tag_expected, tag, sizeof(tag)));
+    g_bytes_unref(res);
+
+    g_bytes_unref(key_bytes);
+    g_bytes_unref(aad);
+    g_bytes_unref(in);
+    g_bytes_unref(out);
+    g_bytes_unref(out_expected);
+    g_bytes_unref(tag_expected);
+    foil_cipher_unref(enc);
+    foil_cipher_unref(dec);
+    foil_key_unref(key);
+    foil_key_unref(key128);
+}
+
 static
 void
 test_cipher_aes_sync(
@@ -811,6 +1040,10 @@ int main(int argc, char* argv[])
         g_test_add_data_func(test_vectors[i].name, test_vectors + i,
             test_cipher_aes_vector);
     }
+    g_test_add_func(TEST_("schedule"), test_cipher_aes_schedule);
+    g_test_add_func(TEST_("gcm"), test_cipher_aes_gcm);
+    g_test_add_func(TEST_("chacha20_poly1305"),
+        test_cipher_chacha20_poly1305);
     return test_run();
 }
 
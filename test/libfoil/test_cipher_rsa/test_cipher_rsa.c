@@ -301,6 +301,60 @@ test_cipher_rsa_clone(
     g_free(pub_path);
 }
 
+static
+void
+test_cipher_rsa_rekey(
+    gconstpointer param)
+{
+    const TestCipherRsa* test = param;
+    char* priv_path = g_strconcat(DATA_DIR, test->priv, NULL);
+    char* pub_path = g_strconcat(DATA_DIR, test->pub, NULL);
+    FoilKey* priv = foil_key_new_from_file(FOIL_KEY_RSA_PRIVATE, priv_path);
+    FoilKey* pub = foil_key_new_from_file(FOIL_KEY_RSA_PUBLIC, pub_path);
+    FoilKey* aes_key = foil_key_generate_new(FOIL_KEY_AES128,
+        FOIL_KEY_BITS_DEFAULT);
+    GBytes* in = g_bytes_new_static(test->input, test->input_size);
+    FoilCipher* enc = foil_cipher_new(FOIL_CIPHER_RSA_ENCRYPT, priv);
+    FoilCipher* dec = foil_cipher_new(FOIL_CIPHER_RSA_DECRYPT, pub);
+    GBytes* out = test_cipher_bytes(enc, in);
+    GBytes* res = test_cipher_bytes(dec, out);
+
+    g_assert(g_bytes_equal(in, res));
+    g_bytes_unref(out);
+    g_bytes_unref(res);
+
+    /* Swap the keys */
+    g_assert(!foil_cipher_rekey(enc, aes_key));
+    g_assert(foil_cipher_rekey(enc, pub));
+    g_assert(foil_cipher_rekey(dec, priv));
+    g_assert(foil_cipher_key(enc) == pub);
+    g_assert(foil_cipher_key(dec) == priv);
+    out = test_cipher_bytes(enc, in);
+    res = test_cipher_bytes(dec, out);
+    g_assert(g_bytes_equal(in, res));
+    g_bytes_unref(out);
+    g_bytes_unref(res);
+
+    /* And back */
+    g_assert(foil_cipher_rekey(enc, priv));
+    g_assert(foil_cipher_rekey(dec, pub));
+    g_assert(foil_cipher_reset(dec));
+    out = test_cipher_bytes(enc, in);
+    res = test_cipher_bytes(dec, out);
+    g_assert(g_bytes_equal(in, res));
+    g_bytes_unref(out);
+    g_bytes_unref(res);
+
+    g_bytes_unref(in);
+    foil_cipher_unref(enc);
+    foil_cipher_unref(dec);
+    foil_key_unref(priv);
+    foil_key_unref(pub);
+    foil_key_unref(aes_key);
+    g_free(priv_path);
+    g_free(pub_path);
+}
+
 static
 void
 test_cipher_rsa_blocks(
@@ -354,6 +408,61 @@ test_cipher_rsa_blocks(
     g_free(pub_path);
 }
 
+static
+void
+test_cipher_rsa_parallel(
+    gconstpointer param)
+{
+    const TestCipherRsa* test = param;
+    char* priv_path = g_strconcat(DATA_DIR, test->priv, NULL);
+    char* pub_path = g_strconcat(DATA_DIR, test->pub, NULL);
+    FoilKey* priv = foil_key_new_from_file(FOIL_KEY_RSA_PRIVATE, priv_path);
+    FoilKey* pub = foil_key_new_from_file(FOIL_KEY_RSA_PUBLIC, pub_path);
+    FoilCipher* enc = foil_cipher_new(FOIL_CIPHER_RSA_ENCRYPT, priv);
+    guint8* data = g_malloc(test->input_size);
+    GBytes* in;
+    GBytes* out;
+    GBytes* out2;
+    GBytes* res;
+    gsize i;
+
+    for (i = 0; i < test->input_size; i++) {
+        data[i] = (guint8)(i * 31);
+    }
+    in = g_bytes_new_take(data, test->input_size);
+
+    /*
+     * Encryption with the private key is deterministic, the blocks
+     * processed in bulk (and in parallel) must come out exactly the
+     * same and in the same order as those processed one by one.
+     */
+    out = foil_cipher_bytes(FOIL_CIPHER_RSA_ENCRYPT, priv, in);
+    out2 = test_cipher_bytes(enc, in);
+    g_assert(out);
+    g_assert(g_bytes_equal(out, out2));
+    res = foil_cipher_bytes(FOIL_CIPHER_RSA_DECRYPT, pub, out);
+    g_assert(res);
+    g_assert(g_bytes_equal(in, res));
+    g_bytes_unref(out);
+    g_bytes_unref(out2);
+    g_bytes_unref(res);
+
+    /* Bulk private key decryption */
+    out = foil_cipher_bytes(FOIL_CIPHER_RSA_ENCRYPT, pub, in);
+    res = foil_cipher_bytes(FOIL_CIPHER_RSA_DECRYPT, priv, out);
+    g_assert(res);
+    g_assert(g_bytes_equal(in, res));
+    g_bytes_unref(out);
+    g_bytes_unref(res);
+
+    g_bytes_unref(in);
+    foil_cipher_unref(enc);
+    foil_key_unref(priv);
+    foil_key_unref(pub);
+    g_free(priv_path);
+    g_free(pub_path);
+}
+
 /* Exactly one block for 768-bit key (54 bytes)*/
 static const char input_short[] = "This is a secret.This is a secr"
     "et.This is a secret.Th";
@@ -421,12 +530,17 @@ static const char rsa_blocks_input[] =
 #define TEST_CIPHER_BLOCKS(name) \
     { TEST_("blocks-" name), test_cipher_rsa_blocks, name, name ".pub", \
       TEST_ARRAY_AND_SIZE(rsa_blocks_input) }
+#define TEST_CIPHER_PARALLEL(name,size) \
+    { TEST_("parallel-" name), test_cipher_rsa_parallel, name, name ".pub", \
+      NULL, size }
 #define TEST_CIPHER_KEY_CHECK(name) \
     { TEST_("key-check-" name), test_cipher_rsa_key_check, name, name ".pub" }
 
 static const TestCipherRsa tests[] = {
     { TEST_("basic"), test_cipher_rsa_basic, "rsa-768" },
     { TEST_("decode_failure"), test_cipher_rsa_decode_failure, "rsa-768" },
+    { TEST_("rekey"), test_cipher_rsa_rekey, "rsa-768", "rsa-768.pub",
+      TEST_ARRAY_AND_SIZE(input_short) },
     TEST_CIPHER_KEY_CHECK("rsa-768"  ),
     TEST_CIPHER_KEY_CHECK("rsa-1024" ),
     TEST_CIPHER_KEY_CHECK("rsa-1500" ),
@@ -450,7 +564,9 @@ static const TestCipherRsa tests[] = {
     TEST_CIPHER_BLOCKS("rsa-768"  ),
     TEST_CIPHER_BLOCKS("rsa-1024" ),
     TEST_CIPHER_BLOCKS("rsa-1500" ),
-    TEST_CIPHER_BLOCKS("rsa-2048" )
+    TEST_CIPHER_BLOCKS("rsa-2048" ),
+    TEST_CIPHER_PARALLEL("rsa-768", 5000),
+    TEST_CIPHER_PARALLEL("rsa-1024", 65536)
 };
 
 int main(int argc, char* argv[])
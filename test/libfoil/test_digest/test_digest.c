@@ -35,6 +35,7 @@
 #include "test_common.h"
 
 #include "foil_digest_p.h"
+#include "foil_output.h"
 
 #include <gutil_misc.h>
 
@@ -71,6 +72,22 @@ static const guint8 empty_sha512_data[] = {
     0x63,0xb9,0x31,0xbd,0x47,0x41,0x7a,0x81,
     0xa5,0x38,0x32,0x7a,0xf9,0x27,0xda,0x3e
 };
+static const guint8 empty_blake2b_data[] = {
+    0x78,0x6a,0x02,0xf7,0x42,0x01,0x59,0x03,
+    0xc6,0xc6,0xfd,0x85,0x25,0x52,0xd2,0x72,
+    0x91,0x2f,0x47,0x40,0xe1,0x58,0x47,0x61,
+    0x8a,0x86,0xe2,0x17,0xf7,0x1f,0x54,0x19,
+    0xd2,0x5e,0x10,0x31,0xaf,0xee,0x58,0x53,
+    0x13,0x89,0x64,0x44,0x93,0x4e,0xb0,0x4b,
+    0x90,0x3a,0x68,0x5b,0x14,0x48,0xb7,0x55,
+    0xd5,0x6f,0x70,0x1a,0xfe,0x9b,0xe2,0xce
+};
+static const guint8 empty_blake3_data[] = {
+    0xaf,0x13,0x49,0xb9,0xf5,0xf9,0xa1,0xa6,
+    0xa0,0x40,0x4d,0xea,0x36,0xdc,0xc9,0x49,
+    0x9b,0xcb,0x25,0xc9,0xad,0xc1,0x12,0xb7,
+    0xcc,0x9a,0x93,0xca,0xe4,0x1f,0x32,0x62
+};
 
 /* MD5 examples from http://www.ietf.org/rfc/rfc1321 */
 
@@ -240,6 +257,98 @@ static const guint8 test_sha512_data4[] = {
     0xCA,0xA6,0x4D,0x3F,0x3F,0xB7,0xBA,0xE9
 };
 
+/* Same inputs as SHA512, digests computed with the reference code */
+
+#define BLAKE2B_TEST1   SHA512_TEST1
+#define BLAKE2B_TEST2   SHA512_TEST2
+#define BLAKE2B_TEST3   SHA512_TEST3                /* times 1000000 */
+#define BLAKE2B_TEST4   SHA512_TEST4                /* times 10 */
+
+static const guint8 test_blake2b_data1[] = {
+    0xba,0x80,0xa5,0x3f,0x98,0x1c,0x4d,0x0d,
+    0x6a,0x27,0x97,0xb6,0x9f,0x12,0xf6,0xe9,
+    0x4c,0x21,0x2f,0x14,0x68,0x5a,0xc4,0xb7,
+    0x4b,0x12,0xbb,0x6f,0xdb,0xff,0xa2,0xd1,
+    0x7d,0x87,0xc5,0x39,0x2a,0xab,0x79,0x2d,
+    0xc2,0x52,0xd5,0xde,0x45,0x33,0xcc,0x95,
+    0x18,0xd3,0x8a,0xa8,0xdb,0xf1,0x92,0x5a,
+    0xb9,0x23,0x86,0xed,0xd4,0x00,0x99,0x23
+};
+
+static const guint8 test_blake2b_data2[] = {
+    0xce,0x74,0x1a,0xc5,0x93,0x0f,0xe3,0x46,
+    0x81,0x11,0x75,0xc5,0x22,0x7b,0xb7,0xbf,
+    0xcd,0x47,0xf4,0x26,0x12,0xfa,0xe4,0x6c,
+    0x08,0x09,0x51,0x4f,0x9e,0x0e,0x3a,0x11,
+    0xee,0x17,0x73,0x28,0x71,0x47,0xcd,0xea,
+    0xee,0xdf,0xf5,0x07,0x09,0xaa,0x71,0x63,
+    0x41,0xfe,0x65,0x24,0x0f,0x4a,0xd6,0x77,
+    0x7d,0x6b,0xfa,0xf9,0x72,0x6e,0x5e,0x52
+};
+
+static const guint8 test_blake2b_data3[] = {
+    0x98,0xfb,0x3e,0xfb,0x72,0x06,0xfd,0x19,
+    0xeb,0xf6,0x9b,0x6f,0x31,0x2c,0xf7,0xb6,
+    0x4e,0x3b,0x94,0xdb,0xe1,0xa1,0x71,0x07,
+    0x91,0x39,0x75,0xa7,0x93,0xf1,0x77,0xe1,
+    0xd0,0x77,0x60,0x9d,0x7f,0xba,0x36,0x3c,
+    0xbb,0xa0,0x0d,0x05,0xf7,0xaa,0x4e,0x4f,
+    0xa8,0x71,0x5d,0x64,0x28,0x10,0x4c,0x0a,
+    0x75,0x64,0x3b,0x0f,0xf3,0xfd,0x3e,0xaf
+};
+
+static const guint8 test_blake2b_data4[] = {
+    0xbe,0x92,0xee,0xe3,0xcc,0xfb,0x66,0x46,
+    0x84,0x37,0x53,0x5e,0xb7,0x55,0x08,0xa6,
+    0x03,0x0a,0xb8,0xc6,0x9b,0xeb,0x1e,0xe8,
+    0x49,0x10,0xab,0xaa,0x9f,0x17,0x60,0xeb,
+    0x52,0xa6,0x76,0x35,0x77,0xb4,0x4e,0xfc,
+    0x88,0x22,0xe7,0x4c,0xe2,0x16,0x25,0x90,
+    0x8f,0x37,0x86,0xc8,0x6a,0xbd,0x71,0x65,
+    0x6d,0x5f,0xd0,0xa1,0x47,0x5b,0xb9,0x95
+};
+
+#define BLAKE3_TEST1    SHA512_TEST1
+#define BLAKE3_TEST2    SHA512_TEST2
+#define BLAKE3_TEST3    SHA512_TEST3                /* times 1000000 */
+#define BLAKE3_TEST4    SHA512_TEST4                /* times 10 */
+
+static const guint8 test_blake3_data1[] = {
+    0x64,0x37,0xb3,0xac,0x38,0x46,0x51,0x33,
+    0xff,0xb6,0x3b,0x75,0x27,0x3a,0x8d,0xb5,
+    0x48,0xc5,0x58,0x46,0x5d,0x79,0xdb,0x03,
+    0xfd,0x35,0x9c,0x6c,0xd5,0xbd,0x9d,0x85
+};
+
+static const guint8 test_blake3_data2[] = {
+    0x55,0x3e,0x1a,0xa2,0xa4,0x77,0xcb,0x31,
+    0x66,0xe6,0xab,0x38,0xc1,0x2d,0x59,0xf6,
+    0xc5,0x01,0x7f,0x08,0x85,0xaa,0xf0,0x79,
+    0xf2,0x17,0xda,0x00,0xcf,0xca,0x36,0x3f
+};
+
+static const guint8 test_blake3_data3[] = {
+    0x61,0x6f,0x57,0x5a,0x1b,0x58,0xd4,0xc9,
+    0x79,0x7d,0x42,0x17,0xb9,0x73,0x0a,0xe5,
+    0xe6,0xeb,0x31,0x9d,0x76,0xed,0xef,0x65,
+    0x49,0xb4,0x6f,0x4e,0xfe,0x31,0xff,0x8b
+};
+
+static const guint8 test_blake3_data4[] = {
+    0xc7,0xb3,0xc7,0xf5,0x62,0xf8,0x1e,0x0e,
+    0x25,0x55,0xb8,0x5a,0xe8,0x47,0x62,0x6d,
+    0x11,0x92,0x7a,0x70,0x85,0x5d,0x51,0x63,
+    0x1e,0xe4,0xeb,0x9b,0x8d,0xcc,0x6b,0x04
+};
+
+/* BLAKE3 of 5 MiB + 17 bytes of (i % 251), i.e. a few thousand chunks */
+static const guint8 test_blake3_large_data[] = {
+    0x46,0x9e,0x69,0x3f,0x0f,0x55,0xb6,0x3b,
+    0x51,0x65,0x4a,0x6f,0xcd,0x32,0xdb,0xda,
+    0x34,0xf5,0x38,0x76,0x15,0x07,0xd8,0xb5,
+    0x37,0x5b,0x9c,0x4b,0xe0,0xf6,0xbe,0xff
+};
+
 static
 void
 test_basic(
@@ -277,6 +386,9 @@ test_basic(
     g_assert_cmpuint(foil_digest_type_block_size(FOIL_DIGEST_SHA1), == ,64);
     g_assert_cmpuint(foil_digest_type_block_size(FOIL_DIGEST_SHA256), == ,64);
     g_assert_cmpuint(foil_digest_type_block_size(FOIL_DIGEST_SHA512), == ,128);
+    g_assert_cmpuint(foil_digest_type_block_size(FOIL_DIGEST_BLAKE2B), == ,
+        128);
+    g_assert_cmpuint(foil_digest_type_block_size(FOIL_DIGEST_BLAKE3), == ,64);
     g_assert_cmpuint(foil_digest_block_size(md5), == ,64);
     foil_digest_update(NULL, NULL, 0);
     foil_digest_update_bytes(NULL, NULL);
@@ -496,6 +608,208 @@ test_digest(
     foil_digest_unref(unfinished);
 }
 
+static
+void
+test_blake3_large(
+    gconstpointer param)
+{
+    const gsize size = 5 * 1024 * 1024 + 17;
+    guint8* data = g_malloc(size);
+    FoilDigest* digest = foil_digest_new_blake3();
+    FoilDigest* copy;
+    GBytes* bytes;
+    gsize i;
+
+    for (i = 0; i < size; i++) {
+        data[i] = (guint8)(i % 251);
+    }
+
+    /* One-shot (large subtrees may get hashed in parallel) */
+    bytes = foil_digest_data(FOIL_DIGEST_BLAKE3, data, size);
+    g_assert(gutil_bytes_equal(bytes, TEST_ARRAY_AND_SIZE
+        (test_blake3_large_data)));
+    g_bytes_unref(bytes);
+
+    /* Odd-sized pieces, copying the state half way through */
+    for (i = 0; i < size / 2; i += 100003) {
+        foil_digest_update(digest, data + i, MIN(100003, size / 2 - i));
+    }
+    copy = foil_digest_clone(digest);
+    foil_digest_update(digest, data + size / 2, size - size / 2);
+    g_assert(gutil_bytes_equal(foil_digest_finish(digest),
+        TEST_ARRAY_AND_SIZE(test_blake3_large_data)));
+    foil_digest_update(copy, data + size / 2, size - size / 2);
+    g_assert(gutil_bytes_equal(foil_digest_finish(copy),
+        TEST_ARRAY_AND_SIZE(test_blake3_large_data)));
+    foil_digest_unref(digest);
+    foil_digest_unref(copy);
+    g_free(data);
+}
+
+static
+const GType*
+test_multi_types(
+    GType* types)
+{
+    types[0] = FOIL_DIGEST_MD5;
+    types[1] = FOIL_DIGEST_SHA1;
+    types[2] = FOIL_DIGEST_SHA256;
+    return types;
+}
+
+static
+void
+test_multi_check(
+    FoilDigestMulti* multi,
+    const void* data,
+    gsize size)
+{
+    guint i;
+
+    for (i = 0; i < foil_digest_multi_count(multi); i++) {
+        FoilDigest* digest = foil_digest_multi_get(multi, i);
+        GBytes* expected = foil_digest_data(G_TYPE_FROM_INSTANCE(digest),
+            data, size);
+
+        g_assert(g_bytes_equal(foil_digest_finish(digest), expected));
+        g_bytes_unref(expected);
+    }
+}
+
+static
+void
+test_multi(
+    gconstpointer param)
+{
+    static const char text[] = "The quick brown fox jumps over the lazy dog";
+    const gsize len = strlen(text);
+    const GType invalid[] = { FOIL_DIGEST_SHA1, (GType)0 };
+    GType types[3];
+    GBytes* digests[G_N_ELEMENTS(types)];
+    FoilDigestMulti* multi;
+    guint i;
+
+    test_multi_types(types);
+    g_assert(!foil_digest_multi_new(NULL, 0));
+    g_assert(!foil_digest_multi_new(types, 0));
+    g_assert(!foil_digest_multi_new(invalid, G_N_ELEMENTS(invalid)));
+    g_assert(!foil_digest_multi_ref(NULL));
+    foil_digest_multi_unref(NULL);
+    g_assert_cmpuint(foil_digest_multi_count(NULL), == ,0);
+    g_assert(!foil_digest_multi_get(NULL, 0));
+    g_assert(!foil_digest_multi_update(NULL, text, len));
+    g_assert(!foil_digest_multi_reset(NULL));
+    g_assert(!foil_digest_multi_data(types, G_N_ELEMENTS(types), text, len,
+        NULL));
+    g_assert(!foil_digest_multi_data(NULL, 0, text, len, digests));
+    g_assert(!foil_output_multi_digest_new(NULL, NULL));
+
+    multi = foil_digest_multi_new(types, G_N_ELEMENTS(types));
+    g_assert(multi);
+    g_assert_cmpuint(foil_digest_multi_count(multi), == ,G_N_ELEMENTS(types));
+    g_assert(!foil_digest_multi_get(multi, G_N_ELEMENTS(types)));
+    g_assert(!foil_digest_multi_update(multi, NULL, 1));
+    g_assert(foil_digest_multi_update(multi, NULL, 0));
+    g_assert(foil_digest_multi_update(multi, text, 4));
+    g_assert(foil_digest_multi_update(multi, text + 4, len - 4));
+    test_multi_check(multi, text, len);
+
+    /* Can't update finished digests */
+    g_assert(!foil_digest_multi_update(multi, text, len));
+
+    /* But can after reset */
+    g_assert(foil_digest_multi_reset(multi));
+    g_assert(foil_digest_multi_update(multi, text, len));
+    test_multi_check(multi, text, len);
+    foil_digest_multi_unref(foil_digest_multi_ref(multi));
+    foil_digest_multi_unref(multi);
+
+    /* One-shot */
+    g_assert(foil_digest_multi_data(types, G_N_ELEMENTS(types), text, len,
+        digests));
+    for (i = 0; i < G_N_ELEMENTS(types); i++) {
+        GBytes* expected = foil_digest_data(types[i], text, len);
+
+        g_assert(g_bytes_equal(digests[i], expected));
+        g_bytes_unref(expected);
+        g_bytes_unref(digests[i]);
+    }
+}
+
+static
+void
+test_multi_large(
+    gconstpointer param)
+{
+    /* Large enough to be split between threads, not multiple of chunk */
+    const gsize size = 3 * 1024 * 1024 + 17;
+    guint8* data = g_malloc(size);
+    GType types[3];
+    FoilDigestMulti* multi = foil_digest_multi_new(test_multi_types(types),
+        G_N_ELEMENTS(types));
+    gsize i;
+
+    for (i = 0; i < size; i++) {
+        data[i] = (guint8)(i * 7 + (i >> 8));
+    }
+
+    g_assert(foil_digest_multi_update(multi, data, 100));
+    g_assert(foil_digest_multi_update(multi, data + 100, size - 100));
+    test_multi_check(multi, data, size);
+    foil_digest_multi_unref(multi);
+
+    /* Single digest goes straight through */
+    multi = foil_digest_multi_new(types + 2, 1);
+    g_assert(foil_digest_multi_update(multi, data, size));
+    test_multi_check(multi, data, size);
+    foil_digest_multi_unref(multi);
+    g_free(data);
+}
+
+static
+void
+test_multi_output(
+    gconstpointer param)
+{
+    static const char text[] = "The quick brown fox jumps over the lazy dog";
+    const gsize len = strlen(text);
+    GType types[3];
+    FoilDigestMulti* multi = foil_digest_multi_new(test_multi_types(types),
+        G_N_ELEMENTS(types));
+    FoilOutput* mem = foil_output_mem_new(NULL);
+    FoilOutput* out = foil_output_multi_digest_new(mem, multi);
+    FoilBytes bufs[2];
+    GBytes* bytes;
+
+    /* Pass-through */
+    bufs[0].val = (const guint8*)text + 4;
+    bufs[0].len = 6;
+    bufs[1].val = (const guint8*)text + 10;
+    bufs[1].len = len - 10;
+    g_assert(foil_output_reserve(out, len));
+    g_assert(foil_output_write_all(out, text, 4));
+    g_assert_cmpint(foil_output_writev(out, bufs, 2), == ,len - 4);
+    g_assert(!foil_output_reset(out));
+    bytes = foil_output_free_to_bytes(out);
+    g_assert(bytes);
+    g_assert(gutil_bytes_equal(bytes, text, len));
+    g_bytes_unref(bytes);
+    test_multi_check(multi, text, len);
+    foil_output_unref(mem);
+
+    /* No underlying output */
+    g_assert(foil_digest_multi_reset(multi));
+    out = foil_output_multi_digest_new(NULL, multi);
+    g_assert(foil_output_reserve(out, len));
+    g_assert(foil_output_write_all(out, text, 4));
+    g_assert_cmpint(foil_output_writev(out, bufs, 2), == ,len - 4);
+    g_assert(foil_output_flush(out));
+    foil_output_close(out);
+    foil_output_unref(out);
+    test_multi_check(multi, text, len);
+    foil_digest_multi_unref(multi);
+}
+
 /* Test descriptors */
 
 #define TEST_NAME(name) "/digest/" name
@@ -509,6 +823,8 @@ test_digest(
 #define TEST_SHA1(i,n) TEST_(SHA1,sha1,i,n)
 #define TEST_SHA256(i,n) TEST_(SHA256,sha256,i,n)
 #define TEST_SHA512(i,n) TEST_(SHA512,sha512,i,n)
+#define TEST_BLAKE2B(i,n) TEST_(BLAKE2B,blake2b,i,n)
+#define TEST_BLAKE3(i,n) TEST_(BLAKE3,blake3,i,n)
 
 #define TEST_EMPTY(ALG,alg) {              \
     TEST_NAME(#ALG "_EMPTY"), test_digest, \
@@ -524,14 +840,22 @@ static const TestDigest tests[] = {
     { TEST_NAME("Basic"), test_basic },
     { TEST_NAME("Clone"), test_clone },
     { TEST_NAME("Copy"), test_copy },
+    { TEST_NAME("Multi"), test_multi },
+    { TEST_NAME("MultiLarge"), test_multi_large },
+    { TEST_NAME("MultiOutput"), test_multi_output },
+    { TEST_NAME("BLAKE3_LARGE"), test_blake3_large },
     TEST_EMPTY(MD5,md5),
     TEST_EMPTY(SHA1,sha1),
     TEST_EMPTY(SHA256,sha256),
     TEST_EMPTY(SHA512,sha512),
+    TEST_EMPTY(BLAKE2B,blake2b),
+    TEST_EMPTY(BLAKE3,blake3),
     TEST_RESET(MD5,md5,2,1),
     TEST_RESET(SHA1,sha1,2,1),
     TEST_RESET(SHA256,sha256,2,1),
     TEST_RESET(SHA512,sha512,2,1),
+    TEST_RESET(BLAKE2B,blake2b,2,1),
+    TEST_RESET(BLAKE3,blake3,2,1),
     /* MD5 */
     TEST_MD5(1,1),
     TEST_MD5(2,1),
@@ -554,7 +878,17 @@ static const TestDigest tests[] = {
     TEST_SHA512(1,1),
     TEST_SHA512(2,1),
     TEST_SHA512(3,1000000),
-    TEST_SHA512(4,10)
+    TEST_SHA512(4,10),
+    /* BLAKE2B */
+    TEST_BLAKE2B(1,1),
+    TEST_BLAKE2B(2,1),
+    TEST_BLAKE2B(3,1000000),
+    TEST_BLAKE2B(4,10),
+    /* BLAKE3 */
+    TEST_BLAKE3(1,1),
+    TEST_BLAKE3(2,1),
+    TEST_BLAKE3(3,1000000),
+    TEST_BLAKE3(4,10)
 };
 
 int main(int argc, char* argv[])
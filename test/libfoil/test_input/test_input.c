@@ -38,6 +38,7 @@
 
 #include <gutil_misc.h>
 
+#include <fcntl.h>
 #ifdef _WIN32
 #  include <io.h>
 #  include <direct.h>
@@ -449,6 +450,219 @@ test_input_file(
     g_bytes_unref(bytes_expected);
 }
 
+static
+void
+test_input_fd(
+    void)
+{
+    char* tmpdir = g_dir_make_tmp("test_input_XXXXXX", NULL);
+    char* fname = g_build_filename(tmpdir, "test", NULL);
+    const gsize datalen = 3 * 0x1000 + 123;
+    guint8* data = g_malloc(datalen);
+    guint8* buf = g_malloc(datalen);
+    gsize i;
+    FoilInput* in;
+    GBytes* bytes;
+    int fd;
+
+    for (i = 0; i < datalen; i++) {
+        data[i] = (guint8)i;
+    }
+    g_assert(g_file_set_contents(fname, (char*)data, datalen, NULL));
+
+    /* Invalid descriptor */
+    g_assert(!foil_input_file_new_fd(-1, 0, 0));
+
+    /* Small buffer, mixing small reads, skips and large reads */
+    in = foil_input_file_new_open_full(fname, 0, 16);
+    g_assert(in);
+    g_assert(foil_input_read(in, buf, 10) == 10);
+    g_assert(!memcmp(buf, data, 10));
+    g_assert(foil_input_read(in, NULL, 5) == 5);
+    g_assert(foil_input_read(in, buf, 0x1000) == 0x1000);
+    g_assert(!memcmp(buf, data + 15, 0x1000));
+    i = 15 + 0x1000;
+    g_assert(foil_input_read(in, buf, datalen) == (gssize)(datalen - i));
+    g_assert(!memcmp(buf, data + i, datalen - i));
+    g_assert(!foil_input_read(in, buf, 1));
+    foil_input_unref(in);
+
+    /* O_DIRECT (silently ignored if not supported) */
+    in = foil_input_file_new_open_full(fname, FOIL_INPUT_FILE_DIRECT, 0);
+    g_assert(in);
+    bytes = foil_input_read_all(in);
+    g_assert(g_bytes_get_size(bytes) == datalen);
+    g_assert(!memcmp(g_bytes_get_data(bytes, NULL), data, datalen));
+    g_bytes_unref(bytes);
+    foil_input_unref(in);
+
+    /* Descriptor which we are not supposed to close */
+    fd = open(fname, O_RDONLY);
+    g_assert(fd >= 0);
+    in = foil_input_file_new_fd(fd, 0, 0);
+    g_assert(in);
+    g_assert(foil_input_read(in, buf, 10) == 10);
+    g_assert(!memcmp(buf, data, 10));
+    foil_input_unref(in);
+    g_assert(!close(fd));
+
+    /* Non-existent file */
+    remove(fname);
+    g_assert(!foil_input_file_new_open_full(fname, 0, 0));
+
+    rmdir(tmpdir);
+    g_free(tmpdir);
+    g_free(fname);
+    g_free(data);
+    g_free(buf);
+}
+
+static
+void
+test_input_uring(
+    void)
+{
+    char* tmpdir = g_dir_make_tmp("test_input_XXXXXX", NULL);
+    char* fname = g_build_filename(tmpdir, "test", NULL);
+    const gsize datalen = 5 * 0x1000 + 321;
+    guint8* data = g_malloc(datalen);
+    guint8* buf = g_malloc(datalen);
+    gsize i;
+    FoilInput* in;
+    GBytes* bytes;
+    int fd;
+
+    for (i = 0; i < datalen; i++) {
+        data[i] = (guint8)(i + i / 251);
+    }
+    g_assert(g_file_set_contents(fname, (char*)data, datalen, NULL));
+
+    /* Invalid parameters */
+    g_assert(!foil_input_uring_new(-1, 0, 0, 0));
+    g_assert(!foil_input_uring_new_open(NULL));
+
+    /* Small buffers, reads and skips crossing the buffer boundaries */
+    fd = open(fname, O_RDONLY);
+    g_assert(fd >= 0);
+    in = foil_input_uring_new(fd, FOIL_INPUT_FILE_CLOSE, 0x1000, 2);
+    g_assert(in);
+    g_assert(foil_input_read(in, buf, 10) == 10);
+    g_assert(!memcmp(buf, data, 10));
+    g_assert(foil_input_read(in, NULL, 0x1000) == 0x1000);
+    i = 10 + 0x1000;
+    g_assert(foil_input_read(in, buf, 3 * 0x1000) == 3 * 0x1000);
+    g_assert(!memcmp(buf, data + i, 3 * 0x1000));
+    i += 3 * 0x1000;
+    g_assert(foil_input_read(in, buf, datalen) == (gssize)(datalen - i));
+    g_assert(!memcmp(buf, data + i, datalen - i));
+    g_assert(!foil_input_read(in, buf, 1));
+    foil_input_unref(in);
+
+    /* Descriptor which we are not supposed to close */
+    fd = open(fname, O_RDONLY);
+    g_assert(fd >= 0);
+    in = foil_input_uring_new(fd, 0, 0, 0);
+    g_assert(in);
+    g_assert(foil_input_read(in, buf, 10) == 10);
+    g_assert(!memcmp(buf, data, 10));
+    foil_input_unref(in);
+
+    /* Must be positioned right after the consumed data */
+    g_assert(read(fd, buf, 5) == 5);
+    g_assert(!memcmp(buf, data + 10, 5));
+    g_assert(!close(fd));
+
+    /* Open by path */
+    in = foil_input_uring_new_open(fname);
+    g_assert(in);
+    bytes = foil_input_read_all(in);
+    g_assert(g_bytes_get_size(bytes) == datalen);
+    g_assert(!memcmp(g_bytes_get_data(bytes, NULL), data, datalen));
+    g_bytes_unref(bytes);
+    foil_input_unref(in);
+
+    /* Non-existent file */
+    remove(fname);
+    g_assert(!foil_input_uring_new_open(fname));
+
+    rmdir(tmpdir);
+    g_free(tmpdir);
+    g_free(fname);
+    g_free(data);
+    g_free(buf);
+}
+
+static
+void
+test_input_readahead(
+    void)
+{
+    const gsize datalen = 10000;
+    guint8* data = g_malloc(datalen);
+    guint8* buf = g_malloc(datalen + 1);
+    GBytes* bytes;
+    GBytes* md1;
+    GBytes* md2;
+    FoilInput* mem;
+    FoilInput* in;
+    FoilDigest* digest;
+    gsize i, total;
+    gssize n;
+
+    for (i = 0; i < datalen; i++) {
+        data[i] = (guint8)(i * 3 + i / 255);
+    }
+    bytes = g_bytes_new_static(data, datalen);
+
+    /* NULL input */
+    g_assert(!foil_input_readahead_new(NULL, 0, 0));
+
+    /* Odd sized reads crossing the chunk boundaries */
+    mem = foil_input_mem_new(bytes);
+    in = foil_input_readahead_new(mem, 100, 3);
+    foil_input_unref(mem);
+    for (total = 0, i = 1; total < datalen; total += n, i++) {
+        n = foil_input_read(in, buf + total, i);
+        g_assert(n > 0);
+    }
+    g_assert(total == datalen);
+    g_assert(!memcmp(buf, data, datalen));
+    g_assert(!foil_input_read(in, buf, 1));
+    g_assert(foil_input_bytes_read(in) == datalen);
+    foil_input_unref(in);
+
+    /* Digest stage running on the helper thread, skipping the data */
+    digest = foil_digest_new_md5();
+    mem = foil_input_mem_new(bytes);
+    in = foil_input_digest_new(mem, digest);
+    foil_input_unref(mem);
+    mem = in;
+    in = foil_input_readahead_new(mem, 0, 0);
+    foil_input_unref(mem);
+    g_assert(foil_input_skip(in, datalen + 1) == (gssize)datalen);
+    foil_input_unref(in);
+    md1 = foil_digest_finish(digest);
+    md2 = foil_digest_bytes(FOIL_DIGEST_MD5, bytes);
+    g_assert(g_bytes_equal(md1, md2));
+    foil_digest_unref(digest);
+    g_bytes_unref(md1);
+    g_bytes_unref(md2);
+
+    /* Closing the stream before everything has been read */
+    mem = foil_input_mem_new(bytes);
+    in = foil_input_readahead_new(mem, 10, 2);
+    foil_input_unref(mem);
+    g_assert(foil_input_read(in, buf, 5) == 5);
+    g_assert(!memcmp(buf, data, 5));
+    foil_input_close(in);
+    g_assert(foil_input_read(in, buf, 5) < 0);
+    foil_input_unref(in);
+
+    g_bytes_unref(bytes);
+    g_free(data);
+    g_free(buf);
+}
+
 /* base64 test */
 
 typedef struct test_input_base64_data {
@@ -645,6 +859,9 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("push"), test_input_push);
     g_test_add_func(TEST_("digest"), test_input_digest);
     g_test_add_func(TEST_("file"), test_input_file);
+    g_test_add_func(TEST_("fd"), test_input_fd);
+    g_test_add_func(TEST_("uring"), test_input_uring);
+    g_test_add_func(TEST_("readahead"), test_input_readahead);
     for (i = 0; i < G_N_ELEMENTS(base64_tests); i++) {
         char* name = g_strdup_printf(TEST_("base64") "/%d", i + 1);
         g_test_add_data_func(name, base64_tests + i, test_input_base64);
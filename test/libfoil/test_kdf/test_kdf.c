@@ -49,6 +49,16 @@ typedef struct test_kdf {
     FoilBytes output;
 } TestKdf;
 
+typedef struct test_hkdf {
+    const char* name;
+    GType (*digest_type)(void);
+    FoilBytes ikm;
+    const FoilBytes* salt;
+    const FoilBytes* info;
+    guint dlen;
+    FoilBytes output;
+} TestHkdf;
+
 static
 void
 test_null(
@@ -65,6 +75,13 @@ test_null(
     g_assert(!foil_kdf_pbkdf2(FOIL_DIGEST_SHA1, NULL, 0, &salt, 0, 0));
     /* NULL password */
     g_assert(!foil_kdf_pbkdf2(FOIL_DIGEST_SHA1, NULL, -1, &salt, 1, 0));
+
+    g_assert(!foil_kdf_hkdf((GType)0, NULL, NULL, NULL, 0));
+    g_assert(!foil_kdf_hkdf(FOIL_DIGEST_SHA256, NULL, NULL, NULL, 0));
+    g_assert(!foil_kdf_hkdf(FOIL_RANDOM_DEFAULT, &salt, NULL, NULL, 0));
+    /* Too long */
+    g_assert(!foil_kdf_hkdf(FOIL_DIGEST_SHA256, &salt, NULL, NULL,
+        255 * 32 + 1));
 }
 
 static
@@ -86,6 +103,25 @@ test_kdf(
     g_bytes_unref(result);
 }
 
+static
+void
+test_hkdf(
+    gconstpointer param)
+{
+    const TestHkdf* test = param;
+    GBytes* result = foil_kdf_hkdf(test->digest_type(), &test->ikm,
+        test->salt, test->info, test->dlen);
+    gsize size = 0;
+    gconstpointer data;
+
+    g_assert(result);
+    data = g_bytes_get_data(result, &size);
+
+    g_assert_cmpuint(size, == ,test->output.len);
+    g_assert(!memcmp(data, test->output.val, size));
+    g_bytes_unref(result);
+}
+
 /* Test descriptors */
 
 #define TEST_(name) "/kdf/" name
@@ -214,6 +250,76 @@ static const TestKdf tests[] = {
     }
 };
 
+/* RFC 5869 HMAC-based Extract-and-Expand Key Derivation Function */
+
+static const guint8 rfc5869_ikm[] = {
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b
+};
+
+static const guint8 rfc5869_001_salt_data[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c
+};
+static const FoilBytes rfc5869_001_salt = {
+    TEST_ARRAY_AND_SIZE(rfc5869_001_salt_data)
+};
+
+static const guint8 rfc5869_001_info_data[] = {
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+    0xf8, 0xf9
+};
+static const FoilBytes rfc5869_001_info = {
+    TEST_ARRAY_AND_SIZE(rfc5869_001_info_data)
+};
+
+static const guint8 rfc5869_001_output[] = {
+    0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a,
+    0x90, 0x43, 0x4f, 0x64, 0xd0, 0x36, 0x2f, 0x2a,
+    0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c,
+    0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf,
+    0x34, 0x00, 0x72, 0x08, 0xd5, 0xb8, 0x87, 0x18,
+    0x58, 0x65
+};
+
+static const guint8 rfc5869_003_output[] = {
+    0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f,
+    0x71, 0x5f, 0x80, 0x2a, 0x06, 0x3c, 0x5a, 0x31,
+    0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1, 0x87, 0x9e,
+    0xc3, 0x45, 0x4e, 0x5f, 0x3c, 0x73, 0x8d, 0x2d,
+    0x9d, 0x20, 0x13, 0x95, 0xfa, 0xa4, 0xb6, 0x1a,
+    0x96, 0xc8
+};
+
+static const TestHkdf hkdf_tests[] = {
+    {
+        TEST_("RFC5869/001"),
+        foil_impl_digest_sha256_get_type,
+        { TEST_ARRAY_AND_SIZE(rfc5869_ikm) },
+        &rfc5869_001_salt,
+        &rfc5869_001_info,
+        42,
+        { TEST_ARRAY_AND_SIZE(rfc5869_001_output) }
+    },{
+        TEST_("RFC5869/003"),
+        foil_impl_digest_sha256_get_type,
+        { TEST_ARRAY_AND_SIZE(rfc5869_ikm) },
+        NULL, /* No salt */
+        NULL, /* No info */
+        42,
+        { TEST_ARRAY_AND_SIZE(rfc5869_003_output) }
+    },{
+        TEST_("RFC5869/003-short"),
+        foil_impl_digest_sha256_get_type,
+        { TEST_ARRAY_AND_SIZE(rfc5869_ikm) },
+        NULL,
+        NULL,
+        0, /* Use the default (digest size) */
+        { rfc5869_003_output, 32 }
+    }
+};
+
 int main(int argc, char* argv[])
 {
     guint i;
@@ -223,6 +329,9 @@ int main(int argc, char* argv[])
     for (i = 0; i < G_N_ELEMENTS(tests); i++) {
         g_test_add_data_func(tests[i].name, tests + i, test_kdf);
     }
+    for (i = 0; i < G_N_ELEMENTS(hkdf_tests); i++) {
+        g_test_add_data_func(hkdf_tests[i].name, hkdf_tests + i, test_hkdf);
+    }
     return test_run();
 }
 
@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+
+#include "foil_key.h"
+#include "foil_key_ed25519.h"
+#include "foil_output.h"
+#include "foil_private_key.h"
+#include "foil_util.h"
+
+#define DATA_DIR "data/"
+
+/* RFC 8032, section 7.1, TEST 1 */
+static const char test_rfc8032_seed[] =
+    "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60";
+static const char test_rfc8032_pub[] =
+    "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a";
+static const char test_rfc8032_sig[] =
+    "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555f"
+    "b8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b";
+
+/* ssh-keygen -l -E md5 -f openssh.pub */
+static const char test_openssh_fingerprint[] =
+    "10:43:09:83:69:93:6a:1f:1e:f6:97:f2:30:7d:60:b0";
+
+static
+FoilPrivateKey*
+test_private_key(
+    const char* name)
+{
+    char* path = g_strconcat(DATA_DIR, name, NULL);
+    FoilPrivateKey* key = foil_private_key_new_from_file
+        (FOIL_KEY_ED25519_PRIVATE, path);
+
+    g_assert(FOIL_IS_KEY_ED25519_PRIVATE(key));
+    g_free(path);
+    return key;
+}
+
+static
+FoilKey*
+test_public_key(
+    const char* name)
+{
+    char* path = g_strconcat(DATA_DIR, name, NULL);
+    FoilKey* key = foil_key_new_from_file(FOIL_KEY_ED25519_PUBLIC, path);
+
+    g_assert(FOIL_IS_KEY_ED25519_PUBLIC(key));
+    g_free(path);
+    return key;
+}
+
+static
+void
+test_key_ed25519_null(
+    void)
+{
+    static const guint8 sig[FOIL_ED25519_SIGNATURE_SIZE] = { 0 };
+    FoilBytes bytes;
+    FoilKey* pub = test_public_key("rfc8032.pub");
+
+    bytes.val = sig;
+    bytes.len = sizeof(sig);
+    g_assert(!foil_ed25519_sign(NULL, 0, NULL));
+    g_assert(!foil_ed25519_verify(NULL, 0, NULL, NULL));
+    g_assert(!foil_ed25519_verify(NULL, 0, &bytes, NULL));
+    g_assert(!foil_ed25519_verify(NULL, 0, NULL, pub));
+
+    /* Wrong signature size */
+    bytes.len--;
+    g_assert(!foil_ed25519_verify(NULL, 0, &bytes, pub));
+    foil_key_unref(pub);
+}
+
+static
+void
+test_key_ed25519_generate(
+    void)
+{
+    FoilKey* key1;
+    FoilKey* key2;
+    FoilKey* pub1;
+    FoilKey* pub2;
+    FoilBytes sig_bytes;
+    GBytes* bytes;
+    GBytes* sig;
+
+    /* It doesn't make sense to generate public keys */
+    g_assert(!foil_key_generate_new(FOIL_KEY_ED25519_PUBLIC, 0));
+
+    /* Ed25519 keys are always 256 bits long */
+    g_assert(!foil_key_generate_new(FOIL_KEY_ED25519_PRIVATE, 1024));
+
+    key1 = foil_key_generate_new(FOIL_KEY_ED25519_PRIVATE,
+        FOIL_KEY_BITS_DEFAULT);
+    key2 = foil_key_generate_new(FOIL_KEY_ED25519_PRIVATE,
+        FOIL_ED25519_KEY_BITS);
+    g_assert(FOIL_IS_KEY_ED25519_PRIVATE(key1));
+    g_assert(FOIL_IS_KEY_ED25519_PRIVATE(key2));
+    g_assert(!foil_key_equal(key1, key2));
+
+    pub1 = foil_public_key_new_from_private(FOIL_PRIVATE_KEY(key1));
+    pub2 = foil_public_key_new_from_private(FOIL_PRIVATE_KEY(key2));
+    g_assert(FOIL_IS_KEY_ED25519_PUBLIC(pub1));
+    g_assert(FOIL_IS_KEY_ED25519_PUBLIC(pub2));
+    g_assert(!foil_key_equal(pub1, pub2));
+
+    /* Signed by one, verified by the other */
+    sig = foil_ed25519_sign(TEST_ARRAY_AND_SIZE(test_rfc8032_pub),
+        FOIL_PRIVATE_KEY(key1));
+    g_assert(sig);
+    g_assert_cmpuint(g_bytes_get_size(sig), == ,FOIL_ED25519_SIGNATURE_SIZE);
+    g_assert(foil_ed25519_verify(TEST_ARRAY_AND_SIZE(test_rfc8032_pub),
+        foil_bytes_from_data(&sig_bytes, sig), pub1));
+    g_assert(!foil_ed25519_verify(TEST_ARRAY_AND_SIZE(test_rfc8032_pub),
+        foil_bytes_from_data(&sig_bytes, sig), pub2));
+    g_bytes_unref(sig);
+
+    foil_key_unref(pub1);
+    foil_key_unref(pub2);
+    foil_key_unref(key2);
+
+    /* Make sure it can be converted to bytes and back */
+    bytes = foil_key_to_bytes(key1);
+    key2 = foil_key_new_from_bytes(FOIL_KEY_ED25519_PRIVATE, bytes);
+    g_bytes_unref(bytes);
+    g_assert(FOIL_IS_KEY_ED25519_PRIVATE(key2));
+    g_assert(foil_key_equal(key1, key2));
+    foil_key_unref(key2);
+
+    /* And the OpenSSH format too */
+    bytes = foil_key_to_binary_format(key1, FOIL_KEY_BINARY_FORMAT_OPENSSH);
+    key2 = foil_key_new_from_bytes(FOIL_KEY_ED25519_PRIVATE, bytes);
+    g_bytes_unref(bytes);
+    g_assert(FOIL_IS_KEY_ED25519_PRIVATE(key2));
+    g_assert(foil_key_equal(key1, key2));
+    foil_key_unref(key2);
+
+    foil_key_unref(key1);
+}
+
+static
+void
+test_key_ed25519_rfc8032(
+    void)
+{
+    GBytes* seed = test_hex_to_bytes(test_rfc8032_seed);
+    GBytes* pub_bytes = test_hex_to_bytes(test_rfc8032_pub);
+    GBytes* expect = test_hex_to_bytes(test_rfc8032_sig);
+    FoilPrivateKey* priv = test_private_key("rfc8032");
+    FoilPrivateKey* priv2 = foil_private_key_new_from_bytes
+        (FOIL_KEY_ED25519_PRIVATE, seed);
+    FoilKey* pub = test_public_key("rfc8032.pub");
+    FoilKey* pub2 = foil_key_new_from_bytes(FOIL_KEY_ED25519_PUBLIC,
+        pub_bytes);
+    FoilKey* pub3 = foil_public_key_new_from_private(priv);
+    GBytes* sig = foil_ed25519_sign(NULL, 0, priv);
+    guint8 bad[FOIL_ED25519_SIGNATURE_SIZE];
+    FoilBytes sig_bytes;
+
+    /* The raw seed and public key are accepted too */
+    g_assert(foil_private_key_equal(priv, priv2));
+    g_assert(foil_key_equal(pub, pub2));
+    g_assert(foil_key_equal(pub, pub3));
+
+    /* Ed25519 signatures are deterministic */
+    g_assert(sig);
+    TEST_DEBUG_HEXDUMP_BYTES(sig);
+    g_assert(g_bytes_equal(sig, expect));
+    g_assert(foil_ed25519_verify(NULL, 0, foil_bytes_from_data(&sig_bytes,
+        sig), pub));
+
+    /* Damaged signature */
+    memcpy(bad, sig_bytes.val, sizeof(bad));
+    bad[0] ^= 0x01;
+    sig_bytes.val = bad;
+    g_assert(!foil_ed25519_verify(NULL, 0, &sig_bytes, pub));
+
+    g_bytes_unref(sig);
+    g_bytes_unref(expect);
+    g_bytes_unref(pub_bytes);
+    g_bytes_unref(seed);
+    foil_key_unref(pub);
+    foil_key_unref(pub2);
+    foil_key_unref(pub3);
+    foil_private_key_unref(priv);
+    foil_private_key_unref(priv2);
+}
+
+static
+void
+test_key_ed25519_openssh(
+    void)
+{
+    FoilPrivateKey* priv = test_private_key("openssh");
+    FoilKey* pub = foil_public_key_new_from_private(priv);
+    FoilKey* pub1 = test_public_key("openssh.pub");
+    FoilKey* pub2 = test_public_key("openssh.RFC4716");
+    GBytes* expect = test_hex_to_bytes(test_openssh_fingerprint);
+
+    g_assert(foil_key_equal(pub, pub1));
+    g_assert(foil_key_equal(pub, pub2));
+    g_assert(g_bytes_equal(foil_private_key_fingerprint(priv), expect));
+    g_assert(g_bytes_equal(foil_key_fingerprint(pub), expect));
+
+    g_bytes_unref(expect);
+    foil_key_unref(pub);
+    foil_key_unref(pub1);
+    foil_key_unref(pub2);
+    foil_private_key_unref(priv);
+}
+
+static
+void
+test_key_ed25519_encrypted(
+    void)
+{
+    const char* path = DATA_DIR "encrypted";
+    FoilPrivateKey* priv = test_private_key("openssh");
+    GError* error = NULL;
+
+    g_assert(!foil_private_key_decrypt_from_file(FOIL_KEY_ED25519_PRIVATE,
+        path, NULL, &error));
+    g_assert_error(error, FOIL_ERROR, FOIL_ERROR_KEY_ENCRYPTED);
+    g_clear_error(&error);
+
+    /* Encrypted Ed25519 keys aren't supported */
+    g_assert(!foil_private_key_decrypt_from_file(FOIL_KEY_ED25519_PRIVATE,
+        path, "secret", &error));
+    g_assert_error(error, FOIL_ERROR, FOIL_ERROR_KEY_UNKNOWN_ENCRYPTION);
+    g_clear_error(&error);
+
+    g_assert(!foil_private_key_encrypt_to_string(priv,
+        FOIL_KEY_EXPORT_FORMAT_DEFAULT, "secret", NULL));
+    foil_private_key_unref(priv);
+}
+
+static
+void
+test_key_ed25519_private_export(
+    gconstpointer param)
+{
+    const FoilKeyExportFormat format = GPOINTER_TO_INT(param);
+    FoilPrivateKey* priv = test_private_key("openssh");
+    FoilPrivateKey* priv2;
+    char* str = foil_private_key_to_string(priv, format, NULL);
+
+    g_assert(str);
+    GDEBUG("\n%s", str);
+    priv2 = foil_private_key_new_from_string(FOIL_KEY_ED25519_PRIVATE, str);
+    g_assert(priv2);
+    g_assert(foil_private_key_equal(priv, priv2));
+
+    g_free(str);
+    foil_private_key_unref(priv);
+    foil_private_key_unref(priv2);
+}
+
+static
+void
+test_key_ed25519_public_export(
+    gconstpointer param)
+{
+    const FoilKeyExportFormat format = GPOINTER_TO_INT(param);
+    FoilKey* pub = test_public_key("openssh.pub");
+    FoilKey* pub2;
+    char* str = foil_key_to_string(pub, format, "foil test");
+
+    g_assert(str);
+    GDEBUG("\n%s", str);
+    pub2 = foil_key_new_from_string(FOIL_KEY_ED25519_PUBLIC, str);
+    g_assert(pub2);
+    g_assert(foil_key_equal(pub, pub2));
+
+    g_free(str);
+    foil_key_unref(pub);
+    foil_key_unref(pub2);
+}
+
+#define TEST_(name) "/key_ed25519/" name
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_key_ed25519_null);
+    g_test_add_func(TEST_("generate"), test_key_ed25519_generate);
+    g_test_add_func(TEST_("rfc8032"), test_key_ed25519_rfc8032);
+    g_test_add_func(TEST_("openssh"), test_key_ed25519_openssh);
+    g_test_add_func(TEST_("encrypted"), test_key_ed25519_encrypted);
+    g_test_add_data_func(TEST_("private-export-default"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_DEFAULT),
+        test_key_ed25519_private_export);
+    g_test_add_data_func(TEST_("private-export-pkcs8"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_PKCS8),
+        test_key_ed25519_private_export);
+    g_test_add_data_func(TEST_("private-export-openssh"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_OPENSSH),
+        test_key_ed25519_private_export);
+    g_test_add_data_func(TEST_("public-export-default"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_DEFAULT),
+        test_key_ed25519_public_export);
+    g_test_add_data_func(TEST_("public-export-rfc4716"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_RFC4716),
+        test_key_ed25519_public_export);
+    g_test_add_data_func(TEST_("public-export-pkcs8"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_PKCS8),
+        test_key_ed25519_public_export);
+    return test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
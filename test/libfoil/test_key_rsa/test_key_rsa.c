@@ -32,10 +32,14 @@
 
 #include "test_common.h"
 
+#include "foil_cipher.h"
 #include "foil_key.h"
+#include "foil_keyring.h"
 #include "foil_digest.h"
 #include "foil_output.h"
 #include "foil_private_key.h"
+#include "foil_sign.h"
+#include "foil_util.h"
 
 #include "foil_key_rsa_private.h"
 #include "foil_key_rsa_public.h"
@@ -372,6 +376,201 @@ test_key_rsa_generate(
     foil_key_unref(key2);
 }
 
+static
+void
+test_key_rsa_check_ops(
+    FoilPrivateKey* priv)
+{
+    static const guint8 data[] = { 'M','u','l','t','i','-','p','r','i','m','e' };
+    FoilKey* pub = foil_public_key_new_from_private(priv);
+    GBytes* in = g_bytes_new_static(data, sizeof(data));
+    GBytes* enc = foil_cipher_bytes(FOIL_CIPHER_RSA_ENCRYPT, pub, in);
+    GBytes* dec = foil_cipher_bytes(FOIL_CIPHER_RSA_DECRYPT, FOIL_KEY(priv),
+        enc);
+    FoilBytes bytes;
+    GBytes* sig;
+
+    /* Private key operations go through all the primes */
+    g_assert(dec);
+    g_assert(g_bytes_equal(in, dec));
+    foil_bytes_from_data(&bytes, in);
+    sig = foil_rsa_sign(&bytes, FOIL_DIGEST_SHA256, priv);
+    g_assert(sig);
+    g_assert(foil_rsa_verify(&bytes, foil_bytes_from_data(&bytes, sig),
+        FOIL_DIGEST_SHA256, pub));
+
+    g_bytes_unref(sig);
+    g_bytes_unref(dec);
+    g_bytes_unref(enc);
+    g_bytes_unref(in);
+    foil_key_unref(pub);
+}
+
+static
+void
+test_key_rsa_generate_primes(
+    void)
+{
+    GHashTable* params = g_hash_table_new_full(g_str_hash, g_str_equal,
+        NULL, (GDestroyNotify) g_variant_unref);
+    FoilKeyRsaPrivate* rsa;
+    FoilKey* key;
+    FoilKey* key2;
+    GBytes* bytes;
+
+    /* Public keys can't be generated with or without parameters */
+    g_assert(!foil_key_generate_new_full(FOIL_KEY_RSA_PUBLIC, 1024, NULL));
+    g_assert(!foil_key_generate_new_full(FOIL_KEY_RSA_PUBLIC, 1024, params));
+
+    /* Keys that don't take any parameters ignore them */
+    key = foil_key_generate_new_full(FOIL_KEY_AES128, 0, params);
+    g_assert(key);
+    foil_key_unref(key);
+
+    /* No parameters => two primes */
+    key = foil_key_generate_new_full(FOIL_KEY_RSA_PRIVATE, 1024, NULL);
+    g_assert(FOIL_IS_KEY_RSA_PRIVATE(key));
+    g_assert(!FOIL_KEY_RSA_PRIVATE_(key)->data->other_primes.len);
+    foil_key_unref(key);
+
+    /* Invalid number of primes */
+    g_hash_table_insert(params, FOIL_KEY_PARAM_PRIMES,
+        g_variant_ref_sink(g_variant_new_uint32(1)));
+    g_assert(!foil_key_generate_new_full(FOIL_KEY_RSA_PRIVATE, 1024, params));
+
+    /* Too many primes for this key size */
+    g_hash_table_insert(params, FOIL_KEY_PARAM_PRIMES,
+        g_variant_ref_sink(g_variant_new_uint32(5)));
+    g_assert(!foil_key_generate_new_full(FOIL_KEY_RSA_PRIVATE, 1024, params));
+
+    /* Three primes */
+    g_hash_table_insert(params, FOIL_KEY_PARAM_PRIMES,
+        g_variant_ref_sink(g_variant_new_uint32(3)));
+    key = foil_key_generate_new_full(FOIL_KEY_RSA_PRIVATE, 1024, params);
+    g_assert(FOIL_IS_KEY_RSA_PRIVATE(key));
+    rsa = FOIL_KEY_RSA_PRIVATE_(key);
+    g_assert(rsa->data->other_primes.len);
+    test_key_rsa_check_ops(FOIL_PRIVATE_KEY(key));
+
+    /* PKCS #1 round trip preserves the extra prime */
+    bytes = foil_key_to_bytes(key);
+    key2 = foil_key_new_from_bytes(FOIL_KEY_RSA_PRIVATE, bytes);
+    g_assert(key2);
+    g_assert(foil_key_equal(key, key2));
+    test_key_rsa_check_ops(FOIL_PRIVATE_KEY(key2));
+    foil_key_unref(key2);
+    g_bytes_unref(bytes);
+
+    /* OpenSSH format can't store it */
+    g_assert(!foil_key_to_binary_format(key, FOIL_KEY_BINARY_FORMAT_OPENSSH));
+
+    foil_key_unref(key);
+    g_hash_table_destroy(params);
+}
+
+static
+void
+test_key_rsa_multi_prime(
+    void)
+{
+    const char* file = DATA_DIR "rsa-1024-3";
+    FoilPrivateKey* priv = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, file);
+    FoilKey* pub = foil_key_new_from_file(FOIL_KEY_RSA_PUBLIC,
+        DATA_DIR "rsa-1024-3.pub");
+    FoilKey* pub2 = foil_public_key_new_from_private(priv);
+    FoilOutput* out = foil_output_mem_new(NULL);
+    GError* error = NULL;
+    gchar* contents = NULL;
+    gsize length = 0;
+    GBytes* bytes;
+    GBytes* bin;
+
+    g_assert(priv);
+    g_assert(foil_key_equal(pub, pub2));
+    test_key_rsa_check_ops(priv);
+
+    /* Export reproduces the OpenSSL output byte to byte */
+    g_assert(g_file_get_contents(DATA_DIR "rsa-1024-3.bin", &contents,
+        &length, NULL));
+    bin = g_bytes_new_take(contents, length);
+    bytes = foil_key_to_bytes(FOIL_KEY(priv));
+    g_assert(g_bytes_equal(bytes, bin));
+    g_bytes_unref(bytes);
+    g_bytes_unref(bin);
+
+    /* But not in OpenSSH format */
+    g_assert(!foil_private_key_export_full(priv, out,
+        FOIL_KEY_EXPORT_FORMAT_OPENSSH, NULL, &error));
+    g_assert(error->domain == FOIL_ERROR);
+    g_assert(error->code == FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT);
+    g_clear_error(&error);
+
+    foil_output_unref(out);
+    foil_key_unref(pub);
+    foil_key_unref(pub2);
+    foil_private_key_unref(priv);
+}
+
+static
+void
+test_key_rsa_keyring(
+    void)
+{
+    FoilKeyring* keyring = foil_keyring_new();
+    FoilPrivateKey* priv1 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-768");
+    FoilPrivateKey* priv2 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-1024");
+    FoilPrivateKey* priv3 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-768.1");
+    FoilPrivateKey* found;
+    FoilBytes fp1, fp2;
+
+    foil_bytes_from_data(&fp1, foil_private_key_fingerprint(priv1));
+    foil_bytes_from_data(&fp2, foil_private_key_fingerprint(priv2));
+
+    g_assert(!foil_keyring_ref(NULL));
+    foil_keyring_unref(NULL);
+    g_assert(!foil_keyring_count(NULL));
+    g_assert(!foil_keyring_add(NULL, priv1));
+    g_assert(!foil_keyring_add(keyring, NULL));
+    g_assert(!foil_keyring_remove(NULL, &fp1));
+    g_assert(!foil_keyring_remove(keyring, NULL));
+    g_assert(!foil_keyring_find(NULL, &fp1));
+    g_assert(!foil_keyring_find(keyring, NULL));
+
+    g_assert(!foil_keyring_find(keyring, &fp1));
+    g_assert(foil_keyring_add(keyring, priv1));
+    g_assert(foil_keyring_add(keyring, priv2));
+    g_assert_cmpuint(foil_keyring_count(keyring), == ,2);
+
+    /* Same key loaded from a different file has the same fingerprint */
+    g_assert(!foil_keyring_add(keyring, priv3));
+    g_assert_cmpuint(foil_keyring_count(keyring), == ,2);
+
+    found = foil_keyring_find(keyring, &fp1);
+    g_assert(found == priv1);
+    foil_private_key_unref(found);
+    found = foil_keyring_find(keyring, &fp2);
+    g_assert(found == priv2);
+
+    /* The reference returned by foil_keyring_find survives removal */
+    g_assert(foil_keyring_remove(keyring, &fp2));
+    g_assert(!foil_keyring_remove(keyring, &fp2));
+    g_assert(!foil_keyring_find(keyring, &fp2));
+    g_assert_cmpuint(foil_keyring_count(keyring), == ,1);
+    g_assert(foil_private_key_equal(found, priv2));
+    foil_private_key_unref(found);
+
+    g_assert(foil_keyring_ref(keyring) == keyring);
+    foil_keyring_unref(keyring);
+    foil_keyring_unref(keyring);
+    foil_private_key_unref(priv1);
+    foil_private_key_unref(priv2);
+    foil_private_key_unref(priv3);
+}
+
 static
 void
 test_key_rsa_fingerprint(
@@ -1050,6 +1249,7 @@ static const TestKeyRsa tests[] = {
     TEST_READ_OK(private,  "rsa-1024" ),
     TEST_READ_OK(private,  "rsa-1500" ),
     TEST_READ_OK(private,  "rsa-2048" ),
+    TEST_READ_OK(private,  "rsa-1024-3" ),
     TEST_READ_OK3(private, "rsa-768", ".1" ),
     TEST_READ_OK(private,  "openssh-1024" ),
     TEST_READ_OK(private,  "openssh-1500" ),
@@ -1128,11 +1328,14 @@ static const TestKeyRsa tests[] = {
     TEST_FINGERPRINT("rsa-1024" ),
     TEST_FINGERPRINT("rsa-1500" ),
     TEST_FINGERPRINT("rsa-2048" ),
+    TEST_FINGERPRINT("rsa-1024-3" ),
     /* Fingerprint values are produced by e.g. ssh-key -lf data/rsa-768 */
     TEST_FPVAL("rsa-768", "9a:76:f1:62:d8:7c:81:2d:03:f6:f0:6b:9a:1f:d1:69"),
     TEST_FPVAL("rsa-1024", "9b:f5:c4:eb:c2:f0:a0:2b:de:f6:37:63:f6:0c:30:2c"),
     TEST_FPVAL("rsa-1500", "a7:fc:53:56:e3:d2:7e:f1:02:14:5c:69:ad:aa:6b:43"),
     TEST_FPVAL("rsa-2048", "93:2f:fe:5d:87:0e:d6:fd:1f:aa:f9:41:af:e0:26:3f"),
+    TEST_FPVAL("rsa-1024-3",
+        "b8:b6:3a:b2:ac:52:fb:fe:d8:43:48:c4:db:22:04:50"),
     TEST_FPVAL("openssh-1024",
         "be:e9:dc:ae:f9:0a:81:f0:1c:e4:21:40:eb:d5:9c:43"),
     TEST_FPVAL("openssh-1500",
@@ -1145,10 +1348,12 @@ static const TestKeyRsa tests[] = {
     TEST_CONVERT("rsa-1024" ),
     TEST_CONVERT("rsa-1500" ),
     TEST_CONVERT("rsa-2048" ),
+    TEST_CONVERT("rsa-1024-3" ),
     TEST_PRIVATE_EXPORT("rsa-768", "pkcs1", DEFAULT ),
     TEST_PRIVATE_EXPORT("rsa-1024", "pkcs1", DEFAULT ),
     TEST_PRIVATE_EXPORT("rsa-1500", "pkcs1", DEFAULT ),
     TEST_PRIVATE_EXPORT("rsa-2048", "pkcs1", DEFAULT ),
+    TEST_PRIVATE_EXPORT("rsa-1024-3", "pkcs1", DEFAULT ),
     TEST_PRIVATE_EXPORT("openssh-1024", "openssh", OPENSSH ),
     TEST_PRIVATE_EXPORT("openssh-1500", "openssh", OPENSSH ),
     TEST_PRIVATE_EXPORT("openssh-2048", "openssh", OPENSSH ),
@@ -1157,10 +1362,12 @@ static const TestKeyRsa tests[] = {
     TEST_PRIVATE_BYTES("rsa-1024", "pkcs1", RSA_PKCS1 ),
     TEST_PRIVATE_BYTES("rsa-1500", "pkcs1", RSA_PKCS1 ),
     TEST_PRIVATE_BYTES("rsa-2048", "pkcs1", RSA_PKCS1 ),
+    TEST_PRIVATE_BYTES("rsa-1024-3", "pkcs1", RSA_PKCS1 ),
     TEST_PRIVATE_BYTES("rsa-768", "default", DEFAULT ),
     TEST_PRIVATE_BYTES("rsa-1024", "default", DEFAULT ),
     TEST_PRIVATE_BYTES("rsa-1500", "default", DEFAULT ),
     TEST_PRIVATE_BYTES("rsa-2048", "default", DEFAULT ),
+    TEST_PRIVATE_BYTES("rsa-1024-3", "default", DEFAULT ),
     TEST_PRIVATE_BYTES("openssh-1024", "openssh", OPENSSH ),
     TEST_PRIVATE_BYTES("openssh-1500", "openssh", OPENSSH ),
     TEST_PRIVATE_BYTES("openssh-2048", "openssh", OPENSSH ),
@@ -1173,10 +1380,12 @@ static const TestKeyRsa tests[] = {
     TEST_PRIVATE_ENCRYPT("rsa-1024", "pkcs1", DEFAULT ),
     TEST_PRIVATE_ENCRYPT("rsa-1500", "pkcs1", DEFAULT ),
     TEST_PRIVATE_ENCRYPT("rsa-2048", "pkcs1", DEFAULT ),
+    TEST_PRIVATE_ENCRYPT("rsa-1024-3", "pkcs1", DEFAULT ),
     TEST_BYTES("rsa-768"  ),
     TEST_BYTES("rsa-1024" ),
     TEST_BYTES("rsa-1500" ),
     TEST_BYTES("rsa-2048" ),
+    TEST_BYTES("rsa-1024-3" ),
     TEST_PUBLIC_HEX("rsa-768", "000000077373682d7273610000000301"
 "00010000006100c3e8b4fdda80200a526f0cba34467f592c17f9766ae303de88"
 "3b45de47d5fdd0dffbb0cadbc3cc1f936efedb59e1c5c05a78679f8605c55fe6"
@@ -1391,6 +1600,11 @@ static const TestKeyRsa tests[] = {
     TEST_READ_ERR(private, "bad.038"), /* openssh: bad cipername */
     TEST_READ_ERR(private, "bad.039"), /* openssh: broken private part mark */
     TEST_READ_ERR(private, "bad.040"), /* openssh: broken padding */
+    TEST_READ_ERR(private, "bad.041"), /* version 1 without otherPrimeInfos */
+    TEST_READ_ERR(private, "bad.042"), /* version 0 with otherPrimeInfos */
+    TEST_READ_ERR(private, "bad.043"), /* empty otherPrimeInfos */
+    TEST_READ_ERR(private, "bad.044"), /* otherPrimeInfo without ti */
+    TEST_READ_ERR(private, "bad.045"), /* garbage in otherPrimeInfos */
     TEST_READ_ERR(private, "missing")
 };
 
@@ -1402,6 +1616,9 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("uninitialized"), test_key_rsa_uninitialized);
     g_test_add_func(TEST_("invalid_params"), test_key_rsa_invalid_params);
     g_test_add_func(TEST_("generate"), test_key_rsa_generate);
+    g_test_add_func(TEST_("generate_primes"), test_key_rsa_generate_primes);
+    g_test_add_func(TEST_("multi_prime"), test_key_rsa_multi_prime);
+    g_test_add_func(TEST_("keyring"), test_key_rsa_keyring);
     for (i = 0; i < G_N_ELEMENTS(tests); i++) {
         g_test_add_data_func(tests[i].name, tests + i, tests[i].fn);
     }
@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+
+#include "foil_key.h"
+#include "foil_key_x25519.h"
+#include "foil_output.h"
+#include "foil_private_key.h"
+#include "foil_util.h"
+
+#define DATA_DIR "data/"
+
+/* RFC 7748, section 6.1 */
+static const char test_alice_priv[] =
+    "77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a";
+static const char test_alice_pub[] =
+    "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a";
+static const char test_bob_pub[] =
+    "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f";
+static const char test_shared_secret[] =
+    "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742";
+
+/* openssl pkey -pubin -in bob.pub -outform DER | md5sum */
+static const char test_bob_fingerprint[] =
+    "bb:d0:fe:98:10:30:62:a2:12:b8:52:93:fe:18:1e:2f";
+
+static
+FoilPrivateKey*
+test_private_key(
+    const char* name)
+{
+    char* path = g_strconcat(DATA_DIR, name, NULL);
+    FoilPrivateKey* key = foil_private_key_new_from_file
+        (FOIL_KEY_X25519_PRIVATE, path);
+
+    g_assert(FOIL_IS_KEY_X25519_PRIVATE(key));
+    g_free(path);
+    return key;
+}
+
+static
+FoilKey*
+test_public_key(
+    const char* name)
+{
+    char* path = g_strconcat(DATA_DIR, name, NULL);
+    FoilKey* key = foil_key_new_from_file(FOIL_KEY_X25519_PUBLIC, path);
+
+    g_assert(FOIL_IS_KEY_X25519_PUBLIC(key));
+    g_free(path);
+    return key;
+}
+
+static
+void
+test_key_x25519_null(
+    void)
+{
+    static const guint8 zero[FOIL_X25519_KEY_SIZE] = { 0 };
+    FoilPrivateKey* priv = test_private_key("alice");
+    FoilKey* pub = test_public_key("bob.pub");
+    FoilKey* low_order = foil_key_new_from_data(FOIL_KEY_X25519_PUBLIC,
+        zero, sizeof(zero));
+
+    g_assert(!foil_x25519_derive(NULL, NULL));
+    g_assert(!foil_x25519_derive(priv, NULL));
+    g_assert(!foil_x25519_derive(NULL, pub));
+    g_assert(!foil_x25519_public_bytes(NULL));
+
+    /* Private key is not a valid peer */
+    g_assert(!foil_x25519_derive(priv, FOIL_KEY(priv)));
+
+    /* Low order point gives all-zero shared secret */
+    g_assert(low_order);
+    g_assert(!foil_x25519_derive(priv, low_order));
+
+    foil_key_unref(low_order);
+    foil_key_unref(pub);
+    foil_private_key_unref(priv);
+}
+
+static
+void
+test_key_x25519_generate(
+    void)
+{
+    FoilKey* key1;
+    FoilKey* key2;
+    FoilKey* pub1;
+    FoilKey* pub2;
+    GBytes* secret1;
+    GBytes* secret2;
+    GBytes* bytes;
+
+    /* It doesn't make sense to generate public keys */
+    g_assert(!foil_key_generate_new(FOIL_KEY_X25519_PUBLIC, 0));
+
+    /* X25519 keys are always 256 bits long */
+    g_assert(!foil_key_generate_new(FOIL_KEY_X25519_PRIVATE, 1024));
+
+    key1 = foil_key_generate_new(FOIL_KEY_X25519_PRIVATE,
+        FOIL_KEY_BITS_DEFAULT);
+    key2 = foil_key_generate_new(FOIL_KEY_X25519_PRIVATE,
+        FOIL_X25519_KEY_BITS);
+    g_assert(FOIL_IS_KEY_X25519_PRIVATE(key1));
+    g_assert(FOIL_IS_KEY_X25519_PRIVATE(key2));
+    g_assert(!foil_key_equal(key1, key2));
+
+    pub1 = foil_public_key_new_from_private(FOIL_PRIVATE_KEY(key1));
+    pub2 = foil_public_key_new_from_private(FOIL_PRIVATE_KEY(key2));
+    g_assert(FOIL_IS_KEY_X25519_PUBLIC(pub1));
+    g_assert(FOIL_IS_KEY_X25519_PUBLIC(pub2));
+    g_assert(!foil_key_equal(pub1, pub2));
+    g_assert(g_bytes_equal(foil_key_fingerprint(key1),
+        foil_key_fingerprint(pub1)));
+
+    /* Both sides get the same secret */
+    secret1 = foil_x25519_derive(FOIL_PRIVATE_KEY(key1), pub2);
+    secret2 = foil_x25519_derive(FOIL_PRIVATE_KEY(key2), pub1);
+    g_assert(secret1);
+    g_assert(secret2);
+    g_assert_cmpuint(g_bytes_get_size(secret1), == ,FOIL_X25519_KEY_SIZE);
+    g_assert(g_bytes_equal(secret1, secret2));
+    g_bytes_unref(secret1);
+    g_bytes_unref(secret2);
+
+    foil_key_unref(pub1);
+    foil_key_unref(pub2);
+    foil_key_unref(key2);
+
+    /* Make sure it can be converted to bytes and back */
+    bytes = foil_key_to_bytes(key1);
+    key2 = foil_key_new_from_bytes(FOIL_KEY_X25519_PRIVATE, bytes);
+    g_bytes_unref(bytes);
+    g_assert(FOIL_IS_KEY_X25519_PRIVATE(key2));
+    g_assert(foil_key_equal(key1, key2));
+    foil_key_unref(key2);
+
+    foil_key_unref(key1);
+}
+
+static
+void
+test_key_x25519_rfc7748(
+    void)
+{
+    GBytes* priv_bytes = test_hex_to_bytes(test_alice_priv);
+    GBytes* pub_bytes = test_hex_to_bytes(test_alice_pub);
+    GBytes* bob_bytes = test_hex_to_bytes(test_bob_pub);
+    GBytes* expect = test_hex_to_bytes(test_shared_secret);
+    FoilPrivateKey* alice = test_private_key("alice");
+    FoilPrivateKey* bob = test_private_key("bob");
+    FoilPrivateKey* alice2 = foil_private_key_new_from_bytes
+        (FOIL_KEY_X25519_PRIVATE, priv_bytes);
+    FoilKey* alice_pub = test_public_key("alice.pub");
+    FoilKey* alice_pub2 = foil_public_key_new_from_private(alice);
+    FoilKey* bob_pub = foil_key_new_from_bytes(FOIL_KEY_X25519_PUBLIC,
+        bob_bytes);
+    GBytes* secret1 = foil_x25519_derive(alice, bob_pub);
+    GBytes* secret2 = foil_x25519_derive(bob, alice_pub);
+    GBytes* bytes;
+
+    /* The raw keys are accepted too */
+    g_assert(foil_private_key_equal(alice, alice2));
+    g_assert(foil_key_equal(alice_pub, alice_pub2));
+
+    bytes = foil_x25519_public_bytes(FOIL_KEY(alice));
+    g_assert(g_bytes_equal(bytes, pub_bytes));
+    g_bytes_unref(bytes);
+    bytes = foil_x25519_public_bytes(alice_pub);
+    g_assert(g_bytes_equal(bytes, pub_bytes));
+    g_bytes_unref(bytes);
+
+    g_assert(secret1);
+    g_assert(secret2);
+    TEST_DEBUG_HEXDUMP_BYTES(secret1);
+    g_assert(g_bytes_equal(secret1, expect));
+    g_assert(g_bytes_equal(secret2, expect));
+
+    g_bytes_unref(secret1);
+    g_bytes_unref(secret2);
+    g_bytes_unref(expect);
+    g_bytes_unref(bob_bytes);
+    g_bytes_unref(pub_bytes);
+    g_bytes_unref(priv_bytes);
+    foil_key_unref(alice_pub);
+    foil_key_unref(alice_pub2);
+    foil_key_unref(bob_pub);
+    foil_private_key_unref(alice);
+    foil_private_key_unref(alice2);
+    foil_private_key_unref(bob);
+}
+
+static
+void
+test_key_x25519_fingerprint(
+    void)
+{
+    FoilPrivateKey* priv = test_private_key("bob");
+    FoilKey* pub = test_public_key("bob.pub");
+    GBytes* expect = test_hex_to_bytes(test_bob_fingerprint);
+
+    g_assert(g_bytes_equal(foil_private_key_fingerprint(priv), expect));
+    g_assert(g_bytes_equal(foil_key_fingerprint(pub), expect));
+
+    g_bytes_unref(expect);
+    foil_key_unref(pub);
+    foil_private_key_unref(priv);
+}
+
+static
+void
+test_key_x25519_unsupported(
+    void)
+{
+    FoilPrivateKey* priv = test_private_key("alice");
+    FoilKey* pub = test_public_key("alice.pub");
+    GError* error = NULL;
+
+    /* Encrypted X25519 keys aren't supported */
+    g_assert(!foil_private_key_encrypt_to_string(priv,
+        FOIL_KEY_EXPORT_FORMAT_DEFAULT, "secret", NULL));
+
+    /* Neither are SSH formats */
+    g_assert(!foil_private_key_to_string(priv,
+        FOIL_KEY_EXPORT_FORMAT_OPENSSH, NULL));
+    g_assert(!foil_key_to_string(pub, FOIL_KEY_EXPORT_FORMAT_RFC4716,
+        NULL));
+
+    /* Ed25519 key is not an X25519 key */
+    g_assert(!foil_key_new_from_string_full(FOIL_KEY_X25519_PUBLIC,
+        "-----BEGIN PUBLIC KEY-----\n"
+        "MCowBQYDK2VwAyEA11qYAYKxCrfVS/7TyWQHOg7hcvPapiMlrwIaaPcHURo=\n"
+        "-----END PUBLIC KEY-----\n", NULL, &error));
+    g_assert_error(error, FOIL_ERROR, FOIL_ERROR_KEY_UNRECOGNIZED_FORMAT);
+    g_clear_error(&error);
+
+    foil_key_unref(pub);
+    foil_private_key_unref(priv);
+}
+
+static
+void
+test_key_x25519_private_export(
+    gconstpointer param)
+{
+    const FoilKeyExportFormat format = GPOINTER_TO_INT(param);
+    FoilPrivateKey* priv = test_private_key("alice");
+    FoilPrivateKey* priv2;
+    char* str = foil_private_key_to_string(priv, format, NULL);
+    gchar* contents = NULL;
+
+    g_assert(str);
+    GDEBUG("\n%s", str);
+    priv2 = foil_private_key_new_from_string(FOIL_KEY_X25519_PRIVATE, str);
+    g_assert(priv2);
+    g_assert(foil_private_key_equal(priv, priv2));
+
+    /* Matches what OpenSSL produces */
+    g_assert(g_file_get_contents(DATA_DIR "alice", &contents, NULL, NULL));
+    g_assert_cmpstr(str, == ,contents);
+
+    g_free(contents);
+    g_free(str);
+    foil_private_key_unref(priv);
+    foil_private_key_unref(priv2);
+}
+
+static
+void
+test_key_x25519_public_export(
+    gconstpointer param)
+{
+    const FoilKeyExportFormat format = GPOINTER_TO_INT(param);
+    FoilKey* pub = test_public_key("alice.pub");
+    FoilKey* pub2;
+    char* str = foil_key_to_string(pub, format, NULL);
+    gchar* contents = NULL;
+
+    g_assert(str);
+    GDEBUG("\n%s", str);
+    pub2 = foil_key_new_from_string(FOIL_KEY_X25519_PUBLIC, str);
+    g_assert(pub2);
+    g_assert(foil_key_equal(pub, pub2));
+
+    /* Matches what OpenSSL produces */
+    g_assert(g_file_get_contents(DATA_DIR "alice.pub", &contents, NULL,
+        NULL));
+    g_assert_cmpstr(str, == ,contents);
+
+    g_free(contents);
+    g_free(str);
+    foil_key_unref(pub);
+    foil_key_unref(pub2);
+}
+
+#define TEST_(name) "/key_x25519/" name
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_key_x25519_null);
+    g_test_add_func(TEST_("generate"), test_key_x25519_generate);
+    g_test_add_func(TEST_("rfc7748"), test_key_x25519_rfc7748);
+    g_test_add_func(TEST_("fingerprint"), test_key_x25519_fingerprint);
+    g_test_add_func(TEST_("unsupported"), test_key_x25519_unsupported);
+    g_test_add_data_func(TEST_("private-export-default"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_DEFAULT),
+        test_key_x25519_private_export);
+    g_test_add_data_func(TEST_("private-export-pkcs8"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_PKCS8),
+        test_key_x25519_private_export);
+    g_test_add_data_func(TEST_("public-export-default"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_DEFAULT),
+        test_key_x25519_public_export);
+    g_test_add_data_func(TEST_("public-export-pkcs8"),
+        GINT_TO_POINTER(FOIL_KEY_EXPORT_FORMAT_PKCS8),
+        test_key_x25519_public_export);
+    return test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+
+#include "foil_key.h"
+#include "foil_keygen.h"
+#include "foil_private_key.h"
+
+#define TEST_RSA_BITS (512)
+
+typedef struct test_keygen_async {
+    GMainLoop* loop;
+    FoilKey* key;
+    int count;
+} TestKeygenAsync;
+
+static
+void
+test_keygen_async_done(
+    FoilKey* key,
+    void* arg)
+{
+    TestKeygenAsync* test = arg;
+
+    g_assert(key);
+    g_assert(!test->key);
+    test->key = foil_key_ref(key);
+    g_main_loop_quit(test->loop);
+}
+
+static
+void
+test_keygen_not_reached(
+    FoilKey* key,
+    void* arg)
+{
+    g_assert_not_reached();
+}
+
+static
+gboolean
+test_keygen_timeout(
+    gpointer loop)
+{
+    g_main_loop_quit(loop);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+test_null(
+    void)
+{
+    g_assert(!foil_key_generate_async(0, 0, NULL, NULL));
+    g_assert(!foil_key_generate_many(0, 0, 1, 0));
+    g_assert(!foil_key_pool_new(0, 0, 1, 1));
+    g_assert(!foil_key_pool_new(FOIL_KEY_AES128, 0, 0, 1));
+    g_assert(!foil_key_pool_take(NULL));
+    g_assert_cmpuint(foil_key_pool_count(NULL), == ,0);
+    foil_key_pool_free(NULL);
+}
+
+static
+void
+test_async(
+    void)
+{
+    TestKeygenAsync test;
+    guint id;
+
+    memset(&test, 0, sizeof(test));
+    test.loop = g_main_loop_new(NULL, TRUE);
+    id = foil_key_generate_async(FOIL_KEY_RSA_PRIVATE, TEST_RSA_BITS,
+        test_keygen_async_done, &test);
+    g_assert(id);
+    g_main_loop_run(test.loop);
+    g_assert(FOIL_IS_KEY_RSA_PRIVATE(test.key));
+    foil_key_unref(test.key);
+    g_main_loop_unref(test.loop);
+}
+
+static
+void
+test_async_cancel(
+    void)
+{
+    GMainLoop* loop = g_main_loop_new(NULL, TRUE);
+    guint id = foil_key_generate_async(FOIL_KEY_RSA_PRIVATE, TEST_RSA_BITS,
+        test_keygen_not_reached, NULL);
+
+    /* The callback is never invoked */
+    g_assert(id);
+    g_source_remove(id);
+    g_timeout_add(100, test_keygen_timeout, loop);
+    g_main_loop_run(loop);
+    g_main_loop_unref(loop);
+}
+
+static
+void
+test_many(
+    void)
+{
+    GPtrArray* keys = foil_key_generate_many(FOIL_KEY_RSA_PRIVATE,
+        TEST_RSA_BITS, 4, 0);
+    guint i;
+
+    g_assert(keys);
+    g_assert_cmpuint(keys->len, == ,4);
+    for (i = 0; i < keys->len; i++) {
+        g_assert(FOIL_IS_KEY_RSA_PRIVATE(keys->pdata[i]));
+        if (i > 0) {
+            g_assert(!foil_key_equal(keys->pdata[i], keys->pdata[i - 1]));
+        }
+    }
+    g_ptr_array_free(keys, TRUE);
+
+    /* Single thread works too, and so does zero keys */
+    keys = foil_key_generate_many(FOIL_KEY_AES256, 0, 3, 1);
+    g_assert(keys);
+    g_assert_cmpuint(keys->len, == ,3);
+    g_ptr_array_free(keys, TRUE);
+    keys = foil_key_generate_many(FOIL_KEY_AES256, 0, 0, 0);
+    g_assert(keys);
+    g_assert_cmpuint(keys->len, == ,0);
+    g_ptr_array_free(keys, TRUE);
+
+    /* Invalid number of bits */
+    g_assert(!foil_key_generate_many(FOIL_KEY_AES128, 1, 2, 0));
+}
+
+static
+void
+test_pool(
+    void)
+{
+    FoilKeyPool* pool = foil_key_pool_new(FOIL_KEY_RSA_PRIVATE,
+        TEST_RSA_BITS, 2, 2);
+    FoilKey* key1;
+    FoilKey* key2;
+    FoilKey* key3;
+
+    g_assert(pool);
+    key1 = foil_key_pool_take(pool);
+    key2 = foil_key_pool_take(pool);
+    key3 = foil_key_pool_take(pool);
+    g_assert(FOIL_IS_KEY_RSA_PRIVATE(key1));
+    g_assert(FOIL_IS_KEY_RSA_PRIVATE(key2));
+    g_assert(FOIL_IS_KEY_RSA_PRIVATE(key3));
+    g_assert(!foil_key_equal(key1, key2));
+    g_assert(!foil_key_equal(key2, key3));
+    g_assert_cmpuint(foil_key_pool_count(pool), <= ,2);
+    foil_key_unref(key1);
+    foil_key_unref(key2);
+    foil_key_unref(key3);
+    foil_key_pool_free(pool);
+
+    /* Keys left in the pool are released */
+    pool = foil_key_pool_new(FOIL_KEY_AES128, 0, 4, 0);
+    while (foil_key_pool_count(pool) < 4) {
+        g_usleep(1000);
+    }
+    foil_key_pool_free(pool);
+}
+
+#define TEST_(name) "/keygen/" name
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("async"), test_async);
+    g_test_add_func(TEST_("async-cancel"), test_async_cancel);
+    g_test_add_func(TEST_("many"), test_many);
+    g_test_add_func(TEST_("pool"), test_pool);
+    return test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+
+#include "foil_key.h"
+#include "foil_keywrap.h"
+#include "foil_util.h"
+
+typedef struct test_keywrap {
+    const char* name;
+    const char* kek;
+    const char* data;
+    const char* wrapped;
+} TestKeywrap;
+
+static
+FoilKey*
+test_kek(
+    const char* hex)
+{
+    GBytes* bytes = test_hex_to_bytes(hex);
+    const gsize len = g_bytes_get_size(bytes);
+    GByteArray* buf = g_byte_array_new();
+    FoilKey* key;
+    GType type;
+
+    switch (len) {
+    case 16: type = FOIL_KEY_AES128; break;
+    case 24: type = FOIL_KEY_AES192; break;
+    default: type = FOIL_KEY_AES256; break;
+    }
+
+    /* IV is ignored by the key wrap, it's all zeros here */
+    g_byte_array_append(buf, g_bytes_get_data(bytes, NULL), len);
+    g_byte_array_set_size(buf, len + 16);
+    memset(buf->data + len, 0, 16);
+    key = foil_key_new_from_data(type, buf->data, buf->len);
+    g_assert(key);
+    g_byte_array_unref(buf);
+    g_bytes_unref(bytes);
+    return key;
+}
+
+static
+void
+test_null(
+    void)
+{
+    static const guint8 data[24] = { 0 };
+    FoilKey* kek = test_kek("000102030405060708090A0B0C0D0E0F");
+    FoilBytes bytes;
+
+    g_assert(!foil_keywrap_wrap(NULL, NULL));
+    g_assert(!foil_keywrap_wrap(kek, NULL));
+    g_assert(!foil_keywrap_unwrap(NULL, NULL));
+    g_assert(!foil_keywrap_unwrap(kek, NULL));
+
+    /* At least two 64-bit blocks must be wrapped */
+    bytes.val = data;
+    bytes.len = 8;
+    g_assert(!foil_keywrap_wrap(kek, &bytes));
+    g_assert(!foil_keywrap_unwrap(kek, &bytes));
+    bytes.len = 16;
+    g_assert(!foil_keywrap_unwrap(kek, &bytes));
+
+    /* Not a multiple of 8 */
+    bytes.len = 20;
+    g_assert(!foil_keywrap_wrap(kek, &bytes));
+    g_assert(!foil_keywrap_unwrap(kek, &bytes));
+
+    /* Garbage doesn't pass the integrity check */
+    bytes.len = 24;
+    g_assert(!foil_keywrap_unwrap(kek, &bytes));
+    foil_key_unref(kek);
+}
+
+static
+void
+test_keywrap(
+    gconstpointer param)
+{
+    const TestKeywrap* test = param;
+    FoilKey* kek = test_kek(test->kek);
+    GBytes* data = test_hex_to_bytes(test->data);
+    GBytes* expect = test_hex_to_bytes(test->wrapped);
+    FoilBytes bytes;
+    GBytes* wrapped = foil_keywrap_wrap(kek, foil_bytes_from_data(&bytes,
+        data));
+    GBytes* unwrapped;
+    guint8* damaged;
+
+    g_assert(wrapped);
+    TEST_DEBUG_HEXDUMP_BYTES(wrapped);
+    g_assert(g_bytes_equal(wrapped, expect));
+
+    unwrapped = foil_keywrap_unwrap(kek, foil_bytes_from_data(&bytes,
+        wrapped));
+    g_assert(unwrapped);
+    g_assert(g_bytes_equal(unwrapped, data));
+    g_bytes_unref(unwrapped);
+
+    /* Flip one bit */
+    damaged = g_malloc(bytes.len);
+    memcpy(damaged, bytes.val, bytes.len);
+    damaged[bytes.len - 1] ^= 0x01;
+    bytes.val = damaged;
+    g_assert(!foil_keywrap_unwrap(kek, &bytes));
+    g_free(damaged);
+
+    g_bytes_unref(wrapped);
+    g_bytes_unref(expect);
+    g_bytes_unref(data);
+    foil_key_unref(kek);
+}
+
+/* RFC 3394, section 4 */
+static const TestKeywrap keywrap_tests[] = {
+    {
+        "4.1",
+        "000102030405060708090A0B0C0D0E0F",
+        "00112233445566778899AABBCCDDEEFF",
+        "1FA68B0A8112B447AEF34BD8FB5A7B829D3E862371D2CFE5"
+    },{
+        "4.2",
+        "000102030405060708090A0B0C0D0E0F1011121314151617",
+        "00112233445566778899AABBCCDDEEFF",
+        "96778B25AE6CA435F92B5B97C050AED2468AB8A17AD84E5D"
+    },{
+        "4.3",
+        "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F",
+        "00112233445566778899AABBCCDDEEFF",
+        "64E8C3F9CE0F5BA263E9777905818A2A93C8191E7D6E8AE7"
+    },{
+        "4.4",
+        "000102030405060708090A0B0C0D0E0F1011121314151617",
+        "00112233445566778899AABBCCDDEEFF0001020304050607",
+        "031D33264E15D33268F24EC260743EDCE1C6C7DDEE725A936BA814915C6762D2"
+    },{
+        "4.5",
+        "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F",
+        "00112233445566778899AABBCCDDEEFF0001020304050607",
+        "A8F9BC1612C68B3FF6E6F4FBE30E71E4769C8B80A32CB8958CD5D17D6B254DA1"
+    },{
+        "4.6",
+        "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F",
+        "00112233445566778899AABBCCDDEEFF000102030405060708090A0B0C0D0E0F",
+        "28C9F404C4B810F4CBCCB35CFB87F8263F5786E2D80ED326"
+        "CBC7F0E71A99F43BFB988B9B7A02DD21"
+    }
+};
+
+#define TEST_(name) "/keywrap/" name
+
+int main(int argc, char* argv[])
+{
+    guint i;
+
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    for (i = 0; i < G_N_ELEMENTS(keywrap_tests); i++) {
+        const TestKeywrap* test = keywrap_tests + i;
+        char* path = g_strconcat(TEST_("rfc3394/"), test->name, NULL);
+
+        g_test_add_data_func(path, test, test_keywrap);
+        g_free(path);
+    }
+    return test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -33,16 +33,25 @@
 #include "test_common.h"
 
 #include "foil_output.h"
+#include "foil_arena.h"
 #include "foil_cipher.h"
 #include "foil_digest.h"
 #include "foil_hmac.h"
 #include "foil_key.h"
 #include "foil_private_key.h"
+#include "foil_util.h"
 
 #include <gutil_misc.h>
 
 #include <glib/gstdio.h>
 
+#include <fcntl.h>
+#ifdef _WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
 #define TEST_(name) "/output/" name
 
 typedef struct test_output_cipher_data {
@@ -604,6 +613,244 @@ test_output_file(
     g_bytes_unref(bytes_expected);
 }
 
+static
+void
+test_output_fd(
+    void)
+{
+    char* tmpdir = g_dir_make_tmp("test_output_XXXXXX", NULL);
+    char* fname = g_build_filename(tmpdir, "test", NULL);
+    const gsize datalen = 3 * 0x1000 + 123;
+    guint8* data = g_malloc(datalen);
+    char* contents = NULL;
+    gsize i, length = 0;
+    FoilOutput* out;
+    GBytes* bytes;
+    int fd;
+
+    for (i = 0; i < datalen; i++) {
+        data[i] = (guint8)i;
+    }
+
+    /* Invalid descriptor */
+    g_assert(!foil_output_file_new_fd(-1, 0, 0));
+
+    /* Small buffer, mixing small and large writes */
+    out = foil_output_file_new_open_full(fname, FOIL_OUTPUT_FILE_WRITEBEHIND,
+        16);
+    g_assert(out);
+    g_assert(foil_output_reserve(out, datalen));
+    g_assert(foil_output_write_all(out, data, 10));
+    g_assert(foil_output_write_all(out, data + 10, 5));
+    g_assert(foil_output_write_all(out, data + 15, datalen - 15));
+    g_assert(foil_output_bytes_written(out) == datalen);
+    bytes = foil_output_free_to_bytes(out);
+    g_assert(bytes);
+    g_assert(g_bytes_get_size(bytes) == datalen);
+    g_assert(!memcmp(g_bytes_get_data(bytes, NULL), data, datalen));
+    g_bytes_unref(bytes);
+
+    g_assert(g_file_get_contents(fname, &contents, &length, NULL));
+    g_assert(length == datalen);
+    g_assert(!memcmp(data, contents, length));
+    g_free(contents);
+
+    /* O_DIRECT (silently ignored if not supported) with unaligned tail */
+    out = foil_output_file_new_open_full(fname, FOIL_OUTPUT_FILE_DIRECT, 0);
+    g_assert(out);
+    g_assert(foil_output_write_all(out, data, datalen));
+    foil_output_close(out);
+    foil_output_unref(out);
+
+    g_assert(g_file_get_contents(fname, &contents, &length, NULL));
+    g_assert(length == datalen);
+    g_assert(!memcmp(data, contents, length));
+    g_free(contents);
+
+    /* Descriptor which we are not supposed to close */
+    fd = open(fname, O_WRONLY | O_TRUNC);
+    g_assert(fd >= 0);
+    out = foil_output_file_new_fd(fd, 0, 0);
+    g_assert(out);
+    g_assert(foil_output_write_all(out, data, 10));
+    g_assert(!foil_output_free_to_bytes(out));
+    g_assert(!close(fd));
+
+    g_assert(g_file_get_contents(fname, &contents, &length, NULL));
+    g_assert(length == 10);
+    g_assert(!memcmp(data, contents, length));
+    g_free(contents);
+
+    /* Preallocated temporary file */
+    out = foil_output_file_new_tmp_full(0, 0x100, datalen);
+    g_assert(out);
+    g_assert(foil_output_write_all(out, data, datalen));
+    bytes = foil_output_free_to_bytes(out);
+    g_assert(bytes);
+    g_assert(g_bytes_get_size(bytes) == datalen);
+    g_assert(!memcmp(g_bytes_get_data(bytes, NULL), data, datalen));
+    g_bytes_unref(bytes);
+
+    g_unlink(fname);
+    g_rmdir(tmpdir);
+    g_free(tmpdir);
+    g_free(fname);
+    g_free(data);
+}
+
+static
+void
+test_output_uring(
+    void)
+{
+    char* tmpdir = g_dir_make_tmp("test_output_XXXXXX", NULL);
+    char* fname = g_build_filename(tmpdir, "test", NULL);
+    const gsize datalen = 5 * 0x1000 + 321;
+    guint8* data = g_malloc(datalen);
+    char* contents = NULL;
+    gsize i, length = 0;
+    FoilOutput* out;
+    int fd;
+
+    for (i = 0; i < datalen; i++) {
+        data[i] = (guint8)(i + i / 251);
+    }
+
+    /* Invalid parameters */
+    g_assert(!foil_output_uring_new(-1, 0, 0, 0));
+    g_assert(!foil_output_uring_new_open(NULL));
+
+    /* Small buffers, more data than fits into all of them at once */
+    fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    g_assert(fd >= 0);
+    out = foil_output_uring_new(fd, FOIL_OUTPUT_FILE_CLOSE, 0x1000, 2);
+    g_assert(out);
+    foil_output_reserve(out, datalen);
+    for (i = 0; i < datalen; i += 1000) {
+        const gsize n = MIN(1000, datalen - i);
+
+        g_assert(foil_output_write_all(out, data + i, n));
+    }
+    g_assert(foil_output_flush(out));
+    g_assert(foil_output_bytes_written(out) == datalen);
+    g_assert(!foil_output_free_to_bytes(out));
+
+    g_assert(g_file_get_contents(fname, &contents, &length, NULL));
+    g_assert(length == datalen);
+    g_assert(!memcmp(data, contents, length));
+    g_free(contents);
+
+    /* Descriptor which we are not supposed to close, defaults */
+    fd = open(fname, O_WRONLY | O_TRUNC);
+    g_assert(fd >= 0);
+    out = foil_output_uring_new(fd, 0, 0, 0);
+    g_assert(out);
+    g_assert(foil_output_write_all(out, data, 10));
+    foil_output_unref(out);
+
+    /* Must be positioned after the data written by the stream */
+    g_assert(write(fd, data + 10, 5) == 5);
+    g_assert(!close(fd));
+    g_assert(g_file_get_contents(fname, &contents, &length, NULL));
+    g_assert(length == 15);
+    g_assert(!memcmp(data, contents, length));
+    g_free(contents);
+
+    /* Open by path */
+    out = foil_output_uring_new_open(fname);
+    g_assert(out);
+    g_assert(foil_output_write_all(out, data, datalen));
+    foil_output_unref(out);
+
+    g_assert(g_file_get_contents(fname, &contents, &length, NULL));
+    g_assert(length == datalen);
+    g_assert(!memcmp(data, contents, length));
+    g_free(contents);
+
+    g_unlink(fname);
+    g_rmdir(tmpdir);
+    g_free(tmpdir);
+    g_free(fname);
+    g_free(data);
+}
+
+static
+void
+test_output_writebehind(
+    void)
+{
+    const gsize datalen = 10000;
+    guint8* data = g_malloc(datalen);
+    GByteArray* buf = g_byte_array_new();
+    FoilOutput* mem;
+    FoilOutput* out;
+    GBytes* bytes;
+    gsize i, total;
+
+    for (i = 0; i < datalen; i++) {
+        data[i] = (guint8)(i * 3 + i / 255);
+    }
+
+    /* NULL output */
+    g_assert(!foil_output_writebehind_new(NULL, 0, 0));
+
+    /* Odd sized writes crossing the chunk boundaries */
+    mem = foil_output_mem_new(buf);
+    out = foil_output_writebehind_new(mem, 100, 3);
+    for (total = 0, i = 1; total < datalen; i++) {
+        const gsize n = MIN(i, datalen - total);
+
+        g_assert(foil_output_write_all(out, data + total, n));
+        total += n;
+    }
+    g_assert(foil_output_flush(out));
+    g_assert(foil_output_bytes_written(out) == datalen);
+    g_assert(buf->len == datalen);
+    g_assert(!memcmp(buf->data, data, datalen));
+
+    /* Reset is passed through */
+    g_assert(foil_output_write_all(out, data, 10));
+    g_assert(foil_output_reset(out));
+    g_assert(!buf->len);
+    g_assert(foil_output_write_all(out, data, 10));
+    foil_output_close(out);
+    foil_output_unref(out);
+    g_assert(buf->len == 10);
+    g_assert(!memcmp(buf->data, data, 10));
+
+    /* Write fails once the target output fails */
+    foil_output_close(mem);
+    out = foil_output_writebehind_new(mem, 10, 2);
+    foil_output_unref(mem);
+    g_assert(foil_output_write(out, data, 5) == 5);
+    g_assert(!foil_output_flush(out));
+    g_assert(foil_output_write(out, data, 10) < 0);
+    foil_output_unref(out);
+
+    /* Failed submission fails the write which triggered it */
+    mem = foil_output_mem_new(NULL);
+    foil_output_close(mem);
+    out = foil_output_writebehind_new(mem, 10, 1);
+    foil_output_unref(mem);
+    g_assert(foil_output_write(out, data, 25) < 0);
+    foil_output_unref(out);
+
+    /* Everything gets written before to_bytes */
+    mem = foil_output_mem_new(NULL);
+    out = foil_output_writebehind_new(mem, 0, 0);
+    foil_output_unref(mem);
+    g_assert(foil_output_reserve(out, datalen));
+    g_assert(foil_output_write_all(out, data, datalen));
+    bytes = foil_output_free_to_bytes(out);
+    g_assert(bytes);
+    g_assert(g_bytes_get_size(bytes) == datalen);
+    g_assert(!memcmp(g_bytes_get_data(bytes, NULL), data, datalen));
+    g_bytes_unref(bytes);
+
+    g_byte_array_unref(buf);
+    g_free(data);
+}
+
 static
 void
 test_output_assert_equal(
@@ -615,6 +862,158 @@ test_output_assert_equal(
     g_assert(!memcmp(buf->data, str, len));
 }
 
+static
+void
+test_output_arena(
+    void)
+{
+    static const char test[] = "This is an arena output test";
+    FoilArena* arena = foil_arena_new(0);
+    FoilBytes result, expected;
+    FoilOutput* out;
+    GBytes* bytes;
+    guint i;
+
+    expected.val = (const void*)test;
+    expected.len = sizeof(test) - 1;
+    g_assert(!foil_output_arena_new(NULL, &result));
+    g_assert(!foil_output_arena_new(arena, NULL));
+
+    /* Byte by byte, the buffer keeps growing */
+    out = foil_output_arena_new(arena, &result);
+    g_assert(!result.len);
+    for (i = 0; i < expected.len; i++) {
+        g_assert(foil_output_write_byte(out, test[i]));
+        g_assert_cmpuint(result.len, == ,i + 1);
+    }
+    g_assert(foil_bytes_equal(&result, &expected));
+
+    /* Reset and write again, with the exact size reserved */
+    g_assert(foil_output_reset(out));
+    g_assert(!result.len);
+    g_assert(foil_output_reserve(out, expected.len));
+    g_assert(foil_output_write_all(out, expected.val, expected.len));
+    g_assert(foil_bytes_equal(&result, &expected));
+
+    /* Something else gets allocated, the data has to be moved */
+    g_assert(foil_arena_alloc(arena, 1));
+    g_assert(foil_output_write_all(out, expected.val, expected.len));
+    g_assert_cmpuint(result.len, == ,2 * expected.len);
+    g_assert(!memcmp(result.val, test, expected.len));
+    g_assert(!memcmp(result.val + expected.len, test, expected.len));
+
+    /* GBytes is a copy */
+    g_assert(foil_output_reset(out));
+    g_assert(foil_output_write_all(out, expected.val, expected.len));
+    bytes = foil_output_free_to_bytes(out);
+    g_assert(bytes);
+    g_assert(g_bytes_get_data(bytes, NULL) != result.val);
+    g_assert(gutil_bytes_equal(bytes, test, expected.len));
+    g_bytes_unref(bytes);
+
+    /* Result survives the output */
+    out = foil_output_arena_new(arena, &result);
+    g_assert(foil_output_write_all(out, expected.val, expected.len));
+    foil_output_unref(out);
+    g_assert(foil_bytes_equal(&result, &expected));
+    foil_arena_free(arena);
+}
+
+static
+void
+test_output_writev(
+    void)
+{
+    static const char expected[] = "This is a writev test";
+    static const guint8 part1[] = { 'T', 'h', 'i', 's', ' ' };
+    static const guint8 part2[] = { 'i', 's', ' ', 'a', ' ' };
+    static const guint8 part3[] = { 'w', 'r', 'i', 't', 'e', 'v', ' ' };
+    static const guint8 part4[] = { 't', 'e', 's', 't' };
+    const gssize len = sizeof(expected) - 1;
+    GType digest_type = FOIL_DIGEST_SHA1;
+    GBytes* d1 = foil_digest_data(digest_type, expected, len);
+    FoilDigest* digest = foil_digest_new(digest_type);
+    char* tmpdir = g_dir_make_tmp("test_output_XXXXXX", NULL);
+    char* fname = g_build_filename(tmpdir, "test", NULL);
+    char* contents = NULL;
+    gsize length = 0;
+    GByteArray* buf = g_byte_array_new();
+    FoilOutput* out = foil_output_mem_new(buf);
+    FoilOutput* out_digest;
+    FoilBytes parts[5];
+    GBytes* bytes;
+    GBytes* d2;
+
+    parts[0].val = part1; parts[0].len = sizeof(part1);
+    parts[1].val = part2; parts[1].len = sizeof(part2);
+    parts[2].val = NULL;  parts[2].len = 0;
+    parts[3].val = part3; parts[3].len = sizeof(part3);
+    parts[4].val = part4; parts[4].len = sizeof(part4);
+
+    /* Invalid and empty input */
+    g_assert_cmpint(foil_output_writev(NULL, parts, 1), < ,0);
+    g_assert_cmpint(foil_output_writev(out, NULL, 1), == ,0);
+    g_assert_cmpint(foil_output_writev(out, parts, 0), == ,0);
+    g_assert_cmpint(foil_output_writev(out, parts + 2, 1), == ,0);
+
+    /* Memory */
+    g_assert_cmpint(foil_output_writev(out, parts, 5), == ,len);
+    g_assert_cmpuint(foil_output_bytes_written(out), == ,len);
+    test_output_assert_equal(buf, expected);
+    foil_output_unref(out);
+
+    /* Digest */
+    g_byte_array_set_size(buf, 0);
+    out = foil_output_mem_new(buf);
+    out_digest = foil_output_digest_new(out, digest);
+    g_assert_cmpint(foil_output_writev(out_digest, parts, 5), == ,len);
+    g_assert_cmpuint(foil_output_bytes_written(out_digest), == ,len);
+    test_output_assert_equal(buf, expected);
+    foil_output_unref(out_digest);
+    foil_output_unref(out);
+    d2 = foil_digest_finish(digest);
+    g_assert(g_bytes_equal(d1, d2));
+
+    /* Generic implementation */
+    out = test_output_mem_new(-1, 0);
+    g_assert_cmpint(foil_output_writev(out, parts, 5), == ,len);
+    bytes = foil_output_free_to_bytes(out);
+    g_assert(test_bytes_equal_str(bytes, expected));
+    g_bytes_unref(bytes);
+
+    /* Generic implementation stops on the first short write */
+    out = test_output_mem_new(sizeof(part1) + 2, 0);
+    g_assert_cmpint(foil_output_writev(out, parts, 5), == ,sizeof(part1)+2);
+    foil_output_unref(out);
+
+    /* File (buffered data must go first) */
+    out = foil_output_file_new_open(fname);
+    g_assert(foil_output_write_all(out, part1, sizeof(part1)));
+    g_assert_cmpint(foil_output_writev(out, parts + 1, 4), == ,
+        len - sizeof(part1));
+    g_assert_cmpuint(foil_output_bytes_written(out), == ,len);
+    foil_output_unref(out);
+    g_assert(g_file_get_contents(fname, &contents, &length, NULL));
+    g_assert_cmpuint(length, == ,len);
+    g_assert(!memcmp(contents, expected, len));
+
+    /* Closed stream */
+    out = foil_output_mem_new(NULL);
+    foil_output_close(out);
+    g_assert_cmpint(foil_output_writev(out, parts, 5), < ,0);
+    foil_output_unref(out);
+
+    g_unlink(fname);
+    g_rmdir(tmpdir);
+    g_free(tmpdir);
+    g_free(fname);
+    g_free(contents);
+    g_byte_array_unref(buf);
+    foil_digest_unref(digest);
+    g_bytes_unref(d1);
+    g_bytes_unref(d2);
+}
+
 static
 void
 test_output_base64(
@@ -910,7 +1309,12 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("digest2"), test_output_digest2);
     g_test_add_func(TEST_("path"), test_output_path);
     g_test_add_func(TEST_("file"), test_output_file);
+    g_test_add_func(TEST_("fd"), test_output_fd);
+    g_test_add_func(TEST_("uring"), test_output_uring);
+    g_test_add_func(TEST_("writebehind"), test_output_writebehind);
     g_test_add_func(TEST_("base64"), test_output_base64);
+    g_test_add_func(TEST_("writev"), test_output_writev);
+    g_test_add_func(TEST_("arena"), test_output_arena);
     g_test_add_func(TEST_("cipher/basic"), test_output_cipher_basic);
     for (i = 0; i < G_N_ELEMENTS(test_cipher); i++) {
         char* name;
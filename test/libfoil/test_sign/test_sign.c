@@ -32,6 +32,8 @@
 #include "foil_sign.h"
 #include "foil_cipher.h"
 #include "foil_digest.h"
+#include "foil_input.h"
+#include "foil_output.h"
 #include "foil_private_key.h"
 #include "foil_util.h"
 
@@ -126,6 +128,182 @@ test_sign(
     g_free(pub_path);
 }
 
+static
+void
+test_sign_stream_invalid(
+    void)
+{
+    static const guint8 data[] = { '1', '2', '3' };
+    char* priv_path = g_strconcat(DATA_DIR, "rsa-768", NULL);
+    char* pub_path = g_strconcat(DATA_DIR, "rsa-768.pub", NULL);
+    FoilPrivateKey* priv = foil_private_key_new_from_file(FOIL_KEY_RSA_PRIVATE,
+        priv_path);
+    FoilKey* pub = foil_key_new_from_file(FOIL_KEY_RSA_PUBLIC, pub_path);
+    FoilSigner* signer;
+    FoilVerifier* verifier;
+    FoilOutput* out;
+    FoilInput* in;
+    GBytes* sign;
+
+    g_assert(priv);
+    g_assert(pub);
+
+    /* Test NULL resistance */
+    g_assert(!foil_rsa_signer_new(FOIL_DIGEST_MD5, NULL));
+    g_assert(!foil_rsa_verifier_new(FOIL_DIGEST_MD5, NULL));
+    g_assert(!foil_signer_ref(NULL));
+    g_assert(!foil_verifier_ref(NULL));
+    g_assert(!foil_signer_update(NULL, NULL, 0));
+    g_assert(!foil_verifier_update(NULL, NULL, 0));
+    g_assert(!foil_signer_finish(NULL));
+    g_assert(!foil_verifier_finish(NULL, NULL));
+    g_assert(!foil_output_sign_new(NULL, NULL));
+    g_assert(!foil_input_verify_new(NULL, NULL));
+    foil_signer_unref(NULL);
+    foil_verifier_unref(NULL);
+
+    /* Invalid digest and cipher types */
+    g_assert(!foil_rsa_signer_new(0, priv));
+    g_assert(!foil_rsa_verifier_new(0, pub));
+    g_assert(!foil_signer_new(FOIL_DIGEST_MD5, 0, priv));
+    g_assert(!foil_verifier_new(FOIL_DIGEST_MD5, 0, pub));
+
+    /* Can't update or finish twice */
+    signer = foil_rsa_signer_new(FOIL_DIGEST_MD5, priv);
+    g_assert(foil_signer_ref(signer) == signer);
+    foil_signer_unref(signer);
+    g_assert(foil_signer_update(signer, data, sizeof(data)));
+    sign = foil_signer_finish(signer);
+    g_assert(sign);
+    g_assert(!foil_signer_update(signer, data, sizeof(data)));
+    g_assert(!foil_signer_finish(signer));
+    foil_signer_unref(signer);
+
+    /* Missing signature */
+    verifier = foil_rsa_verifier_new(FOIL_DIGEST_MD5, pub);
+    g_assert(foil_verifier_ref(verifier) == verifier);
+    foil_verifier_unref(verifier);
+    g_assert(foil_verifier_update(verifier, data, sizeof(data)));
+    g_assert(!foil_verifier_finish(verifier, NULL));
+    g_assert(!foil_verifier_update(verifier, data, sizeof(data)));
+    foil_verifier_unref(verifier);
+
+    /* NULL streams */
+    signer = foil_rsa_signer_new(FOIL_DIGEST_MD5, priv);
+    verifier = foil_rsa_verifier_new(FOIL_DIGEST_MD5, pub);
+    out = foil_output_sign_new(NULL, signer);
+    in = foil_input_verify_new(NULL, verifier);
+    g_assert(!out);
+    g_assert(!in);
+    foil_signer_unref(signer);
+    foil_verifier_unref(verifier);
+
+    g_bytes_unref(sign);
+    foil_private_key_unref(priv);
+    foil_key_unref(pub);
+    g_free(priv_path);
+    g_free(pub_path);
+}
+
+static
+void
+test_sign_stream(
+    gconstpointer param)
+{
+    const TestSign* test = param;
+    const GType digest_type = FOIL_DIGEST_SHA256;
+    const gsize size = 10000;
+    char* priv_path = g_strconcat(DATA_DIR, test->priv, NULL);
+    char* pub_path = g_strconcat(DATA_DIR, test->pub, NULL);
+    FoilPrivateKey* priv = foil_private_key_new_from_file(FOIL_KEY_RSA_PRIVATE,
+        priv_path);
+    FoilKey* pub = foil_key_new_from_file(FOIL_KEY_RSA_PUBLIC, pub_path);
+    guint8* data = g_malloc(size);
+    GBytes* bytes = g_bytes_new_take(data, size);
+    GByteArray* buf = g_byte_array_new();
+    FoilSigner* signer;
+    FoilVerifier* verifier;
+    FoilOutput* mem_out;
+    FoilOutput* out;
+    FoilInput* mem_in;
+    FoilInput* in;
+    FoilBytes in_bytes, sign_bytes;
+    GBytes* sign;
+    GBytes* sign2;
+    gsize i;
+
+    for (i = 0; i < size; i++) {
+        data[i] = (guint8)i;
+    }
+    in_bytes.val = data;
+    in_bytes.len = size;
+
+    /* Signing in chunks produces the same (deterministic) signature */
+    sign = foil_rsa_sign(&in_bytes, digest_type, priv);
+    g_assert(sign);
+    signer = foil_rsa_signer_new(digest_type, priv);
+    for (i = 0; i < size; i += 999) {
+        g_assert(foil_signer_update(signer, data + i, MIN(999, size - i)));
+    }
+    sign2 = foil_signer_finish(signer);
+    g_assert(sign2);
+    g_assert(g_bytes_equal(sign, sign2));
+    foil_signer_unref(signer);
+    g_bytes_unref(sign2);
+
+    /* Same thing but through the output stream */
+    signer = foil_rsa_signer_new(digest_type, priv);
+    mem_out = foil_output_mem_new(buf);
+    out = foil_output_sign_new(mem_out, signer);
+    foil_output_unref(mem_out); /* The signing stage holds the reference */
+    for (i = 0; i < size; i += 333) {
+        g_assert(foil_output_write_all(out, data + i, MIN(333, size - i)));
+    }
+    foil_output_close(out);
+    foil_output_unref(out);
+    g_assert_cmpuint(buf->len, == ,size);
+    g_assert(!memcmp(buf->data, data, size));
+    sign2 = foil_signer_finish(signer);
+    g_assert(sign2);
+    g_assert(g_bytes_equal(sign, sign2));
+    foil_signer_unref(signer);
+    g_bytes_unref(sign2);
+
+    /* Verify in chunks */
+    foil_bytes_from_data(&sign_bytes, sign);
+    verifier = foil_rsa_verifier_new(digest_type, pub);
+    for (i = 0; i < size; i += 777) {
+        g_assert(foil_verifier_update(verifier, data + i, MIN(777, size - i)));
+    }
+    g_assert(foil_verifier_finish(verifier, &sign_bytes));
+    foil_verifier_unref(verifier);
+
+    /* And through the input stream */
+    verifier = foil_rsa_verifier_new(digest_type, pub);
+    mem_in = foil_input_mem_new(bytes);
+    in = foil_input_verify_new(mem_in, verifier);
+    foil_input_unref(mem_in);
+    g_assert(foil_input_skip(in, size) == (gssize)size);
+    foil_input_unref(in);
+    g_assert(foil_verifier_finish(verifier, &sign_bytes));
+    foil_verifier_unref(verifier);
+
+    /* Damaged data */
+    data[0] ^= 0xff;
+    verifier = foil_rsa_verifier_new(digest_type, pub);
+    g_assert(foil_verifier_update(verifier, data, size));
+    g_assert(!foil_verifier_finish(verifier, &sign_bytes));
+    foil_verifier_unref(verifier);
+
+    g_byte_array_unref(buf);
+    g_bytes_unref(bytes);
+    g_bytes_unref(sign);
+    foil_private_key_unref(priv);
+    foil_key_unref(pub);
+    g_free(priv_path);
+    g_free(pub_path);
+}
+
 /* Test descriptors */
 
 #define TEST_(name) "/sign/" name
@@ -133,6 +311,8 @@ test_sign(
     { TEST_("sign-ok-" name), test_sign, name, name ".pub", -1 }
 #define TEST_VERIFY_FAIL(name,damage) \
     { TEST_("verify-err-" name), test_sign, name, name ".pub", damage }
+#define TEST_SIGN_STREAM(name) \
+    { TEST_("stream-" name), test_sign_stream, name, name ".pub", -1 }
 
 static const TestSign tests[] = {
     TEST_SIGN_OK("rsa-768"),
@@ -143,6 +323,8 @@ static const TestSign tests[] = {
     TEST_VERIFY_FAIL("rsa-1024", 1),
     TEST_VERIFY_FAIL("rsa-1500", 2),
     TEST_VERIFY_FAIL("rsa-2048", 3),
+    TEST_SIGN_STREAM("rsa-768"),
+    TEST_SIGN_STREAM("rsa-2048"),
 };
 
 int main(int argc, char* argv[])
@@ -150,6 +332,7 @@ int main(int argc, char* argv[])
     guint i;
     g_test_init(&argc, &argv, NULL);
     g_test_add_func(TEST_("invalid"), test_sign_invalid);
+    g_test_add_func(TEST_("stream-invalid"), test_sign_stream_invalid);
     for (i = 0; i < G_N_ELEMENTS(tests); i++) {
         g_test_add_data_func(tests[i].name, tests + i, tests[i].fn);
     }
@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) ARISING
+ * IN ANY WAY OUT OF THE USE OR INABILITY TO USE THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+
+#include "foil_stats.h"
+#include "foil_cipher.h"
+#include "foil_digest.h"
+#include "foil_hmac.h"
+#include "foil_kdf.h"
+#include "foil_key.h"
+
+static const guint8 test_data[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+    0x20
+};
+
+static
+const FoilStatsEntry*
+test_stats_find(
+    const FoilStats* stats,
+    FoilStatsKind kind,
+    const char* name,
+    const char* op)
+{
+    guint i;
+
+    for (i = 0; i < stats->count; i++) {
+        const FoilStatsEntry* entry = stats->entries + i;
+
+        if (entry->kind == kind && !g_strcmp0(entry->name, name) &&
+            !g_strcmp0(entry->op, op)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static
+guint64
+test_stats_total_ops(
+    void)
+{
+    FoilStats* stats = foil_stats_snapshot();
+    guint64 total = 0;
+    guint i;
+
+    for (i = 0; i < stats->count; i++) {
+        total += stats->entries[i].ops;
+    }
+    foil_stats_free(stats);
+    return total;
+}
+
+static
+void
+test_stats_trace(
+    const FoilStatsSpan* span,
+    void* user_data)
+{
+    GPtrArray* ops = user_data;
+
+    g_assert(span->name);
+    g_assert(span->op);
+    g_assert_cmpint(span->nsec, >= ,0);
+    g_ptr_array_add(ops, g_strconcat(span->name, "/", span->op, NULL));
+}
+
+static
+gboolean
+test_stats_traced(
+    GPtrArray* ops,
+    const char* name,
+    const char* op)
+{
+    char* expected = g_strconcat(name, "/", op, NULL);
+    gboolean found = FALSE;
+    guint i;
+
+    for (i = 0; i < ops->len && !found; i++) {
+        found = !strcmp(ops->pdata[i], expected);
+    }
+    g_free(expected);
+    return found;
+}
+
+/*==========================================================================*
+ * disabled
+ *==========================================================================*/
+
+static
+void
+test_disabled(
+    void)
+{
+    FoilStats* stats;
+
+    foil_stats_enable(FALSE);
+    foil_stats_reset();
+    g_assert(!foil_stats_enabled());
+    g_assert(!foil_stats_active());
+    g_bytes_unref(foil_digest_data(FOIL_DIGEST_SHA256, TEST_ARRAY_AND_SIZE
+        (test_data)));
+    g_assert_cmpuint(test_stats_total_ops(), == ,0);
+
+    /* Empty snapshot is still a valid snapshot */
+    stats = foil_stats_snapshot();
+    g_assert(stats);
+    foil_stats_free(stats);
+    foil_stats_free(NULL);
+}
+
+/*==========================================================================*
+ * counters
+ *==========================================================================*/
+
+static
+void
+test_counters(
+    void)
+{
+    const GType cipher_type = FOIL_CIPHER_AES_CBC_ENCRYPT;
+    const char* cipher_name = foil_cipher_type_name(cipher_type);
+    const char* sha256 = foil_digest_type_name(FOIL_DIGEST_SHA256);
+    const char* sha1 = foil_digest_type_name(FOIL_DIGEST_SHA1);
+    FoilKey* key = foil_key_generate_new(FOIL_KEY_AES128, 0);
+    const FoilStatsEntry* entry;
+    FoilStats* stats;
+    FoilDigest* digest;
+    FoilHmac* hmac;
+    FoilBytes salt;
+
+    foil_stats_enable(TRUE);
+    foil_stats_reset();
+    g_assert(foil_stats_enabled());
+    g_assert(foil_stats_active());
+
+    /* Cipher */
+    g_bytes_unref(foil_cipher_data(cipher_type, key,
+        TEST_ARRAY_AND_SIZE(test_data)));
+
+    /* Digest */
+    g_bytes_unref(foil_digest_data(FOIL_DIGEST_SHA256,
+        TEST_ARRAY_AND_SIZE(test_data)));
+    digest = foil_digest_new(FOIL_DIGEST_SHA256);
+    foil_digest_update(digest, TEST_ARRAY_AND_SIZE(test_data));
+    foil_digest_update(digest, TEST_ARRAY_AND_SIZE(test_data));
+    foil_digest_unref(digest);
+
+    /* HMAC */
+    hmac = foil_hmac_new(FOIL_DIGEST_SHA1, TEST_ARRAY_AND_SIZE(test_data));
+    foil_hmac_update(hmac, TEST_ARRAY_AND_SIZE(test_data));
+    foil_hmac_unref(hmac);
+
+    /* KDF */
+    salt.val = test_data;
+    salt.len = 8;
+    g_bytes_unref(foil_kdf_pbkdf2(FOIL_DIGEST_SHA1, "password", -1,
+        &salt, 2, 20));
+    g_bytes_unref(foil_kdf_hkdf(FOIL_DIGEST_SHA256, &salt, NULL, NULL, 42));
+
+    /* Failures aren't counted */
+    g_assert(!foil_kdf_pbkdf2(FOIL_DIGEST_SHA1, NULL, -1, &salt, 1, 0));
+
+    stats = foil_stats_snapshot();
+    g_assert(stats);
+    g_assert(stats->count > 0);
+
+    entry = test_stats_find(stats, FOIL_STATS_CIPHER, cipher_name, "new");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, == ,1);
+    g_assert_cmpuint(entry->nsec, == ,0);
+    entry = test_stats_find(stats, FOIL_STATS_CIPHER, cipher_name, "data");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, == ,1);
+    g_assert_cmpuint(entry->bytes, == ,sizeof(test_data));
+
+    entry = test_stats_find(stats, FOIL_STATS_DIGEST, sha256, "data");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, == ,1);
+    g_assert_cmpuint(entry->bytes, == ,sizeof(test_data));
+    entry = test_stats_find(stats, FOIL_STATS_DIGEST, sha256, "update");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, >= ,2);
+    g_assert_cmpuint(entry->bytes, >= ,2 * sizeof(test_data));
+    entry = test_stats_find(stats, FOIL_STATS_DIGEST, sha256, "new");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, >= ,1);
+
+    entry = test_stats_find(stats, FOIL_STATS_HMAC, sha1, "new");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, >= ,1);
+    entry = test_stats_find(stats, FOIL_STATS_HMAC, sha1, "update");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, >= ,1);
+    g_assert_cmpuint(entry->bytes, >= ,sizeof(test_data));
+
+    entry = test_stats_find(stats, FOIL_STATS_KDF, sha1, "pbkdf2");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, == ,1);
+    g_assert_cmpuint(entry->bytes, == ,20);
+    entry = test_stats_find(stats, FOIL_STATS_KDF, sha256, "hkdf");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, == ,1);
+    g_assert_cmpuint(entry->bytes, == ,42);
+    foil_stats_free(stats);
+
+    /* Reset zeros the counters but keeps the entries */
+    foil_stats_reset();
+    g_assert_cmpuint(test_stats_total_ops(), == ,0);
+
+    /* Disabled again */
+    foil_stats_enable(FALSE);
+    g_assert(!foil_stats_enabled());
+    g_assert(!foil_stats_active());
+    g_bytes_unref(foil_digest_data(FOIL_DIGEST_SHA256,
+        TEST_ARRAY_AND_SIZE(test_data)));
+    g_assert_cmpuint(test_stats_total_ops(), == ,0);
+    foil_key_unref(key);
+}
+
+/*==========================================================================*
+ * thread
+ *==========================================================================*/
+
+static
+gpointer
+test_thread_proc(
+    gpointer data)
+{
+    guint i;
+
+    for (i = 0; i < GPOINTER_TO_UINT(data); i++) {
+        g_bytes_unref(foil_digest_data(FOIL_DIGEST_SHA1,
+            TEST_ARRAY_AND_SIZE(test_data)));
+    }
+    return NULL;
+}
+
+static
+void
+test_thread(
+    void)
+{
+    const char* sha1 = foil_digest_type_name(FOIL_DIGEST_SHA1);
+    const guint n = 10;
+    const FoilStatsEntry* entry;
+    FoilStats* stats;
+    GThread* thread;
+
+    foil_stats_enable(TRUE);
+    foil_stats_reset();
+
+    /* Counters of the finished thread survive the thread */
+    thread = g_thread_new("stats", test_thread_proc, GUINT_TO_POINTER(n));
+    g_thread_join(thread);
+    test_thread_proc(GUINT_TO_POINTER(n));
+
+    stats = foil_stats_snapshot();
+    entry = test_stats_find(stats, FOIL_STATS_DIGEST, sha1, "data");
+    g_assert(entry);
+    g_assert_cmpuint(entry->ops, == ,2 * n);
+    g_assert_cmpuint(entry->bytes, == ,2 * n * sizeof(test_data));
+    foil_stats_free(stats);
+
+    foil_stats_enable(FALSE);
+    foil_stats_reset();
+}
+
+/*==========================================================================*
+ * trace
+ *==========================================================================*/
+
+static
+void
+test_trace(
+    void)
+{
+    GPtrArray* ops = g_ptr_array_new_with_free_func(g_free);
+    const char* sha256 = foil_digest_type_name(FOIL_DIGEST_SHA256);
+    FoilBytes ikm;
+
+    ikm.val = test_data;
+    ikm.len = sizeof(test_data);
+
+    /* Tracing alone doesn't enable the counters */
+    foil_stats_enable(FALSE);
+    foil_stats_reset();
+    foil_stats_set_trace_func(test_stats_trace, ops);
+    g_assert(!foil_stats_enabled());
+    g_assert(foil_stats_active());
+
+    g_bytes_unref(foil_digest_data(FOIL_DIGEST_SHA256,
+        TEST_ARRAY_AND_SIZE(test_data)));
+    g_bytes_unref(foil_kdf_hkdf(FOIL_DIGEST_SHA256, &ikm, NULL, NULL, 0));
+    g_assert(ops->len > 0);
+    g_assert(test_stats_traced(ops, sha256, "data"));
+    g_assert(test_stats_traced(ops, sha256, "hkdf"));
+    g_assert(test_stats_traced(ops, sha256, "update"));
+    g_assert_cmpuint(test_stats_total_ops(), == ,0);
+
+    /* Remove the trace function */
+    foil_stats_set_trace_func(NULL, NULL);
+    g_assert(!foil_stats_active());
+    g_ptr_array_set_size(ops, 0);
+    g_bytes_unref(foil_digest_data(FOIL_DIGEST_SHA256,
+        TEST_ARRAY_AND_SIZE(test_data)));
+    g_assert_cmpuint(ops->len, == ,0);
+    g_ptr_array_free(ops, TRUE);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_(name) "/stats/" name
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("disabled"), test_disabled);
+    g_test_add_func(TEST_("counters"), test_counters);
+    g_test_add_func(TEST_("thread"), test_thread);
+    g_test_add_func(TEST_("trace"), test_trace);
+    return test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -34,8 +34,10 @@
 #include "foilmsg_p.h"
 
 #include <foil_key.h>
+#include <foil_keyring.h>
 #include <foil_private_key.h>
 #include <foil_output.h>
+#include <foil_stats.h>
 #include <foil_util.h>
 
 #include <gutil_misc.h>
@@ -91,6 +93,56 @@ typedef struct test_foilmsg_keys {
     FoilKey* to_pub;
 } TestFoilMsgKeys;
 
+/*
+ * Key files named ed25519* contain Ed25519 keys, x25519* are X25519
+ * and the rest are RSA.
+ */
+static
+GType
+test_foilmsg_private_key_type(
+    const char* name)
+{
+    return g_str_has_prefix(name, "ed25519") ? FOIL_KEY_ED25519_PRIVATE :
+        g_str_has_prefix(name, "x25519") ? FOIL_KEY_X25519_PRIVATE :
+        FOIL_KEY_RSA_PRIVATE;
+}
+
+static
+GType
+test_foilmsg_public_key_type(
+    const char* name)
+{
+    return g_str_has_prefix(name, "ed25519") ? FOIL_KEY_ED25519_PUBLIC :
+        g_str_has_prefix(name, "x25519") ? FOIL_KEY_X25519_PUBLIC :
+        FOIL_KEY_RSA_PUBLIC;
+}
+
+static
+FoilPrivateKey*
+test_foilmsg_private_key(
+    const char* name)
+{
+    char* path = g_strconcat(DATA_DIR, name, NULL);
+    FoilPrivateKey* key = foil_private_key_new_from_file
+        (test_foilmsg_private_key_type(name), path);
+
+    g_free(path);
+    return key;
+}
+
+static
+FoilKey*
+test_foilmsg_public_key(
+    const char* name)
+{
+    char* path = g_strconcat(DATA_DIR, name, NULL);
+    FoilKey* key = foil_key_new_from_file
+        (test_foilmsg_public_key_type(name), path);
+
+    g_free(path);
+    return key;
+}
+
 static
 void
 test_foilmsg_keys_init(
@@ -99,26 +151,16 @@ test_foilmsg_keys_init(
 {
     memset(keys, 0, sizeof(*keys));
     if (test->from_priv) {
-        char* path = g_strconcat(DATA_DIR, test->from_priv, NULL);
-        keys->from_priv = foil_private_key_new_from_file(FOIL_KEY_RSA_PRIVATE,
-            path);
-        g_free(path);
+        keys->from_priv = test_foilmsg_private_key(test->from_priv);
     }
     if (test->from_pub) {
-        char* path = g_strconcat(DATA_DIR, test->from_pub, NULL);
-        keys->from_pub = foil_key_new_from_file(FOIL_KEY_RSA_PUBLIC, path);
-        g_free(path);
+        keys->from_pub = test_foilmsg_public_key(test->from_pub);
     }
     if (test->to_priv) {
-        char* path = g_strconcat(DATA_DIR, test->to_priv, NULL);
-        keys->to_priv = foil_private_key_new_from_file(FOIL_KEY_RSA_PRIVATE,
-            path);
-        g_free(path);
+        keys->to_priv = test_foilmsg_private_key(test->to_priv);
     }
     if (test->to_pub) {
-        char* path = g_strconcat(DATA_DIR, test->to_pub, NULL);
-        keys->to_pub = foil_key_new_from_file(FOIL_KEY_RSA_PUBLIC, path);
-        g_free(path);
+        keys->to_pub = test_foilmsg_public_key(test->to_pub);
     }
 }
 
@@ -217,6 +259,51 @@ test_foilmsg_decrypt_file(
     g_free(tmpdir);
 }
 
+static
+void
+test_foilmsg_encrypt_tmp(
+    void)
+{
+    FoilPrivateKey* priv = foil_private_key_new_from_file(FOIL_KEY_RSA_PRIVATE,
+        DATA_DIR "rsa-1024");
+    FoilKey* pub = foil_public_key_new_from_private(priv);
+    GByteArray* buf = g_byte_array_new();
+    FoilOutput* out = foil_output_mem_new(buf);
+    FoilOutput* tmp = foil_output_mem_new(NULL);
+    FoilMsg* msg;
+    FoilBytes in, enc;
+    gsize len;
+
+    g_assert(priv);
+    g_assert(pub);
+    foil_bytes_from_string(&in, "This is a test");
+
+    /* Nothing reaches the output if the message can't be encoded */
+    foil_output_close(tmp);
+    g_assert(!foilmsg_encrypt(out, &in, NULL, NULL, priv, pub, NULL, tmp));
+    g_assert(!foil_output_bytes_written(out));
+    g_assert(!buf->len);
+    foil_output_unref(tmp);
+
+    /* The message is copied from tmp to the output */
+    tmp = foil_output_mem_new(NULL);
+    len = foilmsg_encrypt(out, &in, NULL, NULL, priv, pub, NULL, tmp);
+    g_assert(len);
+    g_assert_cmpuint(buf->len, == ,len);
+    foil_output_unref(tmp);
+    foil_output_unref(out);
+
+    enc.val = buf->data;
+    enc.len = buf->len;
+    msg = foilmsg_decrypt(priv, &enc, NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, in.val,  in.len));
+    foilmsg_free(msg);
+    g_byte_array_unref(buf);
+    foil_private_key_unref(priv);
+    foil_key_unref(pub);
+}
+
 static
 void
 test_foilmsg_encrypt_self(
@@ -289,6 +376,463 @@ test_foilmsg_encrypt_self(
     foil_key_unref(pub2);
 }
 
+static
+void
+test_foilmsg_stats(
+    void)
+{
+    FoilPrivateKey* priv = foil_private_key_new_from_file(FOIL_KEY_RSA_PRIVATE,
+        DATA_DIR "rsa-1024");
+    const char* text = "This is a test";
+    FoilMsgEncryptOptions opts;
+    guint64 encrypted = 0, decrypted = 0;
+    FoilBytes bytes;
+    FoilStats* stats;
+    FoilMsg* msg;
+    GBytes* enc;
+    guint i;
+
+    g_assert(priv);
+    memset(&opts, 0, sizeof(opts));
+    opts.flags |= FOILMSG_FLAG_ENCRYPT_FOR_SELF;
+
+    foil_stats_enable(TRUE);
+    foil_stats_reset();
+    enc = foilmsg_encrypt_text_to_bytes(text, priv, NULL, &opts);
+    g_assert(enc);
+    msg = foilmsg_decrypt(priv, foil_bytes_from_data(&bytes, enc), NULL);
+    g_assert(msg);
+    foilmsg_free(msg);
+    g_bytes_unref(enc);
+
+    stats = foil_stats_snapshot();
+    for (i = 0; i < stats->count; i++) {
+        const FoilStatsEntry* entry = stats->entries + i;
+
+        if (entry->kind == FOIL_STATS_MSG) {
+            if (!strcmp(entry->op, "encrypt")) {
+                encrypted += entry->ops;
+                g_assert_cmpuint(entry->bytes, == ,strlen(text));
+            } else if (!strcmp(entry->op, "decrypt")) {
+                decrypted += entry->ops;
+                g_assert_cmpuint(entry->bytes, > ,strlen(text));
+            }
+        }
+    }
+    g_assert_cmpuint(encrypted, == ,1);
+    g_assert_cmpuint(decrypted, == ,1);
+    foil_stats_free(stats);
+    foil_stats_enable(FALSE);
+    foil_stats_reset();
+    foil_private_key_unref(priv);
+}
+
+static
+void
+test_foilmsg_encrypt_multi(
+    void)
+{
+    FoilPrivateKey* priv1 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-1024");
+    FoilPrivateKey* priv2 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-768");
+    FoilKey* pub1 = foil_public_key_new_from_private(priv1);
+    FoilKey* pub2 = foil_public_key_new_from_private(priv2);
+    FoilKey* to[10];
+    FoilMsgEncryptOptions opts;
+    const char* text = "This is a test";
+    const guint len = strlen(text);
+    FoilBytes bytes;
+    FoilMsgInfo* info;
+    FoilMsg* msg;
+    GBytes* enc;
+    guint i;
+
+    /* Enough recipients to take the parallel path */
+    for (i = 0; i < G_N_ELEMENTS(to); i++) {
+        to[i] = (i % 2) ? pub1 : pub2;
+    }
+
+    foilmsg_encrypt_defaults(&opts);
+    foil_bytes_from_string(&bytes, text);
+    g_assert(!foilmsg_encrypt_multi_to_bytes(&bytes, NULL, NULL, priv1,
+        NULL, 0, &opts));
+    g_assert(!foilmsg_encrypt_multi_to_bytes(&bytes, NULL, NULL, priv1,
+        NULL, 1, &opts));
+
+    /* Every recipient must be there */
+    to[3] = NULL;
+    g_assert(!foilmsg_encrypt_multi_to_bytes(&bytes, NULL, NULL, priv1,
+        to, G_N_ELEMENTS(to), &opts));
+    to[3] = pub1;
+
+    /* Sender's key is already on the list, it's not added twice */
+    opts.flags |= FOILMSG_FLAG_ENCRYPT_FOR_SELF;
+    enc = foilmsg_encrypt_multi_to_bytes(&bytes, NULL, NULL, priv1,
+        to, G_N_ELEMENTS(to), &opts);
+    g_assert(enc);
+    info = foilmsg_parse(foil_bytes_from_data(&bytes, enc));
+    g_assert(info);
+    g_assert_cmpint(info->num_encrypt_keys, == ,G_N_ELEMENTS(to));
+    for (i = 0; i < G_N_ELEMENTS(to); i++) {
+        GBytes* fp = foil_key_fingerprint(to[i]);
+
+        g_assert(gutil_bytes_equal(fp,
+            info->encrypt_keys[i].fingerprint.data.val,
+            info->encrypt_keys[i].fingerprint.data.len));
+    }
+    foilmsg_info_free(info);
+
+    /* Each recipient can decrypt it */
+    msg = foilmsg_decrypt(priv1, foil_bytes_from_data(&bytes, enc), NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    g_assert(foilmsg_verify(msg, pub1));
+    foilmsg_free(msg);
+    msg = foilmsg_decrypt(priv2, foil_bytes_from_data(&bytes, enc), NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    g_assert(foilmsg_verify(msg, pub1));
+    foilmsg_free(msg);
+    g_bytes_unref(enc);
+
+    /* Only the sender */
+    enc = foilmsg_encrypt_multi_to_bytes(foil_bytes_from_string(&bytes, text),
+        NULL, NULL, priv2, NULL, 0, &opts);
+    g_assert(enc);
+    msg = foilmsg_decrypt(priv2, foil_bytes_from_data(&bytes, enc), NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    foilmsg_free(msg);
+    g_bytes_unref(enc);
+
+    foil_private_key_unref(priv1);
+    foil_private_key_unref(priv2);
+    foil_key_unref(pub1);
+    foil_key_unref(pub2);
+}
+
+static
+void
+test_foilmsg_x25519(
+    void)
+{
+    FoilPrivateKey* sender = test_foilmsg_private_key("rsa-768");
+    FoilPrivateKey* priv1 = test_foilmsg_private_key("x25519");
+    FoilKey* key2 = foil_key_generate_new(FOIL_KEY_X25519_PRIVATE,
+        FOIL_KEY_BITS_DEFAULT);
+    FoilPrivateKey* priv2 = FOIL_PRIVATE_KEY(key2);
+    FoilKey* pub1 = test_foilmsg_public_key("x25519.pub");
+    FoilKey* pub2 = foil_public_key_new_from_private(priv2);
+    FoilKey* rsa = test_foilmsg_public_key("rsa-1024.pub");
+    FoilKey* sender_pub = foil_public_key_new_from_private(sender);
+    FoilKeyring* keyring = foil_keyring_new();
+    FoilKey* to[10];
+    FoilKey* mixed[2];
+    FoilMsgEncryptOptions opts;
+    const char* text = "This is a test";
+    const guint len = strlen(text);
+    FoilBytes bytes;
+    FoilMsgInfo* info;
+    FoilMsg* msg;
+    GBytes* enc;
+    guint i;
+
+    /* Enough recipients to take the parallel path */
+    for (i = 0; i < G_N_ELEMENTS(to); i++) {
+        to[i] = (i % 2) ? pub1 : pub2;
+    }
+
+    foilmsg_encrypt_defaults(&opts);
+    opts.key_type = FOILMSG_KEY_AES_192;
+    foil_bytes_from_string(&bytes, text);
+    enc = foilmsg_encrypt_multi_to_bytes(&bytes, NULL, NULL, sender,
+        to, G_N_ELEMENTS(to), &opts);
+    g_assert(enc);
+    info = foilmsg_parse(foil_bytes_from_data(&bytes, enc));
+    g_assert(info);
+    g_assert_cmpint(info->encrypt_key_format, == ,
+        FOILMSG_ENCRYPT_KEY_FORMAT_AES192_X25519);
+    g_assert_cmpint(info->num_encrypt_keys, == ,G_N_ELEMENTS(to));
+    for (i = 0; i < G_N_ELEMENTS(to); i++) {
+        const FoilMsgEncryptKey* key = info->encrypt_keys + i;
+
+        /* Ephemeral public key + wrapped 24-byte key and 16-byte IV */
+        g_assert_cmpint(key->fingerprint.tag, == ,FOILMSG_FINGERPRINT_X25519);
+        g_assert_cmpuint(key->data.len, == ,32 + 24 + 16 + 8);
+        g_assert(gutil_bytes_equal(foil_key_fingerprint(to[i]),
+            key->fingerprint.data.val, key->fingerprint.data.len));
+    }
+
+    /* Ephemeral keys are different for each recipient */
+    g_assert(memcmp(info->encrypt_keys[0].data.val,
+        info->encrypt_keys[2].data.val, 32));
+    foilmsg_info_free(info);
+
+    /* Each recipient can decrypt it */
+    msg = foilmsg_decrypt(priv1, foil_bytes_from_data(&bytes, enc), NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    g_assert(foilmsg_verify(msg, sender_pub));
+    foilmsg_free(msg);
+    msg = foilmsg_decrypt(priv2, foil_bytes_from_data(&bytes, enc), NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    g_assert(foilmsg_verify(msg, sender_pub));
+    foilmsg_free(msg);
+
+    /* Including when the key comes from a keyring */
+    g_assert(foil_keyring_add(keyring, priv1));
+    msg = foilmsg_decrypt_with_keyring(keyring, foil_bytes_from_data(&bytes,
+        enc), NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    foilmsg_free(msg);
+
+    /* But not the sender */
+    g_assert(!foilmsg_decrypt(sender, foil_bytes_from_data(&bytes, enc),
+        NULL));
+    g_bytes_unref(enc);
+
+    /* RSA and X25519 recipients can't be mixed */
+    mixed[0] = pub1;
+    mixed[1] = rsa;
+    g_assert(!foilmsg_encrypt_multi_to_bytes(foil_bytes_from_string(&bytes,
+        text), NULL, NULL, sender, mixed, G_N_ELEMENTS(mixed), &opts));
+
+    /* That includes sender's own RSA key */
+    opts.flags |= FOILMSG_FLAG_ENCRYPT_FOR_SELF;
+    g_assert(!foilmsg_encrypt_multi_to_bytes(foil_bytes_from_string(&bytes,
+        text), NULL, NULL, sender, &pub1, 1, &opts));
+    g_assert(!foilmsg_encryptor_new(sender, pub1, &opts, 0));
+
+    foil_keyring_unref(keyring);
+    foil_private_key_unref(sender);
+    foil_private_key_unref(priv1);
+    foil_key_unref(key2);
+    foil_key_unref(pub1);
+    foil_key_unref(pub2);
+    foil_key_unref(rsa);
+    foil_key_unref(sender_pub);
+}
+
+static
+void
+test_foilmsg_aead(
+    gconstpointer param)
+{
+    const FOILMSG_CIPHER* cipher = param;
+    FoilPrivateKey* priv = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-768");
+    FoilKey* pub = foil_public_key_new_from_private(priv);
+    FoilMsgEncryptOptions opts;
+    const char* text = "This is a test of authenticated encryption";
+    const guint len = strlen(text);
+    FoilBytes bytes;
+    FoilMsgInfo* info;
+    FoilMsg* msg;
+    GBytes* enc;
+    guint8* data;
+    gsize size, offset;
+
+    foilmsg_encrypt_defaults(&opts);
+    opts.cipher = *cipher;
+    enc = foilmsg_encrypt_to_bytes(foil_bytes_from_string(&bytes, text),
+        NULL, NULL, priv, pub, &opts);
+    g_assert(enc);
+
+    info = foilmsg_parse(foil_bytes_from_data(&bytes, enc));
+    g_assert(info);
+    g_assert_cmpint(info->encrypted.tag, == ,
+        (*cipher == FOILMSG_CIPHER_AES_GCM) ? FOILMSG_ENCRYPT_FORMAT_AES_GCM :
+        FOILMSG_ENCRYPT_FORMAT_CHACHA20_POLY1305);
+    g_assert(info->header.len > 0);
+    g_assert(info->header.val + info->header.len < info->encrypted.data.val);
+    offset = info->encrypted.data.val - bytes.val;
+    size = info->encrypted.data.len;
+    foilmsg_info_free(info);
+
+    msg = foilmsg_decrypt(priv, &bytes, NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    g_assert(foilmsg_verify(msg, pub));
+    foilmsg_free(msg);
+
+    /* Modified ciphertext */
+    data = gutil_memdup(bytes.val, bytes.len);
+    data[offset] ^= 0x01;
+    bytes.val = data;
+    g_assert(!foilmsg_decrypt(priv, &bytes, NULL));
+    data[offset] ^= 0x01;
+
+    /* Modified tag */
+    data[offset + size - 1] ^= 0x80;
+    g_assert(!foilmsg_decrypt(priv, &bytes, NULL));
+
+    g_free(data);
+    g_bytes_unref(enc);
+    foil_private_key_unref(priv);
+    foil_key_unref(pub);
+}
+
+static
+void
+test_foilmsg_keyring(
+    void)
+{
+    FoilPrivateKey* priv1 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-1024");
+    FoilPrivateKey* priv2 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-768");
+    FoilKey* pub1 = foil_public_key_new_from_private(priv1);
+    FoilKey* pub2 = foil_public_key_new_from_private(priv2);
+    FoilKeyring* keyring = foil_keyring_new();
+    FoilMsgEncryptOptions opts;
+    const char* text = "This is a test";
+    const guint len = strlen(text);
+    FoilBytes bytes, fp;
+    FoilMsgInfo* info;
+    FoilMsg* msg;
+    guint8* broken;
+    GBytes* enc;
+
+    foilmsg_encrypt_defaults(&opts);
+    opts.flags |= FOILMSG_FLAG_ENCRYPT_FOR_SELF;
+    enc = foilmsg_encrypt_to_bytes(foil_bytes_from_string(&bytes, text),
+        NULL, NULL, priv1, pub2, &opts);
+    g_assert(enc);
+    foil_bytes_from_data(&bytes, enc);
+
+    g_assert(!foilmsg_decrypt_with_keyring(NULL, &bytes, NULL));
+    g_assert(!foilmsg_decrypt_with_keyring(keyring, NULL, NULL));
+
+    /* Empty keyring */
+    g_assert(!foilmsg_decrypt_with_keyring(keyring, &bytes, NULL));
+
+    /* Either recipient will do */
+    g_assert(foil_keyring_add(keyring, priv2));
+    msg = foilmsg_decrypt_with_keyring(keyring, &bytes, NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    g_assert(foilmsg_verify(msg, pub1));
+    foilmsg_free(msg);
+
+    g_assert(foil_keyring_add(keyring, priv1));
+    g_assert(foil_keyring_remove(keyring, foil_bytes_from_data(&fp,
+        foil_private_key_fingerprint(priv2))));
+    msg = foilmsg_decrypt_with_keyring(keyring, &bytes, NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    foilmsg_free(msg);
+
+    /* If the first recipient's key doesn't work, the next one is tried */
+    g_assert(foil_keyring_add(keyring, priv2));
+    info = foilmsg_parse(&bytes);
+    g_assert(info);
+    g_assert_cmpint(info->num_encrypt_keys, == ,2);
+    g_assert(gutil_bytes_equal(foil_private_key_fingerprint(priv2),
+        info->encrypt_keys[0].fingerprint.data.val,
+        info->encrypt_keys[0].fingerprint.data.len));
+    broken = g_memdup(bytes.val, bytes.len);
+    broken[info->encrypt_keys[0].data.val - bytes.val] ^= 0x01;
+    foilmsg_info_free(info);
+    bytes.val = broken;
+    g_assert(!foilmsg_decrypt(priv2, &bytes, NULL));
+    msg = foilmsg_decrypt_with_keyring(keyring, &bytes, NULL);
+    g_assert(msg);
+    g_assert(gutil_bytes_equal(msg->data, text, len));
+    foilmsg_free(msg);
+    g_free(broken);
+
+    /* Garbage */
+    g_assert(!foilmsg_decrypt_with_keyring(keyring,
+        foil_bytes_from_string(&bytes, text), NULL));
+
+    foil_keyring_unref(keyring);
+    foil_private_key_unref(priv1);
+    foil_private_key_unref(priv2);
+    foil_key_unref(pub1);
+    foil_key_unref(pub2);
+    g_bytes_unref(enc);
+}
+
+static
+void
+test_foilmsg_encryptor(
+    void)
+{
+    FoilPrivateKey* priv = foil_private_key_new_from_file(FOIL_KEY_RSA_PRIVATE,
+        DATA_DIR "rsa-1024");
+    FoilPrivateKey* priv2 = foil_private_key_new_from_file
+        (FOIL_KEY_RSA_PRIVATE, DATA_DIR "rsa-768");
+    FoilKey* pub = foil_public_key_new_from_private(priv);
+    FoilKey* pub2 = foil_public_key_new_from_private(priv2);
+    FoilMsgEncryptOptions opts;
+    FoilMsgEncryptor* enc;
+    const char* text = "This is a test";
+    const guint len = strlen(text);
+    GBytes* prev = NULL;
+    FoilBytes bytes;
+    guint i;
+
+    foilmsg_encrypt_defaults(&opts);
+    foilmsg_encryptor_free(NULL);
+    g_assert(!foilmsg_encryptor_new(NULL, NULL, NULL, 0));
+    g_assert(!foilmsg_encryptor_new(priv, NULL, &opts, 0));
+    g_assert(!foilmsg_encryptor_encrypt(NULL, NULL, NULL, NULL, NULL));
+    g_assert(!foilmsg_encryptor_encrypt_to_bytes(NULL, NULL, NULL, NULL));
+
+    opts.flags |= FOILMSG_FLAG_ENCRYPT_FOR_SELF;
+    enc = foilmsg_encryptor_new(priv, pub2, &opts, 2);
+    g_assert(enc);
+    g_assert(!foilmsg_encryptor_encrypt_to_bytes(enc, NULL, NULL, NULL));
+
+    /* Use up more keys than the encryptor prepares in advance */
+    for (i = 0; i < 5; i++) {
+        GBytes* out = foilmsg_encryptor_encrypt_to_bytes(enc,
+            foil_bytes_from_string(&bytes, text), "text/plain", NULL);
+        FoilMsgInfo* info;
+        FoilMsg* msg;
+
+        g_assert(out);
+        info = foilmsg_parse(foil_bytes_from_data(&bytes, out));
+        g_assert(info);
+        g_assert_cmpint(info->num_encrypt_keys, == ,2);
+        foilmsg_info_free(info);
+
+        /* Both the recipient and the sender can decrypt it */
+        msg = foilmsg_decrypt(priv2, foil_bytes_from_data(&bytes, out), NULL);
+        g_assert(msg);
+        g_assert(gutil_bytes_equal(msg->data, text, len));
+        g_assert(foilmsg_verify(msg, pub));
+        foilmsg_free(msg);
+        msg = foilmsg_decrypt(priv, foil_bytes_from_data(&bytes, out), NULL);
+        g_assert(msg);
+        g_assert(gutil_bytes_equal(msg->data, text, len));
+        foilmsg_free(msg);
+
+        /* Every message gets its own key */
+        if (prev) {
+            FoilMsgInfo* prev_info = foilmsg_parse
+                (foil_bytes_from_data(&bytes, prev));
+            info = foilmsg_parse(foil_bytes_from_data(&bytes, out));
+            g_assert(!foil_bytes_equal(&info->encrypt_keys[0].data,
+                &prev_info->encrypt_keys[0].data));
+            foilmsg_info_free(prev_info);
+            foilmsg_info_free(info);
+            g_bytes_unref(prev);
+        }
+        prev = out;
+    }
+
+    g_bytes_unref(prev);
+    foilmsg_encryptor_free(enc);
+    foil_private_key_unref(priv);
+    foil_private_key_unref(priv2);
+    foil_key_unref(pub);
+    foil_key_unref(pub2);
+}
+
 static
 void
 test_foilmsg_to_binary(
@@ -557,6 +1101,11 @@ static const FoilMsgEncryptOptions options_aes_128_ctr_self = {
     FOILMSG_CIPHER_AES_CTR, FOILMSG_SIGNATURE_DEFAULT
 };
 
+static const FoilMsgEncryptOptions options_aes_128_gcm_self = {
+    FOILMSG_KEY_AES_128, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
+    FOILMSG_CIPHER_AES_GCM, FOILMSG_SIGNATURE_DEFAULT
+};
+
 static const FoilMsgEncryptOptions options_aes_192_self = {
     FOILMSG_KEY_AES_192, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
     FOILMSG_CIPHER_AES_CBC, FOILMSG_SIGNATURE_DEFAULT
@@ -572,6 +1121,11 @@ static const FoilMsgEncryptOptions options_aes_192_ctr_self = {
     FOILMSG_CIPHER_AES_CTR, FOILMSG_SIGNATURE_DEFAULT
 };
 
+static const FoilMsgEncryptOptions options_aes_192_gcm_self = {
+    FOILMSG_KEY_AES_192, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
+    FOILMSG_CIPHER_AES_GCM, FOILMSG_SIGNATURE_DEFAULT
+};
+
 static const FoilMsgEncryptOptions options_aes_256_self = {
     FOILMSG_KEY_AES_256, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
     FOILMSG_CIPHER_AES_CBC, FOILMSG_SIGNATURE_DEFAULT
@@ -587,6 +1141,21 @@ static const FoilMsgEncryptOptions options_aes_256_ctr_self = {
     FOILMSG_CIPHER_AES_CTR, FOILMSG_SIGNATURE_DEFAULT
 };
 
+static const FoilMsgEncryptOptions options_aes_256_gcm_self = {
+    FOILMSG_KEY_AES_256, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
+    FOILMSG_CIPHER_AES_GCM, FOILMSG_SIGNATURE_SHA256_RSA
+};
+
+static const FoilMsgEncryptOptions options_chacha20_poly1305_self = {
+    FOILMSG_KEY_AES_256, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
+    FOILMSG_CIPHER_CHACHA20_POLY1305, FOILMSG_SIGNATURE_DEFAULT
+};
+
+static const FoilMsgEncryptOptions options_chacha20_poly1305_128 = {
+    FOILMSG_KEY_AES_128, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
+    FOILMSG_CIPHER_CHACHA20_POLY1305, FOILMSG_SIGNATURE_DEFAULT
+};
+
 static const FoilMsgEncryptOptions options_aes_256_sha1_rsa = {
     FOILMSG_KEY_AES_256, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
     FOILMSG_CIPHER_AES_CBC, FOILMSG_SIGNATURE_SHA1_RSA
@@ -602,11 +1171,36 @@ static const FoilMsgEncryptOptions options_aes_256_sha512_rsa = {
     FOILMSG_CIPHER_AES_CBC, FOILMSG_SIGNATURE_SHA512_RSA
 };
 
+static const FoilMsgEncryptOptions options_aes_256_blake3_rsa = {
+    FOILMSG_KEY_AES_256, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
+    FOILMSG_CIPHER_AES_CBC, FOILMSG_SIGNATURE_BLAKE3_RSA
+};
+
 static const FoilMsgEncryptOptions options_aes_256_invalid_sig_alg = {
     FOILMSG_KEY_AES_256, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
     FOILMSG_CIPHER_AES_CBC, (FOILMSG_SIGNATURE)-1
 };
 
+static const FoilMsgEncryptOptions options_aes_256_sha256_ed25519 = {
+    FOILMSG_KEY_AES_256, 0,
+    FOILMSG_CIPHER_AES_CBC, FOILMSG_SIGNATURE_SHA256_ED25519
+};
+
+static const FoilMsgEncryptOptions options_aes_256_sha512_ed25519 = {
+    FOILMSG_KEY_AES_256, 0,
+    FOILMSG_CIPHER_AES_GCM, FOILMSG_SIGNATURE_SHA512_ED25519
+};
+
+static const FoilMsgEncryptOptions options_aes_256_blake3_ed25519 = {
+    FOILMSG_KEY_AES_256, 0,
+    FOILMSG_CIPHER_AES_GCM, FOILMSG_SIGNATURE_BLAKE3_ED25519
+};
+
+static const FoilMsgEncryptOptions options_aes_256_sha256_ed25519_self = {
+    FOILMSG_KEY_AES_256, FOILMSG_FLAG_ENCRYPT_FOR_SELF,
+    FOILMSG_CIPHER_AES_CBC, FOILMSG_SIGNATURE_SHA256_ED25519
+};
+
 static const TestFoilMsg foilmsg_tests[] = {
     {
         TEST_("Binary"), test_foilmsg_binary,
@@ -643,6 +1237,11 @@ static const TestFoilMsg foilmsg_tests[] = {
          "Test of 128-bit encryption (CTR mode)",
         { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
         &options_aes_128_ctr_self
+    },{
+        TEST_("AESGCM/128bit"), test_foilmsg_text,
+         "Test of 128-bit encryption (GCM mode)",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_128_gcm_self
     },{
         TEST_("AESCBC/192bit"), test_foilmsg_text,
          "Test of 192-bit encryption",
@@ -658,6 +1257,11 @@ static const TestFoilMsg foilmsg_tests[] = {
          "Test of 192-bit encryption (CTR mode)",
         { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
         &options_aes_192_ctr_self
+    },{
+        TEST_("AESGCM/192bit"), test_foilmsg_text,
+         "Test of 192-bit encryption (GCM mode)",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_192_gcm_self
     },{
         TEST_("AESCBC/256bit"), test_foilmsg_text,
          "Test of 256-bit encryption",
@@ -673,6 +1277,21 @@ static const TestFoilMsg foilmsg_tests[] = {
          "Test of 256-bit encryption (CTR mode)",
         { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
         &options_aes_256_ctr_self
+    },{
+        TEST_("AESGCM/256bit"), test_foilmsg_text,
+         "Test of 256-bit encryption (GCM mode)",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_gcm_self
+    },{
+        TEST_("ChaCha20Poly1305"), test_foilmsg_text,
+         "Test of ChaCha20-Poly1305 encryption",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_chacha20_poly1305_self
+    },{
+        TEST_("ChaCha20Poly1305/128bit"), test_foilmsg_text,
+         "ChaCha20 requires 256-bit key",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_chacha20_poly1305_128, TEST_ENCRYPT_ERROR
     },{
         TEST_("SelfDecrypt"), test_foilmsg_text,
         "Sender should be able to decrypt this",
@@ -698,11 +1317,76 @@ static const TestFoilMsg foilmsg_tests[] = {
          "Test of SHA512/RSA signature",
         { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
         &options_aes_256_sha512_rsa
+    },{
+        TEST_("Signature/BLAKE3"), test_foilmsg_text,
+         "Test of BLAKE3/RSA signature",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_blake3_rsa
     },{
         TEST_("Signature/Invalid"), test_foilmsg_text,
          "Test of invalid signature algorithm",
         { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
         &options_aes_256_invalid_sig_alg, TEST_ENCRYPT_ERROR
+    },{
+        TEST_("Signature/Ed25519/SHA256"), test_foilmsg_text,
+         "Test of SHA256/Ed25519 signature",
+        { "ed25519", "ed25519.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_sha256_ed25519
+    },{
+        TEST_("Signature/Ed25519/SHA512"), test_foilmsg_text,
+         "Test of SHA512/Ed25519 signature",
+        { "ed25519", "ed25519.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_sha512_ed25519, TEST_LINE_BREAKS
+    },{
+        TEST_("Signature/Ed25519/BLAKE3"), test_foilmsg_text,
+         "Test of BLAKE3/Ed25519 signature",
+        { "ed25519", "ed25519.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_blake3_ed25519
+    },{
+        TEST_("Signature/Ed25519/Self"), test_foilmsg_text,
+         "Ed25519 sender can't decrypt, the recipient still can",
+        { "ed25519", "ed25519.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_sha256_ed25519_self
+    },{
+        TEST_("Signature/Ed25519/NoRecipients"), test_foilmsg_text,
+         "Ed25519 key can't be a recipient",
+        { "ed25519", "ed25519.pub", NULL, NULL },
+        &options_aes_256_sha256_ed25519_self, TEST_ENCRYPT_ERROR
+    },{
+        TEST_("Signature/Ed25519/RSASignature"), test_foilmsg_text,
+         "Ed25519 key can't make RSA signatures",
+        { "ed25519", "ed25519.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_sha256_rsa, TEST_ENCRYPT_ERROR
+    },{
+        TEST_("Signature/Ed25519/RSASender"), test_foilmsg_text,
+         "RSA key can't make Ed25519 signatures",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_sha256_ed25519, TEST_ENCRYPT_ERROR
+    },{
+        TEST_("Signature/Ed25519/WrongKey"), test_foilmsg_text,
+         "Ed25519 signature can't be verified with RSA key",
+        { "ed25519", "rsa-768.pub", "rsa-1024", "rsa-1024.pub" },
+        &options_aes_256_sha256_ed25519, TEST_VERIFY_ERROR
+    },{
+        TEST_("X25519/AES128"), test_foilmsg_text,
+         "Test of 128-bit key wrapped for X25519 recipient",
+        { "rsa-768", "rsa-768.pub", "x25519", "x25519.pub" },
+        &options_aes_128
+    },{
+        TEST_("X25519/Ed25519"), test_foilmsg_text,
+         "Test of X25519 recipient and Ed25519 sender",
+        { "ed25519", "ed25519.pub", "x25519", "x25519.pub" },
+        &options_aes_256_sha512_ed25519, TEST_LINE_BREAKS
+    },{
+        TEST_("X25519/WrongKey"), test_foilmsg_text,
+         "X25519 wrapped key can't be decrypted with RSA key",
+        { "rsa-768", "rsa-768.pub", "rsa-1024", "x25519.pub" },
+        &options_aes_128, TEST_DECRYPT_ERROR
+    },{
+        TEST_("X25519/Self"), test_foilmsg_text,
+         "RSA sender's key can't be mixed with X25519 recipient",
+        { "rsa-768", "rsa-768.pub", "x25519", "x25519.pub" },
+        &options_aes_256_self, TEST_ENCRYPT_ERROR
     },{
         TEST_("FingerprintCheckFailure"), test_foilmsg_text,
         "Fingerprint check is going to fail",
@@ -1765,6 +2449,9 @@ static const TestFoilMsgGarbage foilmsg_garbage_tests[] = {
     { TEST_("DecryptNoData"), "FOILMSG   " }
 };
 
+static const FOILMSG_CIPHER aead_gcm = FOILMSG_CIPHER_AES_GCM;
+static const FOILMSG_CIPHER aead_chacha20 = FOILMSG_CIPHER_CHACHA20_POLY1305;
+
 int main(int argc, char* argv[])
 {
     guint i;
@@ -1773,6 +2460,15 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("Options"), test_foilmsg_options);
     g_test_add_func(TEST_("DecryptFile"), test_foilmsg_decrypt_file);
     g_test_add_func(TEST_("EncryptSelf"), test_foilmsg_encrypt_self);
+    g_test_add_func(TEST_("EncryptTmp"), test_foilmsg_encrypt_tmp);
+    g_test_add_func(TEST_("EncryptMulti"), test_foilmsg_encrypt_multi);
+    g_test_add_func(TEST_("Stats"), test_foilmsg_stats);
+    g_test_add_func(TEST_("Encryptor"), test_foilmsg_encryptor);
+    g_test_add_func(TEST_("Keyring"), test_foilmsg_keyring);
+    g_test_add_func(TEST_("X25519"), test_foilmsg_x25519);
+    g_test_add_data_func(TEST_("AEAD/GCM"), &aead_gcm, test_foilmsg_aead);
+    g_test_add_data_func(TEST_("AEAD/ChaCha20Poly1305"), &aead_chacha20,
+        test_foilmsg_aead);
     for (i = 0; i < G_N_ELEMENTS(foilmsg_convert_tests); i++) {
         const TestFoilMsgConvertToBinary* test = foilmsg_convert_tests + i;
         g_test_add_data_func(test->name, test, test_foilmsg_to_binary);
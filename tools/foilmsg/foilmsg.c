@@ -68,6 +68,10 @@ foilmsg_info_fingerprint_format_name(
     switch (tag) {
     case FOILMSG_FINGERPRINT_SSH_RSA:
         return " (rsa-ssh)";
+    case FOILMSG_FINGERPRINT_SSH_ED25519:
+        return " (ed25519-ssh)";
+    case FOILMSG_FINGERPRINT_X25519:
+        return " (x25519)";
     default:
         return "";
     }
@@ -85,6 +89,12 @@ foilmsg_info_key_format_name(
         return " (AES-192)";
     case FOILMSG_ENCRYPT_KEY_FORMAT_AES256:
         return " (AES-256)";
+    case FOILMSG_ENCRYPT_KEY_FORMAT_AES128_X25519:
+        return " (AES-128, X25519)";
+    case FOILMSG_ENCRYPT_KEY_FORMAT_AES192_X25519:
+        return " (AES-192, X25519)";
+    case FOILMSG_ENCRYPT_KEY_FORMAT_AES256_X25519:
+        return " (AES-256, X25519)";
     default:
         return "";
     }
@@ -104,6 +114,14 @@ foilmsg_info_signature_format_name(
         return " (SHA256-RSA)";
     case FOILMSG_SIGNATURE_FORMAT_SHA512_RSA:
         return " (SHA512-RSA)";
+    case FOILMSG_SIGNATURE_FORMAT_SHA256_ED25519:
+        return " (SHA256-Ed25519)";
+    case FOILMSG_SIGNATURE_FORMAT_SHA512_ED25519:
+        return " (SHA512-Ed25519)";
+    case FOILMSG_SIGNATURE_FORMAT_BLAKE3_RSA:
+        return " (BLAKE3-RSA)";
+    case FOILMSG_SIGNATURE_FORMAT_BLAKE3_ED25519:
+        return " (BLAKE3-Ed25519)";
     default:
         return "";
     }
@@ -119,6 +137,10 @@ foilmsg_info_cipher_name(
         return " (AES-CBC)";
     case FOILMSG_ENCRYPT_FORMAT_AES_CFB:
         return " (AES-CFB)";
+    case FOILMSG_ENCRYPT_FORMAT_AES_GCM:
+        return " (AES-GCM)";
+    case FOILMSG_ENCRYPT_FORMAT_CHACHA20_POLY1305:
+        return " (ChaCha20-Poly1305)";
     default:
         return "";
     }
@@ -440,7 +462,8 @@ main(
         { "self", 'S', 0, G_OPTION_ARG_NONE, &for_self,
           "Encrypt to self and the recipient", NULL },
         { "digest", 'D', 0, G_OPTION_ARG_STRING, &digest,
-          "Signature digest (MD5, SHA1, SHA256 or SHA512) [SHA1]", "DIGEST" },
+          "Signature digest (MD5, SHA1, SHA256, SHA512 or BLAKE3) [SHA1]",
+          "DIGEST" },
         { NULL }
     };
     GOptionEntry decrypt_entries[] = {
@@ -637,6 +660,8 @@ main(
                         } else if (!g_ascii_strcasecmp(digest, "SHA512") ||
                             !g_ascii_strcasecmp(digest, "SHA-512")) {
                             opt.signature = FOILMSG_SIGNATURE_SHA512_RSA;
+                        } else if (!g_ascii_strcasecmp(digest, "BLAKE3")) {
+                            opt.signature = FOILMSG_SIGNATURE_BLAKE3_RSA;
                         } else {
                             GWARN("Invalid signature digest \"%s\", using "
                                 "the default one (SHA1)", digest);
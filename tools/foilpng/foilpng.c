@@ -438,7 +438,8 @@ main(
         { "self", 'S', 0, G_OPTION_ARG_NONE, &for_self,
           "Encrypt to self and the recipient", NULL },
         { "digest", 'D', 0, G_OPTION_ARG_STRING, &digest,
-          "Signature digest (MD5, SHA1, SHA256 or SHA512) [SHA1]", "DIGEST" },
+          "Signature digest (MD5, SHA1, SHA256, SHA512 or BLAKE3) [SHA1]",
+          "DIGEST" },
         { NULL }
     };
     const char* summary =
@@ -662,6 +663,9 @@ main(
                             } else if (!g_ascii_strcasecmp(digest, "SHA512") ||
                                 !g_ascii_strcasecmp(digest, "SHA-512")) {
                                 opt.signature = FOILMSG_SIGNATURE_SHA512_RSA;
+                            } else if (!g_ascii_strcasecmp(digest,
+                                "BLAKE3")) {
+                                opt.signature = FOILMSG_SIGNATURE_BLAKE3_RSA;
                             } else {
                                 GWARN("Invalid signature digest \"%s\", using "
                                     "the default one (SHA1)", digest);